@@ -30,7 +30,20 @@ SOURCES += \
     vortex.cpp \
     dolphin.cpp \
     boat.cpp \
-    wheellayoutparser.cpp
+    wheellayoutparser.cpp \
+    arena.cpp \
+    playertable.cpp \
+    gameevent.cpp \
+    gamestatistics.cpp \
+    gamejournal.cpp \
+    journalreplayer.cpp \
+    replaytimeline.cpp \
+    savefile.cpp \
+    pawnrouter.cpp \
+    landcomponents.cpp \
+    hexdistance.cpp \
+    hexbitboard.cpp \
+    trace.cpp
 
 HEADERS += \
     gameexception.hh \
@@ -57,7 +70,33 @@ HEADERS += \
     vortex.hh \
     dolphin.hh \
     boat.hh \
-    wheellayoutparser.hh
+    wheellayoutparser.hh \
+    arena.hh \
+    playertable.hh \
+    gameevent.hh \
+    gamestatistics.hh \
+    gamejournal.hh \
+    journalreplayer.hh \
+    replaytimeline.hh \
+    countingrandom.hh \
+    savefile.hh \
+    pawnrouter.hh \
+    landcomponents.hh \
+    hexdistance.hh \
+    hexbitboard.hh \
+    trace.hh
+
+# qmake CONFIG+=tracing records the TRACE_SCOPE timers, see trace.hh
+tracing {
+    DEFINES += ISLANDGAME_TRACING
+}
+
+# qmake CONFIG+=avx2 builds the hex distance kernels for AVX2 instead of
+# SSE2, see hexdistance.hh
+avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2
+}
 
 unix {
     target.path = /usr/lib
@@ -5,8 +5,8 @@
 namespace Common {
 
 Actor::Actor(int id ):
-    id_( id ),
-    hex_(nullptr){}
+    hex_(),
+    id_( id ){}
 
 Actor::~Actor(){}
 
@@ -30,15 +30,16 @@ int Actor::getId() const
 void Actor::addHex( std::shared_ptr<Common::Hex> hex )
 {
     hex->addActor(shared_from_this());
-    if (hex_ != nullptr) {
-        hex_->removeActor(shared_from_this());
+    std::shared_ptr<Common::Hex> previous = hex_.lock();
+    if (previous != nullptr) {
+        previous->removeActor(shared_from_this());
     }
     hex_ = hex;
 }
 
 std::shared_ptr<Hex> Actor::getHex()
 {
-    return hex_;
+    return hex_.lock();
 }
 
 }
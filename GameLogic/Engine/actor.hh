@@ -85,7 +85,8 @@ public:
     virtual std::shared_ptr<Common::Hex> getHex();
 
 protected:
-    std::shared_ptr<Common::Hex> hex_;
+    //! The hex the actor is on. Not owned, the hex owns the actor.
+    std::weak_ptr<Common::Hex> hex_;
 
 private:
     int id_;
@@ -1,4 +1,5 @@
 #include "actorfactory.hh"
+#include "gameexception.hh"
 
 namespace Logic {
 
@@ -8,7 +9,8 @@ using std::vector;
 
 ActorFactory::ActorFactory():
     actorDefinitions(),
-    idCounter(0)
+    idCounter(0),
+    factoryMutex()
 {
 
 }
@@ -23,11 +25,13 @@ ActorFactory& ActorFactory::getInstance()
 
 void ActorFactory::addActor(string type, ActorBuildFunction buildFunction)
 {
+    std::lock_guard<std::mutex> lock(factoryMutex);
     actorDefinitions[type] = buildFunction;
 }
 
 std::vector<std::string> ActorFactory::getAvailableActors() const
 {
+    std::lock_guard<std::mutex> lock(factoryMutex);
     auto types = vector<string>();
     for (auto it = actorDefinitions.begin();
          it != actorDefinitions.end();
@@ -40,8 +44,35 @@ std::vector<std::string> ActorFactory::getAvailableActors() const
 
 ActorPointer ActorFactory::createActor(string type)
 {
-    ++idCounter;
-    return actorDefinitions[type](idCounter);
+    ActorBuildFunction build;
+    int id = 0;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        auto definition = actorDefinitions.find(type);
+        if (definition == actorDefinitions.end()) {
+            throw Common::GameException("Unknown actor type " + type);
+        }
+        build = definition->second;
+        id = ++idCounter;
+    }
+    return build(id);
+}
+
+ActorPointer ActorFactory::createActor(string type, int id)
+{
+    ActorBuildFunction build;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        auto definition = actorDefinitions.find(type);
+        if (definition == actorDefinitions.end()) {
+            throw Common::GameException("Unknown actor type " + type);
+        }
+        build = definition->second;
+        if (id > idCounter) {
+            idCounter = id;
+        }
+    }
+    return build(id);
 }
 
 }
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 
 /**
  * @file
@@ -50,15 +51,29 @@ public:
      * @brief createActor
      * @param type
      * @return the created actor. Ownership is transferred to caller
+     * @exception GameException type has not been added
      */
     ActorPointer createActor(std::string type);
 
+    /**
+     * @brief createActor creates an actor with a given id, e.g. when a game
+     * is replayed.
+     * @param type Actor type identifier
+     * @param id Identifier of the new actor
+     * @return the created actor. Ownership is transferred to caller
+     * @exception GameException type has not been added
+     * @post Later actors get ids greater than id
+     */
+    ActorPointer createActor(std::string type, int id);
+
 private:
 
     ActorFactory();
 
     std::map<std::string, ActorBuildFunction> actorDefinitions;
     int idCounter;
+    //! Games may run in several threads, e.g. in the game server.
+    mutable std::mutex factoryMutex;
 };
 
 }
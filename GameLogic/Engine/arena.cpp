@@ -0,0 +1,86 @@
+#include "arena.hh"
+
+#include <cstdint>
+
+namespace Common {
+
+namespace {
+
+//! Arena used by the build functions of the calling thread.
+thread_local std::shared_ptr<Arena> currentArena;
+
+}
+
+Arena::Arena(std::size_t chunkSize):
+    chunks_(),
+    cursor_(nullptr),
+    end_(nullptr),
+    chunkSize_(chunkSize),
+    bytesUsed_(0),
+    bytesReserved_(0)
+{
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(cursor_);
+    std::size_t padding = (alignment - (address % alignment)) % alignment;
+
+    if (cursor_ == nullptr ||
+            static_cast<std::size_t>(end_ - cursor_) < padding + bytes) {
+        // Chunks come from new[], which is aligned for any fundamental type
+        addChunk(bytes + alignment);
+        address = reinterpret_cast<std::uintptr_t>(cursor_);
+        padding = (alignment - (address % alignment)) % alignment;
+    }
+
+    char* result = cursor_ + padding;
+    cursor_ = result + bytes;
+    bytesUsed_ += padding + bytes;
+    return result;
+}
+
+void Arena::reserve(std::size_t bytes)
+{
+    if (cursor_ == nullptr || static_cast<std::size_t>(end_ - cursor_) < bytes) {
+        addChunk(bytes);
+    }
+}
+
+std::size_t Arena::bytesUsed() const
+{
+    return bytesUsed_;
+}
+
+std::size_t Arena::bytesReserved() const
+{
+    return bytesReserved_;
+}
+
+void Arena::addChunk(std::size_t bytes)
+{
+    std::size_t size = bytes > chunkSize_ ? bytes : chunkSize_;
+    chunks_.reserve(chunks_.size() + 1);
+    chunks_.emplace_back(new char[size]);
+    cursor_ = chunks_.back().get();
+    end_ = cursor_ + size;
+    bytesReserved_ += size;
+}
+
+ArenaScope::ArenaScope(std::shared_ptr<Arena> arena):
+    previous_(currentArena)
+{
+    currentArena = std::move(arena);
+}
+
+ArenaScope::~ArenaScope()
+{
+    currentArena = std::move(previous_);
+}
+
+std::shared_ptr<Arena> ArenaScope::current()
+{
+    return currentArena;
+}
+
+}
@@ -0,0 +1,205 @@
+#ifndef ARENA_HH
+#define ARENA_HH
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @file
+ * @brief Per-game memory arena for board objects.
+ */
+
+namespace Common {
+
+/**
+ * @brief Chunked bump allocator that owns the storage of one game's board
+ * objects (hexes, pawns, actors and transports).
+ * @details Objects are placed one after another into large chunks, so
+ * entities created together also lie together in memory. Single objects are
+ * never returned to the arena; all chunks are released at once when the
+ * arena is destroyed, i.e. when the last object allocated from it is gone.
+ * The arena is not thread-safe, one game is expected to use it from one
+ * thread at a time.
+ */
+class Arena {
+
+public:
+
+    //! Default size of a single chunk in bytes.
+    static const std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    /**
+     * @brief Constructor.
+     * @param chunkSize Size of a chunk in bytes. Allocations larger than
+     * the chunk size get a chunk of their own.
+     */
+    explicit Arena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief allocate reserves memory from the arena.
+     * @param bytes Amount of bytes needed.
+     * @param alignment Required alignment, must be a power of two.
+     * @return Pointer to uninitialized memory.
+     * @exception std::bad_alloc Memory could not be allocated.
+     * @post Exception quarantee: strong
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief reserve makes sure that at least bytes can be allocated without
+     * a new chunk being created in between.
+     * @param bytes Amount of bytes that will be needed.
+     * @post Exception quarantee: strong
+     */
+    void reserve(std::size_t bytes);
+
+    /**
+     * @brief bytesUsed tells how many bytes have been handed out.
+     * @return Number of bytes allocated from the arena, padding included.
+     */
+    std::size_t bytesUsed() const;
+
+    /**
+     * @brief bytesReserved tells how much memory the arena holds.
+     * @return Total size of the chunks in bytes.
+     */
+    std::size_t bytesReserved() const;
+
+private:
+
+    void addChunk(std::size_t bytes);
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* cursor_;
+    char* end_;
+    std::size_t chunkSize_;
+    std::size_t bytesUsed_;
+    std::size_t bytesReserved_;
+};
+
+/**
+ * @brief Standard allocator that takes its memory from an Arena.
+ * @details Used with std::allocate_shared, which places the object and its
+ * reference counts into the same arena block. Every allocator keeps the
+ * arena alive, so the arena outlives all objects allocated from it.
+ */
+template <class T>
+class ArenaAllocator {
+
+public:
+
+    using value_type = T;
+
+    /**
+     * @brief Constructor.
+     * @param arena The arena the memory is taken from. Not nullptr.
+     */
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena):
+        arena_(std::move(arena))
+    {
+    }
+
+    /**
+     * @brief Rebinding constructor required by the standard library.
+     */
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other):
+        arena_(other.arena())
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t)
+    {
+        // Released together with the rest of the arena.
+    }
+
+    std::shared_ptr<Arena> arena() const
+    {
+        return arena_;
+    }
+
+private:
+
+    std::shared_ptr<Arena> arena_;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return !(a == b);
+}
+
+/**
+ * @brief ArenaScope makes an arena the current arena of the calling thread
+ * for the lifetime of the scope object.
+ * @details The actor and transport build functions registered in
+ * Initialization::getGameRunner() allocate from the current arena, so the
+ * game engine only has to open a scope around calls to the factories.
+ * Scopes can be nested, the previous arena is restored on destruction.
+ */
+class ArenaScope {
+
+public:
+
+    /**
+     * @brief Constructor, sets arena as the current arena.
+     * @param arena Arena for the current thread, may be nullptr.
+     */
+    explicit ArenaScope(std::shared_ptr<Arena> arena);
+
+    /**
+     * @brief Destructor, restores the previous current arena.
+     */
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /**
+     * @brief current returns the current arena of the calling thread.
+     * @return The arena or nullptr if no scope is open.
+     */
+    static std::shared_ptr<Arena> current();
+
+private:
+
+    std::shared_ptr<Arena> previous_;
+};
+
+/**
+ * @brief makePooled creates a shared object inside an arena.
+ * @param arena The arena to use. If nullptr, the object is created with
+ * std::make_shared instead.
+ * @param args Arguments for the constructor of T.
+ * @return Shared pointer to the new object.
+ */
+template <class T, class... Args>
+std::shared_ptr<T> makePooled(const std::shared_ptr<Arena>& arena,
+                              Args&&... args)
+{
+    if (arena == nullptr) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+    return std::allocate_shared<T>(ArenaAllocator<T>(arena),
+                                   std::forward<Args>(args)...);
+}
+
+}
+
+#endif // ARENA_HH
@@ -33,11 +33,6 @@ public:
      */
     virtual void move( std::shared_ptr<Common::Hex> to);
 
-    /**
-     * @copydoc Common::Transport::canMove()
-     */
-    virtual bool canMove( int playerId ) const;
-
 };
 }
 #endif // BOAT_HH
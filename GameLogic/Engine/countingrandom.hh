@@ -0,0 +1,95 @@
+#ifndef COUNTINGRANDOM_HH
+#define COUNTINGRANDOM_HH
+
+#include <cstdint>
+#include <random>
+
+/**
+ * @file
+ * @brief Random number generator whose state can be saved as two numbers.
+ */
+
+namespace Common {
+
+/**
+ * @brief CountingRandom is a std::mt19937 that counts the numbers drawn.
+ * @details The state of the generator is fully described by the seed and the
+ * number of draws, which makes it easy to store in a save file. It can be
+ * used wherever a UniformRandomBitGenerator is expected, e.g. std::shuffle.
+ */
+class CountingRandom {
+
+public:
+
+    using result_type = std::mt19937::result_type;
+
+    /**
+     * @brief Constructor.
+     * @param seed Seed of the generator.
+     */
+    explicit CountingRandom(std::uint32_t seed):
+        engine_(seed),
+        seed_(seed),
+        draws_(0)
+    {
+    }
+
+    static constexpr result_type min()
+    {
+        return std::mt19937::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return std::mt19937::max();
+    }
+
+    /**
+     * @brief Draws the next number.
+     */
+    result_type operator()()
+    {
+        ++draws_;
+        return engine_();
+    }
+
+    /**
+     * @brief seed returns the seed the generator was started with.
+     */
+    std::uint32_t seed() const
+    {
+        return seed_;
+    }
+
+    /**
+     * @brief draws returns the number of numbers drawn since seeding.
+     */
+    std::uint64_t draws() const
+    {
+        return draws_;
+    }
+
+    /**
+     * @brief restore puts the generator in the state it had after draws
+     * numbers were drawn from seed.
+     * @param seed Seed of the generator.
+     * @param draws Number of draws to skip.
+     */
+    void restore(std::uint32_t seed, std::uint64_t draws)
+    {
+        engine_.seed(seed);
+        engine_.discard(draws);
+        seed_ = seed;
+        draws_ = draws;
+    }
+
+private:
+
+    std::mt19937 engine_;
+    std::uint32_t seed_;
+    std::uint64_t draws_;
+};
+
+}
+
+#endif // COUNTINGRANDOM_HH
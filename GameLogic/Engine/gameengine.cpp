@@ -1,32 +1,85 @@
 #include "actorfactory.hh"
 #include "gameengine.hh"
+#include "gamejournal.hh"
 #include "hex.hh"
 #include "actor.hh"
 #include "boat.hh"
 #include "illegalmoveexception.hh"
 #include "piecefactory.hh"
+#include "playertable.hh"
 #include "transportfactory.hh"
+#include "formatexception.hh"
+#include "hexdistance.hh"
+#include "trace.hh"
+#include "wheellayoutparser.hh"
 
 #include <algorithm>
 #include <iostream>
-#include <ctime>
+#include <limits>
+#include <numeric>
+#include <set>
 
 namespace Logic {
 
 //! Rule for max pawns per tile
-int const MAX_PAWNS_PER_HEX = 3;
+int const MAX_PAWNS_PER_HEX = Common::PawnRouter::MAX_PAWNS_PER_HEX;
 int const MAX_ACTIONS_PER_TURN = 3;
+//! Largest coordinate of a hex in a save file.
+int const MAX_SAVED_COORDINATE = 1 << 16;
+//! Most random numbers a saved game may have drawn. A turn draws a few
+//! dozen, so this allows hundreds of thousands of turns, and skipping them
+//! on load takes a fraction of a second.
+std::uint64_t const MAX_SAVED_DRAWS = std::uint64_t(1) << 24;
+
+//! Range of a wheel result, as checkActorMovement and checkTransportMovement
+//! read it: "D" and numbers that wrap to unsigned reach every hex, anything
+//! else that is not a number reaches only the hex itself.
+static int wheelRange(const std::string& moves)
+{
+    if (moves == "D") {
+        return std::numeric_limits<int>::max();
+    }
+    int range = 0;
+    try {
+        range = std::stoi(moves);
+    } catch(std::exception&) {
+        return 0;
+    }
+    return range < 0 ? std::numeric_limits<int>::max() : range;
+}
 
 GameEngine::GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
                        std::shared_ptr<Common::IGameState> statePtr,
                        std::vector<std::shared_ptr<Common::IPlayer> > players):
+    GameEngine(boardPtr, statePtr, players, std::random_device()())
+{
+}
+
+GameEngine::GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
+                       std::shared_ptr<Common::IGameState> statePtr,
+                       std::vector<std::shared_ptr<Common::IPlayer> > players,
+                       std::uint32_t seed):
     playerVector_(players),
+    playersById_(),
+    playerTable_(nullptr),
     board_(boardPtr),
     gameState_(statePtr),
-    islandRadius_(0)
+    router_(boardPtr),
+    land_(),
+    bitboard_(),
+    islandRadius_(0),
+    actorIds_(0),
+    transportIds_(0),
+    arena_(std::make_shared<Common::Arena>()),
+    rng_(seed),
+    journal_(std::make_shared<Common::GameJournal>(seed)),
+    events_(std::make_shared<Common::GameEventPublisher>()),
+    boardPublishes_(false),
+    announcedPlayer_(0),
+    subscriptions_()
 {
-    // Initialize random-number seed
-    std::srand(std::time(0));
+    subscribe();
+    indexPlayers();
 
     PieceFactory::getInstance().readJSON();
 
@@ -37,17 +90,56 @@ GameEngine::GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
         std::cout<< e.msg() <<std::endl;
     }
 
-    layoutParser_.readJSON("Assets/layout.json");
+    readSpinnerLayout();
+    boardPublishes_ = board_->setEventPublisher(events_);
+}
+
+GameEngine::GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
+                       std::shared_ptr<Common::IGameState> statePtr,
+                       std::vector<std::shared_ptr<Common::IPlayer> > players,
+                       const Common::SaveFile& save):
+    playerVector_(players),
+    playersById_(),
+    playerTable_(nullptr),
+    board_(boardPtr),
+    gameState_(statePtr),
+    router_(boardPtr),
+    land_(),
+    bitboard_(),
+    islandRadius_(0),
+    actorIds_(0),
+    transportIds_(0),
+    arena_(std::make_shared<Common::Arena>()),
+    rng_(save.header().seed),
+    journal_(std::make_shared<Common::GameJournal>(save.header().seed)),
+    events_(std::make_shared<Common::GameEventPublisher>()),
+    boardPublishes_(false),
+    announcedPlayer_(0),
+    subscriptions_()
+{
+    subscribe();
+    indexPlayers();
+    loadGame(save);
+    boardPublishes_ = board_->setEventPublisher(events_);
+}
+
+GameEngine::~GameEngine()
+{
+    // the publisher is shared with the board and the user interface and may
+    // outlive the engine
+    for (int subscription : subscriptions_) {
+        events_->unsubscribe(subscription);
+    }
 }
 
 int GameEngine::movePawn(Common::CubeCoordinate origin,
                          Common::CubeCoordinate target,
                          int pawnId)
 {
-    std::shared_ptr<Common::IPlayer> player = getCurrentPlayer();
+    int playerId = currentPlayer();
 
     // Current player not found
-    if (player == nullptr){
+    if (!hasPlayer(playerId)){
         throw Common::IllegalMoveException("Illegal transport move:"
                                            " no current player");
     }
@@ -58,7 +150,10 @@ int GameEngine::movePawn(Common::CubeCoordinate origin,
         throw Common::IllegalMoveException("Illegal pawn move");
     } else {
         board_->movePawn(pawnId, target);
-        player->setActionsLeft(movesLeft);
+        setActionsLeft(playerId, movesLeft);
+        recordTurn();
+        events_->publish(Common::GameEventType::PAWN_MOVED, pawnId, 0,
+                         origin, target);
     }
 
     return movesLeft;
@@ -69,6 +164,7 @@ int GameEngine::checkPawnMovement(Common::CubeCoordinate origin,
                                   Common::CubeCoordinate target,
                                   int pawnId)
 {
+    TRACE_SCOPE("GameEngine::checkPawnMovement");
 
     // Move is illegal (return -1), if:
     //    (1) Source-, target-hex or pawn doesn't exist
@@ -101,29 +197,21 @@ int GameEngine::checkPawnMovement(Common::CubeCoordinate origin,
     unsigned int distance = cubeCoordinateDistance(origin, target);
 
     int playerId = pawn->getPlayerId();
-    if (playerId == gameState_->currentPlayer()) {
+    if (playerId == gameState_->currentPlayer() && hasPlayer(playerId)) {
 
-        // Find ptr to player
-        auto playerIt = playerVector_.begin();
-        while (playerIt != playerVector_.end()) {
-            if ((*playerIt)->getPlayerId() == gameState_->currentPlayer()) {
-                break;
-            }
-            ++playerIt;
-        }
+        unsigned int hadActions = actionsLeft(playerId);
 
         // (4)
-        if ((*playerIt)->getActionsLeft() >= distance) {
+        if (hadActions >= distance) {
             if (board_->isWaterTile(origin) > 0) {
                 // (5)
-                if ((distance == 1) && ((*playerIt)->getActionsLeft() >= 3)) {
+                if ((distance == 1) && (hadActions >= 3)) {
                     return 0;
                 }
             } else {
-                // (6)
-                if (breadthFirst(origin,target,
-                                (*playerIt)->getActionsLeft())) {
-                    unsigned int hadActions = (*playerIt)->getActionsLeft();
+                // (6), a target in another region of land needs no search
+                if (land_.reachable(origin, target) &&
+                        breadthFirst(origin,target, hadActions)) {
                     return hadActions - distance;
                 }
             }
@@ -134,6 +222,172 @@ int GameEngine::checkPawnMovement(Common::CubeCoordinate origin,
 
 }
 
+std::vector<Common::CubeCoordinate> GameEngine::findPawnRoute(
+        Common::CubeCoordinate origin, Common::CubeCoordinate target)
+{
+    TRACE_SCOPE("GameEngine::findPawnRoute");
+    if (!boardPublishes_) {
+        router_.invalidate();
+    }
+    return router_.route(origin, target);
+}
+
+void GameEngine::checkPawnMovements(const Common::PawnMoveQuery* queries,
+                                    std::size_t count,
+                                    int* movesLeft)
+{
+    TRACE_SCOPE("GameEngine::checkPawnMovements");
+
+    // The queries of one pawn are answered together, by the rules of
+    // checkPawnMovement: the pawn is checked and its moves are searched
+    // once, and each target is then looked up in the moves.
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    auto byPawn = [queries](std::size_t first, std::size_t second) {
+        if (!(queries[first].origin == queries[second].origin)) {
+            return queries[first].origin < queries[second].origin;
+        }
+        return queries[first].pawnId < queries[second].pawnId;
+    };
+    // usually all queries are about one pawn, and sorted already
+    if (!std::is_sorted(order.begin(), order.end(), byPawn)) {
+        std::sort(order.begin(), order.end(), byPawn);
+    }
+
+    std::size_t first = 0;
+    while (first < count) {
+        const Common::PawnMoveQuery& group = queries[order[first]];
+        std::size_t last = first + 1;
+        while (last < count && !byPawn(order[first], order[last])) {
+            ++last;
+        }
+
+        // (1) and (2) for the origin, and the player in turn
+        bool movable = false;
+        unsigned int hadActions = 0;
+        bool swimming = false;
+        Common::HexMask moves;
+        std::shared_ptr<Common::Hex> sourceHex = board_->getHex(group.origin);
+        std::shared_ptr<Common::Pawn> pawn = sourceHex == nullptr ?
+                    nullptr : sourceHex->givePawn(group.pawnId);
+        if (pawn != nullptr) {
+            int playerId = pawn->getPlayerId();
+            movable = playerId == gameState_->currentPlayer() &&
+                    hasPlayer(playerId);
+            if (movable) {
+                hadActions = actionsLeft(playerId);
+                swimming = sourceHex->isWaterTile();
+            }
+        }
+        if (movable && !swimming) {
+            // (6) for every target at once
+            readPawns();
+            moves = bitboard_.pawnMoves(
+                        group.origin,
+                        static_cast<int>(std::min<unsigned int>(
+                                             hadActions,
+                                             std::numeric_limits<int>::max())));
+        }
+
+        for (std::size_t i = first; i < last; ++i) {
+            std::size_t index = order[i];
+            Common::CubeCoordinate target = queries[index].target;
+            std::shared_ptr<Common::Hex> targetHex = board_->getHex(target);
+            movesLeft[index] = -1;
+            // (1) and (3)
+            if (!movable || targetHex == nullptr ||
+                    targetHex->getPawnAmount() >= MAX_PAWNS_PER_HEX) {
+                continue;
+            }
+            unsigned int distance = cubeCoordinateDistance(group.origin,
+                                                           target);
+            // (4)
+            if (hadActions < distance) {
+                continue;
+            }
+            if (swimming) {
+                // (5)
+                if (distance == 1 && hadActions >= 3) {
+                    movesLeft[index] = 0;
+                }
+            } else if (bitboard_.contains(moves, target)) {
+                movesLeft[index] = static_cast<int>(hadActions - distance);
+            }
+        }
+        first = last;
+    }
+    TRACE_COUNTER("checkPawnMovements queries", count);
+}
+
+std::vector<Common::PawnReach> GameEngine::findReachableHexes(
+        int playerId, unsigned int maxActions) const
+{
+    TRACE_SCOPE("GameEngine::findReachableHexes");
+
+    std::vector<std::pair<Common::CubeCoordinate, int>> pawns;
+    for (const Common::CubeCoordinate& coord : hexCoordinates_) {
+        std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+        if (hex == nullptr || hex->getPawnAmount() == 0) {
+            continue;
+        }
+        for (const auto& pawn : hex->getPawns()) {
+            if (pawn->getPlayerId() == playerId) {
+                pawns.push_back({coord, pawn->getId()});
+            }
+        }
+    }
+
+    int limit = static_cast<int>(std::min<unsigned int>(
+                                     maxActions,
+                                     std::numeric_limits<int>::max()));
+    return router_.reachAll(pawns, limit);
+}
+
+std::vector<Common::CubeCoordinate> GameEngine::findPawnMoves(
+        Common::CubeCoordinate origin, int pawnId) const
+{
+    TRACE_SCOPE("GameEngine::findPawnMoves");
+
+    // The same rules as checkPawnMovement
+    std::shared_ptr<Common::Hex> sourceHex = board_->getHex(origin);
+    if (sourceHex == nullptr) {
+        return {};
+    }
+    std::shared_ptr<Common::Pawn> pawn = sourceHex->givePawn(pawnId);
+    if (pawn == nullptr) {
+        return {};
+    }
+    int playerId = pawn->getPlayerId();
+    if (playerId != gameState_->currentPlayer() || !hasPlayer(playerId)) {
+        return {};
+    }
+
+    unsigned int actions = actionsLeft(playerId);
+    readPawns();
+    Common::HexMask moves = bitboard_.mask(origin);
+    if (sourceHex->isWaterTile()) {
+        // a swimmer moves one hex with a whole turn of actions
+        if (actions < Common::PawnRouter::SWIM_ACTIONS) {
+            return {};
+        }
+        moves = bitboard_.dilate(moves);
+        moves.subtract(bitboard_.full());
+    } else {
+        int limit = static_cast<int>(std::min<unsigned int>(
+                                         actions,
+                                         std::numeric_limits<int>::max()));
+        moves = bitboard_.pawnMoves(origin, limit);
+    }
+    moves.subtract(bitboard_.mask(origin));
+    return bitboard_.coordinates(moves);
+}
+
+bool GameEngine::isConnectedOverLand(Common::CubeCoordinate first,
+                                     Common::CubeCoordinate second) const
+{
+    return land_.connected(first, second);
+}
+
 void GameEngine::moveActor(Common::CubeCoordinate origin,
                            Common::CubeCoordinate target,
                            int actorId,
@@ -147,7 +401,10 @@ void GameEngine::moveActor(Common::CubeCoordinate origin,
     } else
     {
         board_->moveActor(actorId, target);
-        getCurrentPlayer()->setActionsLeft(MAX_ACTIONS_PER_TURN);
+        setActionsLeft(currentPlayer(), MAX_ACTIONS_PER_TURN);
+        recordTurn();
+        events_->publish(Common::GameEventType::ACTOR_MOVED, actorId, 0,
+                         origin, target);
     }
 
 
@@ -214,24 +471,26 @@ int GameEngine::moveTransport(Common::CubeCoordinate origin,
                               int transportId)
 {
     // Find current player
-    std::shared_ptr<Common::IPlayer> player = getCurrentPlayer();
+    int playerId = currentPlayer();
 
     // Current player not found
-    if (player == nullptr){
+    if (!hasPlayer(playerId)){
         throw Common::IllegalMoveException("Illegal transport move:"
                                            " no current player");
     }
 
-    std::string movesStr = std::to_string(player->getActionsLeft());
     int movesLeft = checkTransportMovement(origin, target, transportId,
-                                           movesStr);
+                                           false, actionsLeft(playerId));
 
     if (movesLeft < 0) {
         throw Common::IllegalMoveException("Illegal transport move");
     } else
     {
-        player->setActionsLeft(movesLeft);
+        setActionsLeft(playerId, movesLeft);
         board_->moveTransport(transportId, target);
+        recordTurn();
+        events_->publish(Common::GameEventType::TRANSPORT_MOVED, transportId,
+                         0, origin, target);
     }
     return movesLeft;
 }
@@ -248,14 +507,19 @@ int GameEngine::moveTransportWithSpinner(Common::CubeCoordinate origin,
         throw Common::IllegalMoveException("Illegal transport move");
     } else
     {
+        recordTurn();
         if (moves == "D") {
             board_->getHex(origin)->giveTransport(transportId)->removePawns();
+            events_->publish(Common::GameEventType::TRANSPORT_UNLOADED,
+                             transportId, 0, origin, origin);
             movesLeft=0;
         }
         board_->moveTransport(transportId, target);
+        events_->publish(Common::GameEventType::TRANSPORT_MOVED, transportId,
+                         0, origin, target);
     }
     if (movesLeft == 0 ){
-        getCurrentPlayer()->setActionsLeft(MAX_ACTIONS_PER_TURN);
+        setActionsLeft(currentPlayer(), MAX_ACTIONS_PER_TURN);
     }
     return movesLeft;
 
@@ -265,6 +529,27 @@ int GameEngine::checkTransportMovement(Common::CubeCoordinate origin,
                                        Common::CubeCoordinate target,
                                        int transportId,
                                        std::string moves)
+{
+    if (moves == "D") {
+        return checkTransportMovement(origin, target, transportId, true, 3);
+    }
+
+    unsigned int numMoves = 0;
+    try {
+        numMoves = std::stoi(moves);
+    } catch(std::exception &e) {
+        // Given moves-argument couldn't be translated to int
+        numMoves = 0;
+    }
+    return checkTransportMovement(origin, target, transportId, false,
+                                  numMoves);
+}
+
+int GameEngine::checkTransportMovement(Common::CubeCoordinate origin,
+                                       Common::CubeCoordinate target,
+                                       int transportId,
+                                       bool dive,
+                                       unsigned int numMoves)
 {
     // Move is illegal (return -1), if:
     //    (1) Source-, target-hex or actor doesn't exist
@@ -294,26 +579,15 @@ int GameEngine::checkTransportMovement(Common::CubeCoordinate origin,
     }
 
     bool distancePass = false;
-    unsigned int numMoves = 0;
     unsigned int distance = 0;
 
     //Checking if transport is empty
     bool isTransportEmpty = transport->getMaxCapacity() == transport->getCapacity();
     // (4)
-    if (moves == "D") {
+    if (dive) {
         distancePass = true;
-        numMoves = 3;
     // (5)
     } else {
-
-        try {
-            numMoves = std::stoi(moves);
-        } catch(std::exception &e) {
-            // Given moves-argument couldn't be translated to int
-            distancePass = false;
-            numMoves = 0;
-        }
-
         distance = cubeCoordinateDistance(origin, target);
         if (distance <= numMoves) {
             //Check if player can move transport or transport is empty (6)
@@ -340,8 +614,64 @@ int GameEngine::checkTransportMovement(Common::CubeCoordinate origin,
     return movesLeft;
 }
 
+std::vector<Common::CubeCoordinate> GameEngine::findActorMoves(
+        Common::CubeCoordinate origin, int actorId, std::string moves)
+{
+    TRACE_SCOPE("GameEngine::findActorMoves");
+
+    // The same rules as checkActorMovement
+    std::shared_ptr<Common::Hex> sourceHex = board_->getHex(origin);
+    if (sourceHex == nullptr || sourceHex->giveActor(actorId) == nullptr) {
+        return {};
+    }
+    return waterInRange(origin, wheelRange(moves));
+}
+
+std::vector<Common::CubeCoordinate> GameEngine::findTransportMoves(
+        Common::CubeCoordinate origin, int transportId, std::string moves)
+{
+    TRACE_SCOPE("GameEngine::findTransportMoves");
+
+    // The same rules as checkTransportMovement
+    std::shared_ptr<Common::Hex> sourceHex = board_->getHex(origin);
+    if (sourceHex == nullptr) {
+        return {};
+    }
+    std::shared_ptr<Common::Transport> transport =
+            sourceHex->giveTransport(transportId);
+    if (transport == nullptr) {
+        return {};
+    }
+    if (moves != "D") {
+        bool isTransportEmpty =
+                transport->getMaxCapacity() == transport->getCapacity();
+        if (!transport->canMove(gameState_->currentPlayer()) &&
+                !isTransportEmpty) {
+            return {};
+        }
+    }
+    return waterInRange(origin, wheelRange(moves));
+}
+
+std::vector<Common::CubeCoordinate> GameEngine::waterInRange(
+        Common::CubeCoordinate origin, int range) const
+{
+    std::vector<std::uint32_t> found(hexBatch_.size());
+    std::size_t count = Common::waterWithin(origin, hexBatch_, range,
+                                            found.data());
+    std::vector<Common::CubeCoordinate> targets;
+    targets.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t slot = found[i];
+        targets.emplace_back(hexBatch_.x[slot], hexBatch_.y[slot],
+                             hexBatch_.z[slot]);
+    }
+    return targets;
+}
+
 std::string GameEngine::flipTile(Common::CubeCoordinate tileCoord)
 {
+    TRACE_SCOPE("GameEngine::flipTile");
 
     gameState_->changeGamePhase(Common::GamePhase::SINKING);
 
@@ -378,8 +708,10 @@ std::string GameEngine::flipTile(Common::CubeCoordinate tileCoord)
       islandPieces_.pop_back();
 
     }
+    removeFlippable(tileCoord);
 
     // Toimijan arvontaa.
+    Common::ArenaScope arenaScope(arena_);
     auto actors = Logic::ActorFactory::getInstance().getAvailableActors();
     auto transports = Logic::TransportFactory::getInstance().getAvailableTransports();
 
@@ -388,17 +720,32 @@ std::string GameEngine::flipTile(Common::CubeCoordinate tileCoord)
     creatables.reserve(actors.size() + transports.size());
     creatables.insert(creatables.end(), actors.begin(), actors.end());
     creatables.insert(creatables.end(), transports.begin(), transports.end());
-    std::random_shuffle(creatables.begin(), creatables.end());
+    std::shuffle(creatables.begin(), creatables.end(), rng_);
     auto selected = creatables.back();
 
+    recordTurn();
     auto matchString = [selected](auto a)->bool{return a == selected;};
     if(std::find_if(transports.begin(), transports.end(), matchString) != transports.end()){
-        board_->addTransport(Logic::TransportFactory::getInstance().createTransport(selected), tileCoord);
+        auto transport = Logic::TransportFactory::getInstance().createTransport(
+                    selected, ++transportIds_);
+        board_->addTransport(transport, tileCoord);
+        events_->publish(Common::GameEventType::TRANSPORT_SPAWNED,
+                         transport->getId(), 0, tileCoord, tileCoord,
+                         selected);
     } else if (std::find_if(actors.begin(), actors.end(), matchString) != actors.end()) {
-        board_->addActor(ActorFactory::ActorFactory::getInstance().createActor(selected), tileCoord);
+        auto actor = ActorFactory::ActorFactory::getInstance().createActor(
+                    selected, ++actorIds_);
+        board_->addActor(actor, tileCoord);
+        events_->publish(Common::GameEventType::ACTOR_SPAWNED, actor->getId(),
+                         0, tileCoord, tileCoord, selected);
     }
     // muutetaan ruutu vesiruuduksi.
     currentHex->setPieceType("Water");
+    land_.sink(tileCoord);
+    bitboard_.sink(tileCoord);
+    setBatchHex(tileCoord, true);
+    events_->publish(Common::GameEventType::HEX_SUNK, 0, 0, tileCoord,
+                     tileCoord, pieceType);
 
     return selected;
 
@@ -406,21 +753,28 @@ std::string GameEngine::flipTile(Common::CubeCoordinate tileCoord)
 
 std::pair<std::string,std::string> GameEngine::spinWheel()
 {
+    TRACE_SCOPE("GameEngine::spinWheel");
 
     gameState_->changeGamePhase(Common::GamePhase::SPINNING);
 
     // Mikä eläin (arvonta)...
-    layoutParser_.getSections();
-    std::vector<std::string> sections = layoutParser_.getSections();;
-    std::random_shuffle(sections.begin(),sections.end());
-    std::string toMove = sections.back();
+    std::vector<std::size_t> sections(spinnerSections_.size());
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        sections[i] = i;
+    }
+    std::shuffle(sections.begin(), sections.end(), rng_);
+    std::string toMove = spinnerSections_.at(sections.back()).first;
 
     // ...ja paljon liikkuu (1,2,3,D -> arvonta).
 
-    auto moves = layoutParser_.getChancesForSection(toMove);
-    std::random_shuffle(moves.begin(),moves.end());
+    auto moves = spinnerSections_.at(sections.back()).second;
+    std::shuffle(moves.begin(), moves.end(), rng_);
     std::string moveAmount = moves.back().first;
 
+    recordTurn();
+    events_->publish(Common::GameEventType::WHEEL_SPUN, 0, 0, {0, 0, 0},
+                     {0, 0, 0}, toMove, moveAmount);
+
     return std::pair<std::string,std::string> (toMove, moveAmount);
 
 }
@@ -428,115 +782,457 @@ std::pair<std::string,std::string> GameEngine::spinWheel()
 Common::SpinnerLayout GameEngine::getSpinnerLayout() const
 {
     using Common::SpinnerLayout;
-    auto sections = layoutParser_.getSections();
     SpinnerLayout layout;
-    for (const auto& section: sections){
-        auto chaces = layoutParser_.getChancesForSection(section);
-        for (const auto& chance: chaces) {
-            layout[section].insert(chance);
+    for (const auto& section: spinnerSections_){
+        for (const auto& chance: section.second) {
+            layout[section.first].insert(chance);
         }
     }
     return layout;
 }
 
+void GameEngine::readSpinnerLayout()
+{
+    WheelLayoutParser layoutParser;
+    layoutParser.readJSON("Assets/layout.json");
+    for (const auto& section: layoutParser.getSections()) {
+        spinnerSections_.push_back(
+                    {section, layoutParser.getChancesForSection(section)});
+    }
+}
+
 std::shared_ptr<Common::IPlayer> GameEngine::getCurrentPlayer()
 {
     int id = currentPlayer();
-    auto end = playerVector_.end();
-    for (auto iter = playerVector_.begin(); iter != end; ++iter) {
-        if ((*iter)->getPlayerId() == id) {
-            return *iter;
-        }
+    if (!hasPlayer(id)) {
+        return nullptr;
     }
-    return nullptr;
+    return playersById_[id];
 }
 
-bool GameEngine::breadthFirst(Common::CubeCoordinate FromCoord, Common::CubeCoordinate ToCoord, unsigned int actionsLeft)
+std::shared_ptr<Common::GameJournal> GameEngine::getJournal() const
 {
+    return journal_;
+}
 
-    unsigned int currentIndex = 0;
-    std::vector<std::pair<Common::CubeCoordinate,unsigned int>> checkVector;
-    std::pair<Common::CubeCoordinate,unsigned int> firstTile = std::make_pair(FromCoord,currentIndex);
-    checkVector.push_back(firstTile);
+std::shared_ptr<Common::GameEventPublisher> GameEngine::getEvents() const
+{
+    return events_;
+}
 
-    std::vector<Common::CubeCoordinate> workVector;
-    workVector.push_back(FromCoord);
+void GameEngine::saveGame(const std::string& filePath) const
+{
+    Common::SaveFileWriter save;
+    Common::SaveHeader& header = save.header();
+    header.gamePhase = gameState_->currentGamePhase();
+    header.currentPlayer = gameState_->currentPlayer();
+    header.islandRadius = islandRadius_;
+    header.actorIdCounter = actorIds_;
+    header.transportIdCounter = transportIds_;
+    header.seed = rng_.seed();
+    header.draws = rng_.draws();
+
+    for (const Common::CubeCoordinate& coord : hexCoordinates_) {
+        std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+        if (hex == nullptr) {
+            continue;
+        }
+        save.addHex(coord, hex->getPieceType());
+        for (const auto& transport : hex->getTransports()) {
+            save.addTransport(transport->getId(),
+                              transport->getTransportType(), coord);
+        }
+        for (const auto& actor : hex->getActors()) {
+            save.addActor(actor->getId(), actor->getActorType(), coord);
+        }
+        for (const auto& pawn : hex->getPawns()) {
+            std::shared_ptr<Common::Transport> carrier = pawn->getTransport();
+            save.addPawn(pawn->getId(), pawn->getPlayerId(), coord,
+                         carrier == nullptr ? 0 : carrier->getId());
+        }
+    }
 
-    while(not workVector.empty()){
+    for (const auto& player : playerVector_) {
+        int id = player->getPlayerId();
+        Common::SavedPlayer saved = {id, player->getActionsLeft(), 0, 0};
+        if (playerTable_ != nullptr) {
+            const Common::PlayerRecord& record = playerTable_->at(id);
+            saved.pawns = record.pawns;
+            saved.points = record.points;
+        }
+        save.addPlayer(saved);
+    }
 
-        Common::CubeCoordinate currentCoord = workVector.at(0);
-        workVector.erase(workVector.begin());
-        std::shared_ptr<Common::Hex> currentHex = board_->getHex(currentCoord);
+    for (const auto& piece : islandPieces_) {
+        save.addPieceCount(piece.first, piece.second);
+    }
+    for (const auto& section : spinnerSections_) {
+        for (const auto& chance : section.second) {
+            save.addSpinnerChance(section.first, chance.first, chance.second);
+        }
+    }
 
-        if(currentHex->getPawnAmount() < MAX_PAWNS_PER_HEX
-                || currentCoord == FromCoord){
-            if(!(currentHex)->isWaterTile()){
-                unsigned int newIndex = 0;
-                while(newIndex < checkVector.size()){
-                    if(checkVector.at(newIndex).first == currentCoord){
-                        break;
-                    }
-                    newIndex++;
-                }
-                currentIndex = newIndex;
-
-                // Use only existing neighbours
-                std::vector<Common::CubeCoordinate> neighbourVector = {};
-                auto neighbourCoords = currentHex->getNeighbourVector();
-                auto neighboursEnd = neighbourCoords.end();
-                for (auto iter = neighbourCoords.begin(); iter != neighboursEnd;
-                     ++iter)
-                {
-                    if (board_->getHex(*iter) != nullptr) {
-                        neighbourVector.push_back(*iter);
-                    }
-                }
+    save.write(filePath);
+}
 
-                for(auto neighIt = neighbourVector.begin(); neighIt != neighbourVector.end(); neighIt++){
+void GameEngine::loadGame(const Common::SaveFile& save)
+{
+    const Common::SaveHeader& header = save.header();
+
+    // SaveFile checks only the layout of the file. Everything the records
+    // refer to is checked here before it is used, so that a corrupt file
+    // fails with a FormatException.
+    if (header.gamePhase < Common::GamePhase::MOVEMENT ||
+            header.gamePhase > Common::GamePhase::SPINNING) {
+        throw Common::FormatException("Save file has an invalid game phase");
+    }
+    if (!hasPlayer(header.currentPlayer)) {
+        throw Common::FormatException("Save file has an unknown player " +
+                                      std::to_string(header.currentPlayer));
+    }
+    if (header.islandRadius < 0 || header.actorIdCounter < 0 ||
+            header.transportIdCounter < 0) {
+        throw Common::FormatException("Corrupt save file");
+    }
+    if (header.draws > MAX_SAVED_DRAWS) {
+        throw Common::FormatException("Save file has too many random draws");
+    }
 
-                    if((*neighIt) == ToCoord){
-                        std::pair<Common::CubeCoordinate,int> finalTile = std::make_pair((*neighIt),currentIndex);
-                        checkVector.push_back(finalTile);
+    // Strings are shared by many records, convert each only once
+    std::vector<std::string> strings;
+    strings.reserve(header.sections[Common::SAVE_STRINGS].count);
+    for (std::uint32_t i = 0; i < header.sections[Common::SAVE_STRINGS].count;
+         ++i) {
+        strings.push_back(save.string(i));
+    }
+    auto stringAt = [&strings](std::uint32_t index) -> const std::string& {
+        if (index >= strings.size()) {
+            throw Common::FormatException("Invalid string in save file");
+        }
+        return strings[index];
+    };
+
+    // Hexes, all from one block of the arena. They are also put into a
+    // dense grid over the bounding box, so that neighbours are linked
+    // without looking them up from the board.
+    Common::SaveRecords<Common::SavedHex> hexes = save.hexes();
+    int minX = 0, maxX = 0, minZ = 0, maxZ = 0;
+    for (const Common::SavedHex& saved : hexes) {
+        if (saved.x < -MAX_SAVED_COORDINATE || saved.x > MAX_SAVED_COORDINATE ||
+                saved.z < -MAX_SAVED_COORDINATE ||
+                saved.z > MAX_SAVED_COORDINATE ||
+                static_cast<long long>(saved.x) + saved.y + saved.z != 0) {
+            throw Common::FormatException("Save file has an invalid hex");
+        }
+        minX = std::min(minX, saved.x);
+        maxX = std::max(maxX, saved.x);
+        minZ = std::min(minZ, saved.z);
+        maxZ = std::max(maxZ, saved.z);
+    }
+    std::size_t width = static_cast<std::size_t>(maxZ - minZ) + 1;
+    std::size_t cells = (static_cast<std::size_t>(maxX - minX) + 1) * width;
+    // saveGame saves whole islands, whose box has less than twice as many
+    // cells as the island has hexes
+    if (cells > 2 * hexes.size() + 16) {
+        throw Common::FormatException("Save file hexes are not an island");
+    }
+    std::vector<Common::Hex*> grid(cells, nullptr);
+    std::vector<std::shared_ptr<Common::Hex>> created;
+    created.reserve(hexes.size());
+
+    arena_->reserve(hexes.size() * (sizeof(Common::Hex) + 64));
+    hexCoordinates_.reserve(hexes.size());
+    hexBatch_.reserve(hexes.size());
+    for (const Common::SavedHex& saved : hexes) {
+        Common::CubeCoordinate coord(saved.x, saved.y, saved.z);
+        const std::string& type = stringAt(saved.type);
+        Common::Hex*& cell = grid[(saved.x - minX) * width + (saved.z - minZ)];
+        if (cell != nullptr) {
+            throw Common::FormatException("Save file has a hex twice");
+        }
+        std::shared_ptr<Common::Hex> hex =
+                Common::makePooled<Common::Hex>(arena_);
+        hex->setCoordinates(coord);
+        hex->setPieceType(type);
+        board_->addHex(hex);
+        land_.addHex(coord, type != "Water");
+        bitboard_.addHex(coord, type);
+        hexCoordinates_.push_back(coord);
+        setBatchHex(coord, type == "Water");
+        if (type != "Water" && type != "Coral") {
+            addFlippable(coord, type);
+        }
+        cell = hex.get();
+        created.push_back(hex);
+    }
 
-                        unsigned int nextTile = checkVector.size();
-                        std::vector<Common::CubeCoordinate> finalRoadVector;
-                        while(nextTile != 0){
+    const int sides[6][2] = {{1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1},
+                             {0, 1}};
+    for (const std::shared_ptr<Common::Hex>& hex : created) {
+        Common::CubeCoordinate coord = hex->getCoordinates();
+        for (const auto& side : sides) {
+            int x = coord.x + side[0];
+            int z = coord.z + side[1];
+            if (x < minX || x > maxX || z < minZ || z > maxZ) {
+                continue;
+            }
+            Common::Hex* neighbour = grid[(x - minX) * width + (z - minZ)];
+            if (neighbour != nullptr) {
+                hex->addNeighbour(neighbour->shared_from_this());
+            }
+        }
+    }
 
-                            finalRoadVector.insert(finalRoadVector.begin(),checkVector.at(nextTile - 1).first);
-                            nextTile = checkVector.at(nextTile  - 1).second;
-                        }
-                        //finalRoadVector.push_back(FromCoord);
-                        if(finalRoadVector.size() <= actionsLeft){
-                            return true;
-                        }
-                        else{
-                            return false;
-                        }
-                    }
+    // Occupants, each on a hex of the board and with an id of its own
+    auto hexAt = [this](Common::CubeCoordinate coord) {
+        std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+        if (hex == nullptr) {
+            throw Common::FormatException("Save file puts a piece outside "
+                                          "the board");
+        }
+        return hex;
+    };
+    auto checkId = [](std::set<int>& ids, int id) {
+        if (id <= 0 || !ids.insert(id).second) {
+            throw Common::FormatException("Save file has an invalid id " +
+                                          std::to_string(id));
+        }
+    };
+    std::vector<std::string> transportTypes =
+            TransportFactory::getInstance().getAvailableTransports();
+    std::vector<std::string> actorTypes =
+            ActorFactory::getInstance().getAvailableActors();
+    auto checkType = [](const std::vector<std::string>& types,
+                        const std::string& type) {
+        if (std::find(types.begin(), types.end(), type) == types.end()) {
+            throw Common::FormatException("Save file has an unknown piece "
+                                          "type " + type);
+        }
+        return type;
+    };
+
+    Common::ArenaScope arenaScope(arena_);
+    std::set<int> ids;
+    transportIds_ = header.transportIdCounter;
+    for (const Common::SavedObject& saved : save.transports()) {
+        Common::CubeCoordinate coord(saved.x, saved.y, saved.z);
+        hexAt(coord);
+        checkId(ids, saved.id);
+        board_->addTransport(TransportFactory::getInstance().createTransport(
+                                 checkType(transportTypes,
+                                           stringAt(saved.type)),
+                                 saved.id),
+                             coord);
+        transportIds_ = std::max(transportIds_, saved.id);
+    }
+    ids.clear();
+    actorIds_ = header.actorIdCounter;
+    for (const Common::SavedObject& saved : save.actors()) {
+        Common::CubeCoordinate coord(saved.x, saved.y, saved.z);
+        hexAt(coord);
+        checkId(ids, saved.id);
+        board_->addActor(ActorFactory::getInstance().createActor(
+                             checkType(actorTypes, stringAt(saved.type)),
+                             saved.id),
+                         coord);
+        actorIds_ = std::max(actorIds_, saved.id);
+    }
+    ids.clear();
+    for (const Common::SavedPawn& saved : save.pawns()) {
+        Common::CubeCoordinate coord(saved.x, saved.y, saved.z);
+        std::shared_ptr<Common::Hex> hex = hexAt(coord);
+        checkId(ids, saved.id);
+        if (!hasPlayer(saved.player)) {
+            throw Common::FormatException("Save file has an unknown player " +
+                                          std::to_string(saved.player));
+        }
+        board_->addPawn(saved.player, saved.id, coord);
+        if (saved.transport != 0) {
+            std::shared_ptr<Common::Transport> transport =
+                    hex->giveTransport(saved.transport);
+            if (transport == nullptr) {
+                throw Common::FormatException("Save file puts a pawn into "
+                                              "a missing transport");
+            }
+            transport->addPawn(hex->givePawn(saved.id));
+        }
+    }
+    // the board is given the publisher of the game only after loading
+    for (const Common::SavedPawn& saved : save.pawns()) {
+        updatePawns(Common::CubeCoordinate(saved.x, saved.y, saved.z));
+    }
 
-                    auto checkerIt = checkVector.begin();
-                    bool tileNotVisited = true;
-                    while(checkerIt != checkVector.end()){
-                        if((*checkerIt).first == (*neighIt)){
-                            tileNotVisited = false;
-                            break;
-                        }
-                        checkerIt++;
-                    }
-                    if(tileNotVisited){
-                        std::pair<Common::CubeCoordinate,int> tileToCheck = std::make_pair((*neighIt),currentIndex);
-                        checkVector.push_back(tileToCheck);
-                        workVector.push_back((*neighIt));
-                    }
-                }
+    // Players and turn
+    for (const Common::SavedPlayer& saved : save.players()) {
+        if (!hasPlayer(saved.id)) {
+            throw Common::FormatException("Save file has an unknown player " +
+                                          std::to_string(saved.id));
+        }
+        setActionsLeft(saved.id, saved.actionsLeft);
+        if (playerTable_ != nullptr) {
+            Common::PlayerRecord& record = playerTable_->at(saved.id);
+            record.pawns = saved.pawns;
+            record.points = saved.points;
+        }
+    }
+    gameState_->changePlayerTurn(header.currentPlayer);
+    gameState_->changeGamePhase(
+                static_cast<Common::GamePhase>(header.gamePhase));
+
+    // Rules and random numbers
+    islandRadius_ = header.islandRadius;
+    for (const Common::SavedPieceCount& saved : save.pieceCounts()) {
+        islandPieces_.push_back({stringAt(saved.type), saved.count});
+    }
+    for (const Common::SavedSpinnerChance& saved : save.spinner()) {
+        const std::string& section = stringAt(saved.section);
+        if (spinnerSections_.empty() ||
+                spinnerSections_.back().first != section) {
+            spinnerSections_.push_back({section, {}});
+        }
+        spinnerSections_.back().second.push_back(
+                    {stringAt(saved.moves), saved.chance});
+    }
+    rng_.restore(header.seed, header.draws);
+}
+
+void GameEngine::recordTurn()
+{
+    // a game state that publishes its changes has announced the turn already
+    if (currentPlayer() != announcedPlayer_) {
+        events_->publish(Common::GameEventType::PLAYER_CHANGED,
+                         currentPlayer());
+    }
+}
 
+void GameEngine::subscribe()
+{
+    std::shared_ptr<Common::GameJournal> journal = journal_;
+    subscriptions_.push_back(events_->subscribe(
+                                 [journal](const Common::GameEvent& event) {
+        journal->record(event);
+    }));
+    subscriptions_.push_back(events_->subscribe(
+                                 [this](const Common::GameEvent& event) {
+        switch (event.type) {
+        case Common::GameEventType::PLAYER_CHANGED:
+            announcedPlayer_ = event.id;
+            break;
+        case Common::GameEventType::WHEEL_SPUN:
+        case Common::GameEventType::PHASE_CHANGED:
+        case Common::GameEventType::GAME_WON:
+        case Common::GameEventType::ACTOR_MOVED:
+        case Common::GameEventType::ACTOR_REMOVED:
+            break;
+        default:
+            // hexes or pawns changed, and the routes with them
+            router_.invalidate();
+            updatePawns(event.origin);
+            if (!(event.target == event.origin)) {
+                updatePawns(event.target);
             }
         }
-        currentIndex++;
+    }));
+}
+
+void GameEngine::indexPlayers()
+{
+    std::shared_ptr<Common::PlayerTable> table = nullptr;
+    bool sharedTable = !playerVector_.empty();
+
+    for (auto player : playerVector_) {
+        int id = player->getPlayerId();
+        if (id < 0) {
+            sharedTable = false;
+            continue;
+        }
+        if (playersById_.size() <= static_cast<std::size_t>(id)) {
+            playersById_.resize(id + 1);
+        }
+        playersById_[id] = player;
+
+        // Players of one PlayerTable are read straight from the table
+        Common::TablePlayer* tablePlayer =
+                dynamic_cast<Common::TablePlayer*>(player.get());
+        if (tablePlayer == nullptr ||
+                (table != nullptr && tablePlayer->getTable() != table)) {
+            sharedTable = false;
+        } else {
+            table = tablePlayer->getTable();
+        }
+    }
+
+    if (sharedTable) {
+        playerTable_ = table;
     }
+}
+
+bool GameEngine::hasPlayer(int playerId) const
+{
+    return playerId >= 0 &&
+            static_cast<std::size_t>(playerId) < playersById_.size() &&
+            playersById_[playerId] != nullptr;
+}
+
+unsigned int GameEngine::actionsLeft(int playerId) const
+{
+    if (playerTable_ != nullptr) {
+        return playerTable_->find(playerId)->actionsLeft;
+    }
+    return playersById_[playerId]->getActionsLeft();
+}
+
+void GameEngine::setActionsLeft(int playerId, unsigned int actionsLeft)
+{
+    if (playerTable_ != nullptr) {
+        playerTable_->find(playerId)->actionsLeft = actionsLeft;
+    } else {
+        playersById_[playerId]->setActionsLeft(actionsLeft);
+    }
+}
+
+bool GameEngine::breadthFirst(Common::CubeCoordinate FromCoord, Common::CubeCoordinate ToCoord, unsigned int actionsLeft)
+{
+    TRACE_SCOPE("GameEngine::breadthFirst");
+
+    int limit = static_cast<int>(std::min<unsigned int>(
+                                     actionsLeft,
+                                     std::numeric_limits<int>::max()));
+    readPawns();
+    return bitboard_.canWalk(FromCoord, ToCoord, limit);
+}
 
-    return false;
+void GameEngine::updatePawns(Common::CubeCoordinate coord)
+{
+    // Counted again from the hex, so that moves of whole transports and
+    // events seen twice need no special care
+    bitboard_.clearPawns(coord);
+    std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+    if (hex == nullptr || hex->getPawnAmount() == 0) {
+        return;
+    }
+    for (const auto& pawn : hex->getPawns()) {
+        bitboard_.addPawn(coord, pawn->getPlayerId());
+    }
+}
 
+void GameEngine::readPawns() const
+{
+    // A board that publishes its changes keeps the bitboard up to date
+    // through the events, any other is counted again as a whole
+    if (boardPublishes_) {
+        return;
+    }
+    bitboard_.clearPawns(bitboard_.hexes());
+    for (const Common::CubeCoordinate& coord : hexCoordinates_) {
+        std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+        if (hex == nullptr || hex->getPawnAmount() == 0) {
+            continue;
+        }
+        for (const auto& pawn : hex->getPawns()) {
+            bitboard_.addPawn(coord, pawn->getPlayerId());
+        }
+    }
 }
 
 std::vector<Common::CubeCoordinate> GameEngine::addHexToBoard(
@@ -558,6 +1254,7 @@ std::vector<Common::CubeCoordinate> GameEngine::addHexToBoard(
     if (prevHex != nullptr) {
         // There's already a hex in this position, for whatever reason.
         // It is going to be replaced.
+        removeFlippable(coord);
 
         std::string prevType = prevHex->getPieceType();
         if (islandPiecesField != islandPieces_.end())
@@ -567,18 +1264,21 @@ std::vector<Common::CubeCoordinate> GameEngine::addHexToBoard(
         }
 
     } else if (islandPiecesField != islandPieces_.end()) {
+        hexCoordinates_.push_back(coord);
         islandPiecesField->second += 1;
     } else if (pieceType != "Water" && pieceType != "Coral") {
+        hexCoordinates_.push_back(coord);
         // Water and Coral can't be sunk, so don't push them here.
         // New pieceType, push front for sinking-order
         islandPieces_.push_back({pieceType, 1});
 
     } else {
+        hexCoordinates_.push_back(coord);
         // Do nothing to track the amount of Water and Coral
     }
 
     // Add the hex
-    std::shared_ptr<Common::Hex> newHex = std::make_shared<Common::Hex>();
+    std::shared_ptr<Common::Hex> newHex = Common::makePooled<Common::Hex>(arena_);
     newHex->setCoordinates(coord);
     newHex->setPieceType(pieceType);
 
@@ -594,12 +1294,71 @@ std::vector<Common::CubeCoordinate> GameEngine::addHexToBoard(
     }
 
     board_->addHex(newHex);
+    land_.addHex(coord, pieceType != "Water");
+    bitboard_.addHex(coord, pieceType);
+    setBatchHex(coord, pieceType == "Water");
+    events_->publish(Common::GameEventType::HEX_ADDED, 0, 0, coord, coord,
+                     pieceType);
+    if (pieceType != "Water" && pieceType != "Coral") {
+        addFlippable(coord, pieceType);
+    }
 
     return neighbourVector;
 }
 
+std::vector<Common::CubeCoordinate> GameEngine::getFlippableTiles() const
+{
+    if (islandPieces_.empty()) {
+        return {};
+    }
+    auto bucket = flippableHexes_.find(islandPieces_.back().first);
+    if (bucket == flippableHexes_.end()) {
+        return {};
+    }
+    return bucket->second;
+}
+
+void GameEngine::addFlippable(Common::CubeCoordinate coord,
+                              const std::string& type)
+{
+    std::vector<Common::CubeCoordinate>& bucket = flippableHexes_[type];
+    flippableSlots_[coord] = {type, bucket.size()};
+    bucket.push_back(coord);
+}
+
+void GameEngine::removeFlippable(Common::CubeCoordinate coord)
+{
+    auto slot = flippableSlots_.find(coord);
+    if (slot == flippableSlots_.end()) {
+        return;
+    }
+
+    // Move the last hex of the bucket into the freed position
+    std::vector<Common::CubeCoordinate>& bucket =
+            flippableHexes_.at(slot->second.first);
+    std::size_t index = slot->second.second;
+    if (index + 1 != bucket.size()) {
+        bucket[index] = bucket.back();
+        flippableSlots_.at(bucket[index]).second = index;
+    }
+    bucket.pop_back();
+    flippableSlots_.erase(slot);
+}
+
+void GameEngine::setBatchHex(Common::CubeCoordinate coord, bool isWater)
+{
+    auto slot = batchSlots_.find(coord);
+    if (slot != batchSlots_.end()) {
+        hexBatch_.water[slot->second] = isWater ? -1 : 0;
+        return;
+    }
+    batchSlots_.emplace(coord, hexBatch_.size());
+    hexBatch_.add(coord, isWater);
+}
+
 void GameEngine::initializeBoard()
 {
+    TRACE_SCOPE("GameEngine::initializeBoard");
     /* Method initializes the game board -hexes
      * Pieces to fill the board with are defined in Assets/pieces.json
     */
@@ -607,9 +1366,8 @@ void GameEngine::initializeBoard()
     // Size (radius) of the goal areas on the edge of the board
     int goalSize = 2;
 
-    // Get pieces from piecefactory
-    Logic::PieceFactory pieceFactory = Logic::PieceFactory::getInstance();
-    pieceFactory.readJSON();
+    // Get pieces from piecefactory, the constructor has read them
+    Logic::PieceFactory& pieceFactory = Logic::PieceFactory::getInstance();
     typedef std::vector<std::pair<std::string,int>> pieceVector;
     pieceVector pieces =
             pieceFactory.getGamePieces();
@@ -681,6 +1439,7 @@ void GameEngine::initializeBoats()
      * Expects transportfactory to already know how to build boats.
      */
     auto& factory = Logic::TransportFactory::getInstance();
+    Common::ArenaScope arenaScope(arena_);
     int players = playerAmount();
 
     // Throw if transportfactory doesn't know boats.
@@ -747,8 +1506,12 @@ void GameEngine::initializeBoats()
         if (hexToAdd != nullptr) {
             if (hexToAdd->getPieceType() == "Water") {
                 std::shared_ptr<Common::Transport> newBoat =
-                                factory.createTransport("boat");
+                                factory.createTransport("boat",
+                                                        ++transportIds_);
                 board_->addTransport(newBoat, coordToAdd);
+                events_->publish(Common::GameEventType::TRANSPORT_ADDED,
+                                 newBoat->getId(), 0, coordToAdd, coordToAdd,
+                                 "boat");
             }
         }
 
@@ -758,8 +1521,7 @@ void GameEngine::initializeBoats()
 unsigned int GameEngine::cubeCoordinateDistance(Common::CubeCoordinate source, Common::CubeCoordinate target) const
 {
 
-    return ((abs(source.x - target.x) + abs(source.y - target.y)
-             + abs(source.z - target.z)) / 2);
+    return Common::hexDistance(source, target);
 
 }
 
@@ -1,13 +1,24 @@
 #ifndef GAMEENGINE_HH
 #define GAMEENGINE_HH
 
+#include "arena.hh"
+#include "countingrandom.hh"
 #include "cubecoordinate.hh"
+#include "gameevent.hh"
+#include "gamejournal.hh"
+#include "hexbitboard.hh"
+#include "hexdistance.hh"
 #include "igameboard.hh"
 #include "igamerunner.hh"
 #include "igamestate.hh"
 #include "iplayer.hh"
-#include "wheellayoutparser.hh"
+#include "landcomponents.hh"
+#include "pawnrouter.hh"
+#include "playertable.hh"
+#include "savefile.hh"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +52,39 @@ class GameEngine : public Common::IGameRunner
                std::shared_ptr<Common::IGameState> statePtr,
                std::vector<std::shared_ptr<Common::IPlayer>> players);
 
+    /**
+     * @brief Constructor for a reproducible game.
+     * @param boardPtr Shared pointer to the game board.
+     * @param statePtr Shared pointer to the game state.
+     * @param playerVector Vector that contains players.
+     * @param seed Seed of the random number generator. Games with the same
+     * seed, players and moves have the same flips and spins, as long as the
+     * program is built with the same standard library.
+     */
+    GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
+               std::shared_ptr<Common::IGameState> statePtr,
+               std::vector<std::shared_ptr<Common::IPlayer>> players,
+               std::uint32_t seed);
+
+    /**
+     * @brief Constructor for a saved game.
+     * @param boardPtr Shared pointer to an empty game board.
+     * @param statePtr Shared pointer to the game state.
+     * @param playerVector Vector that contains the players of the save.
+     * @param save The saved game.
+     * @exception FormatException The players do not match the save or the
+     * save refers to unknown types.
+     */
+    GameEngine(std::shared_ptr<Common::IGameBoard> boardPtr,
+               std::shared_ptr<Common::IGameState> statePtr,
+               std::vector<std::shared_ptr<Common::IPlayer>> players,
+               const Common::SaveFile& save);
+
+    /**
+     * @brief Destructor, unsubscribes the engine from its events.
+     */
+    virtual ~GameEngine();
+
     /**
      * @copydoc Common::IGameRunner::movePawn()
      */
@@ -54,6 +98,38 @@ class GameEngine : public Common::IGameRunner
     virtual int checkPawnMovement(Common::CubeCoordinate origin,
                                   Common::CubeCoordinate target,
                                   int pawnId);
+
+    /**
+     * @copydoc Common::IGameRunner::findPawnRoute()
+     */
+    virtual std::vector<Common::CubeCoordinate> findPawnRoute(
+            Common::CubeCoordinate origin, Common::CubeCoordinate target);
+
+    /**
+     * @copydoc Common::IGameRunner::checkPawnMovements()
+     */
+    virtual void checkPawnMovements(const Common::PawnMoveQuery* queries,
+                                    std::size_t count,
+                                    int* movesLeft);
+
+    /**
+     * @copydoc Common::IGameRunner::findReachableHexes()
+     */
+    virtual std::vector<Common::PawnReach> findReachableHexes(
+            int playerId, unsigned int maxActions) const;
+
+    /**
+     * @copydoc Common::IGameRunner::findPawnMoves()
+     */
+    virtual std::vector<Common::CubeCoordinate> findPawnMoves(
+            Common::CubeCoordinate origin, int pawnId) const;
+
+    /**
+     * @copydoc Common::IGameRunner::isConnectedOverLand()
+     */
+    virtual bool isConnectedOverLand(Common::CubeCoordinate first,
+                                     Common::CubeCoordinate second) const;
+
     /**
      * @copydoc Common::IGameRunner::moveActor()
      */
@@ -95,11 +171,28 @@ class GameEngine : public Common::IGameRunner
                                     Common::CubeCoordinate target,
                                     int transportId,
                                     std::string moves);
+
+    /**
+     * @copydoc Common::IGameRunner::findActorMoves()
+     */
+    virtual std::vector<Common::CubeCoordinate> findActorMoves(
+            Common::CubeCoordinate origin, int actorId, std::string moves);
+
+    /**
+     * @copydoc Common::IGameRunner::findTransportMoves()
+     */
+    virtual std::vector<Common::CubeCoordinate> findTransportMoves(
+            Common::CubeCoordinate origin, int transportId, std::string moves);
     /**
      * @copydoc Common::IGameRunner::flipTile()
      */
     virtual std::string flipTile(Common::CubeCoordinate tileCoord);
 
+    /**
+     * @copydoc Common::IGameRunner::getFlippableTiles()
+     */
+    virtual std::vector<Common::CubeCoordinate> getFlippableTiles() const;
+
     /**
      * @copydoc Common::IGameRunner::spinWheel()
      */
@@ -130,8 +223,38 @@ class GameEngine : public Common::IGameRunner
      */
     virtual int playerAmount() const;
 
+    /**
+     * @copydoc Common::IGameRunner::getJournal()
+     */
+    virtual std::shared_ptr<Common::GameJournal> getJournal() const;
+
+    /**
+     * @copydoc Common::IGameRunner::getEvents()
+     */
+    virtual std::shared_ptr<Common::GameEventPublisher> getEvents() const;
+
+    /**
+     * @copydoc Common::IGameRunner::saveGame()
+     */
+    virtual void saveGame(const std::string& filePath) const;
+
   private:
 
+    int checkTransportMovement(Common::CubeCoordinate origin,
+                               Common::CubeCoordinate target,
+                               int transportId,
+                               bool dive,
+                               unsigned int numMoves);
+
+    void indexPlayers();
+    void recordTurn();
+    void subscribe();
+    bool hasPlayer(int playerId) const;
+    unsigned int actionsLeft(int playerId) const;
+    void setActionsLeft(int playerId, unsigned int actionsLeft);
+    void updatePawns(Common::CubeCoordinate coord);
+    void readPawns() const;
+
     bool breadthFirst(Common::CubeCoordinate FromCoord, Common::CubeCoordinate ToCoord, unsigned int actionsLeft);
 
     unsigned int cubeCoordinateDistance(Common::CubeCoordinate source, Common::CubeCoordinate target) const;
@@ -140,20 +263,89 @@ class GameEngine : public Common::IGameRunner
                                                       std::string pieceType);
     void initializeBoard();
     void initializeBoats();
+    void readSpinnerLayout();
+    void loadGame(const Common::SaveFile& save);
+
+    void addFlippable(Common::CubeCoordinate coord, const std::string& type);
+    void removeFlippable(Common::CubeCoordinate coord);
+    void setBatchHex(Common::CubeCoordinate coord, bool isWater);
+    std::vector<Common::CubeCoordinate> waterInRange(
+            Common::CubeCoordinate origin, int range) const;
 
     std::vector<std::shared_ptr<Common::IPlayer>> playerVector_;
+
+    //! Players indexed by player id, nullptr for unused ids.
+    std::vector<std::shared_ptr<Common::IPlayer>> playersById_;
+
+    //! Table shared by the players, nullptr if they are not TablePlayers
+    //! of a single table. The actions are then read through IPlayer.
+    std::shared_ptr<Common::PlayerTable> playerTable_;
     std::shared_ptr<Common::IGameBoard> board_;
     std::shared_ptr<Common::IGameState> gameState_;
 
-    //! Actortypes.
+    //! Search of the latest pawn route, dropped when the board changes.
+    Common::PawnRouter router_;
+
+    //! Regions of land, updated as hexes are added and sunk.
+    Common::LandComponents land_;
 
-    WheelLayoutParser layoutParser_;
+    //! Terrain and pawns as bit masks, updated with the board. The pawns of
+    //! a board that does not publish its changes are read again by the
+    //! queries, const ones too.
+    mutable Common::HexBitboard bitboard_;
+
+    //! Sections of the spinner and the moves of each, in wheel order.
+    std::vector<std::pair<std::string,
+                          std::vector<std::pair<std::string, unsigned>>>>
+        spinnerSections_;
+
+    //! Coordinates of the hexes added to the board, in the order added.
+    std::vector<Common::CubeCoordinate> hexCoordinates_;
+
+    //! The hexes of the board as the distance kernels read them, and the
+    //! position of each hex in it.
+    Common::HexBatch hexBatch_;
+    std::map<Common::CubeCoordinate, std::size_t> batchSlots_;
 
     //! Piecetypes.
     std::vector<std::pair<std::string,int>> islandPieces_;
 
+    //! Hexes that can still be flipped, one bucket per piece type. The
+    //! sinking order of the buckets is the order of islandPieces_.
+    std::map<std::string, std::vector<Common::CubeCoordinate>> flippableHexes_;
+
+    //! Bucket and position in it of every flippable hex.
+    std::map<Common::CubeCoordinate, std::pair<std::string, std::size_t>>
+        flippableSlots_;
+
     // Radius of the island, needed to spawn boats
     int islandRadius_;
+
+    //! Ids of the latest actor and transport of this game. Games running
+    //! side by side, e.g. in the game server, number their pieces apart.
+    int actorIds_;
+    int transportIds_;
+
+    //! Storage for the hexes, actors and transports of this game.
+    std::shared_ptr<Common::Arena> arena_;
+
+    //! Random numbers for flips and spins.
+    Common::CountingRandom rng_;
+
+    //! Record of everything that happened in the game.
+    std::shared_ptr<Common::GameJournal> journal_;
+
+    //! Changes of the game, the journal is one of the listeners.
+    std::shared_ptr<Common::GameEventPublisher> events_;
+
+    //! Whether the board publishes the pawns added and removed to events_.
+    bool boardPublishes_;
+
+    //! Player of the latest PLAYER_CHANGED event.
+    int announcedPlayer_;
+
+    //! Subscriptions of the engine to events_.
+    std::vector<int> subscriptions_;
 };
 
 }
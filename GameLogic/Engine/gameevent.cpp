@@ -0,0 +1,84 @@
+#include "gameevent.hh"
+
+#include <algorithm>
+
+namespace Common {
+
+GameEventPublisher::GameEventPublisher():
+    listeners_(),
+    nextSubscription_(1),
+    depth_(0),
+    removed_(false)
+{
+}
+
+int GameEventPublisher::subscribe(Listener listener)
+{
+    listeners_.push_back({nextSubscription_, std::move(listener)});
+    return nextSubscription_++;
+}
+
+void GameEventPublisher::unsubscribe(int subscription)
+{
+    for (auto& listener : listeners_) {
+        if (listener.first == subscription) {
+            // erased after the delivery in progress, it may be iterating
+            listener.second = nullptr;
+            removed_ = true;
+        }
+    }
+    if (depth_ == 0) {
+        compact();
+    }
+}
+
+void GameEventPublisher::publish(const GameEvent& event)
+{
+    // listeners subscribed during the delivery wait for the next event
+    std::size_t count = listeners_.size();
+    ++depth_;
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (listeners_[i].second) {
+                // copied, the listener may unsubscribe itself
+                Listener listener = listeners_[i].second;
+                listener(event);
+            }
+        }
+    } catch (...) {
+        --depth_;
+        throw;
+    }
+    if (--depth_ == 0) {
+        compact();
+    }
+}
+
+void GameEventPublisher::publish(GameEventType type, int id, int other,
+                                 CubeCoordinate origin, CubeCoordinate target,
+                                 std::string name, std::string detail)
+{
+    publish(GameEvent{type, id, other, origin, target, std::move(name),
+                      std::move(detail)});
+}
+
+void GameEventPublisher::publish(GameEventType type, int id, int other)
+{
+    CubeCoordinate none(0, 0, 0);
+    publish(GameEvent{type, id, other, none, none, "", ""});
+}
+
+void GameEventPublisher::compact()
+{
+    if (!removed_) {
+        return;
+    }
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [](const auto& listener) {
+                                        return !listener.second;
+                                    }),
+                     listeners_.end());
+    removed_ = false;
+}
+
+}
@@ -0,0 +1,146 @@
+#ifndef GAMEEVENT_HH
+#define GAMEEVENT_HH
+
+#include "cubecoordinate.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file
+ * @brief Fine-grained changes of a game and the publisher that delivers
+ * them to the user interface, the journal and other listeners.
+ */
+
+namespace Common {
+
+/**
+ * @brief Kinds of changes in a game. The fields a kind uses are listed with
+ * it, see GameEvent.
+ */
+enum class GameEventType : std::uint8_t {
+    //! A hex was added to the board: target, name (piece type).
+    HEX_ADDED,
+    //! A hex was flipped and turned to water: target, name (old piece type).
+    HEX_SUNK,
+    //! A pawn was placed: id, other (player id), target.
+    PAWN_ADDED,
+    //! A pawn moved: id, origin, target.
+    PAWN_MOVED,
+    //! A pawn was removed: id, target (its location).
+    PAWN_REMOVED,
+    //! A pawn boarded a transport: id, other (transport id), target.
+    PAWN_BOARDED,
+    //! An actor came out of a sunk hex: id, name (actor type), target.
+    ACTOR_SPAWNED,
+    //! An actor moved: id, origin, target.
+    ACTOR_MOVED,
+    //! An actor was removed: id, target (its location).
+    ACTOR_REMOVED,
+    //! A transport was placed when the board was set up: id, name, target.
+    TRANSPORT_ADDED,
+    //! A transport came out of a sunk hex: id, name (type), target.
+    TRANSPORT_SPAWNED,
+    //! A transport moved with its pawns: id, origin, target.
+    TRANSPORT_MOVED,
+    //! A transport dropped its pawns (dive): id, target (its location).
+    TRANSPORT_UNLOADED,
+    //! A transport was removed and its pawns left in the water: id, target.
+    TRANSPORT_REMOVED,
+    //! The wheel was spun: name (animal), detail (moves).
+    WHEEL_SPUN,
+    //! Another player got the turn: id (player id).
+    PLAYER_CHANGED,
+    //! The game moved to another phase: other (GamePhase).
+    PHASE_CHANGED,
+    //! The game has a winner: id (player id).
+    GAME_WON
+};
+
+/**
+ * @brief One change of a game. Which fields are used depends on the type,
+ * the others are zero or empty.
+ */
+struct GameEvent {
+    GameEventType type;
+    int id;
+    int other;
+    //! Where a moved piece came from, the same as target for other changes.
+    CubeCoordinate origin;
+    CubeCoordinate target;
+    std::string name;
+    std::string detail;
+};
+
+/**
+ * @brief GameEventPublisher delivers game events to the listeners
+ * subscribed to it.
+ * @details Events are delivered synchronously, in the order of
+ * subscription, while the change that caused them is being made. A listener
+ * may publish further events, subscribe or unsubscribe; listeners added
+ * during a delivery only get the events published after it.
+ */
+class GameEventPublisher {
+
+public:
+
+    using Listener = std::function<void(const GameEvent&)>;
+
+    GameEventPublisher();
+
+    /**
+     * @brief subscribe adds a listener.
+     * @param listener Called for every event published from now on.
+     * @return Identifier of the subscription, for unsubscribe().
+     * @post Exception quarantee: strong
+     */
+    int subscribe(Listener listener);
+
+    /**
+     * @brief unsubscribe removes a listener. Unknown identifiers are ignored.
+     * @param subscription Identifier returned by subscribe().
+     * @post Exception quarantee: nothrow
+     */
+    void unsubscribe(int subscription);
+
+    /**
+     * @brief publish delivers an event to all listeners.
+     * @param event The event.
+     * @post Exception quarantee: as strong as the listeners give
+     */
+    void publish(const GameEvent& event);
+
+    /**
+     * @brief publish builds an event and delivers it to all listeners.
+     * @post Exception quarantee: as strong as the listeners give
+     */
+    void publish(GameEventType type, int id, int other,
+                 CubeCoordinate origin, CubeCoordinate target,
+                 std::string name = "", std::string detail = "");
+
+    /**
+     * @brief publish delivers an event that has no location, like a turn
+     * or phase change. The coordinates of the event are (0, 0, 0).
+     * @post Exception quarantee: as strong as the listeners give
+     */
+    void publish(GameEventType type, int id, int other = 0);
+
+private:
+
+    void compact();
+
+    std::vector<std::pair<int, Listener>> listeners_;
+    int nextSubscription_;
+    //! Deliveries in progress, events may be published from listeners.
+    int depth_;
+    //! Some listeners are unsubscribed but not yet erased.
+    bool removed_;
+};
+
+}
+
+#endif // GAMEEVENT_HH
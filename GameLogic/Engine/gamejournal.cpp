@@ -0,0 +1,443 @@
+#include "gamejournal.hh"
+#include "formatexception.hh"
+#include "ioexception.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace Common {
+
+namespace {
+
+const std::uint8_t MAGIC[3] = {'I', 'G', 'J'};
+
+std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^
+            static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^
+            -static_cast<std::int64_t>(value & 1);
+}
+
+}
+
+const std::uint8_t GameJournal::FORMAT_VERSION;
+
+GameJournal::GameJournal(std::uint32_t seed):
+    data_(),
+    eventCount_(0),
+    seed_(seed),
+    cursor_(0, 0, 0),
+    strings_(),
+    playerInTurn_(-1)
+{
+    data_.reserve(4096);
+    data_.insert(data_.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    data_.push_back(FORMAT_VERSION);
+    writeVarint(seed);
+}
+
+std::uint32_t GameJournal::seed() const
+{
+    return seed_;
+}
+
+const std::vector<std::uint8_t>& GameJournal::data() const
+{
+    return data_;
+}
+
+std::size_t GameJournal::eventCount() const
+{
+    return eventCount_;
+}
+
+void GameJournal::writeFile(const std::string& filePath) const
+{
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data_.data()),
+              static_cast<std::streamsize>(data_.size()));
+    if (!out) {
+        throw IoException("Could not write journal " + filePath);
+    }
+}
+
+void GameJournal::recordHexAdded(CubeCoordinate coord,
+                                 const std::string& pieceType)
+{
+    beginEvent(JournalEventType::HEX_ADD);
+    writeCoordinate(coord);
+    writeString(pieceType);
+}
+
+void GameJournal::recordPawnAdded(int pawnId, int playerId,
+                                  CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::PAWN_ADD);
+    writeSigned(pawnId);
+    writeSigned(playerId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordPawnMoved(int pawnId, CubeCoordinate origin,
+                                  CubeCoordinate target)
+{
+    beginEvent(JournalEventType::PAWN_MOVE);
+    writeSigned(pawnId);
+    writeCoordinate(origin);
+    writeCoordinate(target);
+}
+
+void GameJournal::recordPawnRemoved(int pawnId, CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::PAWN_REMOVE);
+    writeSigned(pawnId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordPawnBoarded(int pawnId, int transportId,
+                                    CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::PAWN_BOARD);
+    writeSigned(pawnId);
+    writeSigned(transportId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordActorMoved(int actorId, CubeCoordinate origin,
+                                   CubeCoordinate target)
+{
+    beginEvent(JournalEventType::ACTOR_MOVE);
+    writeSigned(actorId);
+    writeCoordinate(origin);
+    writeCoordinate(target);
+}
+
+void GameJournal::recordActorRemoved(int actorId, CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::ACTOR_REMOVE);
+    writeSigned(actorId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordTransportAdded(int transportId,
+                                       const std::string& type,
+                                       CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::TRANSPORT_ADD);
+    writeSigned(transportId);
+    writeString(type);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordTransportMoved(int transportId, CubeCoordinate origin,
+                                       CubeCoordinate target)
+{
+    beginEvent(JournalEventType::TRANSPORT_MOVE);
+    writeSigned(transportId);
+    writeCoordinate(origin);
+    writeCoordinate(target);
+}
+
+void GameJournal::recordTransportRemoved(int transportId,
+                                         CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::TRANSPORT_REMOVE);
+    writeSigned(transportId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordTransportUnloaded(int transportId,
+                                          CubeCoordinate coord)
+{
+    beginEvent(JournalEventType::TRANSPORT_UNLOAD);
+    writeSigned(transportId);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordFlip(CubeCoordinate coord,
+                             const std::string& spawnedType, int spawnedId,
+                             bool spawnedTransport)
+{
+    beginEvent(spawnedTransport ? JournalEventType::FLIP_TRANSPORT
+                                : JournalEventType::FLIP_ACTOR);
+    writeSigned(spawnedId);
+    writeString(spawnedType);
+    writeCoordinate(coord);
+}
+
+void GameJournal::recordSpin(const std::string& animal,
+                             const std::string& moves)
+{
+    beginEvent(JournalEventType::SPIN);
+    writeString(animal);
+    writeString(moves);
+}
+
+void GameJournal::recordPlayerInTurn(int playerId)
+{
+    if (playerId == playerInTurn_) {
+        return;
+    }
+    beginEvent(JournalEventType::TURN_CHANGE);
+    writeSigned(playerId);
+    playerInTurn_ = playerId;
+}
+
+void GameJournal::record(const GameEvent& event)
+{
+    switch (event.type) {
+    case GameEventType::HEX_ADDED:
+        recordHexAdded(event.target, event.name);
+        break;
+    case GameEventType::PAWN_ADDED:
+        recordPawnAdded(event.id, event.other, event.target);
+        break;
+    case GameEventType::PAWN_MOVED:
+        recordPawnMoved(event.id, event.origin, event.target);
+        break;
+    case GameEventType::PAWN_REMOVED:
+        recordPawnRemoved(event.id, event.target);
+        break;
+    case GameEventType::PAWN_BOARDED:
+        recordPawnBoarded(event.id, event.other, event.target);
+        break;
+    case GameEventType::ACTOR_SPAWNED:
+        recordFlip(event.target, event.name, event.id, false);
+        break;
+    case GameEventType::ACTOR_MOVED:
+        recordActorMoved(event.id, event.origin, event.target);
+        break;
+    case GameEventType::ACTOR_REMOVED:
+        recordActorRemoved(event.id, event.target);
+        break;
+    case GameEventType::TRANSPORT_ADDED:
+        recordTransportAdded(event.id, event.name, event.target);
+        break;
+    case GameEventType::TRANSPORT_SPAWNED:
+        recordFlip(event.target, event.name, event.id, true);
+        break;
+    case GameEventType::TRANSPORT_MOVED:
+        recordTransportMoved(event.id, event.origin, event.target);
+        break;
+    case GameEventType::TRANSPORT_UNLOADED:
+        recordTransportUnloaded(event.id, event.target);
+        break;
+    case GameEventType::TRANSPORT_REMOVED:
+        recordTransportRemoved(event.id, event.target);
+        break;
+    case GameEventType::WHEEL_SPUN:
+        recordSpin(event.name, event.detail);
+        break;
+    case GameEventType::PLAYER_CHANGED:
+        recordPlayerInTurn(event.id);
+        break;
+    case GameEventType::HEX_SUNK:
+    case GameEventType::PHASE_CHANGED:
+    case GameEventType::GAME_WON:
+        break;
+    }
+}
+
+void GameJournal::beginEvent(JournalEventType type)
+{
+    data_.push_back(static_cast<std::uint8_t>(type));
+    ++eventCount_;
+}
+
+void GameJournal::writeVarint(std::uint64_t value)
+{
+    while (value >= 0x80) {
+        data_.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<std::uint8_t>(value));
+}
+
+void GameJournal::writeSigned(std::int64_t value)
+{
+    writeVarint(zigzag(value));
+}
+
+void GameJournal::writeCoordinate(CubeCoordinate coord)
+{
+    writeSigned(static_cast<std::int64_t>(coord.x) - cursor_.x);
+    writeSigned(static_cast<std::int64_t>(coord.z) - cursor_.z);
+    cursor_ = coord;
+}
+
+void GameJournal::writeString(const std::string& value)
+{
+    auto found = strings_.find(value);
+    if (found != strings_.end()) {
+        writeVarint(found->second);
+        return;
+    }
+
+    // An index one past the table introduces a new string
+    std::uint32_t index = static_cast<std::uint32_t>(strings_.size());
+    writeVarint(index);
+    writeVarint(value.size());
+    data_.insert(data_.end(), value.begin(), value.end());
+    strings_[value] = index;
+}
+
+JournalReader::JournalReader(const std::uint8_t* data, std::size_t size):
+    position_(data),
+    end_(data + size),
+    seed_(0),
+    cursor_(0, 0, 0),
+    strings_()
+{
+    if (size < sizeof(MAGIC) + 1 ||
+            !std::equal(MAGIC, MAGIC + sizeof(MAGIC), data)) {
+        throw FormatException("Not a game journal");
+    }
+    position_ += sizeof(MAGIC);
+    if (*position_++ != GameJournal::FORMAT_VERSION) {
+        throw FormatException("Unsupported game journal version");
+    }
+    seed_ = static_cast<std::uint32_t>(readVarint());
+}
+
+JournalReader::JournalReader(const std::vector<std::uint8_t>& data):
+    JournalReader(data.data(), data.size())
+{
+}
+
+std::uint32_t JournalReader::seed() const
+{
+    return seed_;
+}
+
+std::vector<std::uint8_t> JournalReader::readFile(const std::string& filePath)
+{
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in) {
+        throw IoException("Could not open journal " + filePath);
+    }
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(in)),
+                                   std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        throw IoException("Could not read journal " + filePath);
+    }
+    return data;
+}
+
+bool JournalReader::next(JournalEvent& event)
+{
+    if (position_ == end_) {
+        return false;
+    }
+
+    event.type = static_cast<JournalEventType>(*position_++);
+    event.id = 0;
+    event.other = 0;
+    event.name = nullptr;
+    event.detail = nullptr;
+
+    switch (event.type) {
+    case JournalEventType::HEX_ADD:
+        event.target = readCoordinate();
+        event.name = readString();
+        break;
+    case JournalEventType::PAWN_ADD:
+    case JournalEventType::PAWN_BOARD:
+        event.id = readInt();
+        event.other = readInt();
+        event.target = readCoordinate();
+        break;
+    case JournalEventType::PAWN_MOVE:
+    case JournalEventType::ACTOR_MOVE:
+    case JournalEventType::TRANSPORT_MOVE:
+        event.id = readInt();
+        event.origin = readCoordinate();
+        event.target = readCoordinate();
+        break;
+    case JournalEventType::PAWN_REMOVE:
+    case JournalEventType::ACTOR_REMOVE:
+    case JournalEventType::TRANSPORT_REMOVE:
+    case JournalEventType::TRANSPORT_UNLOAD:
+        event.id = readInt();
+        event.target = readCoordinate();
+        break;
+    case JournalEventType::TRANSPORT_ADD:
+    case JournalEventType::FLIP_ACTOR:
+    case JournalEventType::FLIP_TRANSPORT:
+        event.id = readInt();
+        event.name = readString();
+        event.target = readCoordinate();
+        break;
+    case JournalEventType::SPIN:
+        event.name = readString();
+        event.detail = readString();
+        break;
+    case JournalEventType::TURN_CHANGE:
+        event.other = readInt();
+        break;
+    default:
+        throw FormatException("Unknown event in game journal");
+    }
+    return true;
+}
+
+std::uint64_t JournalReader::readVarint()
+{
+    std::uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        if (position_ == end_) {
+            throw FormatException("Truncated game journal");
+        }
+        std::uint8_t byte = *position_++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw FormatException("Invalid varint in game journal");
+}
+
+std::int64_t JournalReader::readSigned()
+{
+    return unzigzag(readVarint());
+}
+
+int JournalReader::readInt()
+{
+    return static_cast<int>(readSigned());
+}
+
+CubeCoordinate JournalReader::readCoordinate()
+{
+    cursor_.x = static_cast<int>(cursor_.x + readSigned());
+    cursor_.z = static_cast<int>(cursor_.z + readSigned());
+    cursor_.y = -cursor_.x - cursor_.z;
+    return cursor_;
+}
+
+const std::string* JournalReader::readString()
+{
+    std::uint64_t index = readVarint();
+    if (index < strings_.size()) {
+        return &strings_[index];
+    }
+    if (index != strings_.size()) {
+        throw FormatException("Invalid string index in game journal");
+    }
+
+    std::uint64_t length = readVarint();
+    if (length > static_cast<std::uint64_t>(end_ - position_)) {
+        throw FormatException("Truncated game journal");
+    }
+    strings_.emplace_back(reinterpret_cast<const char*>(position_),
+                          static_cast<std::size_t>(length));
+    position_ += length;
+    return &strings_.back();
+}
+
+}
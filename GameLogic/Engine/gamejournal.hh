@@ -0,0 +1,237 @@
+#ifndef GAMEJOURNAL_HH
+#define GAMEJOURNAL_HH
+
+#include "cubecoordinate.hh"
+#include "gameevent.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @brief Append-only binary journal of a game and a reader for it.
+ */
+
+namespace Common {
+
+/**
+ * @brief Kinds of events in a GameJournal. The values are part of the file
+ * format and must not change.
+ */
+enum class JournalEventType : std::uint8_t {
+    //! A hex was added to the board: target, name (piece type).
+    HEX_ADD = 1,
+    //! A pawn was placed: id, other (player id), target.
+    PAWN_ADD = 2,
+    //! A pawn moved: id, origin, target.
+    PAWN_MOVE = 3,
+    //! A pawn was removed: id, target (its location).
+    PAWN_REMOVE = 4,
+    //! A pawn boarded a transport: id, other (transport id), target.
+    PAWN_BOARD = 5,
+    //! An actor moved: id, origin, target.
+    ACTOR_MOVE = 6,
+    //! An actor was removed: id, target (its location).
+    ACTOR_REMOVE = 7,
+    //! A transport was placed: id, name (transport type), target.
+    TRANSPORT_ADD = 8,
+    //! A transport moved: id, origin, target.
+    TRANSPORT_MOVE = 9,
+    //! A transport was removed: id, target (its location).
+    TRANSPORT_REMOVE = 10,
+    //! A transport dropped its pawns (dive): id, target (its location).
+    TRANSPORT_UNLOAD = 11,
+    //! A tile was flipped and an actor spawned: id, name (actor type), target.
+    FLIP_ACTOR = 12,
+    //! A tile was flipped and a transport spawned: id, name, target.
+    FLIP_TRANSPORT = 13,
+    //! The wheel was spun: name (animal), detail (moves).
+    SPIN = 14,
+    //! Another player got the turn: other (player id).
+    TURN_CHANGE = 15
+};
+
+/**
+ * @brief A decoded journal event. Which fields are used depends on the type,
+ * see JournalEventType.
+ */
+struct JournalEvent {
+    JournalEventType type;
+    int id;
+    int other;
+    CubeCoordinate origin;
+    CubeCoordinate target;
+    //! Points into the string table of the reader, nullptr if not used.
+    const std::string* name;
+    //! Points into the string table of the reader, nullptr if not used.
+    const std::string* detail;
+};
+
+/**
+ * @brief GameJournal records every change of a game into a compact binary
+ * buffer.
+ * @details The buffer starts with a header (magic "IGJ", format version and
+ * the seed of the game) followed by the events. An event is a type byte and
+ * its fields as LEB128 varints. Signed values are zigzag encoded and
+ * coordinates are stored as the difference to the previous coordinate of the
+ * journal (the origin of a move is relative to the previous event, the
+ * target relative to the origin), so an ordinary event takes 3-6 bytes.
+ * Strings are written once and later referred to by their index.
+ * Coordinates must be valid cube coordinates (x + y + z == 0), only x and z
+ * are stored.
+ */
+class GameJournal {
+
+public:
+
+    //! Version of the format written by this class.
+    static const std::uint8_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Constructor, writes the header.
+     * @param seed Seed of the random number generator of the game.
+     */
+    explicit GameJournal(std::uint32_t seed);
+
+    /**
+     * @brief seed returns the seed of the game.
+     */
+    std::uint32_t seed() const;
+
+    /**
+     * @brief data returns the encoded journal.
+     * @return Header and all events recorded so far.
+     */
+    const std::vector<std::uint8_t>& data() const;
+
+    /**
+     * @brief eventCount returns the number of events recorded.
+     */
+    std::size_t eventCount() const;
+
+    /**
+     * @brief writeFile writes the journal to a file.
+     * @param filePath Path of the file, an existing file is replaced.
+     * @exception IoException The file could not be written.
+     */
+    void writeFile(const std::string& filePath) const;
+
+    void recordHexAdded(CubeCoordinate coord, const std::string& pieceType);
+    void recordPawnAdded(int pawnId, int playerId, CubeCoordinate coord);
+    void recordPawnMoved(int pawnId, CubeCoordinate origin,
+                         CubeCoordinate target);
+    void recordPawnRemoved(int pawnId, CubeCoordinate coord);
+    void recordPawnBoarded(int pawnId, int transportId, CubeCoordinate coord);
+    void recordActorMoved(int actorId, CubeCoordinate origin,
+                          CubeCoordinate target);
+    void recordActorRemoved(int actorId, CubeCoordinate coord);
+    void recordTransportAdded(int transportId, const std::string& type,
+                              CubeCoordinate coord);
+    void recordTransportMoved(int transportId, CubeCoordinate origin,
+                              CubeCoordinate target);
+    void recordTransportRemoved(int transportId, CubeCoordinate coord);
+    void recordTransportUnloaded(int transportId, CubeCoordinate coord);
+    void recordFlip(CubeCoordinate coord, const std::string& spawnedType,
+                    int spawnedId, bool spawnedTransport);
+    void recordSpin(const std::string& animal, const std::string& moves);
+
+    /**
+     * @brief recordPlayerInTurn records a turn change if playerId is not the
+     * player of the previous turn change.
+     * @param playerId The player in turn.
+     */
+    void recordPlayerInTurn(int playerId);
+
+    /**
+     * @brief record records a game event. Spawns are recorded as flips;
+     * sunk hexes, phase changes and wins are implied by other events or not
+     * part of the journal and are ignored.
+     * @param event The event.
+     */
+    void record(const GameEvent& event);
+
+private:
+
+    void beginEvent(JournalEventType type);
+    void writeVarint(std::uint64_t value);
+    void writeSigned(std::int64_t value);
+    void writeCoordinate(CubeCoordinate coord);
+    void writeString(const std::string& value);
+
+    std::vector<std::uint8_t> data_;
+    std::size_t eventCount_;
+    std::uint32_t seed_;
+    CubeCoordinate cursor_;
+    std::map<std::string, std::uint32_t> strings_;
+    int playerInTurn_;
+};
+
+/**
+ * @brief JournalReader decodes the events of a journal one at a time.
+ * @details The reader does not copy the data, which has to outlive it.
+ */
+class JournalReader {
+
+public:
+
+    /**
+     * @brief Constructor, reads the header.
+     * @param data Start of the journal.
+     * @param size Size of the journal in bytes.
+     * @exception FormatException The header is invalid or of an unknown
+     * version.
+     */
+    JournalReader(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * @brief Constructor, reads the header.
+     * @param data The journal.
+     * @exception FormatException The header is invalid or of an unknown
+     * version.
+     */
+    explicit JournalReader(const std::vector<std::uint8_t>& data);
+
+    /**
+     * @brief seed returns the seed of the game.
+     */
+    std::uint32_t seed() const;
+
+    /**
+     * @brief next decodes the next event.
+     * @param event Receives the event.
+     * @return false, if the journal has no more events.
+     * @exception FormatException The journal is truncated or corrupt.
+     */
+    bool next(JournalEvent& event);
+
+    /**
+     * @brief readFile reads a journal written by GameJournal::writeFile.
+     * @param filePath Path of the file.
+     * @return The journal, to be given to a reader.
+     * @exception IoException The file could not be read.
+     */
+    static std::vector<std::uint8_t> readFile(const std::string& filePath);
+
+private:
+
+    std::uint64_t readVarint();
+    std::int64_t readSigned();
+    int readInt();
+    CubeCoordinate readCoordinate();
+    const std::string* readString();
+
+    const std::uint8_t* position_;
+    const std::uint8_t* end_;
+    std::uint32_t seed_;
+    CubeCoordinate cursor_;
+    //! Deque, so the pointers handed out in events stay valid.
+    std::deque<std::string> strings_;
+};
+
+}
+
+#endif // GAMEJOURNAL_HH
@@ -0,0 +1,442 @@
+#include "gamestatistics.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace Common {
+
+namespace {
+
+const char* const NO_ACTOR = "none";
+
+const char* const PHASE_NAMES[] = {"movement", "sinking", "spinning"};
+
+bool isNeighbour(CubeCoordinate a, CubeCoordinate b)
+{
+    int distance = std::max(std::abs(a.x - b.x),
+                            std::max(std::abs(a.y - b.y),
+                                     std::abs(a.z - b.z)));
+    return distance == 1;
+}
+
+std::size_t phaseIndex(GamePhase phase)
+{
+    return static_cast<std::size_t>(phase) - 1;
+}
+
+bool validPhase(int phase)
+{
+    return phase >= MOVEMENT && phase <= SPINNING;
+}
+
+template <typename Key, typename Value>
+void addCounts(std::map<Key, Value>& to, const std::map<Key, Value>& from)
+{
+    for (const auto& count : from) {
+        to[count.first] += count.second;
+    }
+}
+
+void writeStat(std::ostream& out, const RunningStat& stat)
+{
+    out << stat.count() << ',' << stat.mean() << ','
+        << std::sqrt(stat.variance()) << ',' << stat.min() << ','
+        << stat.max() << '\n';
+}
+
+}
+
+RunningStat::RunningStat():
+    count_(0),
+    mean_(0),
+    m2_(0),
+    min_(std::numeric_limits<double>::infinity()),
+    max_(-std::numeric_limits<double>::infinity())
+{
+}
+
+void RunningStat::add(double value)
+{
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (value - mean_);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void RunningStat::merge(const RunningStat& other)
+{
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    double count = static_cast<double>(count_ + other.count_);
+    double delta = other.mean_ - mean_;
+    mean_ += delta * static_cast<double>(other.count_) / count;
+    m2_ += other.m2_ + delta * delta * static_cast<double>(count_) *
+            static_cast<double>(other.count_) / count;
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+std::uint64_t RunningStat::count() const
+{
+    return count_;
+}
+
+double RunningStat::mean() const
+{
+    return mean_;
+}
+
+double RunningStat::variance() const
+{
+    if (count_ < 2) {
+        return 0;
+    }
+    return m2_ / static_cast<double>(count_ - 1);
+}
+
+double RunningStat::min() const
+{
+    return count_ == 0 ? 0 : min_;
+}
+
+double RunningStat::max() const
+{
+    return count_ == 0 ? 0 : max_;
+}
+
+GameStatistics::Recorder::Recorder(GameStatistics& statistics,
+                                   std::shared_ptr<GameEventPublisher> events):
+    statistics_(statistics),
+    events_(events),
+    subscription_(0),
+    finished_(false),
+    eventNumber_(0),
+    turns_(1),
+    seats_(0),
+    winner_(0),
+    phase_(MOVEMENT),
+    phaseStart_(std::chrono::steady_clock::now()),
+    phaseTimes_(),
+    actors_(),
+    transports_(),
+    pawnsLost_(),
+    transportUsage_(),
+    spins_()
+{
+    subscription_ = events_->subscribe([this](const GameEvent& event) {
+        onEvent(event);
+    });
+}
+
+GameStatistics::Recorder::~Recorder()
+{
+    if (!finished_) {
+        try {
+            finish();
+        } catch (...) {
+            // a game that can't be added is left out, finish has already
+            // unsubscribed
+        }
+    }
+}
+
+void GameStatistics::Recorder::finish()
+{
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    events_->unsubscribe(subscription_);
+    beginPhase(phase_);
+
+    GameStatistics& to = statistics_;
+    ++to.games_;
+    if (winner_ > 0) {
+        ++to.wonGames_;
+    }
+    to.gameLength_.add(turns_);
+    ++to.lengthHistogram_[std::min<std::size_t>(turns_ / LENGTH_BUCKET_TURNS,
+                                                LENGTH_BUCKETS - 1)];
+    if (to.seats_.size() < static_cast<std::size_t>(seats_)) {
+        to.seats_.resize(static_cast<std::size_t>(seats_));
+    }
+    for (int seat = 1; seat <= seats_; ++seat) {
+        Seat& counts = to.seats_[static_cast<std::size_t>(seat - 1)];
+        ++counts.games;
+        if (seat == winner_) {
+            ++counts.wins;
+        }
+    }
+    addCounts(to.pawnsLost_, pawnsLost_);
+    for (const auto& usage : transportUsage_) {
+        TransportUsage& counts = to.transportUsage_[usage.first];
+        counts.appeared += usage.second.appeared;
+        counts.moves += usage.second.moves;
+        counts.boarded += usage.second.boarded;
+        counts.removed += usage.second.removed;
+    }
+    addCounts(to.spins_, spins_);
+    for (std::size_t i = 0; i < phaseTimes_.size(); ++i) {
+        to.phaseTimes_[i].merge(phaseTimes_[i]);
+    }
+}
+
+void GameStatistics::Recorder::onEvent(const GameEvent& event)
+{
+    if (finished_) {
+        return;
+    }
+    ++eventNumber_;
+    switch (event.type) {
+    case GameEventType::PAWN_ADDED:
+        seats_ = std::max(seats_, event.other);
+        break;
+    case GameEventType::PAWN_REMOVED:
+        ++pawnsLost_[actorAt(event.target)];
+        break;
+    case GameEventType::PAWN_BOARDED: {
+        auto transport = transports_.find(event.other);
+        if (transport != transports_.end()) {
+            ++transportUsage_[transport->second].boarded;
+        }
+        break;
+    }
+    case GameEventType::ACTOR_SPAWNED:
+        actors_[event.id] = {event.name, event.target, eventNumber_};
+        break;
+    case GameEventType::ACTOR_MOVED: {
+        auto actor = actors_.find(event.id);
+        if (actor != actors_.end()) {
+            actor->second.location = event.target;
+            actor->second.active = eventNumber_;
+        }
+        break;
+    }
+    case GameEventType::ACTOR_REMOVED:
+        actors_.erase(event.id);
+        break;
+    case GameEventType::TRANSPORT_ADDED:
+    case GameEventType::TRANSPORT_SPAWNED:
+        transports_[event.id] = event.name;
+        ++transportUsage_[event.name].appeared;
+        break;
+    case GameEventType::TRANSPORT_MOVED: {
+        auto transport = transports_.find(event.id);
+        if (transport != transports_.end()) {
+            ++transportUsage_[transport->second].moves;
+        }
+        break;
+    }
+    case GameEventType::TRANSPORT_REMOVED: {
+        auto transport = transports_.find(event.id);
+        if (transport != transports_.end()) {
+            ++transportUsage_[transport->second].removed;
+            transports_.erase(transport);
+        }
+        break;
+    }
+    case GameEventType::WHEEL_SPUN:
+        ++spins_[{event.name, event.detail}];
+        break;
+    case GameEventType::PLAYER_CHANGED:
+        ++turns_;
+        break;
+    case GameEventType::PHASE_CHANGED:
+        if (validPhase(event.other)) {
+            beginPhase(static_cast<GamePhase>(event.other));
+        }
+        break;
+    case GameEventType::GAME_WON:
+        winner_ = event.id;
+        finish();
+        break;
+    default:
+        break;
+    }
+}
+
+void GameStatistics::Recorder::beginPhase(GamePhase phase)
+{
+    std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now();
+    std::chrono::duration<double> spent = now - phaseStart_;
+    phaseTimes_[phaseIndex(phase_)].add(spent.count());
+    phase_ = phase;
+    phaseStart_ = now;
+}
+
+std::string GameStatistics::Recorder::actorAt(CubeCoordinate location) const
+{
+    const ActorState* onHex = nullptr;
+    const ActorState* nextToHex = nullptr;
+    for (const auto& actor : actors_) {
+        const ActorState& state = actor.second;
+        if (state.location == location) {
+            if (onHex == nullptr || state.active > onHex->active) {
+                onHex = &state;
+            }
+        } else if (isNeighbour(state.location, location)) {
+            if (nextToHex == nullptr || state.active > nextToHex->active) {
+                nextToHex = &state;
+            }
+        }
+    }
+    if (onHex != nullptr) {
+        return onHex->type;
+    }
+    if (nextToHex != nullptr) {
+        return nextToHex->type;
+    }
+    return NO_ACTOR;
+}
+
+GameStatistics::GameStatistics():
+    games_(0),
+    wonGames_(0),
+    gameLength_(),
+    lengthHistogram_(),
+    seats_(),
+    pawnsLost_(),
+    transportUsage_(),
+    spins_(),
+    phaseTimes_()
+{
+}
+
+void GameStatistics::merge(const GameStatistics& other)
+{
+    games_ += other.games_;
+    wonGames_ += other.wonGames_;
+    gameLength_.merge(other.gameLength_);
+    for (std::size_t i = 0; i < LENGTH_BUCKETS; ++i) {
+        lengthHistogram_[i] += other.lengthHistogram_[i];
+    }
+    if (seats_.size() < other.seats_.size()) {
+        seats_.resize(other.seats_.size());
+    }
+    for (std::size_t i = 0; i < other.seats_.size(); ++i) {
+        seats_[i].games += other.seats_[i].games;
+        seats_[i].wins += other.seats_[i].wins;
+    }
+    addCounts(pawnsLost_, other.pawnsLost_);
+    for (const auto& usage : other.transportUsage_) {
+        TransportUsage& counts = transportUsage_[usage.first];
+        counts.appeared += usage.second.appeared;
+        counts.moves += usage.second.moves;
+        counts.boarded += usage.second.boarded;
+        counts.removed += usage.second.removed;
+    }
+    addCounts(spins_, other.spins_);
+    for (std::size_t i = 0; i < phaseTimes_.size(); ++i) {
+        phaseTimes_[i].merge(other.phaseTimes_[i]);
+    }
+}
+
+std::uint64_t GameStatistics::games() const
+{
+    return games_;
+}
+
+std::uint64_t GameStatistics::wonGames() const
+{
+    return wonGames_;
+}
+
+const RunningStat& GameStatistics::gameLength() const
+{
+    return gameLength_;
+}
+
+const std::array<std::uint64_t, GameStatistics::LENGTH_BUCKETS>&
+GameStatistics::lengthHistogram() const
+{
+    return lengthHistogram_;
+}
+
+const std::vector<GameStatistics::Seat>& GameStatistics::seats() const
+{
+    return seats_;
+}
+
+const std::map<std::string, std::uint64_t>& GameStatistics::pawnsLost() const
+{
+    return pawnsLost_;
+}
+
+const std::map<std::string, TransportUsage>&
+GameStatistics::transportUsage() const
+{
+    return transportUsage_;
+}
+
+const std::map<std::pair<std::string, std::string>, std::uint64_t>&
+GameStatistics::spins() const
+{
+    return spins_;
+}
+
+const RunningStat& GameStatistics::phaseTime(GamePhase phase) const
+{
+    return phaseTimes_.at(phaseIndex(phase));
+}
+
+void GameStatistics::write(std::ostream& out) const
+{
+    double games = games_ == 0 ? 1 : static_cast<double>(games_);
+    out << "statistic,key,values\n";
+    out << "games,," << games_ << ',' << wonGames_ << '\n';
+    out << "game_length,turns,";
+    writeStat(out, gameLength_);
+    for (std::size_t i = 0; i < LENGTH_BUCKETS; ++i) {
+        if (lengthHistogram_[i] == 0) {
+            continue;
+        }
+        out << "length_histogram," << i * LENGTH_BUCKET_TURNS << '-';
+        if (i + 1 < LENGTH_BUCKETS) {
+            out << (i + 1) * LENGTH_BUCKET_TURNS - 1;
+        }
+        out << ',' << lengthHistogram_[i] << '\n';
+    }
+    for (std::size_t i = 0; i < seats_.size(); ++i) {
+        const Seat& seat = seats_[i];
+        out << "seat," << i + 1 << ',' << seat.games << ',' << seat.wins
+            << ',' << (seat.games == 0 ? 0. :
+                       static_cast<double>(seat.wins) /
+                       static_cast<double>(seat.games)) << '\n';
+    }
+    for (const auto& lost : pawnsLost_) {
+        out << "pawns_lost," << lost.first << ',' << lost.second << ','
+            << static_cast<double>(lost.second) / games << '\n';
+    }
+    for (const auto& usage : transportUsage_) {
+        out << "transport," << usage.first << ',' << usage.second.appeared
+            << ',' << usage.second.moves << ',' << usage.second.boarded
+            << ',' << usage.second.removed << '\n';
+    }
+    std::uint64_t spins = 0;
+    for (const auto& spin : spins_) {
+        spins += spin.second;
+    }
+    for (const auto& spin : spins_) {
+        out << "spin," << spin.first.first << ' ' << spin.first.second << ','
+            << spin.second << ','
+            << static_cast<double>(spin.second) / static_cast<double>(spins)
+            << '\n';
+    }
+    for (std::size_t i = 0; i < phaseTimes_.size(); ++i) {
+        out << "phase_seconds," << PHASE_NAMES[i] << ',';
+        writeStat(out, phaseTimes_[i]);
+    }
+}
+
+}
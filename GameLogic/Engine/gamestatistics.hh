@@ -0,0 +1,230 @@
+#ifndef GAMESTATISTICS_HH
+#define GAMESTATISTICS_HH
+
+#include "cubecoordinate.hh"
+#include "gameevent.hh"
+#include "igamestate.hh"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file
+ * @brief Statistics of many games, for balancing the layout and the pieces.
+ */
+
+namespace Common {
+
+/**
+ * @brief RunningStat keeps the count, mean, variance, minimum and maximum of
+ * a stream of values without storing them.
+ */
+class RunningStat {
+
+public:
+
+    RunningStat();
+
+    /**
+     * @brief add adds a value.
+     * @post Exception quarantee: nothrow
+     */
+    void add(double value);
+
+    /**
+     * @brief merge adds the values of another stream.
+     * @post Exception quarantee: nothrow
+     */
+    void merge(const RunningStat& other);
+
+    std::uint64_t count() const;
+    double mean() const;
+    //! Sample variance, zero for less than two values.
+    double variance() const;
+    double min() const;
+    double max() const;
+
+private:
+
+    std::uint64_t count_;
+    double mean_;
+    //! Sum of squared differences from the mean.
+    double m2_;
+    double min_;
+    double max_;
+};
+
+/**
+ * @brief How often a kind of transport was used.
+ */
+struct TransportUsage {
+    //! Transports placed on the board or spawned from a sunk hex.
+    std::uint64_t appeared = 0;
+    std::uint64_t moves = 0;
+    //! Pawns that got on board.
+    std::uint64_t boarded = 0;
+    //! Transports destroyed by actors.
+    std::uint64_t removed = 0;
+};
+
+/**
+ * @brief GameStatistics sums up the results of any number of games in a
+ * fixed amount of memory.
+ * @details A Recorder follows one game through its events and adds the game
+ * to the statistics when the game is won or the recorder is destroyed.
+ * Statistics kept by different threads are combined with merge, so each
+ * thread can record its own games without locking. The memory used depends
+ * only on the number of seats, actor and transport types and wheel
+ * outcomes, not on the number of games.
+ */
+class GameStatistics {
+
+public:
+
+    //! Game lengths are counted in buckets of this many turns.
+    static const unsigned LENGTH_BUCKET_TURNS = 5;
+    //! Number of buckets, the last one holds all longer games.
+    static const std::size_t LENGTH_BUCKETS = 40;
+
+    /**
+     * @brief Recorder collects the statistics of one game from its events.
+     * @details The recorder subscribes to the publisher of the game when it
+     * is created and unsubscribes when it is destroyed. Memory used during
+     * the game grows with the pieces of that game only.
+     */
+    class Recorder {
+
+    public:
+
+        /**
+         * @brief Constructor, starts following a game.
+         * @param statistics Where the game is added, must outlive the
+         * recorder.
+         * @param events Publisher of the game.
+         * @post Exception quarantee: strong
+         */
+        Recorder(GameStatistics& statistics,
+                 std::shared_ptr<GameEventPublisher> events);
+
+        /**
+         * @brief Destructor, adds the game if finish has not been called.
+         */
+        ~Recorder();
+
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        /**
+         * @brief finish adds the game to the statistics. Later events are
+         * ignored. Called by itself when the game is won.
+         * @post Exception quarantee: basic
+         */
+        void finish();
+
+    private:
+
+        struct ActorState {
+            std::string type;
+            CubeCoordinate location;
+            //! Number of the event that last moved or spawned the actor.
+            std::uint64_t active;
+        };
+
+        void onEvent(const GameEvent& event);
+        void beginPhase(GamePhase phase);
+        std::string actorAt(CubeCoordinate location) const;
+
+        GameStatistics& statistics_;
+        std::shared_ptr<GameEventPublisher> events_;
+        int subscription_;
+        bool finished_;
+
+        std::uint64_t eventNumber_;
+        unsigned turns_;
+        int seats_;
+        int winner_;
+        GamePhase phase_;
+        std::chrono::steady_clock::time_point phaseStart_;
+        std::array<RunningStat, 3> phaseTimes_;
+
+        std::map<int, ActorState> actors_;
+        std::map<int, std::string> transports_;
+        std::map<std::string, std::uint64_t> pawnsLost_;
+        std::map<std::string, TransportUsage> transportUsage_;
+        std::map<std::pair<std::string, std::string>, std::uint64_t> spins_;
+    };
+
+    //! Games and wins of a seat, seat 1 plays first.
+    struct Seat {
+        std::uint64_t games = 0;
+        std::uint64_t wins = 0;
+    };
+
+    GameStatistics();
+
+    /**
+     * @brief merge adds the games of other statistics to these.
+     * @post Exception quarantee: basic
+     */
+    void merge(const GameStatistics& other);
+
+    //! Games added.
+    std::uint64_t games() const;
+    //! Games that ended with a winner.
+    std::uint64_t wonGames() const;
+    //! Turns played in a game.
+    const RunningStat& gameLength() const;
+    //! Number of games by length, see LENGTH_BUCKET_TURNS.
+    const std::array<std::uint64_t, LENGTH_BUCKETS>& lengthHistogram() const;
+    //! Seats by seat number starting from 1, index 0 is seat 1.
+    const std::vector<Seat>& seats() const;
+    /**
+     * @brief pawnsLost tells how many pawns each actor type removed.
+     * @details A pawn removed on a hex is credited to the actor on the hex
+     * that moved or appeared last, or on a neighbouring hex when the hex has
+     * none (a vortex). Pawns removed with no actor near are under "none".
+     */
+    const std::map<std::string, std::uint64_t>& pawnsLost() const;
+    //! Use of each transport type.
+    const std::map<std::string, TransportUsage>& transportUsage() const;
+    //! Wheel results by animal and moves.
+    const std::map<std::pair<std::string, std::string>, std::uint64_t>&
+    spins() const;
+    /**
+     * @brief phaseTime tells how long each visit to a phase took.
+     * @param phase The phase.
+     * @return Seconds per visit.
+     */
+    const RunningStat& phaseTime(GamePhase phase) const;
+
+    /**
+     * @brief write prints the statistics as comma separated lines of
+     * statistic, key and values.
+     * @param out The stream.
+     */
+    void write(std::ostream& out) const;
+
+private:
+
+    std::uint64_t games_;
+    std::uint64_t wonGames_;
+    RunningStat gameLength_;
+    std::array<std::uint64_t, LENGTH_BUCKETS> lengthHistogram_;
+    std::vector<Seat> seats_;
+    std::map<std::string, std::uint64_t> pawnsLost_;
+    std::map<std::string, TransportUsage> transportUsage_;
+    std::map<std::pair<std::string, std::string>, std::uint64_t> spins_;
+    std::array<RunningStat, 3> phaseTimes_;
+};
+
+}
+
+#endif // GAMESTATISTICS_HH
@@ -136,6 +136,16 @@ std::shared_ptr<Common::Transport> Hex::giveTransport(int transportId) const
     return transportMap_[transportId];
 }
 
+bool Hex::isPawnInTransport(std::shared_ptr<Common::Pawn> pawn) const
+{
+    std::shared_ptr<Common::Transport> carrier = pawn->getTransport();
+    if (carrier == nullptr) {
+        return false;
+    }
+    auto slot = transportMap_.find(carrier->getId());
+    return slot != transportMap_.end() && slot->second == carrier;
+}
+
 std::shared_ptr<Common::Actor> Hex::giveActor(int actorId) const
 {
     if (actorMap_.find(actorId) == actorMap_.end()) {
@@ -149,46 +159,57 @@ void Hex::clear(){
     actorMap_.clear();
     transportMap_.clear();
     pawnMap_.clear();
+    piecesChanged();
 }
 
 void Hex::clearPawnsFromTerrain()
 {
     std::map<int, std::shared_ptr<Common::Pawn>>::iterator it;
-    std::map<int, std::shared_ptr<Common::Transport>>::iterator it2;
-    std::vector<std::shared_ptr<Common::Pawn>> removable;
-    bool pawnIsInTransport;
-    for( it = pawnMap_.begin(); it != pawnMap_.end(); ++it){
-        pawnIsInTransport = false;
-        for ( it2 = transportMap_.begin(); it2 != transportMap_.end(); ++it2){
-            if ( it2->second->isPawnInTransport(it->second) ){
-                pawnIsInTransport = true;
-            }
+    for( it = pawnMap_.begin(); it != pawnMap_.end(); ){
+        if ( isPawnInTransport(it->second) ){
+            ++it;
+        } else {
+            it = pawnMap_.erase(it);
         }
-        if ( !pawnIsInTransport ){
-            removable.push_back(it->second);
-        }
-    }
-    std::vector<std::shared_ptr<Common::Pawn>>::iterator it3;
-    for( it3 = removable.begin(); it3 != removable.end(); ++it3){
-        removePawn(*it3);
     }
+    piecesChanged();
 }
 
 void Hex::clearTransports()
 {
     transportMap_.clear();
+    piecesChanged();
 }
 
 void Hex::addNeighbour(std::shared_ptr<Common::Hex> hex)
 {
+    if (neighbourHexes_.empty()) {
+        neighbourHexes_.reserve(neighbourVector_.size());
+    }
     neighbourHexes_.push_back(hex);
 }
 
 void Hex::clearAllFromNeightbours()
 {
-    std::vector<std::shared_ptr<Common::Hex>>::const_iterator it;
+    std::vector<std::weak_ptr<Common::Hex>>::const_iterator it;
     for ( it = neighbourHexes_.begin(); it != neighbourHexes_.end(); ++it){
-        (*it)->clear();
+        std::shared_ptr<Common::Hex> neighbour = it->lock();
+        if (neighbour != nullptr) {
+            neighbour->clear();
+        }
+    }
+}
+
+void Hex::setChangeListener(
+        std::function<void(Common::CubeCoordinate)> listener)
+{
+    changeListener_ = std::move(listener);
+}
+
+void Hex::piecesChanged()
+{
+    if (changeListener_) {
+        changeListener_(coord_);
     }
 }
 
@@ -2,6 +2,7 @@
 #define HEX_HH
 
 #include "cubecoordinate.hh"
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -138,6 +139,15 @@ class Hex : public std::enable_shared_from_this<Hex> {
      */
     std::shared_ptr<Common::Transport> giveTransport(int transportId) const;
 
+    /**
+     * @brief isPawnInTransport tells if a transport on the hex carries the
+     * pawn. A pawn whose transport has left the hex is not carried here.
+     * @param pawn The pawn.
+     * @return true, if the pawn is in a transport of the hex, else false
+     * @post Exception quarantee: nothrow
+     */
+    bool isPawnInTransport(std::shared_ptr<Common::Pawn> pawn) const;
+
     /**
      * @brief giveActor returns the actor with id actorId
      * @param actorId the id of the actor needed
@@ -163,6 +173,7 @@ class Hex : public std::enable_shared_from_this<Hex> {
    /**
     * @brief addNeighbour adds neighbour hex to the hex
     * @param neightbour has been added to the hex
+    * @note The neighbour is not owned by the hex, the game board owns it.
     */
    void addNeighbour(std::shared_ptr<Common::Hex> hex);
    /**
@@ -171,6 +182,21 @@ class Hex : public std::enable_shared_from_this<Hex> {
     */
    void clearAllFromNeightbours();
 
+   /**
+    * @brief setChangeListener sets a function that is told when pieces
+    * leave the hex by clear, clearPawnsFromTerrain or clearTransports, or
+    * pawns board or leave a transport on it. These are the changes the
+    * rules of the actors make without the game board.
+    * @param listener Called with the coordinates of the hex, an empty
+    * function for none.
+    */
+   void setChangeListener(std::function<void(Common::CubeCoordinate)>
+                          listener);
+   /**
+    * @brief piecesChanged calls the change listener, if the hex has one.
+    */
+   void piecesChanged();
+
    /**
     * @brief getActors returns Actors inside the Hex.
     * @return vector of shared_ptrs to Actors.
@@ -209,8 +235,11 @@ class Hex : public std::enable_shared_from_this<Hex> {
 
     //! Vector which contains coordinates of neighbour hexes
     std::vector<Common::CubeCoordinate> neighbourVector_;
-    //! Vector which contains neighbour hexes
-    std::vector<std::shared_ptr<Common::Hex>> neighbourHexes_;
+    //! Vector which contains neighbour hexes, owned by the game board
+    std::vector<std::weak_ptr<Common::Hex>> neighbourHexes_;
+
+    //! Told about the changes made by the rules of the actors.
+    std::function<void(Common::CubeCoordinate)> changeListener_;
 
     void setNeighbourVector();
 
@@ -0,0 +1,598 @@
+#include "hexbitboard.hh"
+#include "pawnrouter.hh"
+#include "trace.hh"
+
+#include <algorithm>
+
+namespace Common {
+
+namespace {
+
+const std::size_t WORD_BITS = 64;
+
+// x and z steps to the six neighbours
+const int SIDES[6][2] = {{1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1}};
+
+// Hexes left free around the board when the box grows, so that a board
+// built ring by ring is not numbered again for every ring.
+const int MARGIN = 4;
+
+std::size_t lowestBit(std::uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+std::size_t bitCount(std::uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+    std::size_t bits = 0;
+    for (; word != 0; word &= word - 1) {
+        ++bits;
+    }
+    return bits;
+#endif
+}
+
+template <typename Visit>
+void forEachIndex(const HexMask& set, Visit visit)
+{
+    const std::vector<std::uint64_t>& words = set.words();
+    for (std::size_t word = 0; word < words.size(); ++word) {
+        for (std::uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {
+            visit(word * WORD_BITS + lowestBit(bits));
+        }
+    }
+}
+
+}
+
+HexMask::HexMask():
+    words_(),
+    bits_(0)
+{
+}
+
+HexMask::HexMask(std::size_t bits):
+    words_((bits + WORD_BITS - 1) / WORD_BITS, 0),
+    bits_(bits)
+{
+}
+
+std::size_t HexMask::size() const
+{
+    return bits_;
+}
+
+bool HexMask::test(std::size_t index) const
+{
+    return (words_[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+void HexMask::set(std::size_t index)
+{
+    words_[index / WORD_BITS] |= std::uint64_t(1) << (index % WORD_BITS);
+}
+
+void HexMask::reset(std::size_t index)
+{
+    words_[index / WORD_BITS] &= ~(std::uint64_t(1) << (index % WORD_BITS));
+}
+
+void HexMask::clear()
+{
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+bool HexMask::any() const
+{
+    for (std::uint64_t word : words_) {
+        if (word != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t HexMask::count() const
+{
+    std::size_t bits = 0;
+    for (std::uint64_t word : words_) {
+        bits += bitCount(word);
+    }
+    return bits;
+}
+
+HexMask& HexMask::operator|=(const HexMask& other)
+{
+    for (std::size_t word = 0; word < words_.size(); ++word) {
+        words_[word] |= other.words_[word];
+    }
+    return *this;
+}
+
+HexMask& HexMask::operator&=(const HexMask& other)
+{
+    for (std::size_t word = 0; word < words_.size(); ++word) {
+        words_[word] &= other.words_[word];
+    }
+    return *this;
+}
+
+HexMask& HexMask::subtract(const HexMask& other)
+{
+    for (std::size_t word = 0; word < words_.size(); ++word) {
+        words_[word] &= ~other.words_[word];
+    }
+    return *this;
+}
+
+void HexMask::orShifted(const HexMask& source, std::ptrdiff_t offset)
+{
+    std::size_t count = words_.size();
+    std::size_t distance = static_cast<std::size_t>(
+                offset < 0 ? -offset : offset);
+    std::size_t wordShift = distance / WORD_BITS;
+    unsigned bitShift = static_cast<unsigned>(distance % WORD_BITS);
+    if (wordShift >= count) {
+        return;
+    }
+
+    // Plain pointers, and the word that has no neighbour to borrow bits
+    // from done apart, keep the loops free of branches.
+    const std::uint64_t* from = source.words_.data();
+    std::uint64_t* to = words_.data();
+    std::size_t moved = count - wordShift;
+    if (offset >= 0) {
+        to += wordShift;
+        if (bitShift == 0) {
+            for (std::size_t word = 0; word < moved; ++word) {
+                to[word] |= from[word];
+            }
+        } else {
+            to[0] |= from[0] << bitShift;
+            for (std::size_t word = 1; word < moved; ++word) {
+                to[word] |= (from[word] << bitShift) |
+                        (from[word - 1] >> (WORD_BITS - bitShift));
+            }
+        }
+        trim();
+    } else {
+        from += wordShift;
+        if (bitShift == 0) {
+            for (std::size_t word = 0; word < moved; ++word) {
+                to[word] |= from[word];
+            }
+        } else {
+            for (std::size_t word = 0; word + 1 < moved; ++word) {
+                to[word] |= (from[word] >> bitShift) |
+                        (from[word + 1] << (WORD_BITS - bitShift));
+            }
+            to[moved - 1] |= from[moved - 1] >> bitShift;
+        }
+    }
+}
+
+const std::vector<std::uint64_t>& HexMask::words() const
+{
+    return words_;
+}
+
+bool HexMask::operator==(const HexMask& other) const
+{
+    return bits_ == other.bits_ && words_ == other.words_;
+}
+
+void HexMask::trim()
+{
+    std::size_t used = bits_ % WORD_BITS;
+    if (used != 0) {
+        words_.back() &= (std::uint64_t(1) << used) - 1;
+    }
+}
+
+HexBitboard::HexBitboard():
+    minX_(0),
+    minZ_(0),
+    columns_(0),
+    rows_(0),
+    offsets_(),
+    hexes_(),
+    typeNames_(),
+    terrains_(),
+    types_(),
+    pawns_(),
+    full_(),
+    players_(),
+    enterable_(),
+    walkable_(),
+    movesValid_(false),
+    movesOrigin_(),
+    movesSteps_(0),
+    moves_()
+{
+}
+
+void HexBitboard::addHex(CubeCoordinate coord, const std::string& pieceType)
+{
+    std::size_t type = typeOf(pieceType);
+    if (indexOf(coord) == NONE) {
+        grow(coord);
+    }
+    std::size_t index = static_cast<std::size_t>(indexOf(coord));
+    if (hexes_.test(index)) {
+        terrains_[types_[index]].reset(index);
+    }
+    hexes_.set(index);
+    types_[index] = static_cast<std::uint8_t>(type);
+    terrains_[type].set(index);
+    refresh(index);
+}
+
+void HexBitboard::sink(CubeCoordinate coord)
+{
+    std::ptrdiff_t index = indexOf(coord);
+    if (index == NONE || !hexes_.test(static_cast<std::size_t>(index))) {
+        return;
+    }
+    addHex(coord, "Water");
+}
+
+void HexBitboard::addPawn(CubeCoordinate coord, int playerId)
+{
+    std::ptrdiff_t found = indexOf(coord);
+    if (found == NONE || !hexes_.test(static_cast<std::size_t>(found))) {
+        return;
+    }
+    std::size_t index = static_cast<std::size_t>(found);
+    if (playerId >= 0) {
+        std::size_t player = static_cast<std::size_t>(playerId);
+        if (players_.size() <= player) {
+            players_.resize(player + 1, HexMask(hexes_.size()));
+        }
+        players_[player].set(index);
+    }
+    if (++pawns_[index] >= PawnRouter::MAX_PAWNS_PER_HEX) {
+        full_.set(index);
+        refresh(index);
+    }
+}
+
+void HexBitboard::clearPawns(CubeCoordinate coord)
+{
+    std::ptrdiff_t found = indexOf(coord);
+    if (found == NONE) {
+        return;
+    }
+    std::size_t index = static_cast<std::size_t>(found);
+    pawns_[index] = 0;
+    full_.reset(index);
+    for (HexMask& player : players_) {
+        player.reset(index);
+    }
+    refresh(index);
+}
+
+void HexBitboard::clearPawns(const HexMask& area)
+{
+    full_.subtract(area);
+    for (HexMask& player : players_) {
+        player.subtract(area);
+    }
+    forEachIndex(area, [this](std::size_t index) {
+        pawns_[index] = 0;
+        refresh(index);
+    });
+}
+
+int HexBitboard::pawnCount(CubeCoordinate coord) const
+{
+    std::ptrdiff_t index = indexOf(coord);
+    return index == NONE ? 0 : pawns_[static_cast<std::size_t>(index)];
+}
+
+const HexMask& HexBitboard::hexes() const
+{
+    return hexes_;
+}
+
+HexMask HexBitboard::terrain(const std::string& pieceType) const
+{
+    const HexMask* found = terrainMask(pieceType);
+    return found == nullptr ? HexMask(hexes_.size()) : *found;
+}
+
+HexMask HexBitboard::water() const
+{
+    return terrain("Water");
+}
+
+HexMask HexBitboard::goals() const
+{
+    return terrain("Coral");
+}
+
+HexMask HexBitboard::land() const
+{
+    HexMask land = hexes_;
+    const HexMask* water = terrainMask("Water");
+    if (water != nullptr) {
+        land.subtract(*water);
+    }
+    return land;
+}
+
+const HexMask& HexBitboard::full() const
+{
+    return full_;
+}
+
+HexMask HexBitboard::pawnsOf(int playerId) const
+{
+    if (playerId < 0 || static_cast<std::size_t>(playerId) >= players_.size()) {
+        return HexMask(hexes_.size());
+    }
+    return players_[static_cast<std::size_t>(playerId)];
+}
+
+HexMask HexBitboard::mask(CubeCoordinate coord) const
+{
+    HexMask single(hexes_.size());
+    std::ptrdiff_t index = indexOf(coord);
+    if (index != NONE && hexes_.test(static_cast<std::size_t>(index))) {
+        single.set(static_cast<std::size_t>(index));
+    }
+    return single;
+}
+
+HexMask HexBitboard::dilate(const HexMask& from) const
+{
+    HexMask result = from;
+    for (std::ptrdiff_t offset : offsets_) {
+        result.orShifted(from, offset);
+    }
+    result &= hexes_;
+    return result;
+}
+
+HexMask HexBitboard::pawnMoves(CubeCoordinate origin, int steps) const
+{
+    TRACE_SCOPE("HexBitboard::pawnMoves");
+
+    HexMask reached(hexes_.size());
+    std::ptrdiff_t index = indexOf(origin);
+    if (index != NONE && hexes_.test(static_cast<std::size_t>(index))) {
+        walk(index, NONE, steps, reached);
+    }
+    return reached;
+}
+
+int HexBitboard::steps(CubeCoordinate origin, CubeCoordinate target,
+                       int maxSteps) const
+{
+    TRACE_SCOPE("HexBitboard::steps");
+
+    std::ptrdiff_t from = indexOf(origin);
+    std::ptrdiff_t to = indexOf(target);
+    if (from == NONE || to == NONE ||
+            !hexes_.test(static_cast<std::size_t>(from)) ||
+            !hexes_.test(static_cast<std::size_t>(to)) ||
+            full_.test(static_cast<std::size_t>(to))) {
+        return -1;
+    }
+    HexMask reached(hexes_.size());
+    return walk(from, to, maxSteps, reached);
+}
+
+bool HexBitboard::canWalk(CubeCoordinate origin, CubeCoordinate target,
+                          int maxSteps) const
+{
+    if (!movesValid_ || !(origin == movesOrigin_) ||
+            maxSteps != movesSteps_) {
+        moves_ = pawnMoves(origin, maxSteps);
+        movesOrigin_ = origin;
+        movesSteps_ = maxSteps;
+        movesValid_ = true;
+    }
+    return contains(moves_, target);
+}
+
+bool HexBitboard::contains(const HexMask& set, CubeCoordinate coord) const
+{
+    std::ptrdiff_t index = indexOf(coord);
+    return index != NONE && set.test(static_cast<std::size_t>(index));
+}
+
+std::vector<CubeCoordinate> HexBitboard::coordinates(const HexMask& set) const
+{
+    std::vector<CubeCoordinate> coords;
+    coords.reserve(set.count());
+    forEachIndex(set, [this, &coords](std::size_t index) {
+        coords.push_back(coordinateAt(index));
+    });
+    return coords;
+}
+
+void HexBitboard::clear()
+{
+    minX_ = 0;
+    minZ_ = 0;
+    columns_ = 0;
+    rows_ = 0;
+    offsets_.fill(0);
+    hexes_ = HexMask();
+    typeNames_.clear();
+    terrains_.clear();
+    types_.clear();
+    pawns_.clear();
+    full_ = HexMask();
+    players_.clear();
+    enterable_ = HexMask();
+    walkable_ = HexMask();
+    movesValid_ = false;
+    moves_ = HexMask();
+}
+
+std::ptrdiff_t HexBitboard::indexOf(CubeCoordinate coord) const
+{
+    int column = coord.x - minX_;
+    int row = coord.z - minZ_;
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_) {
+        return NONE;
+    }
+    return static_cast<std::ptrdiff_t>(row) * (columns_ + 1) + column;
+}
+
+CubeCoordinate HexBitboard::coordinateAt(std::size_t index) const
+{
+    std::size_t stride = static_cast<std::size_t>(columns_) + 1;
+    int x = minX_ + static_cast<int>(index % stride);
+    int z = minZ_ + static_cast<int>(index / stride);
+    return CubeCoordinate(x, -x - z, z);
+}
+
+std::size_t HexBitboard::typeOf(const std::string& pieceType)
+{
+    auto found = std::find(typeNames_.begin(), typeNames_.end(), pieceType);
+    if (found != typeNames_.end()) {
+        return static_cast<std::size_t>(found - typeNames_.begin());
+    }
+    terrains_.push_back(HexMask(hexes_.size()));
+    typeNames_.push_back(pieceType);
+    return typeNames_.size() - 1;
+}
+
+const HexMask* HexBitboard::terrainMask(const std::string& pieceType) const
+{
+    auto found = std::find(typeNames_.begin(), typeNames_.end(), pieceType);
+    if (found == typeNames_.end()) {
+        return nullptr;
+    }
+    return &terrains_[static_cast<std::size_t>(found - typeNames_.begin())];
+}
+
+void HexBitboard::grow(CubeCoordinate coord)
+{
+    TRACE_SCOPE("HexBitboard::grow");
+
+    int minX = coord.x - MARGIN;
+    int maxX = coord.x + MARGIN;
+    int minZ = coord.z - MARGIN;
+    int maxZ = coord.z + MARGIN;
+    if (columns_ > 0) {
+        minX = std::min(minX_, minX);
+        maxX = std::max(minX_ + columns_ - 1, maxX);
+        minZ = std::min(minZ_, minZ);
+        maxZ = std::max(minZ_ + rows_ - 1, maxZ);
+    }
+    int columns = maxX - minX + 1;
+    int rows = maxZ - minZ + 1;
+    std::size_t bits = static_cast<std::size_t>(rows) *
+            static_cast<std::size_t>(columns + 1);
+
+    // Everything is numbered again into new masks, which replace the old
+    // ones only when all are done.
+    HexMask hexes(bits);
+    std::vector<HexMask> terrains(terrains_.size(), HexMask(bits));
+    std::vector<std::uint8_t> types(bits, 0);
+    std::vector<int> pawns(bits, 0);
+    HexMask full(bits);
+    std::vector<HexMask> players(players_.size(), HexMask(bits));
+    forEachIndex(hexes_, [&](std::size_t from) {
+        CubeCoordinate moved = coordinateAt(from);
+        std::size_t to = static_cast<std::size_t>(moved.z - minZ) *
+                static_cast<std::size_t>(columns + 1) +
+                static_cast<std::size_t>(moved.x - minX);
+        hexes.set(to);
+        types[to] = types_[from];
+        terrains[types_[from]].set(to);
+        pawns[to] = pawns_[from];
+        if (full_.test(from)) {
+            full.set(to);
+        }
+        for (std::size_t player = 0; player < players_.size(); ++player) {
+            if (players_[player].test(from)) {
+                players[player].set(to);
+            }
+        }
+    });
+
+    minX_ = minX;
+    minZ_ = minZ;
+    columns_ = columns;
+    rows_ = rows;
+    for (int side = 0; side < 6; ++side) {
+        offsets_[side] = SIDES[side][0] +
+                static_cast<std::ptrdiff_t>(SIDES[side][1]) * (columns + 1);
+    }
+    hexes_ = std::move(hexes);
+    terrains_ = std::move(terrains);
+    types_ = std::move(types);
+    pawns_ = std::move(pawns);
+    full_ = std::move(full);
+    players_ = std::move(players);
+    enterable_ = HexMask(bits);
+    walkable_ = HexMask(bits);
+    forEachIndex(hexes_, [this](std::size_t index) {
+        refresh(index);
+    });
+}
+
+void HexBitboard::refresh(std::size_t index)
+{
+    movesValid_ = false;
+    enterable_.reset(index);
+    walkable_.reset(index);
+    if (!hexes_.test(index) || full_.test(index)) {
+        return;
+    }
+    enterable_.set(index);
+    if (typeNames_[types_[index]] != "Water") {
+        walkable_.set(index);
+    }
+}
+
+int HexBitboard::walk(std::ptrdiff_t origin, std::ptrdiff_t target,
+                      int maxSteps, HexMask& reached) const
+{
+    std::size_t start = static_cast<std::size_t>(origin);
+    reached.set(start);
+    int found = -1;
+    if (origin == target) {
+        found = 0;
+    }
+    // A pawn enters any hex that is not full, and walks on from those that
+    // are land.
+    HexMask frontier(hexes_.size());
+    frontier.set(start);
+    HexMask next(hexes_.size());
+    for (int step = 1; step <= maxSteps && found < 0 && frontier.any();
+         ++step) {
+        next.clear();
+        for (std::ptrdiff_t offset : offsets_) {
+            next.orShifted(frontier, offset);
+        }
+        next &= enterable_;
+        next.subtract(reached);
+        reached |= next;
+        if (target != NONE && next.test(static_cast<std::size_t>(target))) {
+            found = step;
+        }
+        frontier = next;
+        frontier &= walkable_;
+    }
+    reached.subtract(full_);
+    return found;
+}
+
+}
@@ -0,0 +1,316 @@
+#ifndef HEXBITBOARD_HH
+#define HEXBITBOARD_HH
+
+#include "cubecoordinate.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @brief The board as sets of hexes, one bit per hex.
+ */
+
+namespace Common {
+
+/**
+ * @brief HexMask is a set of hexes of one HexBitboard, bit i tells if hex
+ * number i is in the set.
+ * @details Masks of one board have the same size and are combined word by
+ * word.
+ */
+class HexMask {
+
+public:
+
+    HexMask();
+
+    /**
+     * @brief Constructor, an empty set.
+     * @param bits Number of hexes the set can hold.
+     */
+    explicit HexMask(std::size_t bits);
+
+    std::size_t size() const;
+
+    bool test(std::size_t index) const;
+    void set(std::size_t index);
+    void reset(std::size_t index);
+
+    /**
+     * @brief clear removes all hexes, the size stays.
+     * @post Exception quarantee: nothrow
+     */
+    void clear();
+
+    /**
+     * @brief any tells if the set has some hex.
+     * @post Exception quarantee: nothrow
+     */
+    bool any() const;
+
+    /**
+     * @brief count tells the number of hexes in the set.
+     * @post Exception quarantee: nothrow
+     */
+    std::size_t count() const;
+
+    //! Union, the masks must be of the same size.
+    HexMask& operator|=(const HexMask& other);
+    //! Intersection, the masks must be of the same size.
+    HexMask& operator&=(const HexMask& other);
+
+    /**
+     * @brief subtract removes the hexes of other from the set.
+     * @post Exception quarantee: nothrow
+     */
+    HexMask& subtract(const HexMask& other);
+
+    /**
+     * @brief orShifted adds the hexes of source moved by offset positions,
+     * hex i of source becomes hex i + offset. Hexes moved past either end
+     * are dropped.
+     * @param source Mask of the same size, not this one.
+     * @param offset Positions to move, negative moves down.
+     * @post Exception quarantee: nothrow
+     */
+    void orShifted(const HexMask& source, std::ptrdiff_t offset);
+
+    const std::vector<std::uint64_t>& words() const;
+
+    bool operator==(const HexMask& other) const;
+
+private:
+
+    // bits past size() are kept zero
+    void trim();
+
+    std::vector<std::uint64_t> words_;
+    std::size_t bits_;
+};
+
+/**
+ * @brief HexBitboard keeps the terrain and the pawns of a board as
+ * HexMasks, so that questions about many hexes are answered a word of hexes
+ * at a time.
+ * @details The hexes are numbered row by row over the bounding box of the
+ * board, with one unused column at the end of each row. The six neighbours
+ * of every hex are then at fixed distances in the numbering, and the
+ * neighbours of a whole set are six shifted copies of it. A neighbour
+ * across the edge of the box lands in the unused column, which no hex
+ * occupies. One step of a breadth first search is thus six shifts and a
+ * mask with the hexes that can be walked on.
+ *
+ * The box grows when a hex is added outside it, and the masks are numbered
+ * again. The owner keeps the bitboard in sync with the board: hexes as they
+ * are added and sunk, and pawns of the hexes that changed.
+ */
+class HexBitboard {
+
+public:
+
+    HexBitboard();
+
+    /**
+     * @brief addHex adds a hex, or changes the terrain of one added before.
+     * Its pawns are kept.
+     * @param coord The location of the hex.
+     * @param pieceType The terrain, "Water" and "Coral" as on Hex.
+     * @post Exception quarantee: basic
+     */
+    void addHex(CubeCoordinate coord, const std::string& pieceType);
+
+    /**
+     * @brief sink turns a hex to water. Does nothing for a hex that has not
+     * been added.
+     * @param coord The location of the hex.
+     * @post Exception quarantee: basic
+     */
+    void sink(CubeCoordinate coord);
+
+    /**
+     * @brief addPawn counts one more pawn on a hex. Does nothing for a hex
+     * that has not been added.
+     * @param coord The location of the pawn.
+     * @param playerId The owner of the pawn.
+     * @post Exception quarantee: basic
+     */
+    void addPawn(CubeCoordinate coord, int playerId);
+
+    /**
+     * @brief clearPawns forgets the pawns of a hex.
+     * @param coord The location of the hex.
+     * @post Exception quarantee: nothrow
+     */
+    void clearPawns(CubeCoordinate coord);
+
+    /**
+     * @brief clearPawns forgets the pawns of every hex of area.
+     * @param area Mask of this board.
+     * @post Exception quarantee: nothrow
+     */
+    void clearPawns(const HexMask& area);
+
+    /**
+     * @brief pawnCount tells the number of pawns on a hex.
+     * @return 0 for a hex that has not been added.
+     * @post Exception quarantee: nothrow
+     */
+    int pawnCount(CubeCoordinate coord) const;
+
+    //! All hexes of the board.
+    const HexMask& hexes() const;
+
+    /**
+     * @brief terrain tells the hexes of one piece type.
+     * @return An empty mask for a type no hex has had.
+     * @post Exception quarantee: strong
+     */
+    HexMask terrain(const std::string& pieceType) const;
+
+    //! Water hexes.
+    HexMask water() const;
+    //! Goal hexes, the Coral.
+    HexMask goals() const;
+    //! Hexes that are not water.
+    HexMask land() const;
+
+    //! Hexes that have PawnRouter::MAX_PAWNS_PER_HEX pawns or more.
+    const HexMask& full() const;
+
+    /**
+     * @brief pawnsOf tells the hexes with pawns of a player.
+     * @post Exception quarantee: strong
+     */
+    HexMask pawnsOf(int playerId) const;
+
+    /**
+     * @brief mask makes a set of one hex.
+     * @return An empty mask for a hex that has not been added.
+     * @post Exception quarantee: strong
+     */
+    HexMask mask(CubeCoordinate coord) const;
+
+    /**
+     * @brief dilate adds the neighbours of every hex of the set.
+     * @param from Mask of this board.
+     * @return The hexes of from and their neighbours on the board.
+     * @post Exception quarantee: strong
+     */
+    HexMask dilate(const HexMask& from) const;
+
+    /**
+     * @brief pawnMoves finds the hexes a pawn can walk to in at most steps
+     * steps, by the rules of PawnRouter: over land that is not full, ending
+     * on any hex that is not full. The origin is walked from whatever it
+     * is.
+     * @param origin The hex the pawn starts from.
+     * @param steps Largest number of steps.
+     * @return The hexes, the origin with them unless it is full.
+     * @post Exception quarantee: strong
+     */
+    HexMask pawnMoves(CubeCoordinate origin, int steps) const;
+
+    /**
+     * @brief steps tells the length of a shortest walk from origin to
+     * target by the rules of pawnMoves.
+     * @param origin The hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @param maxSteps Longer walks are not searched.
+     * @return Number of steps, or -1 if there is no walk of at most
+     * maxSteps.
+     * @post Exception quarantee: strong
+     */
+    int steps(CubeCoordinate origin, CubeCoordinate target,
+              int maxSteps) const;
+
+    /**
+     * @brief canWalk tells if steps would find a walk.
+     * @details The hexes found by pawnMoves for the latest origin are kept
+     * until the bitboard changes, so questions about many targets of one
+     * pawn cost one search together.
+     * @param origin The hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @param maxSteps Largest number of steps.
+     * @post Exception quarantee: strong
+     */
+    bool canWalk(CubeCoordinate origin, CubeCoordinate target,
+                 int maxSteps) const;
+
+    /**
+     * @brief contains tells if a hex is in a set.
+     * @post Exception quarantee: nothrow
+     */
+    bool contains(const HexMask& set, CubeCoordinate coord) const;
+
+    /**
+     * @brief coordinates lists the hexes of a set.
+     * @return The hexes in increasing z, then x.
+     * @post Exception quarantee: strong
+     */
+    std::vector<CubeCoordinate> coordinates(const HexMask& set) const;
+
+    /**
+     * @brief clear forgets all hexes and pawns.
+     * @post Exception quarantee: nothrow
+     */
+    void clear();
+
+private:
+
+    //! Number of a hex that is outside the box.
+    static const std::ptrdiff_t NONE = -1;
+
+    std::ptrdiff_t indexOf(CubeCoordinate coord) const;
+    CubeCoordinate coordinateAt(std::size_t index) const;
+    std::size_t typeOf(const std::string& pieceType);
+    const HexMask* terrainMask(const std::string& pieceType) const;
+    void grow(CubeCoordinate coord);
+    void refresh(std::size_t index);
+
+    // Breadth first search of pawnMoves, reached gets the hexes walked to.
+    // Returns the steps to target, or -1 if not reached.
+    int walk(std::ptrdiff_t origin, std::ptrdiff_t target, int maxSteps,
+             HexMask& reached) const;
+
+    // Box of the numbering, columns_ + 1 numbers per row.
+    int minX_;
+    int minZ_;
+    int columns_;
+    int rows_;
+    //! Distance in the numbering to each of the six neighbours.
+    std::array<std::ptrdiff_t, 6> offsets_;
+
+    HexMask hexes_;
+
+    //! Piece types in the order first added, and a mask of each.
+    std::vector<std::string> typeNames_;
+    std::vector<HexMask> terrains_;
+    //! Piece type of each hex.
+    std::vector<std::uint8_t> types_;
+
+    //! Pawns on each hex.
+    std::vector<int> pawns_;
+    HexMask full_;
+    //! Hexes with pawns of each player, by player id.
+    std::vector<HexMask> players_;
+
+    //! Hexes that are not full, which a pawn may walk to, and those of them
+    //! that are land, which it may walk on from. Kept with each change, as
+    //! every search needs them.
+    HexMask enterable_;
+    HexMask walkable_;
+
+    //! pawnMoves of the latest canWalk, valid until the next change.
+    mutable bool movesValid_;
+    mutable CubeCoordinate movesOrigin_;
+    mutable int movesSteps_;
+    mutable HexMask moves_;
+};
+
+}
+
+#endif // HEXBITBOARD_HH
@@ -0,0 +1,203 @@
+#include "hexdistance.hh"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ISLANDGAME_HEX_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ISLANDGAME_HEX_SSE2
+#endif
+
+namespace Common {
+
+void HexBatch::add(CubeCoordinate coord, bool isWater)
+{
+    // grow all first, so a failure leaves the arrays the same length
+    reserve(size() + 1);
+    x.push_back(coord.x);
+    y.push_back(coord.y);
+    z.push_back(coord.z);
+    water.push_back(isWater ? -1 : 0);
+}
+
+std::size_t HexBatch::size() const
+{
+    return x.size();
+}
+
+void HexBatch::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    water.clear();
+}
+
+void HexBatch::reserve(std::size_t count)
+{
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+    water.reserve(count);
+}
+
+namespace {
+
+inline std::int32_t distanceAt(CubeCoordinate origin, const HexBatch& batch,
+                               std::size_t i)
+{
+    return (std::abs(batch.x[i] - origin.x) + std::abs(batch.y[i] - origin.y) +
+            std::abs(batch.z[i] - origin.z)) / 2;
+}
+
+#if defined(ISLANDGAME_HEX_AVX2)
+
+const std::size_t LANES = 8;
+
+inline __m256i distanceLanes(__m256i ox, __m256i oy, __m256i oz,
+                             const HexBatch& batch, std::size_t i)
+{
+    __m256i dx = _mm256_sub_epi32(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(batch.x.data() + i)), ox);
+    __m256i dy = _mm256_sub_epi32(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(batch.y.data() + i)), oy);
+    __m256i dz = _mm256_sub_epi32(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(batch.z.data() + i)), oz);
+    __m256i sum = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_abs_epi32(dx), _mm256_abs_epi32(dy)),
+                _mm256_abs_epi32(dz));
+    return _mm256_srli_epi32(sum, 1);
+}
+
+#elif defined(ISLANDGAME_HEX_SSE2)
+
+const std::size_t LANES = 4;
+
+// SSE2 has no abs for 32-bit lanes
+inline __m128i absLanes(__m128i value)
+{
+    __m128i sign = _mm_srai_epi32(value, 31);
+    return _mm_sub_epi32(_mm_xor_si128(value, sign), sign);
+}
+
+inline __m128i distanceLanes(__m128i ox, __m128i oy, __m128i oz,
+                             const HexBatch& batch, std::size_t i)
+{
+    __m128i dx = _mm_sub_epi32(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(batch.x.data() + i)), ox);
+    __m128i dy = _mm_sub_epi32(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(batch.y.data() + i)), oy);
+    __m128i dz = _mm_sub_epi32(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(batch.z.data() + i)), oz);
+    __m128i sum = _mm_add_epi32(_mm_add_epi32(absLanes(dx), absLanes(dy)),
+                                absLanes(dz));
+    return _mm_srli_epi32(sum, 1);
+}
+
+#endif
+
+}
+
+void hexDistances(CubeCoordinate origin, const HexBatch& batch,
+                  std::int32_t* distances)
+{
+    std::size_t count = batch.size();
+    std::size_t i = 0;
+
+#if defined(ISLANDGAME_HEX_AVX2)
+    __m256i ox = _mm256_set1_epi32(origin.x);
+    __m256i oy = _mm256_set1_epi32(origin.y);
+    __m256i oz = _mm256_set1_epi32(origin.z);
+    for (; i + LANES <= count; i += LANES) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(distances + i),
+                            distanceLanes(ox, oy, oz, batch, i));
+    }
+#elif defined(ISLANDGAME_HEX_SSE2)
+    __m128i ox = _mm_set1_epi32(origin.x);
+    __m128i oy = _mm_set1_epi32(origin.y);
+    __m128i oz = _mm_set1_epi32(origin.z);
+    for (; i + LANES <= count; i += LANES) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(distances + i),
+                         distanceLanes(ox, oy, oz, batch, i));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        distances[i] = distanceAt(origin, batch, i);
+    }
+}
+
+std::size_t waterWithin(CubeCoordinate origin, const HexBatch& batch,
+                        int range, std::uint32_t* indices)
+{
+    std::size_t count = batch.size();
+    std::size_t found = 0;
+    std::size_t i = 0;
+
+    // The lanes that pass become a bit mask. Most groups of lanes have none,
+    // the others write the index of every lane while only the passing ones
+    // move the end forward. The writes stay below i + lanes, inside the
+    // buffer.
+#if defined(ISLANDGAME_HEX_AVX2)
+    __m256i ox = _mm256_set1_epi32(origin.x);
+    __m256i oy = _mm256_set1_epi32(origin.y);
+    __m256i oz = _mm256_set1_epi32(origin.z);
+    __m256i limit = _mm256_set1_epi32(range);
+    for (; i + LANES <= count; i += LANES) {
+        __m256i far = _mm256_cmpgt_epi32(
+                    distanceLanes(ox, oy, oz, batch, i), limit);
+        __m256i water = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(batch.water.data() + i));
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(
+                    _mm256_castsi256_ps(_mm256_andnot_si256(far, water))));
+        if (bits == 0) {
+            continue;
+        }
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            indices[found] = static_cast<std::uint32_t>(i + lane);
+            found += (bits >> lane) & 1;
+        }
+    }
+#elif defined(ISLANDGAME_HEX_SSE2)
+    __m128i ox = _mm_set1_epi32(origin.x);
+    __m128i oy = _mm_set1_epi32(origin.y);
+    __m128i oz = _mm_set1_epi32(origin.z);
+    __m128i limit = _mm_set1_epi32(range);
+    for (; i + LANES <= count; i += LANES) {
+        __m128i far = _mm_cmpgt_epi32(distanceLanes(ox, oy, oz, batch, i),
+                                      limit);
+        __m128i water = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(batch.water.data() + i));
+        unsigned bits = static_cast<unsigned>(_mm_movemask_ps(
+                    _mm_castsi128_ps(_mm_andnot_si128(far, water))));
+        if (bits == 0) {
+            continue;
+        }
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            indices[found] = static_cast<std::uint32_t>(i + lane);
+            found += (bits >> lane) & 1;
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (batch.water[i] != 0 && distanceAt(origin, batch, i) <= range) {
+            indices[found++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+const char* hexKernelName()
+{
+#if defined(ISLANDGAME_HEX_AVX2)
+    return "avx2";
+#elif defined(ISLANDGAME_HEX_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef HEXDISTANCE_HH
+#define HEXDISTANCE_HH
+
+#include "cubecoordinate.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * @file
+ * @brief Hex distances between one hex and many, computed several at a time.
+ *
+ * The kernels use AVX2 when the engine is built with qmake CONFIG+=avx2,
+ * SSE2 on other x86 builds and plain loops elsewhere. All give the same
+ * results.
+ */
+
+namespace Common {
+
+/**
+ * @brief hexDistance tells the number of steps between two hexes.
+ * @post Exception quarantee: nothrow
+ */
+inline unsigned int hexDistance(CubeCoordinate source, CubeCoordinate target)
+{
+    return (std::abs(source.x - target.x) + std::abs(source.y - target.y) +
+            std::abs(source.z - target.z)) / 2;
+}
+
+/**
+ * @brief HexBatch keeps many hexes as one array per coordinate, the layout
+ * the distance kernels read.
+ */
+struct HexBatch {
+    std::vector<std::int32_t> x;
+    std::vector<std::int32_t> y;
+    std::vector<std::int32_t> z;
+    //! -1 for water, 0 for other hexes.
+    std::vector<std::int32_t> water;
+
+    /**
+     * @brief add appends a hex.
+     * @post Exception quarantee: strong
+     */
+    void add(CubeCoordinate coord, bool isWater = false);
+
+    std::size_t size() const;
+    void clear();
+    void reserve(std::size_t count);
+};
+
+/**
+ * @brief hexDistances computes the distance from origin to every hex of the
+ * batch.
+ * @param origin The hex measured from.
+ * @param batch The hexes measured to.
+ * @param distances Buffer of batch.size() values, distances[i] is the
+ * distance to hex i.
+ * @post Exception quarantee: nothrow
+ */
+void hexDistances(CubeCoordinate origin, const HexBatch& batch,
+                  std::int32_t* distances);
+
+/**
+ * @brief waterWithin finds the water hexes of the batch at most range steps
+ * from origin, like the targets of an actor that spun range.
+ * @param origin The hex measured from.
+ * @param batch The hexes looked at.
+ * @param range Largest distance accepted.
+ * @param indices Buffer of batch.size() values, the positions of the hexes
+ * found are written to the start of it in increasing order.
+ * @return The number of hexes found.
+ * @post Exception quarantee: nothrow
+ */
+std::size_t waterWithin(CubeCoordinate origin, const HexBatch& batch,
+                        int range, std::uint32_t* indices);
+
+/**
+ * @brief hexKernelName tells which kernels this build uses.
+ * @return "avx2", "sse2" or "scalar".
+ */
+const char* hexKernelName();
+
+}
+
+#endif // HEXDISTANCE_HH
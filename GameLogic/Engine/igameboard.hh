@@ -13,6 +13,8 @@
 
 namespace Common {
 
+class GameEventPublisher;
+
 /**
  * @brief Interface for game board.
  */
@@ -171,6 +173,22 @@ class IGameBoard : public std::enable_shared_from_this<Common::IGameBoard> {
      * @post transport removed from the gameboard and Hex-object. Exception quarantee: basic
      */
     virtual void removeTransport(int id) = 0;
+
+    /**
+     * @brief setEventPublisher makes the board publish the changes made to
+     * it outside the game runner, like pawns added or removed. The game
+     * runner gives the board its publisher when it is created.
+     * @param events Publisher of the game, nullptr to stop publishing.
+     * @return True if the board publishes its changes. The default board
+     * does not, and the game runner reads the pawns from the board again
+     * whenever it checks their moves.
+     * @post Exception quarantee: nothrow
+     */
+    virtual bool setEventPublisher(std::shared_ptr<GameEventPublisher> events)
+    {
+        (void)events;
+        return false;
+    }
 };
 
 }
@@ -2,12 +2,18 @@
 #define IGAMERUNNER_HH
 
 #include "cubecoordinate.hh"
+#include "gameevent.hh"
+#include "gamejournal.hh"
 #include "igamestate.hh"
 #include "iplayer.hh"
 #include "pawn.hh"
+#include "pawnrouter.hh"
 
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 /**
  * @file
@@ -20,6 +26,16 @@
 namespace Common {
 
 using SpinnerLayout = std::map<std::string, std::map<std::string,unsigned>>;
+
+/**
+ * @brief One pawn move asked about with IGameRunner::checkPawnMovements.
+ */
+struct PawnMoveQuery {
+    CubeCoordinate origin;
+    CubeCoordinate target;
+    int pawnId;
+};
+
 /**
  * @brief Offers an interface, which is used to control the game logic.
  */
@@ -129,6 +145,85 @@ public:
                                   Common::CubeCoordinate target,
                                   int pawnId) = 0;
 
+    /**
+     * @brief findPawnRoute finds a shortest route a pawn can walk from
+     * origin to target.
+     * @details The route follows the rules of checkPawnMovement: it goes
+     * over land hexes that are not full, and the target must not be full.
+     * The pawn may start on water and the route may end on water. The
+     * actions left are not checked, so the route can take several turns.
+     * Queries from the same origin continue the same search until the
+     * board changes.
+     * @param origin The hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @return The hexes of the route, origin first and target last, or an
+     * empty vector if there is no route.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<CubeCoordinate> findPawnRoute(
+            CubeCoordinate origin, CubeCoordinate target) = 0;
+
+    /**
+     * @brief checkPawnMovements answers many checkPawnMovement questions at
+     * once.
+     * @details Queries about the same pawn share one route search, in
+     * whatever order they are given, so asking about all targets of a pawn
+     * costs about one search.
+     * @param queries The moves.
+     * @param count Number of queries.
+     * @param movesLeft Buffer of count results, the result of each query is
+     * written to the same position: as returned by checkPawnMovement.
+     * @post Exception quarantee: basic
+     */
+    virtual void checkPawnMovements(const PawnMoveQuery* queries,
+                                    std::size_t count,
+                                    int* movesLeft) = 0;
+
+    /**
+     * @brief findReachableHexes finds every hex some pawn of a player can
+     * walk to, the actions it takes and the pawn that gets there first.
+     * @details The walks follow the rules of checkPawnMovement and are
+     * searched from all the pawns at once. A pawn in water swims to a
+     * neighbouring hex with a whole turn of actions and may walk on from
+     * there. Use the actions left of the player for this turn, or more to
+     * see further.
+     * @param playerId The identifier of the player.
+     * @param maxActions Hexes that take more actions are left out.
+     * @return The hexes in order of the actions needed, the hexes of the
+     * pawns first with no actions.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<PawnReach> findReachableHexes(
+            int playerId, unsigned int maxActions) const = 0;
+
+    /**
+     * @brief findPawnMoves lists the hexes a pawn can move to with the
+     * actions its player has left.
+     * @details These are the targets checkPawnMovement accepts, except the
+     * hex the pawn is on. They are found on the bitboard of the game, a
+     * few shifts of the whole board per action.
+     * @param origin The hex the pawn is on.
+     * @param pawnId The identifier of the pawn.
+     * @return The hexes in increasing z, then x, or an empty vector if the
+     * pawn is not on origin or its player is not in turn.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<CubeCoordinate> findPawnMoves(
+            CubeCoordinate origin, int pawnId) const = 0;
+
+    /**
+     * @brief isConnectedOverLand tells if two hexes are in the same region
+     * of land, however the pawns stand.
+     * @details The regions are kept up to date as tiles sink, so the answer
+     * takes no search.
+     * @param first A hex.
+     * @param second Another hex.
+     * @return False if either hex is water or does not exist.
+     * @post Exception quarantee: nothrow
+     */
+    virtual bool isConnectedOverLand(CubeCoordinate first,
+                                     CubeCoordinate second) const = 0;
+
     /**
      * @brief checkActorMovement tells if the move is possible.
      * @details Actor move is illegal, if one of the following holds:\n
@@ -167,6 +262,36 @@ public:
                                     Common::CubeCoordinate target,
                                     int transportId,
                                     std::string moves) = 0;
+
+    /**
+     * @brief findActorMoves lists the hexes an actor can move to.
+     * @details These are the targets checkActorMovement accepts. The water
+     * hexes in range are found from the whole board at once, several hexes
+     * at a time.
+     * @param origin The hex the actor is on.
+     * @param actorId The identifier of the actor.
+     * @param moves The moves the wheel gave, a number or "D".
+     * @return The hexes in the order they were added to the board, or an
+     * empty vector if the actor is not on origin.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<CubeCoordinate> findActorMoves(
+            CubeCoordinate origin, int actorId, std::string moves) = 0;
+
+    /**
+     * @brief findTransportMoves lists the hexes a transport can move to.
+     * @details These are the targets checkTransportMovement accepts, found
+     * like in findActorMoves.
+     * @param origin The hex the transport is on.
+     * @param transportId The identifier of the transport.
+     * @param moves The moves the wheel gave, a number or "D".
+     * @return The hexes in the order they were added to the board, or an
+     * empty vector if the transport is not on origin or the current player
+     * may not move it.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<CubeCoordinate> findTransportMoves(
+            CubeCoordinate origin, int transportId, std::string moves) = 0;
     /**
      * @brief flipTile sinks the tile if possible and tells the actor on the bottom of the tile.
      * @param tileCoord Coordinate of the selected tile.
@@ -178,6 +303,16 @@ public:
      */
     virtual std::string flipTile(CubeCoordinate tileCoord) = 0;
 
+    /**
+     * @brief getFlippableTiles tells which tiles can be flipped right now.
+     * @details These are the tiles of the terrain type that sinks next, i.e.
+     * exactly the tiles flipTile() accepts.
+     * @return Coordinates of the flippable tiles in no particular order.
+     * Empty if no tile can be flipped.
+     * @post Exception quarantee: strong
+     */
+    virtual std::vector<CubeCoordinate> getFlippableTiles() const = 0;
+
     /**
      * @brief spinWheel decide and report which "animal" moves and how much it
      * moves.
@@ -229,6 +364,38 @@ public:
      */
     virtual Common::GamePhase currentGamePhase() const = 0;
 
+    /**
+     * @brief getJournal returns the journal the game is recorded to.
+     * @details The journal listens to getEvents(), so everything published
+     * there is recorded.
+     * @return The journal of the game.
+     * @post Exception quarantee: nothrow
+     */
+    virtual std::shared_ptr<GameJournal> getJournal() const = 0;
+
+    /**
+     * @brief getEvents returns the publisher of the changes of the game.
+     * @details The game runner publishes the changes it makes to the board
+     * and the wheel. Changes made directly to the board or the game state by
+     * the caller, like adding pawns or removing eaten ones, are published
+     * by the board, which the game runner gives the publisher (see
+     * IGameBoard::setEventPublisher), and by a game state that is given it.
+     * @return The publisher of the game.
+     * @post Exception quarantee: nothrow
+     */
+    virtual std::shared_ptr<GameEventPublisher> getEvents() const = 0;
+
+    /**
+     * @brief saveGame saves the complete state of the game: the board and
+     * everything on it, the players, the game phase, the sinking order and
+     * the state of the random number generator.
+     * @param filePath Path of the save file, an existing file is replaced.
+     * @exception IoException The file could not be written.
+     * @post The game can be continued with Initialization::loadGameRunner().
+     * @post Exception quarantee: strong
+     */
+    virtual void saveGame(const std::string& filePath) const = 0;
+
 
 
 };
@@ -1,4 +1,5 @@
 #include "initialize.hh"
+#include "arena.hh"
 #include "gameengine.hh"
 #include "hex.hh"
 
@@ -12,50 +13,77 @@
 namespace Common {
 namespace Initialization {
 
-std::shared_ptr<IGameRunner> getGameRunner(std::shared_ptr<IGameBoard> boardPtr,
-                                           std::shared_ptr<IGameState> statePtr,
-                                           std::vector<std::shared_ptr<IPlayer>> playerVector)
+void addDefaultTypes()
 {
-
     auto& actorFactory = Logic::ActorFactory::getInstance();
     actorFactory.addActor("shark",
                           [=] (int id) -> std::shared_ptr<Actor>
     {
-        return std::make_shared<Shark>(id);
+        return makePooled<Shark>(ArenaScope::current(), id);
     });
     actorFactory.addActor("kraken",
                           [=] (int id) -> std::shared_ptr<Actor>
     {
-        return std::make_shared<Kraken>(id);
+        return makePooled<Kraken>(ArenaScope::current(), id);
     });
     actorFactory.addActor("seamunster",
                           [=] (int id) -> std::shared_ptr<Actor>
     {
-        return std::make_shared<Seamunster>(id);
+        return makePooled<Seamunster>(ArenaScope::current(), id);
     });
     actorFactory.addActor("vortex",
                           [=] (int id) -> std::shared_ptr<Actor>
     {
-        return std::make_shared<Vortex>(id);
+        return makePooled<Vortex>(ArenaScope::current(), id);
     });
 
     auto& transportFactory = Logic::TransportFactory::getInstance();
     transportFactory.addTransport("boat",
                                   [=] (int id) -> std::shared_ptr<Transport>
     {
-        return std::make_shared<Boat>(id);
+        return makePooled<Boat>(ArenaScope::current(), id);
     });
     transportFactory.addTransport("dolphin",
                                   [=] (int id) -> std::shared_ptr<Transport>
     {
-        return std::make_shared<Dolphin>(id);
+        return makePooled<Dolphin>(ArenaScope::current(), id);
     });
+}
+
+std::shared_ptr<IGameRunner> getGameRunner(std::shared_ptr<IGameBoard> boardPtr,
+                                           std::shared_ptr<IGameState> statePtr,
+                                           std::vector<std::shared_ptr<IPlayer>> playerVector)
+{
+    addDefaultTypes();
 
     std::shared_ptr <Logic::GameEngine> runner =
             std::make_shared<Logic::GameEngine>(boardPtr, statePtr, playerVector);
     return runner;
 
 }
+
+std::shared_ptr<IGameRunner> getGameRunner(std::shared_ptr<IGameBoard> boardPtr,
+                                           std::shared_ptr<IGameState> statePtr,
+                                           std::vector<std::shared_ptr<IPlayer>> playerVector,
+                                           std::uint32_t seed)
+{
+    addDefaultTypes();
+
+    return std::make_shared<Logic::GameEngine>(boardPtr, statePtr,
+                                               playerVector, seed);
+}
+
+std::shared_ptr<IGameRunner> loadGameRunner(std::shared_ptr<IGameBoard> boardPtr,
+                                            std::shared_ptr<IGameState> statePtr,
+                                            std::vector<std::shared_ptr<IPlayer>> playerVector,
+                                            const SaveFile& save)
+{
+    addDefaultTypes();
+
+    return std::make_shared<Logic::GameEngine>(boardPtr, statePtr,
+                                               playerVector, save);
+}
+
 void addNewActorType(std::string typeName, Logic::ActorBuildFunction buildFunction)
 {
     Logic::ActorFactory::getInstance().addActor(typeName, buildFunction);
@@ -7,7 +7,9 @@
 #include "iplayer.hh"
 #include "actorfactory.hh"
 #include "transportfactory.hh"
+#include "savefile.hh"
 
+#include <cstdint>
 #include <memory>
 
 /**
@@ -40,6 +42,50 @@ std::shared_ptr<IGameRunner> getGameRunner(std::shared_ptr<IGameBoard> boardPtr,
                                            std::shared_ptr<IGameState> statePtr,
                                            std::vector<std::shared_ptr<IPlayer>> playerVector);
 
+/**
+ * @brief getGameRunner Creates a game runner whose random events are
+ * generated from the given seed, e.g. to replay a recorded game.
+ * @param boardPtr Shared pointer to the game board.
+ * @param statePtr Shared pointer to the game state.
+ * @param playerVector Vector that contains players.
+ * @param seed Seed of the random number generator (GameJournal::seed()).
+ * @exception IOException Could not open file Assets/actors.json or Assets/pieces.json for reading.
+ * @exception FormatException Format of file Assets/actors.json or Assets/pieces.json is invalid.
+ * @return Created instance of IGameRunner.
+ * @post GameBoard added
+ */
+std::shared_ptr<IGameRunner> getGameRunner(std::shared_ptr<IGameBoard> boardPtr,
+                                           std::shared_ptr<IGameState> statePtr,
+                                           std::vector<std::shared_ptr<IPlayer>> playerVector,
+                                           std::uint32_t seed);
+
+/**
+ * @brief loadGameRunner Creates a game runner that continues a saved game.
+ * @details The board is rebuilt straight from the save file, no JSON files
+ * are read. Create the players from SaveFile::players() first.
+ * @param boardPtr Shared pointer to an empty game board.
+ * @param statePtr Shared pointer to the game state.
+ * @param playerVector The players of the saved game.
+ * @param save The saved game.
+ * @exception FormatException The players do not match the save or the save
+ * is corrupt.
+ * @return Created instance of IGameRunner.
+ * @post The board, game state and players are as they were when the game
+ * was saved. The journal of the runner starts empty.
+ */
+std::shared_ptr<IGameRunner> loadGameRunner(std::shared_ptr<IGameBoard> boardPtr,
+                                            std::shared_ptr<IGameState> statePtr,
+                                            std::vector<std::shared_ptr<IPlayer>> playerVector,
+                                            const SaveFile& save);
+
+/**
+ * @brief addDefaultTypes registers the actor and transport types of the
+ * base game to the factories.
+ * @note getGameRunner calls this. It is needed separately only when a game
+ * is rebuilt without a game runner, e.g. by JournalReplayer.
+ */
+void addDefaultTypes();
+
 /**
  * @brief addNewActorType registers a new actor type to game
  * @param typeName Name of the new actor type
@@ -0,0 +1,165 @@
+#include "journalreplayer.hh"
+#include "actorfactory.hh"
+#include "formatexception.hh"
+#include "hex.hh"
+#include "transportfactory.hh"
+
+namespace Common {
+
+JournalReplayer::JournalReplayer(std::shared_ptr<IGameBoard> board,
+                                 std::shared_ptr<IGameState> state):
+    board_(board),
+    state_(state),
+    arena_(std::make_shared<Arena>())
+{
+}
+
+void JournalReplayer::apply(const JournalEvent& event)
+{
+    ArenaScope arenaScope(arena_);
+
+    switch (event.type) {
+    case JournalEventType::HEX_ADD:
+        addHex(event.target, *event.name);
+        break;
+
+    case JournalEventType::PAWN_ADD:
+        board_->addPawn(event.other, event.id, event.target);
+        break;
+
+    case JournalEventType::PAWN_MOVE: {
+        std::shared_ptr<Pawn> pawn = hexAt(event.origin)->givePawn(event.id);
+        if (pawn == nullptr) {
+            throw FormatException("Journal moves a pawn that is not there");
+        }
+        std::shared_ptr<Transport> carrier = pawn->getTransport();
+        if (carrier != nullptr) {
+            carrier->removePawn(pawn);
+        }
+        board_->movePawn(event.id, event.target);
+        break;
+    }
+
+    case JournalEventType::PAWN_REMOVE:
+        board_->removePawn(event.id);
+        break;
+
+    case JournalEventType::PAWN_BOARD: {
+        std::shared_ptr<Hex> hex = hexAt(event.target);
+        std::shared_ptr<Pawn> pawn = hex->givePawn(event.id);
+        std::shared_ptr<Transport> transport = hex->giveTransport(event.other);
+        if (pawn == nullptr || transport == nullptr) {
+            throw FormatException("Journal boards a pawn that is not there");
+        }
+        transport->addPawn(pawn);
+        break;
+    }
+
+    case JournalEventType::ACTOR_MOVE:
+        board_->moveActor(event.id, event.target);
+        break;
+
+    case JournalEventType::ACTOR_REMOVE:
+        board_->removeActor(event.id);
+        break;
+
+    case JournalEventType::TRANSPORT_ADD:
+        board_->addTransport(Logic::TransportFactory::getInstance()
+                             .createTransport(*event.name, event.id),
+                             event.target);
+        break;
+
+    case JournalEventType::TRANSPORT_MOVE:
+        board_->moveTransport(event.id, event.target);
+        break;
+
+    case JournalEventType::TRANSPORT_REMOVE:
+    case JournalEventType::TRANSPORT_UNLOAD: {
+        std::shared_ptr<Transport> transport =
+                hexAt(event.target)->giveTransport(event.id);
+        if (transport == nullptr) {
+            throw FormatException("Journal refers to a transport that is not "
+                                  "there");
+        }
+        transport->removePawns();
+        if (event.type == JournalEventType::TRANSPORT_REMOVE) {
+            board_->removeTransport(event.id);
+        }
+        break;
+    }
+
+    case JournalEventType::FLIP_ACTOR:
+    case JournalEventType::FLIP_TRANSPORT: {
+        changePhase(GamePhase::SINKING);
+        std::shared_ptr<Hex> hex = hexAt(event.target);
+        if (event.type == JournalEventType::FLIP_TRANSPORT) {
+            board_->addTransport(Logic::TransportFactory::getInstance()
+                                 .createTransport(*event.name, event.id),
+                                 event.target);
+        } else {
+            board_->addActor(Logic::ActorFactory::getInstance()
+                             .createActor(*event.name, event.id),
+                             event.target);
+        }
+        hex->setPieceType("Water");
+        break;
+    }
+
+    case JournalEventType::SPIN:
+        changePhase(GamePhase::SPINNING);
+        break;
+
+    case JournalEventType::TURN_CHANGE:
+        if (state_ != nullptr) {
+            state_->changePlayerTurn(event.other);
+        }
+        break;
+    }
+}
+
+std::size_t JournalReplayer::replay(JournalReader& reader)
+{
+    std::size_t applied = 0;
+    JournalEvent event;
+    while (reader.next(event)) {
+        apply(event);
+        ++applied;
+    }
+    return applied;
+}
+
+std::shared_ptr<Hex> JournalReplayer::hexAt(CubeCoordinate coord) const
+{
+    std::shared_ptr<Hex> hex = board_->getHex(coord);
+    if (hex == nullptr) {
+        throw FormatException("Journal refers to a hex that is not on the "
+                              "board");
+    }
+    return hex;
+}
+
+void JournalReplayer::addHex(CubeCoordinate coord,
+                             const std::string& pieceType)
+{
+    std::shared_ptr<Hex> newHex = makePooled<Hex>(arena_);
+    newHex->setCoordinates(coord);
+    newHex->setPieceType(pieceType);
+
+    for (const CubeCoordinate& neighbourCoord : newHex->getNeighbourVector()) {
+        std::shared_ptr<Hex> neighbourHex = board_->getHex(neighbourCoord);
+        if (neighbourHex != nullptr) {
+            newHex->addNeighbour(neighbourHex);
+            neighbourHex->addNeighbour(newHex);
+        }
+    }
+    board_->addHex(newHex);
+}
+
+void JournalReplayer::changePhase(GamePhase phase)
+{
+    if (state_ != nullptr) {
+        state_->changeGamePhase(phase);
+    }
+}
+
+}
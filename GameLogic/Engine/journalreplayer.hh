@@ -0,0 +1,75 @@
+#ifndef JOURNALREPLAYER_HH
+#define JOURNALREPLAYER_HH
+
+#include "arena.hh"
+#include "gamejournal.hh"
+#include "igameboard.hh"
+#include "igamestate.hh"
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file
+ * @brief Rebuilds a game from a GameJournal.
+ */
+
+namespace Common {
+
+/**
+ * @brief JournalReplayer applies the events of a journal to a game board.
+ * @details The replayer works on the board directly and does not check the
+ * rules, which were already checked when the game was recorded. Random
+ * results are taken from the journal, so no game runner is needed.
+ * Spawned actors and transports are created through the factories with their
+ * recorded ids, so the actor and transport types of the recorded game must be
+ * registered first (Initialization::addDefaultTypes()).
+ */
+class JournalReplayer {
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param board The board to rebuild the game on, normally empty.
+     * @param state Game state that follows the turns and phases of the
+     * journal, may be nullptr.
+     */
+    explicit JournalReplayer(std::shared_ptr<IGameBoard> board,
+                             std::shared_ptr<IGameState> state = nullptr);
+
+    /**
+     * @brief apply applies a single event to the board.
+     * @param event The event.
+     * @exception FormatException The event refers to a hex or an object that
+     * is not on the board.
+     * @post Exception quarantee: basic
+     */
+    void apply(const JournalEvent& event);
+
+    /**
+     * @brief replay applies all remaining events of a journal.
+     * @param reader Reader of the journal.
+     * @return Number of events applied.
+     * @exception FormatException The journal is corrupt or does not match
+     * the board.
+     * @post Exception quarantee: basic
+     */
+    std::size_t replay(JournalReader& reader);
+
+private:
+
+    std::shared_ptr<Hex> hexAt(CubeCoordinate coord) const;
+    void addHex(CubeCoordinate coord, const std::string& pieceType);
+    void changePhase(GamePhase phase);
+
+    std::shared_ptr<IGameBoard> board_;
+    std::shared_ptr<IGameState> state_;
+
+    //! Storage for the hexes, actors and transports of the replayed game.
+    std::shared_ptr<Arena> arena_;
+};
+
+}
+
+#endif // JOURNALREPLAYER_HH
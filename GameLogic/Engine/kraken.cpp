@@ -9,7 +9,7 @@ Kraken::Kraken(int typeId):Actor(typeId)
 
 void Kraken::doAction()
 {
-    hex_->clearTransports();
+    getHex()->clearTransports();
 }
 
 std::string Kraken::getActorType() const
@@ -0,0 +1,307 @@
+#include "landcomponents.hh"
+#include "trace.hh"
+
+#include <utility>
+
+namespace Common {
+
+namespace {
+
+// x and z steps to the six neighbours, the opposite of side i is side i + 3
+const int SIDES[6][2] = {{1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1}};
+
+// y follows from x and z
+std::uint64_t keyOf(int x, int z)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+            static_cast<std::uint32_t>(z);
+}
+
+}
+
+const int LandComponents::NONE;
+
+LandComponents::LandComponents():
+    indices_(),
+    neighbours_(),
+    land_(),
+    labels_(),
+    parents_(),
+    ranks_(),
+    stamps_(),
+    // hexes start with stamp 0, which no search uses
+    stamp_(1),
+    regions_(0)
+{
+}
+
+void LandComponents::addHex(CubeCoordinate coord, bool land)
+{
+    int index = indexOf(coord);
+    if (index == NONE) {
+        index = static_cast<int>(neighbours_.size());
+        std::array<int, 6> sides;
+        for (int side = 0; side < 6; ++side) {
+            auto found = indices_.find(keyOf(coord.x + SIDES[side][0],
+                                             coord.z + SIDES[side][1]));
+            sides[side] = found == indices_.end() ? NONE : found->second;
+        }
+        indices_.insert({keyOf(coord.x, coord.z), index});
+        neighbours_.push_back(sides);
+        land_.push_back(false);
+        labels_.push_back(NONE);
+        stamps_.push_back(0);
+        for (int side = 0; side < 6; ++side) {
+            if (sides[side] != NONE) {
+                neighbours_[sides[side]][(side + 3) % 6] = index;
+            }
+        }
+    }
+
+    if (!land) {
+        sink(coord);
+        return;
+    }
+    if (land_[index]) {
+        return;
+    }
+    land_[index] = true;
+    labels_[index] = newLabel();
+    ++regions_;
+    for (int neighbour : neighbours_[index]) {
+        if (isLand(neighbour)) {
+            unite(labels_[index], labels_[neighbour]);
+        }
+    }
+}
+
+void LandComponents::sink(CubeCoordinate coord)
+{
+    TRACE_SCOPE("LandComponents::sink");
+
+    int index = indexOf(coord);
+    if (index == NONE || !land_[index]) {
+        return;
+    }
+    land_[index] = false;
+    labels_[index] = NONE;
+
+    // Land neighbours next to each other around the hex stay connected, so
+    // only one neighbour of each unbroken arc of land needs to be searched
+    // from.
+    const std::array<int, 6>& sides = neighbours_[index];
+    std::vector<int> starts;
+    for (int side = 0; side < 6; ++side) {
+        int previous = sides[(side + 5) % 6];
+        if (isLand(sides[side]) && !isLand(previous)) {
+            starts.push_back(sides[side]);
+        }
+    }
+    if (starts.empty()) {
+        if (isLand(sides[0])) {
+            // land all around
+            return;
+        }
+        --regions_;
+        return;
+    }
+    if (starts.size() > 1) {
+        separate(starts);
+    }
+}
+
+bool LandComponents::connected(CubeCoordinate first,
+                               CubeCoordinate second) const
+{
+    int firstIndex = indexOf(first);
+    int secondIndex = indexOf(second);
+    if (firstIndex == NONE || secondIndex == NONE ||
+            !land_[firstIndex] || !land_[secondIndex]) {
+        return false;
+    }
+    return regionOf(firstIndex) == regionOf(secondIndex);
+}
+
+bool LandComponents::reachable(CubeCoordinate origin,
+                               CubeCoordinate target) const
+{
+    int originIndex = indexOf(origin);
+    int targetIndex = indexOf(target);
+    if (originIndex == NONE || targetIndex == NONE || !land_[originIndex]) {
+        return false;
+    }
+
+    int region = regionOf(originIndex);
+    if (land_[targetIndex]) {
+        return regionOf(targetIndex) == region;
+    }
+    for (int neighbour : neighbours_[targetIndex]) {
+        if (isLand(neighbour) && regionOf(neighbour) == region) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t LandComponents::regions() const
+{
+    return regions_;
+}
+
+void LandComponents::clear()
+{
+    indices_.clear();
+    neighbours_.clear();
+    land_.clear();
+    labels_.clear();
+    parents_.clear();
+    ranks_.clear();
+    stamps_.clear();
+    stamp_ = 1;
+    regions_ = 0;
+}
+
+int LandComponents::indexOf(CubeCoordinate coord) const
+{
+    auto found = indices_.find(keyOf(coord.x, coord.z));
+    return found == indices_.end() ? NONE : found->second;
+}
+
+int LandComponents::newLabel()
+{
+    int label = static_cast<int>(parents_.size());
+    parents_.push_back(label);
+    ranks_.push_back(0);
+    return label;
+}
+
+int LandComponents::find(int label) const
+{
+    while (parents_[label] != label) {
+        parents_[label] = parents_[parents_[label]];
+        label = parents_[label];
+    }
+    return label;
+}
+
+int LandComponents::regionOf(int index) const
+{
+    return find(labels_[index]);
+}
+
+void LandComponents::unite(int first, int second)
+{
+    first = find(first);
+    second = find(second);
+    if (first == second) {
+        return;
+    }
+    if (ranks_[first] < ranks_[second]) {
+        std::swap(first, second);
+    }
+    parents_[second] = first;
+    if (ranks_[first] == ranks_[second]) {
+        ++ranks_[first];
+    }
+    --regions_;
+}
+
+bool LandComponents::isLand(int index) const
+{
+    return index != NONE && land_[index];
+}
+
+void LandComponents::separate(const std::vector<int>& starts)
+{
+    // One search from each start, taking turns one hex at a time. Searches
+    // that meet are in the same region and form a group. A group that runs
+    // out of hexes is a region of its own and is labelled again. When at
+    // most one group is left searching, the rest of the old region is what
+    // it would find, and that keeps the old labels. So the cost is the size
+    // of the regions that break off, not the size of the island.
+    std::size_t count = starts.size();
+    std::uint32_t base = stamp_;
+    stamp_ += static_cast<std::uint32_t>(count);
+
+    std::vector<std::vector<int>> found(count);
+    std::vector<std::size_t> next(count, 0);
+    std::vector<std::size_t> group(count);
+    std::vector<bool> closed(count, false);
+    for (std::size_t search = 0; search < count; ++search) {
+        found[search].push_back(starts[search]);
+        stamps_[starts[search]] = base + static_cast<std::uint32_t>(search);
+        group[search] = search;
+    }
+    auto groupOf = [&group](std::size_t search) {
+        while (group[search] != search) {
+            search = group[search];
+        }
+        return search;
+    };
+
+    std::size_t open = count;
+    while (open > 1) {
+        for (std::size_t search = 0; search < count; ++search) {
+            if (next[search] == found[search].size()) {
+                continue;
+            }
+            int index = found[search][next[search]++];
+            for (int neighbour : neighbours_[index]) {
+                if (!isLand(neighbour)) {
+                    continue;
+                }
+                std::uint32_t stamp = stamps_[neighbour];
+                if (stamp >= base && stamp < stamp_) {
+                    std::size_t mine = groupOf(search);
+                    std::size_t theirs = groupOf(stamp - base);
+                    if (mine != theirs) {
+                        group[theirs] = mine;
+                        --open;
+                    }
+                    continue;
+                }
+                stamps_[neighbour] = base + static_cast<std::uint32_t>(search);
+                found[search].push_back(neighbour);
+            }
+        }
+
+        // groups that have nothing left to search are complete regions
+        std::vector<bool> searching(count, false);
+        for (std::size_t search = 0; search < count; ++search) {
+            if (next[search] < found[search].size()) {
+                searching[groupOf(search)] = true;
+            }
+        }
+        for (std::size_t search = 0; search < count; ++search) {
+            if (group[search] == search && !closed[search] &&
+                    !searching[search]) {
+                closed[search] = true;
+                --open;
+            }
+        }
+    }
+
+    // the old region counted once, now each closed group and the one still
+    // searching are regions
+    --regions_;
+    if (open == 1) {
+        ++regions_;
+    }
+    for (std::size_t search = 0; search < count; ++search) {
+        if (group[search] != search || !closed[search]) {
+            continue;
+        }
+        int label = newLabel();
+        for (std::size_t member = 0; member < count; ++member) {
+            if (groupOf(member) != search) {
+                continue;
+            }
+            for (int index : found[member]) {
+                labels_[index] = label;
+            }
+        }
+        ++regions_;
+    }
+}
+
+}
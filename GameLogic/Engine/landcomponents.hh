@@ -0,0 +1,126 @@
+#ifndef LANDCOMPONENTS_HH
+#define LANDCOMPONENTS_HH
+
+#include "cubecoordinate.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file
+ * @brief Connected regions of land, kept up to date as the island sinks.
+ */
+
+namespace Common {
+
+/**
+ * @brief LandComponents tells which land hexes are connected to each other
+ * over land.
+ * @details The hexes are numbered densely in the order they are added, and
+ * every land hex has the label of its region. Labels that have been joined
+ * are kept in a union-find, so adding land joins the regions around it in
+ * O(α(n)). Sinking a hex can only split its own region. Searches from its
+ * land neighbours run side by side until at most one of them is still
+ * going, and the hexes of the pieces that broke off get a new label each,
+ * so sinking costs the size of those pieces. Queries are two finds,
+ * O(α(n)).
+ *
+ * Occupancy is not considered: two hexes in different regions can't be
+ * walked between however the pawns stand, which is what lets a move be
+ * rejected without searching.
+ */
+class LandComponents {
+
+public:
+
+    LandComponents();
+
+    /**
+     * @brief addHex adds a hex, or changes the terrain of one added before.
+     * @param coord The location of the hex.
+     * @param land False for water.
+     * @post Exception quarantee: basic
+     */
+    void addHex(CubeCoordinate coord, bool land);
+
+    /**
+     * @brief sink turns a land hex to water. Does nothing for water and
+     * hexes that have not been added.
+     * @param coord The location of the hex.
+     * @post Exception quarantee: basic
+     */
+    void sink(CubeCoordinate coord);
+
+    /**
+     * @brief connected tells if two land hexes are in the same region.
+     * @return False if either is water or has not been added.
+     * @post Exception quarantee: nothrow
+     */
+    bool connected(CubeCoordinate first, CubeCoordinate second) const;
+
+    /**
+     * @brief reachable tells if a pawn on land at origin could walk to target
+     * on an empty board: the target is in the region of the origin, or it
+     * is water next to the region.
+     * @param origin The land hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @post Exception quarantee: nothrow
+     */
+    bool reachable(CubeCoordinate origin, CubeCoordinate target) const;
+
+    /**
+     * @brief regions tells the number of separate regions of land.
+     * @post Exception quarantee: nothrow
+     */
+    std::size_t regions() const;
+
+    /**
+     * @brief clear forgets all hexes.
+     * @post Exception quarantee: nothrow
+     */
+    void clear();
+
+private:
+
+    //! Number of a hex that is not on the board.
+    static const int NONE = -1;
+
+    int indexOf(CubeCoordinate coord) const;
+    bool isLand(int index) const;
+    int newLabel();
+    int find(int label) const;
+    int regionOf(int index) const;
+    void unite(int first, int second);
+    void separate(const std::vector<int>& starts);
+
+    //! Number of each added hex, by x and z packed in one key.
+    std::unordered_map<std::uint64_t, int> indices_;
+
+    //! Numbers of the six neighbours of each hex, NONE where there is none.
+    std::vector<std::array<int, 6>> neighbours_;
+
+    std::vector<bool> land_;
+
+    //! Label of each land hex, NONE for water. A hex is relabelled, never
+    //! a label, when its region splits.
+    std::vector<int> labels_;
+
+    //! Union-find of the labels, parents halved on every find.
+    mutable std::vector<int> parents_;
+    std::vector<std::uint8_t> ranks_;
+
+    //! Stamp of the latest search that reached each hex, every search of
+    //! every sink has its own.
+    std::vector<std::uint32_t> stamps_;
+    //! First unused stamp.
+    std::uint32_t stamp_;
+
+    std::size_t regions_;
+};
+
+}
+
+#endif // LANDCOMPONENTS_HH
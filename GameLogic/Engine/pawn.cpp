@@ -1,4 +1,5 @@
 #include "pawn.hh"
+#include "transport.hh"
 
 namespace Common {
 
@@ -51,4 +52,19 @@ int Pawn::getId()
     return pawnId_;
 }
 
+std::shared_ptr<Transport> Pawn::getTransport() const
+{
+    return transport_.lock();
+}
+
+bool Pawn::isInTransport() const
+{
+    return !transport_.expired();
+}
+
+void Pawn::setTransport(std::shared_ptr<Transport> transport)
+{
+    transport_ = transport;
+}
+
 }
@@ -11,6 +11,9 @@
  */
 
 namespace Common {
+
+class Transport;
+
 /**
  * @brief Represents a player-owned game piece on the board
  */
@@ -71,6 +74,26 @@ public:
      */
     int getPlayerId();
 
+    /**
+     * @brief getTransport returns the transport that carries the pawn
+     * @return The transport or nullptr, if the pawn is not in a transport
+     */
+    std::shared_ptr<Common::Transport> getTransport() const;
+
+    /**
+     * @brief isInTransport tells if a transport carries the pawn
+     * @return true, if the pawn is in a transport, else false
+     * @post Exception quarantee: nothrow
+     */
+    bool isInTransport() const;
+
+    /**
+     * @brief setTransport records the transport that carries the pawn
+     * @param transport The transport or nullptr, if the pawn left it
+     * @note Maintained by Transport::addPawn, removePawn and removePawns.
+     */
+    void setTransport(std::shared_ptr<Common::Transport> transport);
+
 private:
 
     //! Cube coordinate.
@@ -80,6 +103,8 @@ private:
     int pawnId_;
     //! The identifier of the player.
     int playerId_;
+    //! The transport carrying the pawn. Not owned.
+    std::weak_ptr<Common::Transport> transport_;
 
 };
 
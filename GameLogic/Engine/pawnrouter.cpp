@@ -0,0 +1,186 @@
+#include "pawnrouter.hh"
+#include "trace.hh"
+
+#include <algorithm>
+
+namespace Common {
+
+PawnRouter::PawnRouter(std::shared_ptr<IGameBoard> board):
+    board_(board),
+    valid_(false),
+    origin_(0, 0, 0),
+    visits_(),
+    frontier_()
+{
+}
+
+std::vector<CubeCoordinate> PawnRouter::route(CubeCoordinate origin,
+                                              CubeCoordinate target)
+{
+    std::vector<CubeCoordinate> hexes;
+    const Visit* visit = reach(origin, target);
+    if (visit == nullptr) {
+        return hexes;
+    }
+
+    hexes.reserve(visit->steps + 1);
+    hexes.push_back(target);
+    while (visit->steps > 0) {
+        hexes.push_back(visit->parent);
+        visit = &visits_.at(visit->parent);
+    }
+    std::reverse(hexes.begin(), hexes.end());
+    return hexes;
+}
+
+int PawnRouter::steps(CubeCoordinate origin, CubeCoordinate target)
+{
+    const Visit* visit = reach(origin, target);
+    return visit == nullptr ? -1 : visit->steps;
+}
+
+std::vector<PawnReach> PawnRouter::reachAll(
+        const std::vector<std::pair<CubeCoordinate, int>>& pawns,
+        int maxActions) const
+{
+    TRACE_SCOPE("PawnRouter::reachAll");
+
+    // Steps cost one or SWIM_ACTIONS actions, so the hexes wait in one
+    // bucket per number of actions and are walked from in that order. A hex
+    // put in a bucket again later has been reached more cheaply since.
+    std::map<CubeCoordinate, std::size_t> best;
+    std::vector<PawnReach> reached;
+    std::vector<std::vector<std::size_t>> buckets(1);
+    for (const auto& pawn : pawns) {
+        if (board_->getHex(pawn.first) != nullptr &&
+                best.insert({pawn.first, reached.size()}).second) {
+            buckets[0].push_back(reached.size());
+            reached.push_back(PawnReach{pawn.first, 0, pawn.second});
+        }
+    }
+
+    for (std::size_t actions = 0; actions < buckets.size(); ++actions) {
+        for (std::size_t bucket = 0; bucket < buckets[actions].size();
+             ++bucket) {
+            PawnReach current = reached[buckets[actions][bucket]];
+            if (current.actions != static_cast<int>(actions)) {
+                continue;
+            }
+            std::shared_ptr<Hex> currentHex = board_->getHex(current.hex);
+            bool start = actions == 0;
+            if (!start && (currentHex->isWaterTile() ||
+                    currentHex->getPawnAmount() >= MAX_PAWNS_PER_HEX)) {
+                continue;
+            }
+            int nextActions = current.actions +
+                    (currentHex->isWaterTile() ? SWIM_ACTIONS : 1);
+            if (nextActions > maxActions) {
+                continue;
+            }
+
+            for (const CubeCoordinate& next :
+                 currentHex->getNeighbourVector()) {
+                std::shared_ptr<Hex> nextHex = board_->getHex(next);
+                if (nextHex == nullptr ||
+                        nextHex->getPawnAmount() >= MAX_PAWNS_PER_HEX) {
+                    continue;
+                }
+                auto found = best.find(next);
+                if (found != best.end() &&
+                        reached[found->second].actions <= nextActions) {
+                    continue;
+                }
+                std::size_t slot = reached.size();
+                if (found != best.end()) {
+                    slot = found->second;
+                    reached[slot] = PawnReach{next, nextActions,
+                                              current.pawnId};
+                } else {
+                    best.insert({next, slot});
+                    reached.push_back(PawnReach{next, nextActions,
+                                                current.pawnId});
+                }
+                if (buckets.size() <= static_cast<std::size_t>(nextActions)) {
+                    buckets.resize(nextActions + 1);
+                }
+                buckets[nextActions].push_back(slot);
+            }
+        }
+    }
+    TRACE_COUNTER("PawnRouter reachAll hexes", reached.size());
+
+    std::stable_sort(reached.begin(), reached.end(),
+                     [](const PawnReach& first, const PawnReach& second) {
+        return first.actions < second.actions;
+    });
+    return reached;
+}
+
+void PawnRouter::invalidate()
+{
+    valid_ = false;
+}
+
+std::size_t PawnRouter::visited() const
+{
+    return valid_ ? visits_.size() : 0;
+}
+
+const PawnRouter::Visit* PawnRouter::reach(CubeCoordinate origin,
+                                           CubeCoordinate target)
+{
+    TRACE_SCOPE("PawnRouter::reach");
+
+    std::shared_ptr<Hex> targetHex = board_->getHex(target);
+    if (targetHex == nullptr ||
+            targetHex->getPawnAmount() >= MAX_PAWNS_PER_HEX) {
+        return nullptr;
+    }
+
+    if (!valid_ || !(origin == origin_)) {
+        visits_.clear();
+        frontier_.clear();
+        origin_ = origin;
+        valid_ = true;
+        // the pawn stands on the origin, so it is left even when it is full
+        // or water
+        if (board_->getHex(origin) != nullptr) {
+            visits_.insert({origin, Visit{origin, 0}});
+            frontier_.push_back(origin);
+        }
+    }
+
+    // hexes are reached in order of their distance, so the first visit of
+    // the target is along a shortest route
+    auto found = visits_.find(target);
+    while (found == visits_.end() && !frontier_.empty()) {
+        CubeCoordinate current = frontier_.front();
+        frontier_.pop_front();
+        int steps = visits_.at(current).steps + 1;
+        std::shared_ptr<Hex> currentHex = board_->getHex(current);
+        if (currentHex == nullptr) {
+            continue;
+        }
+
+        for (const CubeCoordinate& next : currentHex->getNeighbourVector()) {
+            if (visits_.find(next) != visits_.end()) {
+                continue;
+            }
+            std::shared_ptr<Hex> nextHex = board_->getHex(next);
+            if (nextHex == nullptr) {
+                continue;
+            }
+            visits_.insert({next, Visit{current, steps}});
+            if (!nextHex->isWaterTile() &&
+                    nextHex->getPawnAmount() < MAX_PAWNS_PER_HEX) {
+                frontier_.push_back(next);
+            }
+        }
+        found = visits_.find(target);
+    }
+    TRACE_COUNTER("PawnRouter visited", visits_.size());
+
+    return found == visits_.end() ? nullptr : &found->second;
+}
+
+}
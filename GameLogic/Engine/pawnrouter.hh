@@ -0,0 +1,141 @@
+#ifndef PAWNROUTER_HH
+#define PAWNROUTER_HH
+
+#include "cubecoordinate.hh"
+#include "igameboard.hh"
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @file
+ * @brief Shortest routes of pawns over the island.
+ */
+
+namespace Common {
+
+/**
+ * @brief The cheapest way the pawns of a player get to a hex.
+ */
+struct PawnReach {
+    CubeCoordinate hex;
+    //! Actions needed to walk there, see PawnRouter::reachAll.
+    int actions;
+    //! The pawn that needs the fewest actions.
+    int pawnId;
+};
+
+/**
+ * @brief PawnRouter finds the shortest routes a pawn can walk on a board.
+ * @details A pawn walks from hex to neighbouring hex over land that is not
+ * full. It may start on water, when it swims ashore, and it may end its
+ * route on water or on any other hex that is not full.
+ *
+ * The router keeps the breadth first search of the latest origin and
+ * continues it only as far as each query needs, so consecutive queries from
+ * the same origin, like the targets of one selected pawn, cost one search
+ * together. The search has to be invalidated whenever pawns or hexes of the
+ * board change.
+ */
+class PawnRouter {
+
+public:
+
+    //! Rule for max pawns per hex, a full hex is neither walked over nor
+    //! entered.
+    static const int MAX_PAWNS_PER_HEX = 3;
+
+    //! A pawn in water moves one hex with a whole turn of actions.
+    static const int SWIM_ACTIONS = 3;
+
+    /**
+     * @brief Constructor.
+     * @param board The board the routes are searched on.
+     */
+    explicit PawnRouter(std::shared_ptr<IGameBoard> board);
+
+    /**
+     * @brief route finds a shortest route from origin to target. The number
+     * of steps is not limited, so the route may take several turns.
+     * @param origin The hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @return The hexes of the route, origin first and target last, or an
+     * empty vector if either hex does not exist, the target is full or
+     * there is no route.
+     * @post Exception quarantee: basic
+     */
+    std::vector<CubeCoordinate> route(CubeCoordinate origin,
+                                      CubeCoordinate target);
+
+    /**
+     * @brief steps tells the length of a shortest route from origin to
+     * target.
+     * @param origin The hex the pawn starts from.
+     * @param target The hex the pawn walks to.
+     * @return Number of steps, or -1 if route would return no route.
+     * @post Exception quarantee: basic
+     */
+    int steps(CubeCoordinate origin, CubeCoordinate target);
+
+    /**
+     * @brief reachAll finds every hex some of the pawns can walk to, in one
+     * search started from all of them at once.
+     * @details A step over land takes one action, so on land the actions
+     * are the length of the route, which is what
+     * IGameRunner::checkPawnMovement compares to the actions left. A pawn
+     * in water swims to a neighbouring hex with SWIM_ACTIONS actions and
+     * walks on from there. The search of route() is not touched.
+     * @param pawns The location and id of each pawn.
+     * @param maxActions Hexes that take more actions are left out.
+     * @return The hexes in order of the actions needed, the hexes of the
+     * pawns first with no actions.
+     * @post Exception quarantee: strong
+     */
+    std::vector<PawnReach> reachAll(
+            const std::vector<std::pair<CubeCoordinate, int>>& pawns,
+            int maxActions) const;
+
+    /**
+     * @brief invalidate drops the search, the next query starts anew.
+     * @post Exception quarantee: nothrow
+     */
+    void invalidate();
+
+    /**
+     * @brief visited tells how many hexes the current search has reached.
+     * @post Exception quarantee: nothrow
+     */
+    std::size_t visited() const;
+
+private:
+
+    //! How a hex was reached.
+    struct Visit {
+        CubeCoordinate parent;
+        int steps;
+    };
+
+    // Continues the search from origin until target is reached or there is
+    // nothing left to visit. Returns the visit of the target or nullptr.
+    const Visit* reach(CubeCoordinate origin, CubeCoordinate target);
+
+    std::shared_ptr<IGameBoard> board_;
+
+    //! True when visits_ and frontier_ belong to origin_.
+    bool valid_;
+    CubeCoordinate origin_;
+
+    //! Every hex reached so far.
+    std::map<CubeCoordinate, Visit> visits_;
+
+    //! Reached hexes that have not been walked from yet, nearest first.
+    std::deque<CubeCoordinate> frontier_;
+};
+
+}
+
+#endif // PAWNROUTER_HH
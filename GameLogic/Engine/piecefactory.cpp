@@ -35,6 +35,7 @@ void PieceFactory::readJSON()
         throw Common::FormatException("JSON parsing failed for input file");
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
     json_ = json.object();
 
 }
@@ -43,6 +44,7 @@ std::vector<std::pair<std::string,int>> PieceFactory::getGamePieces() const
 {
 
     std::vector<std::pair<std::string,int>> gamePieces;
+    std::lock_guard<std::mutex> lock(mutex_);
     QJsonArray common = json_["Common"].toArray();
     for (int i = 0; i < common.size(); ++i) {
         auto piecesData = std::make_pair(common[i].toObject().value("name").toString().toStdString(),common[i].toObject().value("layers").toInt());
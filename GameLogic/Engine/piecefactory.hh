@@ -2,6 +2,7 @@
 #define PIECEFACTORY_HH
 
 #include <QJsonObject>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,8 @@ class PieceFactory {
     PieceFactory();
 
     QJsonObject json_;
+    //! Games may run in several threads, e.g. in the game server.
+    mutable std::mutex mutex_;
 
 };
 
@@ -0,0 +1,89 @@
+#include "playertable.hh"
+
+#include <stdexcept>
+#include <string>
+
+namespace Common {
+
+PlayerTable::PlayerTable():
+    rows_(),
+    size_(0)
+{
+}
+
+PlayerRecord& PlayerTable::addPlayer(int playerId, unsigned int pawns,
+                                     unsigned int actionsLeft)
+{
+    if (playerId < 0 || find(playerId) != nullptr) {
+        throw std::invalid_argument("PlayerTable: invalid or duplicate "
+                                    "player id " + std::to_string(playerId));
+    }
+
+    std::size_t row = static_cast<std::size_t>(playerId);
+    if (rows_.size() <= row) {
+        rows_.resize(row + 1, PlayerRecord{-1, 0, 0, 0});
+    }
+    rows_[row] = PlayerRecord{playerId, actionsLeft, pawns, 0};
+    ++size_;
+    return rows_[row];
+}
+
+PlayerRecord& PlayerTable::at(int playerId)
+{
+    PlayerRecord* record = find(playerId);
+    if (record == nullptr) {
+        throw std::out_of_range("PlayerTable: no player " +
+                                std::to_string(playerId));
+    }
+    return *record;
+}
+
+const PlayerRecord& PlayerTable::at(int playerId) const
+{
+    return const_cast<PlayerTable*>(this)->at(playerId);
+}
+
+std::size_t PlayerTable::size() const
+{
+    return size_;
+}
+
+TablePlayer::TablePlayer(std::shared_ptr<PlayerTable> table, int playerId,
+                         unsigned int pawns, unsigned int actionsLeft):
+    table_(table),
+    playerId_(playerId)
+{
+    table_->addPlayer(playerId, pawns, actionsLeft);
+}
+
+int TablePlayer::getPlayerId() const
+{
+    return playerId_;
+}
+
+void TablePlayer::setActionsLeft(unsigned int actionsLeft)
+{
+    record().actionsLeft = actionsLeft;
+}
+
+unsigned int TablePlayer::getActionsLeft() const
+{
+    return record().actionsLeft;
+}
+
+std::shared_ptr<PlayerTable> TablePlayer::getTable() const
+{
+    return table_;
+}
+
+PlayerRecord& TablePlayer::record()
+{
+    return table_->at(playerId_);
+}
+
+const PlayerRecord& TablePlayer::record() const
+{
+    return table_->at(playerId_);
+}
+
+}
@@ -0,0 +1,171 @@
+#ifndef PLAYERTABLE_HH
+#define PLAYERTABLE_HH
+
+#include "iplayer.hh"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file
+ * @brief Player state indexed by player id, and an IPlayer adapter for it.
+ */
+
+namespace Common {
+
+/**
+ * @brief State of a single player in a PlayerTable.
+ */
+struct PlayerRecord {
+    //! The identifier of the player, -1 for an unused row.
+    int id;
+    //! Actions the player has left in the current turn.
+    unsigned int actionsLeft;
+    //! Pawns the player has left in the game.
+    unsigned int pawns;
+    //! Points the player has gained.
+    unsigned int points;
+};
+
+/**
+ * @brief PlayerTable keeps the state of all players of a game in one array
+ * that is indexed directly by the player id.
+ * @details The game engine reads and writes the rows without virtual calls.
+ * Player objects handed out to the rest of the program are TablePlayer
+ * adapters that refer to a row of the table.
+ */
+class PlayerTable {
+
+public:
+
+    /**
+     * @brief Constructor, creates an empty table.
+     */
+    PlayerTable();
+
+    /**
+     * @brief addPlayer adds a row for a player.
+     * @param playerId The identifier of the player. Not negative.
+     * @param pawns Number of pawns the player starts with.
+     * @param actionsLeft Number of actions the player starts with.
+     * @return The new row.
+     * @exception std::invalid_argument playerId is negative or already in
+     * the table.
+     * @post Exception quarantee: strong
+     */
+    PlayerRecord& addPlayer(int playerId, unsigned int pawns,
+                            unsigned int actionsLeft);
+
+    /**
+     * @brief find returns the row of a player.
+     * @param playerId The identifier of the player.
+     * @return The row or nullptr, if the player is not in the table.
+     * @post Exception quarantee: nothrow
+     */
+    PlayerRecord* find(int playerId)
+    {
+        if (playerId < 0 ||
+                static_cast<std::size_t>(playerId) >= rows_.size() ||
+                rows_[playerId].id != playerId) {
+            return nullptr;
+        }
+        return &rows_[playerId];
+    }
+
+    /**
+     * @copydoc find()
+     */
+    const PlayerRecord* find(int playerId) const
+    {
+        return const_cast<PlayerTable*>(this)->find(playerId);
+    }
+
+    /**
+     * @brief at returns the row of a player.
+     * @param playerId The identifier of the player.
+     * @return The row of the player.
+     * @exception std::out_of_range The player is not in the table.
+     */
+    PlayerRecord& at(int playerId);
+
+    /**
+     * @copydoc at()
+     */
+    const PlayerRecord& at(int playerId) const;
+
+    /**
+     * @brief size returns the number of players in the table.
+     * @post Exception quarantee: nothrow
+     */
+    std::size_t size() const;
+
+private:
+
+    std::vector<PlayerRecord> rows_;
+    std::size_t size_;
+};
+
+/**
+ * @brief TablePlayer implements IPlayer on top of a row of a PlayerTable.
+ * @details All state lives in the table, so changes made through the
+ * adapter and by the game engine are seen by both.
+ */
+class TablePlayer : public IPlayer {
+
+public:
+
+    /**
+     * @brief Constructor, adds the player to the table.
+     * @param table The table of the game. Not nullptr.
+     * @param playerId The identifier of the player.
+     * @param pawns Number of pawns the player starts with.
+     * @param actionsLeft Number of actions the player starts with.
+     * @exception std::invalid_argument The player is already in the table.
+     */
+    TablePlayer(std::shared_ptr<PlayerTable> table, int playerId,
+                unsigned int pawns, unsigned int actionsLeft);
+
+    virtual ~TablePlayer() = default;
+
+    /**
+     * @copydoc Common::IPlayer::getPlayerId()
+     */
+    virtual int getPlayerId() const;
+
+    /**
+     * @copydoc Common::IPlayer::setActionsLeft()
+     */
+    virtual void setActionsLeft(unsigned int actionsLeft);
+
+    /**
+     * @copydoc Common::IPlayer::getActionsLeft()
+     */
+    virtual unsigned int getActionsLeft() const;
+
+    /**
+     * @brief getTable returns the table the player is stored in.
+     */
+    std::shared_ptr<PlayerTable> getTable() const;
+
+protected:
+
+    /**
+     * @brief record returns the row of the player.
+     */
+    PlayerRecord& record();
+
+    /**
+     * @copydoc record()
+     */
+    const PlayerRecord& record() const;
+
+private:
+
+    std::shared_ptr<PlayerTable> table_;
+    int playerId_;
+};
+
+}
+
+#endif // PLAYERTABLE_HH
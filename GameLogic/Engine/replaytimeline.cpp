@@ -0,0 +1,279 @@
+#include "replaytimeline.hh"
+#include "formatexception.hh"
+
+#include <limits>
+
+namespace Common {
+
+namespace {
+
+const std::size_t NO_HEX = std::numeric_limits<std::size_t>::max();
+
+bool isSetup(JournalEventType type)
+{
+    return type == JournalEventType::HEX_ADD ||
+            type == JournalEventType::PAWN_ADD ||
+            type == JournalEventType::TRANSPORT_ADD;
+}
+
+ReplayPiece& piece(std::map<int, ReplayPiece>& pieces, int id)
+{
+    auto found = pieces.find(id);
+    if (found == pieces.end()) {
+        throw FormatException("Journal refers to a piece that is not there");
+    }
+    return found->second;
+}
+
+bool samePlace(const ReplayPiece& first, const ReplayPiece& second)
+{
+    return first.location == second.location &&
+            first.transport == second.transport;
+}
+
+void diffPieces(const std::map<int, ReplayPiece>& from,
+                const std::map<int, ReplayPiece>& to,
+                ReplayPieceDiff& diff)
+{
+    // both maps are ordered by id, so one merge pass finds every change
+    auto old = from.begin();
+    auto now = to.begin();
+    while (old != from.end() || now != to.end()) {
+        if (now == to.end() || (old != from.end() && old->first < now->first)) {
+            diff.removed.push_back(old->first);
+            ++old;
+        } else if (old == from.end() || now->first < old->first) {
+            diff.added.push_back(now->first);
+            ++now;
+        } else {
+            if (old->second.type != now->second.type) {
+                diff.removed.push_back(old->first);
+                diff.added.push_back(now->first);
+            } else if (!samePlace(old->second, now->second)) {
+                diff.moved.push_back(now->first);
+            }
+            ++old;
+            ++now;
+        }
+    }
+}
+
+}
+
+const std::size_t ReplayTimeline::DEFAULT_KEYFRAME_INTERVAL;
+
+ReplayTimeline::ReplayTimeline(std::vector<std::uint8_t> journal,
+                               std::size_t keyframeInterval):
+    steps_(),
+    setupSteps_(0),
+    keyframeInterval_(keyframeInterval == 0 ? 1 : keyframeInterval),
+    hexCoordinates_(),
+    hexIndices_(),
+    names_(),
+    nameIndices_(),
+    water_(0),
+    keyframes_(),
+    cursor_(),
+    cursorPly_(0)
+{
+    // index 0 stands for "no type"
+    intern("");
+    water_ = intern("Water");
+
+    JournalReader reader(journal);
+    JournalEvent event;
+    bool settingUp = true;
+    while (reader.next(event)) {
+        Step step = {event.type, event.id, event.other, event.target, NO_HEX,
+                     0};
+        if (event.type == JournalEventType::HEX_ADD) {
+            auto inserted = hexIndices_.insert(
+                        {event.target, hexCoordinates_.size()});
+            if (inserted.second) {
+                hexCoordinates_.push_back(event.target);
+            }
+            step.hex = inserted.first->second;
+        } else if (event.type == JournalEventType::FLIP_ACTOR ||
+                   event.type == JournalEventType::FLIP_TRANSPORT) {
+            step.hex = hexIndex(event.target);
+        }
+        if (event.name != nullptr && event.type != JournalEventType::SPIN) {
+            step.name = intern(*event.name);
+        }
+        settingUp = settingUp && isSetup(event.type);
+        if (settingUp) {
+            ++setupSteps_;
+        }
+        steps_.push_back(step);
+    }
+
+    ReplayFrame frame;
+    frame.hexTypes.assign(hexCoordinates_.size(), 0);
+    frame.playerInTurn = 0;
+    for (std::size_t i = 0; i < setupSteps_; ++i) {
+        apply(steps_[i], frame);
+    }
+    keyframes_.reserve(plyCount() / keyframeInterval_ + 1);
+    keyframes_.push_back(frame);
+    for (std::size_t ply = 1; ply <= plyCount(); ++ply) {
+        apply(steps_[setupSteps_ + ply - 1], frame);
+        if (ply % keyframeInterval_ == 0) {
+            keyframes_.push_back(frame);
+        }
+    }
+    cursor_ = keyframes_.front();
+}
+
+std::size_t ReplayTimeline::plyCount() const
+{
+    return steps_.size() - setupSteps_;
+}
+
+std::size_t ReplayTimeline::keyframeCount() const
+{
+    return keyframes_.size();
+}
+
+const std::vector<CubeCoordinate>& ReplayTimeline::hexCoordinates() const
+{
+    return hexCoordinates_;
+}
+
+const std::string& ReplayTimeline::name(std::uint16_t index) const
+{
+    return names_.at(index);
+}
+
+const ReplayFrame& ReplayTimeline::frameAt(std::size_t ply)
+{
+    std::size_t keyframe = ply / keyframeInterval_;
+    // continue from the cursor when it is between the keyframe and the ply
+    if (cursorPly_ > ply || cursorPly_ < keyframe * keyframeInterval_) {
+        cursor_ = keyframes_.at(keyframe);
+        cursorPly_ = keyframe * keyframeInterval_;
+    }
+    for (; cursorPly_ < ply; ++cursorPly_) {
+        apply(steps_.at(setupSteps_ + cursorPly_), cursor_);
+    }
+    return cursor_;
+}
+
+ReplayDiff ReplayTimeline::diff(const ReplayFrame& from, const ReplayFrame& to)
+{
+    ReplayDiff result;
+    for (std::size_t i = 0; i < to.hexTypes.size(); ++i) {
+        if (i >= from.hexTypes.size() || from.hexTypes[i] != to.hexTypes[i]) {
+            result.hexes.push_back(i);
+        }
+    }
+    diffPieces(from.pawns, to.pawns, result.pawns);
+    diffPieces(from.actors, to.actors, result.actors);
+    diffPieces(from.transports, to.transports, result.transports);
+    return result;
+}
+
+std::uint16_t ReplayTimeline::intern(const std::string& value)
+{
+    auto found = nameIndices_.find(value);
+    if (found != nameIndices_.end()) {
+        return found->second;
+    }
+    if (names_.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw FormatException("Too many names in journal");
+    }
+    std::uint16_t index = static_cast<std::uint16_t>(names_.size());
+    names_.push_back(value);
+    nameIndices_[value] = index;
+    return index;
+}
+
+std::size_t ReplayTimeline::hexIndex(CubeCoordinate coord) const
+{
+    auto found = hexIndices_.find(coord);
+    if (found == hexIndices_.end()) {
+        throw FormatException("Journal refers to a hex that is not on the "
+                              "board");
+    }
+    return found->second;
+}
+
+void ReplayTimeline::apply(const Step& step, ReplayFrame& frame) const
+{
+    switch (step.type) {
+    case JournalEventType::HEX_ADD:
+        frame.hexTypes[step.hex] = step.name;
+        break;
+
+    case JournalEventType::PAWN_ADD:
+        frame.pawns[step.id] = {0, step.other, step.target, 0};
+        break;
+
+    case JournalEventType::PAWN_MOVE: {
+        ReplayPiece& pawn = piece(frame.pawns, step.id);
+        pawn.location = step.target;
+        pawn.transport = 0;
+        break;
+    }
+
+    case JournalEventType::PAWN_REMOVE:
+        frame.pawns.erase(step.id);
+        break;
+
+    case JournalEventType::PAWN_BOARD:
+        piece(frame.pawns, step.id).transport = step.other;
+        break;
+
+    case JournalEventType::ACTOR_MOVE:
+        piece(frame.actors, step.id).location = step.target;
+        break;
+
+    case JournalEventType::ACTOR_REMOVE:
+        frame.actors.erase(step.id);
+        break;
+
+    case JournalEventType::TRANSPORT_ADD:
+        frame.transports[step.id] = {step.name, 0, step.target, 0};
+        break;
+
+    case JournalEventType::TRANSPORT_MOVE:
+        piece(frame.transports, step.id).location = step.target;
+        // the board moves the pawns in the transport along with it
+        for (auto& pawn : frame.pawns) {
+            if (pawn.second.transport == step.id) {
+                pawn.second.location = step.target;
+            }
+        }
+        break;
+
+    case JournalEventType::TRANSPORT_REMOVE:
+    case JournalEventType::TRANSPORT_UNLOAD:
+        for (auto& pawn : frame.pawns) {
+            if (pawn.second.transport == step.id) {
+                pawn.second.transport = 0;
+            }
+        }
+        if (step.type == JournalEventType::TRANSPORT_REMOVE) {
+            frame.transports.erase(step.id);
+        }
+        break;
+
+    case JournalEventType::FLIP_ACTOR:
+        frame.actors[step.id] = {step.name, 0, step.target, 0};
+        frame.hexTypes[step.hex] = water_;
+        break;
+
+    case JournalEventType::FLIP_TRANSPORT:
+        frame.transports[step.id] = {step.name, 0, step.target, 0};
+        frame.hexTypes[step.hex] = water_;
+        break;
+
+    case JournalEventType::SPIN:
+        break;
+
+    case JournalEventType::TURN_CHANGE:
+        frame.playerInTurn = step.other;
+        break;
+    }
+}
+
+}
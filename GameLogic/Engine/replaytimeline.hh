@@ -0,0 +1,167 @@
+#ifndef REPLAYTIMELINE_HH
+#define REPLAYTIMELINE_HH
+
+#include "cubecoordinate.hh"
+#include "gamejournal.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @brief Seekable view of a recorded game.
+ */
+
+namespace Common {
+
+/**
+ * @brief A pawn, actor or transport at some point of a replay.
+ */
+struct ReplayPiece {
+    //! Type of an actor or a transport (index to ReplayTimeline::name), 0 for
+    //! pawns.
+    std::uint16_t type;
+    //! Owner of a pawn, 0 for actors and transports.
+    int player;
+    CubeCoordinate location;
+    //! Transport carrying a pawn, 0 if none.
+    int transport;
+};
+
+/**
+ * @brief Complete state of the board after some ply of a replay.
+ */
+struct ReplayFrame {
+    //! Piece type of each hex (index to ReplayTimeline::name), in the order of
+    //! ReplayTimeline::hexCoordinates. 0 if the hex is not on the board yet.
+    std::vector<std::uint16_t> hexTypes;
+    std::map<int, ReplayPiece> pawns;
+    std::map<int, ReplayPiece> actors;
+    std::map<int, ReplayPiece> transports;
+    //! Player in turn, 0 before the first turn.
+    int playerInTurn;
+};
+
+/**
+ * @brief Ids of the pieces of one kind that differ between two frames.
+ */
+struct ReplayPieceDiff {
+    std::vector<int> removed;
+    std::vector<int> added;
+    //! Pieces that changed their location or transport.
+    std::vector<int> moved;
+};
+
+/**
+ * @brief Everything that differs between two frames.
+ */
+struct ReplayDiff {
+    //! Hexes (indices to ReplayTimeline::hexCoordinates) whose type changed.
+    std::vector<std::size_t> hexes;
+    ReplayPieceDiff pawns;
+    ReplayPieceDiff actors;
+    ReplayPieceDiff transports;
+};
+
+/**
+ * @brief ReplayTimeline lets a viewer jump to any ply of a recorded game.
+ * @details The journal is decoded once. The events that set up the board
+ * (hexes, pawns and transports added before anything else happens) form
+ * ply 0, every later event is one ply. A full copy of the state is kept
+ * every keyframeInterval plies, so any ply is reached by applying at most
+ * keyframeInterval - 1 events to the nearest earlier keyframe. Stepping
+ * forward from the previous frame applies a single event.
+ */
+class ReplayTimeline {
+
+public:
+
+    //! Plies between keyframes, if not given to the constructor.
+    static const std::size_t DEFAULT_KEYFRAME_INTERVAL = 64;
+
+    /**
+     * @brief Constructor, decodes the journal and builds the keyframes.
+     * @param journal The recorded game, see GameJournal::data().
+     * @param keyframeInterval Plies between keyframes, at least 1.
+     * @exception FormatException The journal is corrupt or inconsistent.
+     */
+    explicit ReplayTimeline(std::vector<std::uint8_t> journal,
+                            std::size_t keyframeInterval =
+                                    DEFAULT_KEYFRAME_INTERVAL);
+
+    ReplayTimeline(const ReplayTimeline&) = delete;
+    ReplayTimeline& operator=(const ReplayTimeline&) = delete;
+
+    /**
+     * @brief plyCount returns the number of plies after the setup.
+     */
+    std::size_t plyCount() const;
+
+    /**
+     * @brief keyframeCount returns the number of keyframes kept.
+     */
+    std::size_t keyframeCount() const;
+
+    /**
+     * @brief hexCoordinates returns the coordinates of all hexes of the game,
+     * the hexes of a frame are in this order.
+     */
+    const std::vector<CubeCoordinate>& hexCoordinates() const;
+
+    /**
+     * @brief name returns a piece, actor or transport type by its index.
+     */
+    const std::string& name(std::uint16_t index) const;
+
+    /**
+     * @brief frameAt returns the state of the game after a ply.
+     * @param ply The ply, 0 is the state after the setup.
+     * @pre ply <= plyCount()
+     * @return The frame, valid until the next call.
+     */
+    const ReplayFrame& frameAt(std::size_t ply);
+
+    /**
+     * @brief diff lists what has to change to turn one frame into another.
+     * @param from The frame shown.
+     * @param to The frame to show.
+     */
+    static ReplayDiff diff(const ReplayFrame& from, const ReplayFrame& to);
+
+private:
+
+    //! An event with its hex and names resolved to indices.
+    struct Step {
+        JournalEventType type;
+        int id;
+        int other;
+        CubeCoordinate target;
+        std::size_t hex;
+        std::uint16_t name;
+    };
+
+    std::uint16_t intern(const std::string& value);
+    std::size_t hexIndex(CubeCoordinate coord) const;
+    void apply(const Step& step, ReplayFrame& frame) const;
+
+    std::vector<Step> steps_;
+    std::size_t setupSteps_;
+    std::size_t keyframeInterval_;
+    std::vector<CubeCoordinate> hexCoordinates_;
+    std::map<CubeCoordinate, std::size_t> hexIndices_;
+    std::vector<std::string> names_;
+    std::map<std::string, std::uint16_t> nameIndices_;
+    std::uint16_t water_;
+
+    //! keyframes_[i] is the frame after ply i * keyframeInterval_.
+    std::vector<ReplayFrame> keyframes_;
+    ReplayFrame cursor_;
+    std::size_t cursorPly_;
+};
+
+}
+
+#endif // REPLAYTIMELINE_HH
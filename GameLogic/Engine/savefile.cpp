@@ -0,0 +1,263 @@
+#include "savefile.hh"
+#include "formatexception.hh"
+#include "ioexception.hh"
+
+#include <QFile>
+#include <QString>
+
+#include <cstring>
+#include <fstream>
+
+namespace Common {
+
+namespace {
+
+const char MAGIC[4] = {'I', 'G', 'S', '\0'};
+
+//! Sections start at multiples of this, so records can be used in place.
+const std::size_t SECTION_ALIGNMENT = 8;
+
+std::size_t aligned(std::size_t offset)
+{
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT *
+            SECTION_ALIGNMENT;
+}
+
+}
+
+const std::uint32_t SaveFile::VERSION;
+
+SaveFileWriter::SaveFileWriter():
+    header_(),
+    strings_(),
+    stringData_(),
+    stringIndex_(),
+    hexes_(),
+    pawns_(),
+    actors_(),
+    transports_(),
+    players_(),
+    pieces_(),
+    spinner_()
+{
+    std::memcpy(header_.magic, MAGIC, sizeof(MAGIC));
+    header_.version = SaveFile::VERSION;
+    header_.headerSize = sizeof(SaveHeader);
+}
+
+SaveHeader& SaveFileWriter::header()
+{
+    return header_;
+}
+
+std::uint32_t SaveFileWriter::string(const std::string& value)
+{
+    auto found = stringIndex_.find(value);
+    if (found != stringIndex_.end()) {
+        return found->second;
+    }
+    std::uint32_t index = static_cast<std::uint32_t>(strings_.size());
+    strings_.push_back({static_cast<std::uint32_t>(stringData_.size()),
+                        static_cast<std::uint32_t>(value.size())});
+    stringData_ += value;
+    stringIndex_[value] = index;
+    return index;
+}
+
+void SaveFileWriter::addHex(CubeCoordinate coord, const std::string& type)
+{
+    hexes_.push_back({coord.x, coord.y, coord.z, string(type)});
+}
+
+void SaveFileWriter::addPawn(int id, int player, CubeCoordinate coord,
+                             int transport)
+{
+    pawns_.push_back({id, player, coord.x, coord.y, coord.z, transport});
+}
+
+void SaveFileWriter::addActor(int id, const std::string& type,
+                              CubeCoordinate coord)
+{
+    actors_.push_back({id, string(type), coord.x, coord.y, coord.z});
+}
+
+void SaveFileWriter::addTransport(int id, const std::string& type,
+                                  CubeCoordinate coord)
+{
+    transports_.push_back({id, string(type), coord.x, coord.y, coord.z});
+}
+
+void SaveFileWriter::addPlayer(const SavedPlayer& player)
+{
+    players_.push_back(player);
+}
+
+void SaveFileWriter::addPieceCount(const std::string& type, int count)
+{
+    pieces_.push_back({string(type), count});
+}
+
+void SaveFileWriter::addSpinnerChance(const std::string& section,
+                                      const std::string& moves,
+                                      unsigned int chance)
+{
+    spinner_.push_back({string(section), string(moves), chance});
+}
+
+void SaveFileWriter::write(const std::string& filePath)
+{
+    struct Block {
+        const void* data;
+        std::size_t count;
+        std::size_t recordSize;
+    };
+    const Block blocks[SAVE_SECTION_COUNT] = {
+        {strings_.data(), strings_.size(), sizeof(SaveString)},
+        {stringData_.data(), stringData_.size(), 1},
+        {hexes_.data(), hexes_.size(), sizeof(SavedHex)},
+        {pawns_.data(), pawns_.size(), sizeof(SavedPawn)},
+        {actors_.data(), actors_.size(), sizeof(SavedObject)},
+        {transports_.data(), transports_.size(), sizeof(SavedObject)},
+        {players_.data(), players_.size(), sizeof(SavedPlayer)},
+        {pieces_.data(), pieces_.size(), sizeof(SavedPieceCount)},
+        {spinner_.data(), spinner_.size(), sizeof(SavedSpinnerChance)}
+    };
+
+    std::size_t offset = aligned(sizeof(SaveHeader));
+    for (int id = 0; id < SAVE_SECTION_COUNT; ++id) {
+        header_.sections[id].offset = static_cast<std::uint32_t>(offset);
+        header_.sections[id].count =
+                static_cast<std::uint32_t>(blocks[id].count);
+        offset = aligned(offset + blocks[id].count * blocks[id].recordSize);
+    }
+
+    std::vector<char> file(offset, '\0');
+    std::memcpy(file.data(), &header_, sizeof(SaveHeader));
+    for (int id = 0; id < SAVE_SECTION_COUNT; ++id) {
+        if (blocks[id].count != 0) {
+            std::memcpy(file.data() + header_.sections[id].offset,
+                        blocks[id].data,
+                        blocks[id].count * blocks[id].recordSize);
+        }
+    }
+
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(file.data(), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        throw IoException("Could not write save file " + filePath);
+    }
+}
+
+SaveFile::SaveFile(const std::string& filePath):
+    file_(new QFile(QString::fromStdString(filePath))),
+    data_(nullptr),
+    size_(0)
+{
+    if (!file_->open(QFile::ReadOnly)) {
+        throw IoException("Could not open save file " + filePath);
+    }
+    size_ = static_cast<std::size_t>(file_->size());
+    if (size_ < sizeof(SaveHeader)) {
+        throw FormatException("Not a save file: " + filePath);
+    }
+    data_ = file_->map(0, file_->size());
+    if (data_ == nullptr) {
+        throw IoException("Could not map save file " + filePath);
+    }
+
+    const SaveHeader& saved = header();
+    if (std::memcmp(saved.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw FormatException("Not a save file: " + filePath);
+    }
+    if (saved.version != VERSION || saved.headerSize != sizeof(SaveHeader)) {
+        throw FormatException("Unsupported save file version");
+    }
+
+    checkSection(SAVE_STRINGS, sizeof(SaveString));
+    checkSection(SAVE_STRING_DATA, 1);
+    checkSection(SAVE_HEXES, sizeof(SavedHex));
+    checkSection(SAVE_PAWNS, sizeof(SavedPawn));
+    checkSection(SAVE_ACTORS, sizeof(SavedObject));
+    checkSection(SAVE_TRANSPORTS, sizeof(SavedObject));
+    checkSection(SAVE_PLAYERS, sizeof(SavedPlayer));
+    checkSection(SAVE_ISLAND_PIECES, sizeof(SavedPieceCount));
+    checkSection(SAVE_SPINNER, sizeof(SavedSpinnerChance));
+}
+
+SaveFile::~SaveFile() = default;
+
+const SaveHeader& SaveFile::header() const
+{
+    return *reinterpret_cast<const SaveHeader*>(data_);
+}
+
+std::string SaveFile::string(std::uint32_t index) const
+{
+    SaveRecords<SaveString> strings = records<SaveString>(SAVE_STRINGS);
+    if (index >= strings.size()) {
+        throw FormatException("Invalid string in save file");
+    }
+    const SaveSection& bytes = header().sections[SAVE_STRING_DATA];
+    const SaveString& entry = strings[index];
+    if (static_cast<std::uint64_t>(entry.offset) + entry.length >
+            bytes.count) {
+        throw FormatException("Invalid string in save file");
+    }
+    return std::string(reinterpret_cast<const char*>(data_) + bytes.offset +
+                       entry.offset, entry.length);
+}
+
+SaveRecords<SavedHex> SaveFile::hexes() const
+{
+    return records<SavedHex>(SAVE_HEXES);
+}
+
+SaveRecords<SavedPawn> SaveFile::pawns() const
+{
+    return records<SavedPawn>(SAVE_PAWNS);
+}
+
+SaveRecords<SavedObject> SaveFile::actors() const
+{
+    return records<SavedObject>(SAVE_ACTORS);
+}
+
+SaveRecords<SavedObject> SaveFile::transports() const
+{
+    return records<SavedObject>(SAVE_TRANSPORTS);
+}
+
+SaveRecords<SavedPlayer> SaveFile::players() const
+{
+    return records<SavedPlayer>(SAVE_PLAYERS);
+}
+
+SaveRecords<SavedPieceCount> SaveFile::pieceCounts() const
+{
+    return records<SavedPieceCount>(SAVE_ISLAND_PIECES);
+}
+
+SaveRecords<SavedSpinnerChance> SaveFile::spinner() const
+{
+    return records<SavedSpinnerChance>(SAVE_SPINNER);
+}
+
+template <class T>
+SaveRecords<T> SaveFile::records(SaveSectionId id) const
+{
+    const SaveSection& section = header().sections[id];
+    return SaveRecords<T>(reinterpret_cast<const T*>(data_ + section.offset),
+                          section.count);
+}
+
+void SaveFile::checkSection(SaveSectionId id, std::size_t recordSize) const
+{
+    const SaveSection& section = header().sections[id];
+    if (section.offset % SECTION_ALIGNMENT != 0 ||
+            section.offset > size_ ||
+            section.count > (size_ - section.offset) / recordSize) {
+        throw FormatException("Corrupt save file");
+    }
+}
+
+}
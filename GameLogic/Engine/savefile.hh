@@ -0,0 +1,274 @@
+#ifndef SAVEFILE_HH
+#define SAVEFILE_HH
+
+#include "cubecoordinate.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class QFile;
+
+/**
+ * @file
+ * @brief Binary save format of a complete game.
+ */
+
+namespace Common {
+
+/**
+ * @brief Section of a save file: an array of fixed size records.
+ */
+struct SaveSection {
+    //! Offset of the first record from the start of the file.
+    std::uint32_t offset;
+    //! Number of records.
+    std::uint32_t count;
+};
+
+/**
+ * @brief Sections of a save file, in the order of SaveHeader::sections.
+ */
+enum SaveSectionId {
+    SAVE_STRINGS,       //!< SaveString
+    SAVE_STRING_DATA,   //!< char, the bytes of all strings
+    SAVE_HEXES,         //!< SavedHex
+    SAVE_PAWNS,         //!< SavedPawn
+    SAVE_ACTORS,        //!< SavedObject
+    SAVE_TRANSPORTS,    //!< SavedObject
+    SAVE_PLAYERS,       //!< SavedPlayer
+    SAVE_ISLAND_PIECES, //!< SavedPieceCount, in sinking order
+    SAVE_SPINNER,       //!< SavedSpinnerChance, in wheel order
+    SAVE_SECTION_COUNT
+};
+
+/**
+ * @brief Header at the start of a save file.
+ * @details All fields have a fixed width and the file contains no pointers,
+ * so the records can be used in place after mapping the file to memory.
+ * Values are stored in the byte order of the machine that saved the game.
+ */
+struct SaveHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::int32_t gamePhase;
+    std::int32_t currentPlayer;
+    std::int32_t islandRadius;
+    std::int32_t actorIdCounter;
+    std::int32_t transportIdCounter;
+    std::uint32_t seed;
+    std::uint32_t reserved;
+    std::uint64_t draws;
+    SaveSection sections[SAVE_SECTION_COUNT];
+};
+
+//! A string in SAVE_STRING_DATA.
+struct SaveString {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+//! A hex and its piece type (index to SAVE_STRINGS).
+struct SavedHex {
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t z;
+    std::uint32_t type;
+};
+
+//! A pawn, transport is 0 if the pawn is not in a transport.
+struct SavedPawn {
+    std::int32_t id;
+    std::int32_t player;
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t z;
+    std::int32_t transport;
+};
+
+//! An actor or a transport and its type (index to SAVE_STRINGS).
+struct SavedObject {
+    std::int32_t id;
+    std::uint32_t type;
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t z;
+};
+
+//! A player.
+struct SavedPlayer {
+    std::int32_t id;
+    std::uint32_t actionsLeft;
+    std::uint32_t pawns;
+    std::uint32_t points;
+};
+
+//! Number of unflipped hexes of a piece type (index to SAVE_STRINGS).
+struct SavedPieceCount {
+    std::uint32_t type;
+    std::int32_t count;
+};
+
+//! A move of a spinner section and its chance (indices to SAVE_STRINGS).
+struct SavedSpinnerChance {
+    std::uint32_t section;
+    std::uint32_t moves;
+    std::uint32_t chance;
+};
+
+/**
+ * @brief SaveRecords is a read-only view of the records of a section.
+ */
+template <class T>
+class SaveRecords {
+
+public:
+
+    SaveRecords(const T* data, std::size_t size):
+        data_(data),
+        size_(size)
+    {
+    }
+
+    const T* begin() const
+    {
+        return data_;
+    }
+
+    const T* end() const
+    {
+        return data_ + size_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    const T& operator[](std::size_t index) const
+    {
+        return data_[index];
+    }
+
+private:
+
+    const T* data_;
+    std::size_t size_;
+};
+
+/**
+ * @brief SaveFileWriter collects the records of a game and writes them to a
+ * save file.
+ */
+class SaveFileWriter {
+
+public:
+
+    /**
+     * @brief Constructor, creates an empty save.
+     */
+    SaveFileWriter();
+
+    /**
+     * @brief header returns the header, the caller fills in the scalar
+     * fields. The sections are filled in by write().
+     */
+    SaveHeader& header();
+
+    /**
+     * @brief string returns the index of a string, adding it if needed.
+     */
+    std::uint32_t string(const std::string& value);
+
+    void addHex(CubeCoordinate coord, const std::string& type);
+    void addPawn(int id, int player, CubeCoordinate coord, int transport);
+    void addActor(int id, const std::string& type, CubeCoordinate coord);
+    void addTransport(int id, const std::string& type, CubeCoordinate coord);
+    void addPlayer(const SavedPlayer& player);
+    void addPieceCount(const std::string& type, int count);
+    void addSpinnerChance(const std::string& section, const std::string& moves,
+                          unsigned int chance);
+
+    /**
+     * @brief write writes the save file.
+     * @param filePath Path of the file, an existing file is replaced.
+     * @exception IoException The file could not be written.
+     */
+    void write(const std::string& filePath);
+
+private:
+
+    SaveHeader header_;
+    std::vector<SaveString> strings_;
+    std::string stringData_;
+    std::map<std::string, std::uint32_t> stringIndex_;
+    std::vector<SavedHex> hexes_;
+    std::vector<SavedPawn> pawns_;
+    std::vector<SavedObject> actors_;
+    std::vector<SavedObject> transports_;
+    std::vector<SavedPlayer> players_;
+    std::vector<SavedPieceCount> pieces_;
+    std::vector<SavedSpinnerChance> spinner_;
+};
+
+/**
+ * @brief SaveFile maps a save file to memory and gives access to its records.
+ * @details Nothing is copied: the records are read straight from the
+ * mapping, which stays valid while the SaveFile exists.
+ */
+class SaveFile {
+
+public:
+
+    //! Version of the save format.
+    static const std::uint32_t VERSION = 1;
+
+    /**
+     * @brief Constructor, maps and validates the file.
+     * @param filePath Path of the save file.
+     * @exception IoException The file could not be opened or mapped.
+     * @exception FormatException The file is not a valid save file of this
+     * version.
+     */
+    explicit SaveFile(const std::string& filePath);
+
+    ~SaveFile();
+
+    SaveFile(const SaveFile&) = delete;
+    SaveFile& operator=(const SaveFile&) = delete;
+
+    const SaveHeader& header() const;
+
+    /**
+     * @brief string returns a string of the string table.
+     * @exception FormatException index is out of range.
+     */
+    std::string string(std::uint32_t index) const;
+
+    SaveRecords<SavedHex> hexes() const;
+    SaveRecords<SavedPawn> pawns() const;
+    SaveRecords<SavedObject> actors() const;
+    SaveRecords<SavedObject> transports() const;
+    SaveRecords<SavedPlayer> players() const;
+    SaveRecords<SavedPieceCount> pieceCounts() const;
+    SaveRecords<SavedSpinnerChance> spinner() const;
+
+private:
+
+    template <class T>
+    SaveRecords<T> records(SaveSectionId id) const;
+
+    void checkSection(SaveSectionId id, std::size_t recordSize) const;
+
+    std::unique_ptr<QFile> file_;
+    const unsigned char* data_;
+    std::size_t size_;
+};
+
+}
+
+#endif // SAVEFILE_HH
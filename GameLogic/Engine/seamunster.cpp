@@ -9,8 +9,9 @@ Seamunster::Seamunster(int typeId): Actor(typeId)
 
 void Seamunster::doAction()
 {
-    hex_->clearTransports();
-    hex_->clearPawnsFromTerrain();
+    std::shared_ptr<Hex> hex = getHex();
+    hex->clearTransports();
+    hex->clearPawnsFromTerrain();
 }
 
 std::string Seamunster::getActorType() const
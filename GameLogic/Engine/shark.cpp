@@ -8,7 +8,7 @@ Shark::Shark(int typeId):Actor(typeId){
 
 void Shark::doAction()
 {
-    hex_->clearPawnsFromTerrain();
+    getHex()->clearPawnsFromTerrain();
 }
 
 std::string Shark::getActorType() const
@@ -0,0 +1,202 @@
+#include "trace.hh"
+#include "ioexception.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+namespace Common {
+
+struct Tracer::ThreadBuffer {
+    explicit ThreadBuffer(int thread) :
+        mutex(),
+        events(),
+        next(0),
+        thread(thread)
+    {
+        events.reserve(BUFFER_EVENTS);
+    }
+
+    // only taken by the owning thread, and by readers of the whole trace
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    // where the next event goes once the buffer is full
+    std::size_t next;
+    int thread;
+};
+
+namespace {
+
+// set on first use, so tracing works during static initialization too
+std::chrono::steady_clock::time_point traceStart()
+{
+    static const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    return start;
+}
+
+// the names are literals in the code, but a quote would break the file
+void writeName(std::ostream& out, const char* name)
+{
+    out << '"';
+    for (const char* c = name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+void writeMicroseconds(std::ostream& out, std::uint64_t nanoseconds)
+{
+    out << nanoseconds / 1000 << '.';
+    std::uint64_t fraction = nanoseconds % 1000;
+    out << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+
+}
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+std::uint64_t Tracer::now()
+{
+    return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - traceStart()).count());
+}
+
+void Tracer::span(const char* name, std::uint64_t start,
+                  std::uint64_t duration)
+{
+    record({name, start, static_cast<std::int64_t>(duration), false});
+}
+
+void Tracer::counter(const char* name, std::int64_t value)
+{
+    record({name, now(), value, true});
+}
+
+std::size_t Tracer::eventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t count = 0;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+
+void Tracer::writeChromeTrace(const std::string& filePath) const
+{
+    std::ofstream out(filePath, std::ios::trunc);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            out << (first ? "\n" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                << "\"tid\":" << buffer->thread
+                << ",\"args\":{\"name\":\"thread " << buffer->thread
+                << "\"}}";
+            first = false;
+            // oldest first, the buffer wraps around at next
+            std::size_t size = buffer->events.size();
+            for (std::size_t i = 0; i < size; ++i) {
+                const TraceEvent& event =
+                        buffer->events[(buffer->next + i) % size];
+                out << ",\n{\"name\":";
+                writeName(out, event.name);
+                out << ",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":";
+                writeMicroseconds(out, event.start);
+                if (event.counter) {
+                    out << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value
+                        << "}}";
+                } else {
+                    out << ",\"ph\":\"X\",\"dur\":";
+                    writeMicroseconds(out,
+                                      static_cast<std::uint64_t>(event.value));
+                    out << '}';
+                }
+            }
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    if (!out) {
+        throw IoException("Could not write trace " + filePath);
+    }
+}
+
+void Tracer::writeChromeTraceFromEnvironment() const
+{
+    const char* filePath = std::getenv("ISLANDGAME_TRACE");
+    if (filePath != nullptr && *filePath != '\0') {
+        writeChromeTrace(filePath);
+    }
+}
+
+Tracer::Tracer() :
+    mutex_(),
+    buffers_()
+{
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    // the tracer keeps a reference too, so the events outlive the thread
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer = std::make_shared<ThreadBuffer>(
+                    static_cast<int>(buffers_.size()) + 1);
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::record(const TraceEvent& event)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < BUFFER_EVENTS) {
+        buffer.events.push_back(event);
+    } else {
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % BUFFER_EVENTS;
+    }
+}
+
+TraceScope::TraceScope(const char* name) :
+    name_(name),
+    start_(Tracer::now())
+{
+}
+
+TraceScope::~TraceScope()
+{
+    // losing a span is better than terminating when the first event of a
+    // thread can't get its buffer
+    try {
+        Tracer::instance().span(name_, start_, Tracer::now() - start_);
+    } catch (...) {
+    }
+}
+
+}
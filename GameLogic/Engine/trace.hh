@@ -0,0 +1,168 @@
+#ifndef TRACE_HH
+#define TRACE_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @brief Scoped timers and counters for finding where a game spends its
+ * time, exported in the Chrome trace event format.
+ *
+ * The macros TRACE_SCOPE and TRACE_COUNTER record nothing and evaluate
+ * nothing unless ISLANDGAME_TRACING is defined (qmake CONFIG+=tracing).
+ * The exported file opens in chrome://tracing and in Perfetto.
+ */
+
+namespace Common {
+
+/**
+ * @brief One recorded span or counter value.
+ */
+struct TraceEvent {
+    //! Name of the span or counter, must outlive the tracer (a literal).
+    const char* name;
+    //! Nanoseconds from the start of the tracer.
+    std::uint64_t start;
+    //! Length of a span in nanoseconds, or the value of a counter.
+    std::int64_t value;
+    //! True for a counter, false for a span.
+    bool counter;
+};
+
+/**
+ * @brief Tracer keeps the events of every thread that has recorded one.
+ * @details Each thread writes to its own ring buffer of BUFFER_EVENTS
+ * events, so threads don't wait for each other. When a buffer is full the
+ * oldest events are overwritten. Buffers stay with the tracer after their
+ * thread ends, so a trace can be exported after a server has stopped its
+ * workers.
+ */
+class Tracer {
+
+public:
+
+    //! Events kept for each thread.
+    static const std::size_t BUFFER_EVENTS = 1 << 16;
+
+    /**
+     * @brief instance returns the tracer of the program.
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief now returns the time used for the events.
+     * @return Nanoseconds from the start of the tracer.
+     * @post Exception quarantee: nothrow
+     */
+    static std::uint64_t now();
+
+    /**
+     * @brief span records a span of time in the calling thread.
+     * @param name Name of the span, a string literal.
+     * @param start Start time from now().
+     * @param duration Length in nanoseconds.
+     * @post Exception quarantee: basic
+     */
+    void span(const char* name, std::uint64_t start, std::uint64_t duration);
+
+    /**
+     * @brief counter records the value of a counter in the calling thread.
+     * @param name Name of the counter, a string literal.
+     * @param value Current value.
+     * @post Exception quarantee: basic
+     */
+    void counter(const char* name, std::int64_t value);
+
+    /**
+     * @brief eventCount returns the number of events kept in all threads.
+     * @post Exception quarantee: nothrow
+     */
+    std::size_t eventCount() const;
+
+    /**
+     * @brief clear drops the events of all threads.
+     * @post Exception quarantee: nothrow
+     */
+    void clear();
+
+    /**
+     * @brief writeChromeTrace writes the events in the Chrome trace event
+     * format, each thread on its own track.
+     * @param filePath Path of the file, an old file is replaced.
+     * @exception IoException if the file can't be written.
+     * @post Exception quarantee: basic
+     */
+    void writeChromeTrace(const std::string& filePath) const;
+
+    /**
+     * @brief writeChromeTraceFromEnvironment writes the trace to the file
+     * named by the environment variable ISLANDGAME_TRACE, if it is set.
+     * @exception IoException if the file can't be written.
+     * @post Exception quarantee: basic
+     */
+    void writeChromeTraceFromEnvironment() const;
+
+private:
+
+    struct ThreadBuffer;
+
+    Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    ThreadBuffer& threadBuffer();
+    void record(const TraceEvent& event);
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+/**
+ * @brief TraceScope records a span from its construction to its
+ * destruction. Use it through TRACE_SCOPE.
+ */
+class TraceScope {
+
+public:
+
+    explicit TraceScope(const char* name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+
+    const char* name_;
+    std::uint64_t start_;
+};
+
+}
+
+#ifdef ISLANDGAME_TRACING
+
+#define ISLANDGAME_TRACE_JOIN_(a, b) a##b
+#define ISLANDGAME_TRACE_JOIN(a, b) ISLANDGAME_TRACE_JOIN_(a, b)
+
+//! Records a span named name from here to the end of the enclosing block.
+#define TRACE_SCOPE(name) \
+    Common::TraceScope ISLANDGAME_TRACE_JOIN(traceScope_, __LINE__)(name)
+
+//! Records the current value of a counter.
+#define TRACE_COUNTER(name, value) \
+    Common::Tracer::instance().counter( \
+        name, static_cast<std::int64_t>(value))
+
+#else
+
+#define TRACE_SCOPE(name) do {} while (false)
+#define TRACE_COUNTER(name, value) do {} while (false)
+
+#endif
+
+#endif // TRACE_HH
@@ -5,28 +5,46 @@
 
 namespace Common{
 
+Transport::Transport():
+    Transport(0)
+{}
+
 Transport::Transport( int id ):
     capacity_(0),
-    hex_(nullptr),
-    id_(id)
+    hex_(),
+    id_(id),
+    pawnCounts_(),
+    playersWithCount_(),
+    mostPawns_(0)
 {}
 
 Transport::~Transport(){}
 
 void Transport::addPawn(std::shared_ptr<Pawn> pawn )
 {
-    if ( getCapacity() > 0 ){
+    if ( getCapacity() > 0 && !isPawnInTransport(pawn) ){
+        // A pawn rides one transport at a time
+        std::shared_ptr<Transport> previous = pawn->getTransport();
+        if (previous != nullptr) {
+            previous->removePawn(pawn);
+        }
         pawns_.push_back(pawn);
+        pawn->setTransport(shared_from_this());
+        countPawn(pawn->getPlayerId());
+        piecesChanged();
     }
 }
 
 void Transport::removePawn(std::shared_ptr<Pawn> pawn)
 {
-    if (pawn != nullptr) {
+    if (isPawnInTransport(pawn)) {
         auto foundPawn = std::find(pawns_.begin(),pawns_.end(),pawn);
         if (foundPawn != pawns_.end()) {
             pawns_.erase(foundPawn);
+            uncountPawn(pawn->getPlayerId());
         }
+        pawn->setTransport(nullptr);
+        piecesChanged();
     }
 }
 
@@ -43,15 +61,16 @@ int Transport::getMaxCapacity() const
 void Transport::addHex( std::shared_ptr<Common::Hex> hex )
 {
     hex->addTransport(shared_from_this());
-    if (hex_ != nullptr) {
-        hex_->removeTransport(shared_from_this());
+    std::shared_ptr<Common::Hex> previous = hex_.lock();
+    if (previous != nullptr) {
+        previous->removeTransport(shared_from_this());
     }
     hex_ = hex;
 }
 
 std::shared_ptr<Hex> Transport::getHex()
 {
-    return hex_;
+    return hex_.lock();
 }
 
 std::vector<std::shared_ptr<Pawn> > Transport::getPawnsInTransport()
@@ -61,7 +80,7 @@ std::vector<std::shared_ptr<Pawn> > Transport::getPawnsInTransport()
 
 bool Transport::isPawnInTransport(std::shared_ptr<Pawn> pawn)
 {
-    return (std::find(pawns_.begin(),pawns_.end(),pawn) != pawns_.end());
+    return pawn != nullptr && pawn->getTransport().get() == this;
 }
 
 int Transport::getId()
@@ -71,7 +90,79 @@ int Transport::getId()
 
 void Transport::removePawns()
 {
+    for (auto pawn : pawns_) {
+        pawn->setTransport(nullptr);
+    }
     pawns_.clear();
+    pawnCounts_.clear();
+    playersWithCount_.clear();
+    mostPawns_ = 0;
+    piecesChanged();
+}
+
+bool Transport::canMove(int playerId) const
+{
+    return pawnsOfPlayer(playerId) >= mostPawns_;
+}
+
+void Transport::piecesChanged()
+{
+    std::shared_ptr<Common::Hex> hex = hex_.lock();
+    if (hex != nullptr) {
+        hex->piecesChanged();
+    }
+}
+
+void Transport::countPawn(int playerId)
+{
+    // Pawns without a valid owner never decide who moves the transport
+    if (playerId < 0) {
+        return;
+    }
+    std::size_t player = static_cast<std::size_t>(playerId);
+    if (pawnCounts_.size() <= player) {
+        pawnCounts_.resize(player + 1, 0);
+    }
+
+    int count = pawnCounts_[player]++;
+    if (count > 0) {
+        --playersWithCount_[count];
+    }
+    if (playersWithCount_.size() <= static_cast<std::size_t>(count + 1)) {
+        playersWithCount_.resize(count + 2, 0);
+    }
+    ++playersWithCount_[count + 1];
+
+    if (count + 1 > mostPawns_) {
+        mostPawns_ = count + 1;
+    }
+}
+
+void Transport::uncountPawn(int playerId)
+{
+    if (pawnsOfPlayer(playerId) == 0) {
+        return;
+    }
+
+    int count = pawnCounts_[playerId]--;
+    --playersWithCount_[count];
+    if (count > 1) {
+        ++playersWithCount_[count - 1];
+    }
+
+    // The player that left the lead still has count - 1 pawns
+    if (count == mostPawns_ && playersWithCount_[count] == 0) {
+        mostPawns_ = count - 1;
+    }
+}
+
+int Transport::pawnsOfPlayer(int playerId) const
+{
+    if (playerId < 0 ||
+            static_cast<std::size_t>(playerId) >= pawnCounts_.size()) {
+        return 0;
+    }
+    return pawnCounts_[playerId];
 }
 
 }
@@ -25,7 +25,7 @@ public:
     /**
      * @brief default constructor
      */
-    Transport() = default;
+    Transport();
 
     /**
      * @brief Constructor of Transport
@@ -51,6 +51,7 @@ public:
      * @post If there is space, pawn is added to transport
      * @note note: Pawn is not removed from the hex
      * @post If transport is full, pawn is not added
+     * @post A pawn that was in another transport has left it
      */
     void addPawn( std::shared_ptr<Common::Pawn> pawn );
 
@@ -86,10 +87,15 @@ public:
 
     /**
      * @brief canMove checks if the player playerId is allowed to move the transport
+     * @details A player may move the transport when no other player has
+     * more pawns in it.
      * @param playerId
      * @return true is playerId can move the transport, false if not
+     * @post Exception quarantee: nothrow
+     * @note Constant time, the pawn counts are kept up to date as pawns
+     * board and leave
      */
-    virtual bool canMove( int playerId ) const = 0;
+    virtual bool canMove( int playerId ) const;
 
     /**
      * @brief addHex adds the transport to the hex
@@ -118,6 +124,7 @@ public:
      * @brief isPawnInTransport checks if pawn is in transport
      * @param pawn the pawn we want to check for
      * @return true if pawn is in transport, otherwise false
+     * @note Constant time, uses the pawn's back-reference to its transport
      */
     bool isPawnInTransport(std::shared_ptr<Common::Pawn> pawn);
 
@@ -136,11 +143,25 @@ protected:
     using PawnVector = std::vector<std::shared_ptr<Common::Pawn>>;
     int capacity_;
     PawnVector pawns_;
-    std::shared_ptr<Common::Hex> hex_;
+    //! The hex the transport is on. Not owned, the hex owns the transport.
+    std::weak_ptr<Common::Hex> hex_;
 
 private:
+    // tells the hex that the pawns on board changed
+    void piecesChanged();
+    void countPawn(int playerId);
+    void uncountPawn(int playerId);
+    int pawnsOfPlayer(int playerId) const;
+
     int id_;
 
+    //! Pawns in the transport per player id.
+    std::vector<int> pawnCounts_;
+    //! Number of players for each pawn count, index 0 unused.
+    std::vector<int> playersWithCount_;
+    //! Largest pawn count of a single player.
+    int mostPawns_;
+
 };
 
 }
@@ -1,4 +1,5 @@
 #include "transportfactory.hh"
+#include "gameexception.hh"
 
 namespace Logic {
 
@@ -8,7 +9,8 @@ using std::vector;
 
 TransportFactory::TransportFactory():
     transportDefinitions_(),
-    idCounter_(0)
+    idCounter_(0),
+    factoryMutex_()
 {
 
 }
@@ -23,11 +25,13 @@ TransportFactory& TransportFactory::getInstance()
 
 void TransportFactory::addTransport(string type, TransportBuildFunction buildFunction)
 {
+    std::lock_guard<std::mutex> lock(factoryMutex_);
     transportDefinitions_[type] = buildFunction;
 }
 
 std::vector<std::string> TransportFactory::getAvailableTransports() const
 {
+    std::lock_guard<std::mutex> lock(factoryMutex_);
     auto types = vector<string>();
     for (auto it = transportDefinitions_.begin();
          it != transportDefinitions_.end();
@@ -40,8 +44,35 @@ std::vector<std::string> TransportFactory::getAvailableTransports() const
 
 TransportPointer TransportFactory::createTransport(string type)
 {
-    ++idCounter_;
-    return transportDefinitions_[type](idCounter_);
+    TransportBuildFunction build;
+    int id = 0;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex_);
+        auto definition = transportDefinitions_.find(type);
+        if (definition == transportDefinitions_.end()) {
+            throw Common::GameException("Unknown transport type " + type);
+        }
+        build = definition->second;
+        id = ++idCounter_;
+    }
+    return build(id);
+}
+
+TransportPointer TransportFactory::createTransport(string type, int id)
+{
+    TransportBuildFunction build;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex_);
+        auto definition = transportDefinitions_.find(type);
+        if (definition == transportDefinitions_.end()) {
+            throw Common::GameException("Unknown transport type " + type);
+        }
+        build = definition->second;
+        if (id > idCounter_) {
+            idCounter_ = id;
+        }
+    }
+    return build(id);
 }
 
 }
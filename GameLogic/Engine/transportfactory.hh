@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 
 /**
  * @file
@@ -49,15 +50,29 @@ public:
      * @brief createTransport
      * @param type
      * @return the created transport. Ownership is transferred to caller
+     * @exception GameException type has not been added
      */
     TransportPointer createTransport(std::string type);
 
+    /**
+     * @brief createTransport creates a transport with a given id, e.g. when
+     * a game is replayed.
+     * @param type transport type identifier
+     * @param id Identifier of the new transport
+     * @return the created transport. Ownership is transferred to caller
+     * @exception GameException type has not been added
+     * @post Later transports get ids greater than id
+     */
+    TransportPointer createTransport(std::string type, int id);
+
 private:
 
     TransportFactory();
 
     std::map<std::string, TransportBuildFunction> transportDefinitions_;
     int idCounter_;
+    //! Games may run in several threads, e.g. in the game server.
+    mutable std::mutex factoryMutex_;
 };
 
 }
@@ -14,8 +14,9 @@ void Vortex::move(std::shared_ptr<Hex> to)
 
 void Vortex::doAction()
 {
-    hex_->clearAllFromNeightbours();
-    hex_->clear();
+    std::shared_ptr<Hex> hex = getHex();
+    hex->clearAllFromNeightbours();
+    hex->clear();
 }
 
 std::string Vortex::getActorType() const
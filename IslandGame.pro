@@ -6,3 +6,11 @@ SUBDIRS += \
     GameLogic
 
 UI.depends = GameLogic
+# the engine tests link the engine library
+Tests.depends = GameLogic
+
+# the game server uses epoll
+linux {
+    SUBDIRS += Server
+    Server.depends = GameLogic
+}
@@ -0,0 +1,53 @@
+QT       -= gui
+
+TARGET = IslandGameServer
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= app_bundle
+
+SOURCES += \
+    main.cpp \
+    gameserver.cpp \
+    workerpool.cpp \
+    session.cpp \
+    ../Protocol/protocol.cpp \
+    ../../UI/gameboard.cpp \
+    ../../UI/entitystore.cpp \
+    ../../UI/gamestate.cpp \
+    ../../UI/player.cpp
+
+HEADERS += \
+    gameserver.hh \
+    workerpool.hh \
+    session.hh \
+    ../Protocol/protocol.hh \
+    ../../UI/gameboard.hh \
+    ../../UI/entitystore.hh \
+    ../../UI/gamestate.hh \
+    ../../UI/player.hh
+
+INCLUDEPATH += $$PWD/../Protocol $$PWD/../../UI $$PWD/../../GameLogic/Engine
+DEPENDPATH += $$PWD/../Protocol $$PWD/../../UI $$PWD/../../GameLogic/Engine
+
+CONFIG(release, debug|release) {
+   DESTDIR = release
+}
+
+CONFIG(debug, debug|release) {
+   DESTDIR = debug
+}
+
+LIBS += -L$$OUT_PWD/../../GameLogic/Engine
+LIBS += -L$$OUT_PWD/../../GameLogic/Engine/$${DESTDIR}/ -lEngine
+LIBS += -lpthread
+
+# qmake CONFIG+=tracing records the TRACE_SCOPE timers, see trace.hh
+tracing {
+    DEFINES += ISLANDGAME_TRACING
+}
+
+# the engine reads the game pieces and the wheel from Assets
+copyfiles.commands += cp -r $$_PRO_FILE_PWD_/../../GameLogic/Assets $$DESTDIR
+
+QMAKE_EXTRA_TARGETS += copyfiles
+POST_TARGETDEPS += copyfiles
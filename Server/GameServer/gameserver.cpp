@@ -0,0 +1,450 @@
+#include "gameserver.hh"
+#include "ioexception.hh"
+#include "formatexception.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <future>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Server {
+
+namespace {
+
+const int MAX_EVENTS = 256;
+const std::size_t READ_SIZE = 16 * 1024;
+const int LISTEN_BACKLOG = 4096;
+// answers waiting for a client that does not read them, a client that
+// falls further behind is disconnected
+const std::size_t MAX_OUTPUT_SIZE = 16 * MAX_FRAME_SIZE;
+
+Common::IoException systemError(const std::string& what)
+{
+    return Common::IoException(what + ": " + std::strerror(errno));
+}
+
+void setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw systemError("Could not make socket non-blocking");
+    }
+}
+
+}
+
+GameServer::GameServer(std::size_t workers):
+    epoll_(epoll_create1(EPOLL_CLOEXEC)),
+    wakeUp_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    listeners_(),
+    tcpPort_(0),
+    unixPath_(),
+    stopping_(false),
+    connections_(),
+    connectionFds_(),
+    nextId_(1),
+    completionMutex_(),
+    completions_(),
+    statistics_(workers == 0 ? 1 : workers),
+    sessions_(workers == 0 ? 1 : workers),
+    workers_(workers == 0 ? 1 : workers)
+{
+    if (epoll_ < 0 || wakeUp_ < 0) {
+        int error = errno;
+        if (epoll_ >= 0) {
+            ::close(epoll_);
+        }
+        if (wakeUp_ >= 0) {
+            ::close(wakeUp_);
+        }
+        errno = error;
+        throw systemError("Could not create event loop");
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeUp_;
+    epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeUp_, &event);
+}
+
+GameServer::~GameServer()
+{
+    // the workers post to wakeUp_, so they are stopped before it is closed
+    workers_.stop();
+    for (auto& connection : connections_) {
+        ::close(connection.first);
+    }
+    for (int listener : listeners_) {
+        ::close(listener);
+    }
+    if (!unixPath_.empty()) {
+        unlink(unixPath_.c_str());
+    }
+    ::close(wakeUp_);
+    ::close(epoll_);
+}
+
+void GameServer::listenTcp(std::uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw systemError("Could not create TCP socket");
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), length) < 0 ||
+            listen(fd, LISTEN_BACKLOG) < 0 ||
+            getsockname(fd, reinterpret_cast<sockaddr*>(&address),
+                        &length) < 0) {
+        Common::IoException error = systemError("Could not listen on port " +
+                                                std::to_string(port));
+        ::close(fd);
+        throw error;
+    }
+    tcpPort_ = ntohs(address.sin_port);
+    addListener(fd);
+}
+
+std::uint16_t GameServer::tcpPort() const
+{
+    return tcpPort_;
+}
+
+void GameServer::listenUnix(const std::string& path)
+{
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw Common::IoException("Socket path too long: " + path);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw systemError("Could not create Unix socket");
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            listen(fd, LISTEN_BACKLOG) < 0) {
+        Common::IoException error = systemError("Could not listen on " + path);
+        ::close(fd);
+        throw error;
+    }
+    unixPath_ = path;
+    addListener(fd);
+}
+
+void GameServer::run()
+{
+    epoll_event events[MAX_EVENTS];
+    while (!stopping_) {
+        int count = epoll_wait(epoll_, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("epoll_wait failed");
+        }
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeUp_) {
+                std::uint64_t value;
+                while (::read(wakeUp_, &value, sizeof(value)) > 0) {
+                }
+                finishCompletions();
+                continue;
+            }
+            bool isListener = false;
+            for (int listener : listeners_) {
+                isListener = isListener || listener == fd;
+            }
+            if (isListener) {
+                accept(fd);
+                continue;
+            }
+            auto found = connections_.find(fd);
+            if (found == connections_.end()) {
+                continue;
+            }
+            Connection& connection = found->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close(connection);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                write(connection);
+                if (connections_.count(fd) == 0) {
+                    continue;
+                }
+            }
+            if (events[i].events & EPOLLIN) {
+                read(connection);
+            }
+        }
+    }
+}
+
+void GameServer::stop()
+{
+    stopping_ = true;
+    std::uint64_t one = 1;
+    if (::write(wakeUp_, &one, sizeof(one)) < 0) {
+        // the counter is already set, the loop wakes up anyway
+    }
+}
+
+void GameServer::addListener(int fd)
+{
+    setNonBlocking(fd);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        Common::IoException error = systemError("Could not watch socket");
+        ::close(fd);
+        throw error;
+    }
+    listeners_.push_back(fd);
+}
+
+void GameServer::accept(int listener)
+{
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN when all are accepted; on EMFILE and the like the
+            // pending connections wait until sockets are closed
+            return;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        std::uint64_t id = nextId_++;
+        connections_[fd] = {fd, id, {}, {}, 0, false};
+        connectionFds_[id] = fd;
+    }
+}
+
+void GameServer::read(Connection& connection)
+{
+    std::uint8_t buffer[READ_SIZE];
+    bool closed = false;
+    while (true) {
+        ssize_t count = ::read(connection.fd, buffer, READ_SIZE);
+        if (count > 0) {
+            connection.input.insert(connection.input.end(), buffer,
+                                    buffer + count);
+            continue;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        closed = count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+    }
+    std::size_t used = connection.input.size();
+
+    // hand every complete frame to the worker, keep the incomplete rest
+    std::size_t complete = 0;
+    try {
+        std::size_t size;
+        while ((size = frameSize(connection.input.data() + complete,
+                                 used - complete)) != 0) {
+            complete += size;
+        }
+    } catch (Common::FormatException&) {
+        closed = true;
+    }
+    if (complete != 0) {
+        std::vector<std::uint8_t> frames(connection.input.begin(),
+                                         connection.input.begin() + complete);
+        connection.input.erase(connection.input.begin(),
+                               connection.input.begin() + complete);
+        std::uint64_t id = connection.id;
+        workers_.post(workerOf(id), [this, id, frames]() mutable {
+            serve(id, std::move(frames));
+        });
+    }
+    if (closed) {
+        close(connection);
+    }
+}
+
+void GameServer::write(Connection& connection)
+{
+    while (connection.written < connection.output.size()) {
+        ssize_t count = send(connection.fd,
+                             connection.output.data() + connection.written,
+                             connection.output.size() - connection.written,
+                             MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            close(connection);
+            return;
+        }
+        connection.written += static_cast<std::size_t>(count);
+    }
+
+    bool pending = connection.written < connection.output.size();
+    if (!pending) {
+        connection.output.clear();
+        connection.written = 0;
+    }
+    if (pending != connection.waitingToWrite) {
+        epoll_event event = {};
+        event.events = pending ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.fd = connection.fd;
+        epoll_ctl(epoll_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.waitingToWrite = pending;
+    }
+}
+
+void GameServer::close(Connection& connection)
+{
+    std::uint64_t id = connection.id;
+    int fd = connection.fd;
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connectionFds_.erase(id);
+    connections_.erase(fd);
+
+    // the session goes after the frames already posted for it
+    std::size_t worker = workerOf(id);
+    workers_.post(worker, [this, worker, id]() {
+        sessions_[worker].erase(id);
+    });
+}
+
+void GameServer::finishCompletions()
+{
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        completions.swap(completions_);
+    }
+    for (Completion& completion : completions) {
+        auto found = connectionFds_.find(completion.connection);
+        if (found == connectionFds_.end()) {
+            // closed while the worker served it
+            continue;
+        }
+        Connection& connection = connections_.at(found->second);
+        std::size_t pending = connection.output.size() - connection.written;
+        if (completion.failed ||
+                pending + completion.output.size() > MAX_OUTPUT_SIZE) {
+            close(connection);
+            continue;
+        }
+        // drop what has been sent, so the buffer holds only what waits
+        connection.output.erase(connection.output.begin(),
+                                connection.output.begin() +
+                                static_cast<std::ptrdiff_t>(
+                                    connection.written));
+        connection.written = 0;
+        connection.output.insert(connection.output.end(),
+                                 completion.output.begin(),
+                                 completion.output.end());
+        if (!connection.waitingToWrite) {
+            write(connection);
+        }
+    }
+}
+
+Common::GameStatistics GameServer::statistics()
+{
+    std::vector<std::future<Common::GameStatistics>> parts;
+    for (std::size_t worker = 0; worker < statistics_.size(); ++worker) {
+        auto part = std::make_shared<std::promise<Common::GameStatistics>>();
+        parts.push_back(part->get_future());
+        workers_.post(worker, [this, worker, part]() {
+            try {
+                part->set_value(statistics_[worker]);
+            } catch (...) {
+                part->set_exception(std::current_exception());
+            }
+        });
+    }
+    Common::GameStatistics total;
+    for (auto& part : parts) {
+        total.merge(part.get());
+    }
+    return total;
+}
+
+std::size_t GameServer::workerOf(std::uint64_t connection) const
+{
+    return static_cast<std::size_t>(connection % sessions_.size());
+}
+
+void GameServer::serve(std::uint64_t connection,
+                       std::vector<std::uint8_t> frames)
+{
+    Completion completion = {connection, {}, false};
+    try {
+        std::size_t worker = workerOf(connection);
+        auto found = sessions_[worker].find(connection);
+        if (found == sessions_[worker].end()) {
+            found = sessions_[worker].emplace(
+                        connection, Session(&statistics_[worker])).first;
+        }
+        Session& session = found->second;
+        std::size_t position = 0;
+        while (position < frames.size()) {
+            std::size_t size = frameSize(frames.data() + position,
+                                         frames.size() - position);
+            FrameReader request(frames.data() + position, size);
+            session.handle(request, completion.output);
+            position += size;
+            if (completion.output.size() > MAX_OUTPUT_SIZE) {
+                // the client asks for more than it could be sent
+                completion.failed = true;
+                break;
+            }
+        }
+    } catch (std::exception&) {
+        // the game of the session is broken, the client has to reconnect
+        completion.failed = true;
+    }
+    if (completion.failed) {
+        sessions_[workerOf(connection)].erase(connection);
+        completion.output.clear();
+    }
+
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        wasEmpty = completions_.empty();
+        completions_.push_back(std::move(completion));
+    }
+    if (wasEmpty) {
+        std::uint64_t one = 1;
+        if (::write(wakeUp_, &one, sizeof(one)) < 0) {
+            // the counter is already set, the loop wakes up anyway
+        }
+    }
+}
+
+}
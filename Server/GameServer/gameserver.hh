@@ -0,0 +1,153 @@
+#ifndef GAMESERVER_HH
+#define GAMESERVER_HH
+
+#include "session.hh"
+#include "workerpool.hh"
+#include "gamestatistics.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file
+ * @brief Serves games to clients over TCP and Unix domain sockets.
+ */
+
+namespace Server {
+
+/**
+ * @brief GameServer plays one game per client connection.
+ * @details One thread runs an epoll loop over non-blocking sockets: it
+ * accepts connections, cuts the input into frames and writes the answers.
+ * The frames a connection has received are handed to a worker of a
+ * WorkerPool as one batch. A connection is always served by the same
+ * worker, which owns its Session, so sessions need no locks and the answers
+ * come back in order. The workers hand the answers back through a queue and
+ * wake the loop with an eventfd. A client that lets more than 16 frames of
+ * the largest size of answers wait unread is disconnected.
+ */
+class GameServer {
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param workers Number of worker threads.
+     * @exception IoException epoll or eventfd could not be created.
+     */
+    explicit GameServer(std::size_t workers);
+
+    /**
+     * @brief Destructor, finishes the tasks of the workers and joins them,
+     * then closes all sockets.
+     */
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    /**
+     * @brief listenTcp accepts connections on the loopback interface.
+     * @param port The port, 0 for any free port.
+     * @exception IoException The socket could not be opened.
+     */
+    void listenTcp(std::uint16_t port);
+
+    /**
+     * @brief tcpPort tells the port given by listenTcp.
+     * @return The port, 0 if the server does not listen on TCP.
+     */
+    std::uint16_t tcpPort() const;
+
+    /**
+     * @brief listenUnix accepts connections on a Unix domain socket.
+     * @param path Path of the socket, an old socket there is replaced.
+     * @exception IoException The socket could not be opened.
+     */
+    void listenUnix(const std::string& path);
+
+    /**
+     * @brief run serves clients until stop() is called.
+     * @exception IoException epoll failed.
+     */
+    void run();
+
+    /**
+     * @brief stop makes run() return. Can be called from any thread.
+     */
+    void stop();
+
+    /**
+     * @brief statistics sums up the games played so far.
+     * @details Every worker keeps the statistics of its own sessions. They
+     * are copied on the workers and merged here, so this can be called
+     * while the server runs. Games still being played are not included.
+     * @return Statistics of the finished and abandoned games.
+     */
+    Common::GameStatistics statistics();
+
+private:
+
+    struct Connection {
+        int fd;
+        std::uint64_t id;
+        std::vector<std::uint8_t> input;
+        std::vector<std::uint8_t> output;
+        std::size_t written;
+        bool waitingToWrite;
+    };
+
+    struct Completion {
+        std::uint64_t connection;
+        std::vector<std::uint8_t> output;
+        //! The session failed and the connection has to be closed.
+        bool failed;
+    };
+
+    void addListener(int fd);
+    void accept(int listener);
+    void read(Connection& connection);
+    void write(Connection& connection);
+    void close(Connection& connection);
+    void finishCompletions();
+    std::size_t workerOf(std::uint64_t connection) const;
+
+    /**
+     * @brief serve runs a batch of frames on the session of a connection.
+     * @details Runs on the worker of the connection.
+     */
+    void serve(std::uint64_t connection, std::vector<std::uint8_t> frames);
+
+    int epoll_;
+    //! Wakes the loop for completions and stop().
+    int wakeUp_;
+    std::vector<int> listeners_;
+    std::uint16_t tcpPort_;
+    std::string unixPath_;
+    std::atomic<bool> stopping_;
+
+    // used only by the thread that runs the loop
+    std::unordered_map<int, Connection> connections_;
+    std::unordered_map<std::uint64_t, int> connectionFds_;
+    std::uint64_t nextId_;
+
+    std::mutex completionMutex_;
+    std::vector<Completion> completions_;
+
+    //! Statistics of the games of each worker, outlive the sessions.
+    std::vector<Common::GameStatistics> statistics_;
+    //! Sessions by connection id, one map per worker.
+    std::vector<std::unordered_map<std::uint64_t, Session>> sessions_;
+    //! Stopped first by the destructor, so no task runs while the sockets
+    //! are closed and the sessions destroyed.
+    WorkerPool workers_;
+};
+
+}
+
+#endif // GAMESERVER_HH
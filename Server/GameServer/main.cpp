@@ -0,0 +1,115 @@
+/* file: main.cpp
+ * description: Starts the game server. Reads the port, the Unix socket path
+ * and the number of worker threads from the command line and serves games
+ * until the process is interrupted. With --stats the statistics of the games
+ * played are written to a file when the server stops.
+ */
+
+#include "gameserver.hh"
+#include "ioexception.hh"
+#include "formatexception.hh"
+#include "trace.hh"
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+
+namespace {
+
+Server::GameServer* runningServer = nullptr;
+
+void stopServer(int)
+{
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+// every client needs a descriptor, so allow as many as the system does
+void raiseFileLimit()
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 &&
+            limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void usage(const char* program)
+{
+    std::cerr << "Usage: " << program
+              << " [--port PORT] [--unix PATH] [--workers COUNT]"
+              << " [--stats PATH]"
+              << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    int port = 7654;
+    std::string unixPath;
+    std::string statsPath;
+    unsigned workers = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 == argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--port") {
+            port = std::atoi(value.c_str());
+        } else if (option == "--unix") {
+            unixPath = value;
+        } else if (option == "--stats") {
+            statsPath = value;
+        } else if (option == "--workers") {
+            workers = static_cast<unsigned>(std::atoi(value.c_str()));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (port < 0 || port > 65535) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    raiseFileLimit();
+    try {
+        Server::GameServer server(workers);
+        server.listenTcp(static_cast<std::uint16_t>(port));
+        if (!unixPath.empty()) {
+            server.listenUnix(unixPath);
+        }
+        std::cout << "Serving games on 127.0.0.1:" << server.tcpPort()
+                  << std::endl;
+
+        runningServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        server.run();
+        runningServer = nullptr;
+        if (!statsPath.empty()) {
+            std::ofstream stats(statsPath, std::ios::trunc);
+            server.statistics().write(stats);
+            if (!stats) {
+                throw Common::IoException("Could not write statistics " +
+                                          statsPath);
+            }
+        }
+#ifdef ISLANDGAME_TRACING
+        Common::Tracer::instance().writeChromeTraceFromEnvironment();
+#endif
+    } catch (Common::IoException& e) {
+        std::cerr << e.msg() << std::endl;
+        return 1;
+    }
+    return 0;
+}
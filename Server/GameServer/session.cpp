@@ -0,0 +1,463 @@
+#include "session.hh"
+#include "initialize.hh"
+#include "formatexception.hh"
+#include "illegalmoveexception.hh"
+#include "hex.hh"
+#include "playertable.hh"
+
+namespace Server {
+
+namespace {
+
+const unsigned MAX_PLAYERS = 4;
+const unsigned MAX_PAWNS = 9;
+const unsigned ACTIONS_PER_TURN = 3;
+
+}
+
+Session::Session(Common::GameStatistics* statistics):
+    board_(nullptr),
+    state_(nullptr),
+    players_(),
+    runner_(nullptr),
+    spin_(),
+    journalSent_(0),
+    statistics_(statistics),
+    recorder_(nullptr)
+{
+}
+
+void Session::handle(FrameReader& request, std::vector<std::uint8_t>& out)
+{
+    MessageType type = request.type();
+    Status status = Status::OK;
+    int value = 0;
+    std::string text;
+
+    try {
+        if (type == MessageType::NEW_GAME) {
+            status = newGame(request);
+        } else if (runner_ == nullptr) {
+            status = Status::NO_GAME;
+        } else if (state_->checkWinCondition()) {
+            status = Status::GAME_OVER;
+            value = state_->getWinnerId();
+        } else {
+            switch (type) {
+            case MessageType::MOVE_PAWN:
+                status = movePawn(request, value);
+                break;
+            case MessageType::MOVE_TRANSPORT:
+                status = moveTransport(request, value);
+                break;
+            case MessageType::FLIP:
+                status = flip(request, value, text);
+                break;
+            case MessageType::SPIN:
+                status = spin(text);
+                break;
+            case MessageType::MOVE_ACTOR:
+                status = moveActor(request);
+                break;
+            case MessageType::MOVE_TRANSPORT_SPIN:
+                status = moveTransportWithSpinner(request);
+                break;
+            case MessageType::SKIP:
+                status = skip();
+                break;
+            case MessageType::QUERY_FLIPPABLE:
+                writeFlippable(out);
+                return;
+            default:
+                status = Status::BAD_REQUEST;
+                break;
+            }
+        }
+    } catch (Common::FormatException&) {
+        status = Status::BAD_REQUEST;
+    } catch (Common::IllegalMoveException&) {
+        status = Status::ILLEGAL;
+    }
+
+    if (runner_ != nullptr) {
+        writeUpdate(out);
+        if (status == Status::OK && state_->checkWinCondition()) {
+            status = Status::GAME_OVER;
+            value = state_->getWinnerId();
+        }
+    }
+    FrameWriter(out, MessageType::RESULT)
+            .u8(static_cast<std::uint8_t>(type))
+            .u8(static_cast<std::uint8_t>(status))
+            .i32(value)
+            .text(text)
+            .finish();
+}
+
+Status Session::newGame(FrameReader& request)
+{
+    unsigned playerCount = request.u8();
+    unsigned pawns = request.u8();
+    std::uint32_t seed = request.u32();
+    if (playerCount == 0 || playerCount > MAX_PLAYERS ||
+            pawns == 0 || pawns > MAX_PAWNS) {
+        return Status::BAD_REQUEST;
+    }
+
+    // an unfinished previous game is counted before the new one starts
+    recorder_.reset();
+    board_ = std::make_shared<Student::GameBoard>();
+    state_ = std::make_shared<Student::GameState>();
+    players_.clear();
+    std::shared_ptr<Common::PlayerTable> table =
+            std::make_shared<Common::PlayerTable>();
+    std::vector<std::shared_ptr<Common::IPlayer>> players;
+    for (unsigned i = 1; i <= playerCount; ++i) {
+        int playerId = static_cast<int>(i);
+        players_[playerId] =
+                std::make_shared<Student::Player>(table, playerId, pawns);
+        players.push_back(players_[playerId]);
+    }
+    runner_ = Common::Initialization::getGameRunner(board_, state_, players,
+                                                    seed);
+    state_->setEventPublisher(runner_->getEvents());
+    if (statistics_ != nullptr) {
+        recorder_.reset(new Common::GameStatistics::Recorder(
+                            *statistics_, runner_->getEvents()));
+    }
+
+    // pawns are placed like in the desktop game
+    for (auto player : players_) {
+        Common::CubeCoordinate start = player.second->getStartingCoord();
+        for (unsigned j = 0; j < pawns; ++j) {
+            int pawnId = player.first * 10 + static_cast<int>(j) + 1;
+            board_->addPawn(player.first, pawnId, start);
+        }
+    }
+    spin_ = {};
+    journalSent_ = 0;
+    return Status::OK;
+}
+
+Status Session::movePawn(FrameReader& request, int& value)
+{
+    int pawnId = request.i32();
+    Common::CubeCoordinate origin = request.coordinate();
+    Common::CubeCoordinate target = request.coordinate();
+    if (state_->currentGamePhase() != Common::GamePhase::MOVEMENT) {
+        return Status::WRONG_PHASE;
+    }
+    if (runner_->checkPawnMovement(origin, target, pawnId) < 0) {
+        return Status::ILLEGAL;
+    }
+
+    std::shared_ptr<Common::Pawn> pawn =
+            board_->getHex(origin)->givePawn(pawnId);
+    value = runner_->movePawn(origin, target, pawnId);
+    std::shared_ptr<Common::Transport> carrier = pawn->getTransport();
+    if (carrier != nullptr) {
+        carrier->removePawn(pawn);
+    }
+    boardTransports(target);
+    resolveActors(target);
+
+    if (board_->getHex(target)->getPieceType() == "Coral") {
+        state_->endGame(state_->currentPlayer());
+    }
+    if (value == 0 &&
+            state_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
+        state_->changeGamePhase(Common::GamePhase::SINKING);
+    }
+    return Status::OK;
+}
+
+Status Session::moveTransport(FrameReader& request, int& value)
+{
+    int transportId = request.i32();
+    Common::CubeCoordinate origin = request.coordinate();
+    Common::CubeCoordinate target = request.coordinate();
+    if (state_->currentGamePhase() != Common::GamePhase::MOVEMENT) {
+        return Status::WRONG_PHASE;
+    }
+    std::string moves = std::to_string(
+                players_.at(state_->currentPlayer())->getActionsLeft());
+    if (origin == target ||
+            runner_->checkTransportMovement(origin, target, transportId,
+                                            moves) < 0) {
+        return Status::ILLEGAL;
+    }
+
+    value = runner_->moveTransport(origin, target, transportId);
+    boardTransports(target);
+    resolveActors(target);
+    if (value == 0 &&
+            state_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
+        state_->changeGamePhase(Common::GamePhase::SINKING);
+    }
+    return Status::OK;
+}
+
+Status Session::flip(FrameReader& request, int& value, std::string& text)
+{
+    Common::CubeCoordinate coord = request.coordinate();
+    if (state_->currentGamePhase() != Common::GamePhase::SINKING) {
+        return Status::WRONG_PHASE;
+    }
+
+    text = runner_->flipTile(coord);
+    std::shared_ptr<Common::Hex> hex = board_->getHex(coord);
+    for (auto transport : hex->getTransports()) {
+        value = transport->getId();
+    }
+    boardTransports(coord);
+    for (auto actor : hex->getActors()) {
+        value = actor->getId();
+        resolveActor(actor->getId());
+    }
+    checkGameEnd();
+    if (state_->currentGamePhase() == Common::GamePhase::SINKING) {
+        state_->changeGamePhase(Common::GamePhase::SPINNING);
+    }
+    return Status::OK;
+}
+
+Status Session::spin(std::string& text)
+{
+    if (state_->currentGamePhase() != Common::GamePhase::SPINNING ||
+            !spin_.first.empty()) {
+        return Status::WRONG_PHASE;
+    }
+    spin_ = runner_->spinWheel();
+    text = spin_.first + " " + spin_.second;
+    if (!spunTypeExists()) {
+        changePlayer();
+    }
+    return Status::OK;
+}
+
+Status Session::moveActor(FrameReader& request)
+{
+    int actorId = request.i32();
+    Common::CubeCoordinate origin = request.coordinate();
+    Common::CubeCoordinate target = request.coordinate();
+    if (state_->currentGamePhase() != Common::GamePhase::SPINNING ||
+            spin_.first.empty()) {
+        return Status::WRONG_PHASE;
+    }
+    std::shared_ptr<Common::Hex> originHex = board_->getHex(origin);
+    std::shared_ptr<Common::Hex> targetHex = board_->getHex(target);
+    if (origin == target || originHex == nullptr || targetHex == nullptr ||
+            originHex->giveActor(actorId) == nullptr ||
+            originHex->giveActor(actorId)->getActorType() != spin_.first ||
+            targetHex->getActors().size() >= 3 ||
+            !runner_->checkActorMovement(origin, target, actorId,
+                                         spin_.second)) {
+        return Status::ILLEGAL;
+    }
+
+    runner_->moveActor(origin, target, actorId, spin_.second);
+    resolveActor(actorId);
+    checkGameEnd();
+    changePlayer();
+    return Status::OK;
+}
+
+Status Session::moveTransportWithSpinner(FrameReader& request)
+{
+    int transportId = request.i32();
+    Common::CubeCoordinate origin = request.coordinate();
+    Common::CubeCoordinate target = request.coordinate();
+    if (state_->currentGamePhase() != Common::GamePhase::SPINNING ||
+            spin_.first.empty()) {
+        return Status::WRONG_PHASE;
+    }
+    std::shared_ptr<Common::Hex> originHex = board_->getHex(origin);
+    if (origin == target || originHex == nullptr ||
+            originHex->giveTransport(transportId) == nullptr ||
+            originHex->giveTransport(transportId)->getTransportType() !=
+            spin_.first ||
+            runner_->checkTransportMovement(origin, target, transportId,
+                                            spin_.second) < 0) {
+        return Status::ILLEGAL;
+    }
+
+    runner_->moveTransportWithSpinner(origin, target, transportId,
+                                      spin_.second);
+    boardTransports(target);
+    resolveActors(target);
+    checkGameEnd();
+    changePlayer();
+    return Status::OK;
+}
+
+Status Session::skip()
+{
+    if (state_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
+        state_->changeGamePhase(Common::GamePhase::SINKING);
+        return Status::OK;
+    }
+    if (state_->currentGamePhase() == Common::GamePhase::SPINNING) {
+        changePlayer();
+        return Status::OK;
+    }
+    return Status::WRONG_PHASE;
+}
+
+void Session::writeFlippable(std::vector<std::uint8_t>& out) const
+{
+    std::vector<Common::CubeCoordinate> tiles = runner_->getFlippableTiles();
+    FrameWriter frame(out, MessageType::FLIPPABLE);
+    frame.u16(static_cast<std::uint16_t>(tiles.size()));
+    for (const Common::CubeCoordinate& tile : tiles) {
+        frame.coordinate(tile);
+    }
+    frame.finish();
+}
+
+void Session::boardTransports(Common::CubeCoordinate location)
+{
+    std::shared_ptr<Common::Hex> hex = board_->getHex(location);
+    for (auto transport : hex->getTransports()) {
+        for (auto pawn : hex->getPawns()) {
+            if (!hex->isPawnInTransport(pawn)) {
+                board_->boardPawn(pawn->getId(), transport->getId());
+            }
+        }
+    }
+}
+
+void Session::resolveActors(Common::CubeCoordinate location)
+{
+    for (auto actor : board_->getHex(location)->getActors()) {
+        resolveActor(actor->getId());
+    }
+    checkGameEnd();
+}
+
+void Session::resolveActor(int actorId)
+{
+    Common::CubeCoordinate location = board_->getActorCoords(actorId);
+    std::shared_ptr<Common::Hex> hex = board_->getHex(location);
+    std::shared_ptr<Common::Actor> actor = hex->giveActor(actorId);
+    std::string actorType = actor->getActorType();
+
+    // the same effects as MainWindow::actorDoAction
+    if (actorType == "shark") {
+        removePawns(location);
+    } else if (actorType == "kraken") {
+        removeTransports(location);
+        for (auto otherActor : hex->getActors()) {
+            if (otherActor->getActorType() == "shark") {
+                resolveActor(otherActor->getId());
+            }
+        }
+    } else if (actorType == "seamunster") {
+        removeTransports(location);
+        removePawns(location);
+    } else if (actorType == "vortex") {
+        removeTransports(location);
+        removePawns(location);
+        removeActors(location);
+        for (auto neighbour : hex->getNeighbourVector()) {
+            if (board_->getHex(neighbour) != nullptr) {
+                removeTransports(neighbour);
+                removePawns(neighbour);
+                removeActors(neighbour);
+            }
+        }
+    }
+    // a vortex also clears itself away, the board drops it from its store
+    actor->doAction();
+}
+
+void Session::removePawns(Common::CubeCoordinate location)
+{
+    std::shared_ptr<Common::Hex> hex = board_->getHex(location);
+    for (auto pawn : hex->getPawns()) {
+        if (!hex->isPawnInTransport(pawn)) {
+            players_.at(pawn->getPlayerId())->removePawn();
+            board_->removePawn(pawn->getId());
+        }
+    }
+}
+
+void Session::removeActors(Common::CubeCoordinate location)
+{
+    for (auto actor : board_->getHex(location)->getActors()) {
+        if (actor->getActorType() != "vortex") {
+            board_->removeActor(actor->getId());
+        }
+    }
+}
+
+void Session::removeTransports(Common::CubeCoordinate location)
+{
+    for (auto transport : board_->getHex(location)->getTransports()) {
+        transport->removePawns();
+        board_->removeTransport(transport->getId());
+    }
+}
+
+void Session::changePlayer()
+{
+    spin_ = {};
+    // players without pawns are skipped, like in MainWindow::checkPawns
+    int next = state_->currentPlayer();
+    for (std::size_t i = 0; i < players_.size(); ++i) {
+        next = next % static_cast<int>(players_.size()) + 1;
+        if (players_.at(next)->getPawns() != 0) {
+            break;
+        }
+    }
+    state_->changePlayerTurn(next);
+    players_.at(next)->setActionsLeft(ACTIONS_PER_TURN);
+    state_->changeGamePhase(Common::GamePhase::MOVEMENT);
+}
+
+void Session::checkGameEnd()
+{
+    std::vector<int> playersNotOut;
+    for (auto player : players_) {
+        if (player.second->getPawns() != 0) {
+            playersNotOut.push_back(player.first);
+        }
+    }
+    if (playersNotOut.size() == 1 && players_.size() > 1) {
+        state_->endGame(playersNotOut.front());
+    }
+}
+
+bool Session::spunTypeExists() const
+{
+    const Student::EntityStore& entities = board_->getEntities();
+    for (std::size_t row = 0; row < entities.size(); ++row) {
+        Student::EntityKind kind = entities.kinds()[row];
+        int id = entities.ids()[row];
+        std::shared_ptr<Common::Hex> hex =
+                board_->getHex(entities.positions()[row]);
+        if (kind == Student::EntityKind::ACTOR &&
+                hex->giveActor(id)->getActorType() == spin_.first) {
+            return true;
+        }
+        if (kind == Student::EntityKind::TRANSPORT &&
+                hex->giveTransport(id)->getTransportType() == spin_.first) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Session::writeUpdate(std::vector<std::uint8_t>& out)
+{
+    const std::vector<std::uint8_t>& journal = runner_->getJournal()->data();
+    if (journal.size() == journalSent_) {
+        return;
+    }
+    FrameWriter(out, MessageType::UPDATE)
+            .bytes(journal.data() + journalSent_,
+                   journal.size() - journalSent_)
+            .finish();
+    journalSent_ = journal.size();
+}
+
+}
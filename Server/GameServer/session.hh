@@ -0,0 +1,95 @@
+#ifndef SESSION_HH
+#define SESSION_HH
+
+#include "protocol.hh"
+#include "gameboard.hh"
+#include "gamestate.hh"
+#include "player.hh"
+#include "igamerunner.hh"
+#include "gamestatistics.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file
+ * @brief A game played over one client connection.
+ */
+
+namespace Server {
+
+/**
+ * @brief Session runs the game of one connection.
+ * @details The session plays the part MainWindow plays in the desktop game:
+ * it validates each request with the check functions of the game runner,
+ * carries out the move, resolves the actors and advances the phases and
+ * turns. A session is only used from one worker thread at a time.
+ */
+class Session {
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param statistics Where the games of the session are added when they
+     * end or the session is destroyed, nullptr to keep no statistics.
+     */
+    explicit Session(Common::GameStatistics* statistics = nullptr);
+
+    /**
+     * @brief handle carries out one request.
+     * @param request The request.
+     * @param out Buffer the UPDATE and RESULT frames are appended to.
+     * @post Exception quarantee: basic
+     */
+    void handle(FrameReader& request, std::vector<std::uint8_t>& out);
+
+private:
+
+    Status newGame(FrameReader& request);
+    Status movePawn(FrameReader& request, int& value);
+    Status moveTransport(FrameReader& request, int& value);
+    Status flip(FrameReader& request, int& value, std::string& text);
+    Status spin(std::string& text);
+    Status moveActor(FrameReader& request);
+    Status moveTransportWithSpinner(FrameReader& request);
+    Status skip();
+    void writeFlippable(std::vector<std::uint8_t>& out) const;
+
+    void boardTransports(Common::CubeCoordinate location);
+    void resolveActors(Common::CubeCoordinate location);
+    void resolveActor(int actorId);
+    void removePawns(Common::CubeCoordinate location);
+    void removeActors(Common::CubeCoordinate location);
+    void removeTransports(Common::CubeCoordinate location);
+    void changePlayer();
+    void checkGameEnd();
+    bool spunTypeExists() const;
+
+    /**
+     * @brief writeUpdate sends the journal events recorded since the
+     * previous update.
+     */
+    void writeUpdate(std::vector<std::uint8_t>& out);
+
+    std::shared_ptr<Student::GameBoard> board_;
+    std::shared_ptr<Student::GameState> state_;
+    std::map<int, std::shared_ptr<Student::Player>> players_;
+    std::shared_ptr<Common::IGameRunner> runner_;
+
+    //! Result of the spin of this turn, empty before the spin.
+    std::pair<std::string, std::string> spin_;
+    //! Bytes of the journal sent to the client.
+    std::size_t journalSent_;
+    Common::GameStatistics* statistics_;
+    std::unique_ptr<Common::GameStatistics::Recorder> recorder_;
+};
+
+}
+
+#endif // SESSION_HH
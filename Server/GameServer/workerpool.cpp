@@ -0,0 +1,79 @@
+#include "workerpool.hh"
+
+namespace Server {
+
+WorkerPool::WorkerPool(std::size_t workers):
+    workers_()
+{
+    for (std::size_t i = 0; i < (workers == 0 ? 1 : workers); ++i) {
+        workers_.emplace_back(new Worker());
+    }
+    for (auto& worker : workers_) {
+        Worker& current = *worker;
+        worker->thread = std::thread([&current]() { run(current); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+std::size_t WorkerPool::size() const
+{
+    return workers_.size();
+}
+
+void WorkerPool::post(std::size_t worker, std::function<void()> task)
+{
+    Worker& target = *workers_.at(worker);
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        wasEmpty = target.tasks.empty();
+        target.tasks.push_back(std::move(task));
+    }
+    if (wasEmpty) {
+        target.wakeUp.notify_one();
+    }
+}
+
+void WorkerPool::stop()
+{
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stopping = true;
+        }
+        worker->wakeUp.notify_one();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void WorkerPool::run(Worker& worker)
+{
+    std::deque<std::function<void()>> tasks;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.wakeUp.wait(lock, [&worker]() {
+                return worker.stopping || !worker.tasks.empty();
+            });
+            if (worker.tasks.empty()) {
+                return;
+            }
+            // take the whole queue so posting does not wait for the tasks
+            tasks.swap(worker.tasks);
+        }
+        for (auto& task : tasks) {
+            task();
+        }
+        tasks.clear();
+    }
+}
+
+}
@@ -0,0 +1,78 @@
+#ifndef WORKERPOOL_HH
+#define WORKERPOOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ * @brief Threads that run the sessions of the game server.
+ */
+
+namespace Server {
+
+/**
+ * @brief WorkerPool runs tasks on a fixed set of threads.
+ * @details Every worker has its own queue, so tasks posted to the same
+ * worker run one at a time in the order they were posted. The server uses
+ * this to keep a session on one thread without locking it.
+ */
+class WorkerPool {
+
+public:
+
+    /**
+     * @brief Constructor, starts the threads.
+     * @param workers Number of threads, at least one.
+     */
+    explicit WorkerPool(std::size_t workers);
+
+    /**
+     * @brief Destructor, stops the pool if stop() has not been called.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    std::size_t size() const;
+
+    /**
+     * @brief post queues a task for a worker.
+     * @param worker Index of the worker, less than size().
+     * @param task The task. It must not throw.
+     * @post Exception quarantee: strong
+     */
+    void post(std::size_t worker, std::function<void()> task);
+
+    /**
+     * @brief stop runs the queued tasks and joins the threads. Tasks posted
+     * after this are not run. Calling it again does nothing.
+     * @post Exception quarantee: nothrow
+     */
+    void stop();
+
+private:
+
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    static void run(Worker& worker);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}
+
+#endif // WORKERPOOL_HH
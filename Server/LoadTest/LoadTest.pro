@@ -0,0 +1,18 @@
+QT       -= core gui
+
+TARGET = IslandGameLoadTest
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+SOURCES += \
+    loadtest.cpp \
+    ../Protocol/protocol.cpp \
+    ../../GameLogic/Engine/formatexception.cpp \
+    ../../GameLogic/Engine/gameexception.cpp
+
+HEADERS += \
+    ../Protocol/protocol.hh
+
+INCLUDEPATH += $$PWD/../Protocol $$PWD/../../GameLogic/Engine
+DEPENDPATH += $$PWD/../Protocol $$PWD/../../GameLogic/Engine
@@ -0,0 +1,372 @@
+/* file: loadtest.cpp
+ * description: Plays games on a running game server over many loopback
+ * connections at once and reports the sustained request rate and the
+ * latency of the requests.
+ */
+
+#include "protocol.hh"
+#include "formatexception.hh"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Common::CubeCoordinate DIRECTIONS[] = {
+    {1, -1, 0}, {1, 0, -1}, {0, 1, -1}, {-1, 1, 0}, {-1, 0, 1}, {0, -1, 1}
+};
+const int PAWN_ID = 11;
+const Common::CubeCoordinate START = {-1, 1, 0};
+
+enum class Step { NEW_GAME, MOVE, SKIP_MOVEMENT, QUERY, FLIP, SPIN, SKIP_SPIN };
+
+struct Client {
+    int fd = -1;
+    std::vector<std::uint8_t> input;
+    std::vector<std::uint8_t> output;
+    std::size_t written = 0;
+    bool waitingToWrite = false;
+    Step step = Step::NEW_GAME;
+    Common::CubeCoordinate pawn = START;
+    int direction = 0;
+    int triedDirections = 0;
+    std::vector<Common::CubeCoordinate> flippable;
+    Clock::time_point sent;
+};
+
+struct Totals {
+    std::size_t requests = 0;
+    std::size_t pawnMoves = 0;
+    std::size_t games = 0;
+    std::size_t updateBytes = 0;
+    std::vector<std::uint32_t> latencies;
+    bool measuring = false;
+};
+
+Common::CubeCoordinate add(Common::CubeCoordinate a, Common::CubeCoordinate b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+void fail(const std::string& what)
+{
+    std::cerr << what << ": " << std::strerror(errno) << std::endl;
+    std::exit(1);
+}
+
+void flush(int epoll, Client& client)
+{
+    while (client.written < client.output.size()) {
+        ssize_t count = send(client.fd, client.output.data() + client.written,
+                             client.output.size() - client.written,
+                             MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            fail("send failed");
+        }
+        client.written += static_cast<std::size_t>(count);
+    }
+    bool pending = client.written < client.output.size();
+    if (!pending) {
+        client.output.clear();
+        client.written = 0;
+    }
+    if (pending != client.waitingToWrite) {
+        epoll_event event = {};
+        event.events = pending ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.ptr = &client;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, client.fd, &event);
+        client.waitingToWrite = pending;
+    }
+}
+
+void sendRequest(int epoll, Client& client, std::mt19937& random)
+{
+    std::vector<std::uint8_t>& out = client.output;
+    switch (client.step) {
+    case Step::NEW_GAME:
+        Server::FrameWriter(out, Server::MessageType::NEW_GAME)
+                .u8(1).u8(1).u32(static_cast<std::uint32_t>(random()))
+                .finish();
+        client.pawn = START;
+        client.triedDirections = 0;
+        break;
+    case Step::MOVE:
+        Server::FrameWriter(out, Server::MessageType::MOVE_PAWN)
+                .i32(PAWN_ID).coordinate(client.pawn)
+                .coordinate(add(client.pawn, DIRECTIONS[client.direction]))
+                .finish();
+        break;
+    case Step::SKIP_MOVEMENT:
+    case Step::SKIP_SPIN:
+        Server::FrameWriter(out, Server::MessageType::SKIP).finish();
+        break;
+    case Step::QUERY:
+        Server::FrameWriter(out, Server::MessageType::QUERY_FLIPPABLE)
+                .finish();
+        break;
+    case Step::FLIP:
+        Server::FrameWriter(out, Server::MessageType::FLIP)
+                .coordinate(client.flippable[random() %
+                                             client.flippable.size()])
+                .finish();
+        break;
+    case Step::SPIN:
+        Server::FrameWriter(out, Server::MessageType::SPIN).finish();
+        break;
+    }
+    client.sent = Clock::now();
+    flush(epoll, client);
+}
+
+// picks the next request from the answer to the previous one
+void advance(Client& client, Server::Status status, Totals& totals)
+{
+    if (status == Server::Status::GAME_OVER ||
+            status == Server::Status::NO_GAME) {
+        client.step = Step::NEW_GAME;
+        return;
+    }
+    if (status == Server::Status::BAD_REQUEST) {
+        std::cerr << "Server rejected a request" << std::endl;
+        std::exit(1);
+    }
+    bool ok = status == Server::Status::OK;
+    switch (client.step) {
+    case Step::NEW_GAME:
+        ++totals.games;
+        client.step = Step::MOVE;
+        break;
+    case Step::MOVE:
+        if (ok) {
+            if (totals.measuring) {
+                ++totals.pawnMoves;
+            }
+            client.pawn = add(client.pawn, DIRECTIONS[client.direction]);
+            client.triedDirections = 0;
+            client.step = Step::SKIP_MOVEMENT;
+        } else if (status == Server::Status::WRONG_PHASE) {
+            client.step = Step::QUERY;
+        } else if (++client.triedDirections == 6) {
+            // the pawn is gone or stuck
+            client.step = Step::NEW_GAME;
+        }
+        client.direction = (client.direction + 1) % 6;
+        break;
+    case Step::SKIP_MOVEMENT:
+        client.step = Step::QUERY;
+        break;
+    case Step::QUERY:
+        client.step = client.flippable.empty() ? Step::NEW_GAME : Step::FLIP;
+        break;
+    case Step::FLIP:
+        client.step = ok ? Step::SPIN : Step::NEW_GAME;
+        break;
+    case Step::SPIN:
+        client.step = ok ? Step::SKIP_SPIN : Step::MOVE;
+        break;
+    case Step::SKIP_SPIN:
+        client.step = Step::MOVE;
+        break;
+    }
+}
+
+// returns true when the answer to the request has arrived
+bool readFrames(Client& client, Totals& totals, Server::Status& status)
+{
+    std::size_t position = 0;
+    bool answered = false;
+    std::size_t size;
+    while ((size = Server::frameSize(client.input.data() + position,
+                                     client.input.size() - position)) != 0) {
+        Server::FrameReader frame(client.input.data() + position, size);
+        position += size;
+        if (frame.type() == Server::MessageType::UPDATE) {
+            totals.updateBytes += size;
+        } else if (frame.type() == Server::MessageType::FLIPPABLE) {
+            client.flippable.resize(frame.u16());
+            for (auto& coord : client.flippable) {
+                coord = frame.coordinate();
+            }
+            status = Server::Status::OK;
+            answered = true;
+        } else if (frame.type() == Server::MessageType::RESULT) {
+            frame.u8();
+            status = static_cast<Server::Status>(frame.u8());
+            answered = true;
+        }
+    }
+    client.input.erase(client.input.begin(), client.input.begin() + position);
+    return answered;
+}
+
+std::uint32_t percentile(std::vector<std::uint32_t>& values, double share)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::size_t index = static_cast<std::size_t>(share * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    int port = 7654;
+    std::size_t sessions = 10000;
+    int seconds = 10;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (option == "--port") {
+            port = value;
+        } else if (option == "--sessions") {
+            sessions = static_cast<std::size_t>(value);
+        } else if (option == "--seconds") {
+            seconds = value;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--port PORT]"
+                      << " [--sessions COUNT] [--seconds SECONDS]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    int epoll = epoll_create1(0);
+    if (epoll < 0) {
+        fail("epoll_create1 failed");
+    }
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+
+    std::vector<Client> clients(sessions);
+    std::mt19937 random(12345);
+    Totals totals;
+    Clock::time_point start = Clock::now();
+    for (Client& client : clients) {
+        // blocking connect keeps the accept backlog of the server short
+        client.fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (client.fd < 0 ||
+                connect(client.fd, reinterpret_cast<sockaddr*>(&address),
+                        sizeof(address)) < 0) {
+            fail("connect failed");
+        }
+        int on = 1;
+        setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        int flags = fcntl(client.fd, F_GETFL, 0);
+        fcntl(client.fd, F_SETFL, flags | O_NONBLOCK);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &client;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, client.fd, &event);
+        sendRequest(epoll, client, random);
+    }
+    std::cout << sessions << " sessions connected" << std::endl;
+
+    // measure once every session is in a game, starting the games is
+    // much slower than playing them
+    Clock::time_point measureFrom;
+    Clock::time_point end;
+    std::vector<epoll_event> events(1024);
+    std::uint8_t buffer[16 * 1024];
+    while (true) {
+        Clock::time_point now = Clock::now();
+        if (!totals.measuring && totals.games >= sessions) {
+            totals.measuring = true;
+            measureFrom = now;
+            end = now + std::chrono::seconds(seconds);
+        }
+        if (totals.measuring && now >= end) {
+            break;
+        }
+        int count = epoll_wait(epoll, events.data(),
+                               static_cast<int>(events.size()), 100);
+        if (count < 0 && errno != EINTR) {
+            fail("epoll_wait failed");
+        }
+        for (int i = 0; i < count; ++i) {
+            Client& client = *static_cast<Client*>(events[i].data.ptr);
+            if (events[i].events & EPOLLOUT) {
+                flush(epoll, client);
+            }
+            if (!(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                continue;
+            }
+            ssize_t read;
+            while ((read = ::read(client.fd, buffer, sizeof(buffer))) > 0) {
+                client.input.insert(client.input.end(), buffer, buffer + read);
+            }
+            if (read == 0 || (read < 0 && errno != EAGAIN)) {
+                std::cerr << "Server closed a connection" << std::endl;
+                return 1;
+            }
+            Server::Status status = Server::Status::OK;
+            try {
+                if (!readFrames(client, totals, status)) {
+                    continue;
+                }
+            } catch (Common::FormatException& e) {
+                std::cerr << e.msg() << std::endl;
+                return 1;
+            }
+            if (totals.measuring) {
+                ++totals.requests;
+                totals.latencies.push_back(static_cast<std::uint32_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - client.sent).count()));
+            }
+            advance(client, status, totals);
+            sendRequest(epoll, client, random);
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() -
+                                                   measureFrom).count();
+    std::cout << "requests/s: " << totals.requests / elapsed << "\n"
+              << "pawn moves/s: " << totals.pawnMoves / elapsed << "\n"
+              << "games started: " << totals.games << " ("
+              << std::chrono::duration<double>(measureFrom - start).count()
+              << " s to start the first " << sessions << ")\n"
+              << "update bytes: " << totals.updateBytes << "\n"
+              << "latency p50: " << percentile(totals.latencies, 0.5)
+              << " us\n"
+              << "latency p99: " << percentile(totals.latencies, 0.99)
+              << " us" << std::endl;
+    for (Client& client : clients) {
+        close(client.fd);
+    }
+    close(epoll);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "protocol.hh"
+#include "formatexception.hh"
+
+namespace Server {
+
+namespace {
+
+std::uint32_t readLength(const std::uint8_t* data)
+{
+    return static_cast<std::uint32_t>(data[0]) |
+            static_cast<std::uint32_t>(data[1]) << 8 |
+            static_cast<std::uint32_t>(data[2]) << 16 |
+            static_cast<std::uint32_t>(data[3]) << 24;
+}
+
+}
+
+std::size_t frameSize(const std::uint8_t* data, std::size_t size)
+{
+    if (size < FRAME_LENGTH_SIZE) {
+        return 0;
+    }
+    std::uint32_t length = readLength(data);
+    if (length == 0 || length > MAX_FRAME_SIZE) {
+        throw Common::FormatException("Invalid frame length");
+    }
+    if (size - FRAME_LENGTH_SIZE < length) {
+        return 0;
+    }
+    return FRAME_LENGTH_SIZE + length;
+}
+
+FrameWriter::FrameWriter(std::vector<std::uint8_t>& out, MessageType type):
+    out_(out),
+    start_(out.size())
+{
+    out_.resize(out_.size() + FRAME_LENGTH_SIZE);
+    u8(static_cast<std::uint8_t>(type));
+}
+
+FrameWriter& FrameWriter::u8(std::uint8_t value)
+{
+    out_.push_back(value);
+    return *this;
+}
+
+FrameWriter& FrameWriter::u16(std::uint16_t value)
+{
+    out_.push_back(static_cast<std::uint8_t>(value));
+    out_.push_back(static_cast<std::uint8_t>(value >> 8));
+    return *this;
+}
+
+FrameWriter& FrameWriter::u32(std::uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8) {
+        out_.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::i32(std::int32_t value)
+{
+    return u32(static_cast<std::uint32_t>(value));
+}
+
+FrameWriter& FrameWriter::coordinate(Common::CubeCoordinate coord)
+{
+    u16(static_cast<std::uint16_t>(coord.x));
+    return u16(static_cast<std::uint16_t>(coord.z));
+}
+
+FrameWriter& FrameWriter::text(const std::string& value)
+{
+    std::size_t size = value.size() < 255 ? value.size() : 255;
+    u8(static_cast<std::uint8_t>(size));
+    out_.insert(out_.end(), value.begin(), value.begin() + size);
+    return *this;
+}
+
+FrameWriter& FrameWriter::bytes(const std::uint8_t* data, std::size_t size)
+{
+    out_.insert(out_.end(), data, data + size);
+    return *this;
+}
+
+void FrameWriter::finish()
+{
+    std::uint32_t length =
+            static_cast<std::uint32_t>(out_.size() - start_ - FRAME_LENGTH_SIZE);
+    for (std::size_t i = 0; i < FRAME_LENGTH_SIZE; ++i) {
+        out_[start_ + i] = static_cast<std::uint8_t>(length >> (8 * i));
+    }
+}
+
+FrameReader::FrameReader(const std::uint8_t* frame, std::size_t size):
+    type_(static_cast<MessageType>(frame[FRAME_LENGTH_SIZE])),
+    position_(frame + FRAME_LENGTH_SIZE + 1),
+    end_(frame + size)
+{
+}
+
+MessageType FrameReader::type() const
+{
+    return type_;
+}
+
+std::uint8_t FrameReader::u8()
+{
+    return *take(1);
+}
+
+std::uint16_t FrameReader::u16()
+{
+    const std::uint8_t* data = take(2);
+    return static_cast<std::uint16_t>(data[0] | data[1] << 8);
+}
+
+std::uint32_t FrameReader::u32()
+{
+    return readLength(take(4));
+}
+
+std::int32_t FrameReader::i32()
+{
+    return static_cast<std::int32_t>(u32());
+}
+
+Common::CubeCoordinate FrameReader::coordinate()
+{
+    int x = static_cast<std::int16_t>(u16());
+    int z = static_cast<std::int16_t>(u16());
+    return Common::CubeCoordinate(x, -x - z, z);
+}
+
+std::string FrameReader::text()
+{
+    std::size_t size = u8();
+    const std::uint8_t* data = take(size);
+    return std::string(data, data + size);
+}
+
+std::vector<std::uint8_t> FrameReader::rest()
+{
+    std::vector<std::uint8_t> result(position_, end_);
+    position_ = end_;
+    return result;
+}
+
+const std::uint8_t* FrameReader::take(std::size_t size)
+{
+    if (static_cast<std::size_t>(end_ - position_) < size) {
+        throw Common::FormatException("Truncated message");
+    }
+    const std::uint8_t* data = position_;
+    position_ += size;
+    return data;
+}
+
+}
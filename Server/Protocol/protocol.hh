@@ -0,0 +1,171 @@
+#ifndef PROTOCOL_HH
+#define PROTOCOL_HH
+
+#include "cubecoordinate.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @brief Wire format between the game server and its clients.
+ * @details Every message is a frame: the length of the rest of the frame as
+ * a 32-bit little-endian integer, a MessageType byte and the payload.
+ * Integers in the payload are little-endian, coordinates are the x and z of
+ * a cube coordinate as 16-bit integers and strings are a length byte
+ * followed by the bytes.
+ */
+
+namespace Server {
+
+enum class MessageType : std::uint8_t {
+    // Client to server
+
+    //! Starts a new game, replacing the current one: u8 players,
+    //! u8 pawns per player, u32 seed.
+    NEW_GAME = 1,
+    //! i32 pawn id, origin, target.
+    MOVE_PAWN = 2,
+    //! Transport move in the movement phase: i32 transport id, origin, target.
+    MOVE_TRANSPORT = 3,
+    //! Sinks a tile: coordinate.
+    FLIP = 4,
+    //! Spins the wheel, no payload.
+    SPIN = 5,
+    //! Moves an actor by the result of the spin: i32 actor id, origin, target.
+    MOVE_ACTOR = 6,
+    //! Moves a transport by the result of the spin: i32 transport id, origin,
+    //! target.
+    MOVE_TRANSPORT_SPIN = 7,
+    //! Ends the movement or spinning phase, no payload.
+    SKIP = 8,
+    //! Asks for the tiles that can be flipped, no payload.
+    QUERY_FLIPPABLE = 9,
+
+    // Server to client
+
+    //! Answer to every request: u8 request type, u8 Status, i32 value,
+    //! string. The value and the string depend on the request: moves left,
+    //! the spawned actor (id and type) or the spin ("animal moves").
+    RESULT = 64,
+    //! Events of the game since the previous update, in the GameJournal
+    //! format. The first update of a game starts with the journal header.
+    //! Sent before the RESULT of the request that caused them.
+    UPDATE = 65,
+    //! u16 count, coordinates.
+    FLIPPABLE = 66
+};
+
+enum class Status : std::uint8_t {
+    OK = 0,
+    //! The engine rejected the move.
+    ILLEGAL = 1,
+    //! The request is not allowed in the current phase.
+    WRONG_PHASE = 2,
+    //! No game has been started on the connection.
+    NO_GAME = 3,
+    //! The request could not be decoded.
+    BAD_REQUEST = 4,
+    //! The game has a winner, value is its id.
+    GAME_OVER = 5
+};
+
+//! Bytes before the type of a frame.
+const std::size_t FRAME_LENGTH_SIZE = 4;
+
+//! Frames larger than this are treated as a protocol error.
+const std::size_t MAX_FRAME_SIZE = 1024 * 1024;
+
+/**
+ * @brief frameSize tells if a complete frame is at the start of a buffer.
+ * @param data Start of the buffer.
+ * @param size Bytes in the buffer.
+ * @return Size of the whole frame, or 0 if more bytes are needed.
+ * @exception FormatException The frame is empty or larger than
+ * MAX_FRAME_SIZE.
+ */
+std::size_t frameSize(const std::uint8_t* data, std::size_t size);
+
+/**
+ * @brief FrameWriter appends a frame to a buffer.
+ */
+class FrameWriter {
+
+public:
+
+    /**
+     * @brief Constructor, starts the frame.
+     * @param out Buffer the frame is appended to.
+     * @param type Type of the message.
+     */
+    FrameWriter(std::vector<std::uint8_t>& out, MessageType type);
+
+    FrameWriter& u8(std::uint8_t value);
+    FrameWriter& u16(std::uint16_t value);
+    FrameWriter& u32(std::uint32_t value);
+    FrameWriter& i32(std::int32_t value);
+    FrameWriter& coordinate(Common::CubeCoordinate coord);
+    FrameWriter& text(const std::string& value);
+    FrameWriter& bytes(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * @brief finish writes the length of the frame.
+     * @post The frame is complete, nothing may be added.
+     */
+    void finish();
+
+private:
+
+    std::vector<std::uint8_t>& out_;
+    std::size_t start_;
+};
+
+/**
+ * @brief FrameReader reads the payload of a frame.
+ * @details The reader does not copy the data, which has to outlive it.
+ */
+class FrameReader {
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param frame Start of a complete frame.
+     * @param size Size of the frame, as returned by frameSize().
+     */
+    FrameReader(const std::uint8_t* frame, std::size_t size);
+
+    MessageType type() const;
+
+    //! @exception FormatException The payload is too short.
+    std::uint8_t u8();
+    //! @exception FormatException The payload is too short.
+    std::uint16_t u16();
+    //! @exception FormatException The payload is too short.
+    std::uint32_t u32();
+    //! @exception FormatException The payload is too short.
+    std::int32_t i32();
+    //! @exception FormatException The payload is too short.
+    Common::CubeCoordinate coordinate();
+    //! @exception FormatException The payload is too short.
+    std::string text();
+
+    /**
+     * @brief rest returns the unread part of the payload.
+     */
+    std::vector<std::uint8_t> rest();
+
+private:
+
+    const std::uint8_t* take(std::size_t size);
+
+    MessageType type_;
+    const std::uint8_t* position_;
+    const std::uint8_t* end_;
+};
+
+}
+
+#endif // PROTOCOL_HH
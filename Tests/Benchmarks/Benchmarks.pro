@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    TerrainRendering \
+    ItemMovement \
+    SpriteAtlas \
+    HexDistance
@@ -0,0 +1,30 @@
+QT       += testlib
+QT       -= gui
+
+TARGET = tst_hexdistancebench
+CONFIG   += console
+CONFIG   -= app_bundle
+CONFIG   += c++14
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# qmake CONFIG+=avx2 measures the AVX2 kernels, see hexdistance.hh
+avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2
+}
+
+SOURCES += \
+    tst_hexdistancebench.cpp \
+    ../../../GameLogic/Engine/hexdistance.cpp
+
+HEADERS += \
+    ../../../GameLogic/Engine/cubecoordinate.hh \
+    ../../../GameLogic/Engine/hexdistance.hh
+
+INCLUDEPATH += ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../GameLogic/Engine/
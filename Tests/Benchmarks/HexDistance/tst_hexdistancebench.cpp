@@ -0,0 +1,146 @@
+#include <QtTest>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cubecoordinate.hh"
+#include "hexdistance.hh"
+
+namespace {
+
+// a board of radius 36 has about 4000 hexes
+const int BOARD_RADIUS = 36;
+const int WATER_PERCENT = 40;
+const int RANGE = 5;
+
+}
+
+/**
+ * @brief Cost of measuring from one hex to every hex of a board of radius
+ * BOARD_RADIUS.
+ * @details The scalar benchmarks are the loops the engine had before, one
+ * GameEngine::cubeCoordinateDistance call per hex. The kernel benchmarks
+ * use the kernels this build selected, hexKernelName tells which. Each
+ * benchmark checks its result against the scalar loop.
+ */
+class HexDistanceBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    HexDistanceBench();
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchScalarDistances();
+    void benchHexDistances();
+    void benchScalarWaterWithin();
+    void benchWaterWithin();
+
+private:
+    void scalarDistances(std::vector<std::int32_t>& distances) const;
+    std::size_t scalarWaterWithin(std::vector<std::uint32_t>& indices) const;
+
+    std::vector<Common::CubeCoordinate> coordinates_;
+    std::vector<bool> water_;
+    Common::HexBatch batch_;
+    Common::CubeCoordinate origin_;
+};
+
+HexDistanceBench::HexDistanceBench() :
+    coordinates_(),
+    water_(),
+    batch_(),
+    origin_(3, -5, 2)
+{
+}
+
+void HexDistanceBench::initTestCase()
+{
+    qDebug("hex kernels: %s", Common::hexKernelName());
+
+    std::mt19937 random(49);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (int x = -BOARD_RADIUS; x <= BOARD_RADIUS; ++x) {
+        for (int z = -BOARD_RADIUS; z <= BOARD_RADIUS; ++z) {
+            int y = -x - z;
+            if (y < -BOARD_RADIUS || y > BOARD_RADIUS) {
+                continue;
+            }
+            bool water = percent(random) < WATER_PERCENT;
+            coordinates_.push_back(Common::CubeCoordinate(x, y, z));
+            water_.push_back(water);
+            batch_.add(Common::CubeCoordinate(x, y, z), water);
+        }
+    }
+}
+
+void HexDistanceBench::benchScalarDistances()
+{
+    std::vector<std::int32_t> distances(coordinates_.size());
+    QBENCHMARK {
+        scalarDistances(distances);
+    }
+}
+
+void HexDistanceBench::benchHexDistances()
+{
+    std::vector<std::int32_t> distances(batch_.size());
+    QBENCHMARK {
+        Common::hexDistances(origin_, batch_, distances.data());
+    }
+
+    std::vector<std::int32_t> expected(coordinates_.size());
+    scalarDistances(expected);
+    QCOMPARE(distances, expected);
+}
+
+void HexDistanceBench::benchScalarWaterWithin()
+{
+    std::vector<std::uint32_t> indices(coordinates_.size());
+    QBENCHMARK {
+        scalarWaterWithin(indices);
+    }
+}
+
+void HexDistanceBench::benchWaterWithin()
+{
+    std::vector<std::uint32_t> indices(batch_.size());
+    std::size_t found = 0;
+    QBENCHMARK {
+        found = Common::waterWithin(origin_, batch_, RANGE, indices.data());
+    }
+
+    std::vector<std::uint32_t> expected(coordinates_.size());
+    QCOMPARE(found, scalarWaterWithin(expected));
+    indices.resize(found);
+    expected.resize(found);
+    QCOMPARE(indices, expected);
+}
+
+void HexDistanceBench::scalarDistances(
+        std::vector<std::int32_t>& distances) const
+{
+    for (std::size_t i = 0; i < coordinates_.size(); ++i) {
+        distances[i] = static_cast<std::int32_t>(
+                    Common::hexDistance(origin_, coordinates_[i]));
+    }
+}
+
+std::size_t HexDistanceBench::scalarWaterWithin(
+        std::vector<std::uint32_t>& indices) const
+{
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < coordinates_.size(); ++i) {
+        if (water_[i] && Common::hexDistance(origin_, coordinates_[i]) <=
+                static_cast<unsigned int>(RANGE)) {
+            indices[found++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+QTEST_APPLESS_MAIN(HexDistanceBench)
+
+#include "tst_hexdistancebench.moc"
@@ -0,0 +1,164 @@
+#include <QtTest>
+#include <QGraphicsScene>
+#include <vector>
+
+#include "cubecoordinate.hh"
+#include "gamepixmapitem.hh"
+#include "helpers.hh"
+#include "hexitem.hh"
+#include "terrainlayer.hh"
+#include "view.hh"
+
+namespace {
+
+// the same hex and pawn sizes as the game
+const int HEX_SIZE = 120;
+const QSize PAWN_PIXMAP_SIZE = QSize(HEX_SIZE/3*2, HEX_SIZE/3*2);
+const int BOARD_RADIUS = 30;
+const int MOVING_ITEMS = 1000;
+
+}
+
+/**
+ * @brief Cost of moving MOVING_ITEMS pawns per frame on a board of radius
+ * BOARD_RADIUS.
+ * @details Every pawn moves back and forth between two neighbouring hexes.
+ * benchRemoveAndAdd moves the pawns the way setLocationOnBoard did before,
+ * by taking them out of the scene and adding them back.
+ */
+class ItemMovementBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    ItemMovementBench();
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void benchRemoveAndAdd();
+    void benchSetLocationOnBoard();
+    void benchSetLocationOnBoardFrame();
+
+private:
+    void moveAll();
+
+    QGraphicsScene *scene_;
+    Student::View *view_;
+    std::vector<Student::HexItem *> hexes_;
+    std::vector<Student::GamePixmapItem *> items_;
+    // index of the hex each item is on
+    std::vector<std::size_t> locations_;
+};
+
+ItemMovementBench::ItemMovementBench() :
+    scene_(nullptr),
+    view_(nullptr),
+    hexes_(),
+    items_(),
+    locations_()
+{
+}
+
+void ItemMovementBench::init()
+{
+    scene_ = new QGraphicsScene;
+    view_ = new Student::View;
+    hexes_.clear();
+    items_.clear();
+    locations_.clear();
+
+    QPen pen(Qt::black);
+    pen.setWidth(3);
+    Student::TerrainLayer *terrain = new Student::TerrainLayer(HEX_SIZE);
+    scene_->addItem(terrain);
+    for (int x = -BOARD_RADIUS; x <= BOARD_RADIUS; ++x) {
+        for (int z = -BOARD_RADIUS; z <= BOARD_RADIUS; ++z) {
+            int y = -x - z;
+            if (y < -BOARD_RADIUS || y > BOARD_RADIUS) {
+                continue;
+            }
+            Common::CubeCoordinate coord(x, y, z);
+            QPointF pixelCoords = Student::cubeToPixel(coord, HEX_SIZE);
+            Student::HexItem *hex = new Student::HexItem(coord, pixelCoords,
+                                                         HEX_SIZE, pen);
+            hex->setPolygon(Student::hexagonCorners(HEX_SIZE));
+            hex->setPos(pixelCoords);
+            scene_->addItem(hex);
+            terrain->setHex(coord, Qt::darkGreen);
+            hexes_.push_back(hex);
+        }
+    }
+
+    QPixmap pixmap(PAWN_PIXMAP_SIZE);
+    pixmap.fill(Qt::red);
+    for (int i = 0; i < MOVING_ITEMS; ++i) {
+        Student::GamePixmapItem *item = new Student::GamePixmapItem("pawn", i);
+        item->setItemPixmap(pixmap);
+        std::size_t location = static_cast<std::size_t>(i) * 2;
+        item->setLocationOnBoard(nullptr, hexes_.at(location), scene_);
+        items_.push_back(item);
+        locations_.push_back(location);
+    }
+
+    view_->setScene(scene_);
+    view_->resize(1280, 720);
+}
+
+void ItemMovementBench::cleanup()
+{
+    delete view_;
+    delete scene_;
+}
+
+void ItemMovementBench::benchRemoveAndAdd()
+{
+    QBENCHMARK {
+        for (std::size_t i = 0; i < items_.size(); ++i) {
+            Student::GamePixmapItem *item = items_[i];
+            std::size_t target = locations_[i] ^ 1;
+            scene_->removeItem(item);
+            hexes_[locations_[i]]->changeSlotOccupation("pawn", 0);
+            hexes_[target]->changeSlotOccupation("pawn", 0);
+            item->setPos(hexes_[target]->getSlot("pawn", 0));
+            item->setPixmap(item->pixmap());
+            scene_->addItem(item);
+            locations_[i] = target;
+        }
+        // the scene updates its index when it processes the changes
+        QCoreApplication::processEvents();
+    }
+}
+
+void ItemMovementBench::benchSetLocationOnBoard()
+{
+    QBENCHMARK {
+        moveAll();
+        QCoreApplication::processEvents();
+    }
+}
+
+void ItemMovementBench::benchSetLocationOnBoardFrame()
+{
+    view_->show();
+    QVERIFY(QTest::qWaitForWindowExposed(view_));
+    QBENCHMARK {
+        moveAll();
+        view_->viewport()->repaint();
+    }
+}
+
+void ItemMovementBench::moveAll()
+{
+    for (std::size_t i = 0; i < items_.size(); ++i) {
+        std::size_t target = locations_[i] ^ 1;
+        items_[i]->setLocationOnBoard(hexes_[locations_[i]], hexes_[target],
+                                      scene_);
+        locations_[i] = target;
+    }
+}
+
+QTEST_MAIN(ItemMovementBench)
+
+#include "tst_itemmovementbench.moc"
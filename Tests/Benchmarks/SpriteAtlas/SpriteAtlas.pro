@@ -0,0 +1,41 @@
+QT       += testlib widgets
+
+TARGET = tst_spriteatlasbench
+CONFIG   += console
+CONFIG   -= app_bundle
+CONFIG   += c++14
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Run with -platform offscreen when there is no display.
+SOURCES += \
+    tst_spriteatlasbench.cpp \
+    ../../../UI/spriteatlas.cpp \
+    ../../../UI/pawnitem.cpp \
+    ../../../UI/gamepixmapitem.cpp \
+    ../../../UI/hexitem.cpp \
+    ../../../UI/helpers.cpp \
+    ../../../UI/renderstats.cpp \
+    ../../../GameLogic/Engine/ioexception.cpp \
+    ../../../GameLogic/Engine/gameexception.cpp
+
+HEADERS += \
+    ../../../UI/spriteatlas.hh \
+    ../../../UI/pawnitem.hh \
+    ../../../UI/gamepixmapitem.hh \
+    ../../../UI/hexitem.hh \
+    ../../../UI/helpers.hh \
+    ../../../GameLogic/Engine/cubecoordinate.hh \
+    ../../../UI/renderstats.hh
+
+INCLUDEPATH += ../../../UI \
+                ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../UI \
+                ../../../GameLogic/Engine/
+
+RESOURCES += \
+    ../../../UI/images.qrc
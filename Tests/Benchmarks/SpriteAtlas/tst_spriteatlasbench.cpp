@@ -0,0 +1,84 @@
+#include <QtTest>
+#include <vector>
+
+#include "pawnitem.hh"
+#include "spriteatlas.hh"
+
+namespace {
+
+// the same hex and pawn sizes as the game
+const int HEX_SIZE = 120;
+const QSize PAWN_PIXMAP_SIZE = QSize(HEX_SIZE/3*2, HEX_SIZE/3*2);
+const int PAWNS = 1000;
+const int PLAYERS = 6;
+
+}
+
+/**
+ * @brief Cost of creating PAWNS pawn items and selecting and deselecting
+ * them.
+ * @details benchCreateDecoding makes the pixmaps the way the items did
+ * before the atlas, by decoding and scaling the image for every item.
+ */
+class SpriteAtlasBench : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchCreateDecoding();
+    void benchCreatePawnItems();
+    void benchSelectPawnItems();
+};
+
+void SpriteAtlasBench::initTestCase()
+{
+    Student::SpriteAtlas::instance().preload(":/pawn-images",
+                                             {PAWN_PIXMAP_SIZE});
+    QVERIFY(Student::SpriteAtlas::instance().size() > 0);
+}
+
+void SpriteAtlasBench::benchCreateDecoding()
+{
+    QBENCHMARK {
+        std::vector<QPixmap> pixmaps;
+        for (int i = 0; i < PAWNS; ++i) {
+            pixmaps.push_back(QPixmap(QString(":/pawn-images/pawn-image%1.png")
+                                      .arg(i % PLAYERS + 1))
+                              .scaled(PAWN_PIXMAP_SIZE, Qt::KeepAspectRatio));
+        }
+    }
+}
+
+void SpriteAtlasBench::benchCreatePawnItems()
+{
+    QBENCHMARK {
+        std::vector<Student::PawnItem *> pawns;
+        for (int i = 0; i < PAWNS; ++i) {
+            pawns.push_back(new Student::PawnItem(PAWN_PIXMAP_SIZE,
+                                                  i % PLAYERS + 1, i));
+        }
+        qDeleteAll(pawns);
+    }
+}
+
+void SpriteAtlasBench::benchSelectPawnItems()
+{
+    std::vector<Student::PawnItem *> pawns;
+    for (int i = 0; i < PAWNS; ++i) {
+        pawns.push_back(new Student::PawnItem(PAWN_PIXMAP_SIZE,
+                                              i % PLAYERS + 1, i));
+    }
+    QBENCHMARK {
+        for (Student::PawnItem *pawn : pawns) {
+            pawn->setPawnPixmap(true);
+            pawn->setPawnPixmap(false);
+        }
+    }
+    qDeleteAll(pawns);
+}
+
+QTEST_MAIN(SpriteAtlasBench)
+
+#include "tst_spriteatlasbench.moc"
@@ -0,0 +1,36 @@
+QT       += testlib widgets
+
+TARGET = tst_terrainrenderingbench
+CONFIG   += console
+CONFIG   -= app_bundle
+CONFIG   += c++14
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Run with -platform offscreen when there is no display.
+SOURCES += \
+    tst_terrainrenderingbench.cpp \
+    ../../../UI/terrainlayer.cpp \
+    ../../../UI/hexitem.cpp \
+    ../../../UI/helpers.cpp \
+    ../../../UI/view.cpp \
+    ../../../UI/renderstats.cpp \
+    ../../../GameLogic/Engine/ioexception.cpp \
+    ../../../GameLogic/Engine/gameexception.cpp
+
+HEADERS += \
+    ../../../UI/terrainlayer.hh \
+    ../../../UI/hexitem.hh \
+    ../../../UI/helpers.hh \
+    ../../../UI/view.hh \
+    ../../../GameLogic/Engine/cubecoordinate.hh \
+    ../../../UI/renderstats.hh
+
+INCLUDEPATH += ../../../UI \
+                ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../UI \
+                ../../../GameLogic/Engine/
@@ -0,0 +1,215 @@
+#include <QtTest>
+#include <QGraphicsPolygonItem>
+#include <QGraphicsScene>
+#include <QScrollBar>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "cubecoordinate.hh"
+#include "helpers.hh"
+#include "hexitem.hh"
+#include "terrainlayer.hh"
+#include "view.hh"
+
+namespace {
+
+// the same hex size as the game
+const int HEX_SIZE = 120;
+const int BOARD_RADIUS = 30;
+// view pixels scrolled for every frame
+const int PAN_STEP = 40;
+// scale of the zoomed out view, the whole board fits in it
+const qreal ZOOMED_OUT_SCALE = 0.05;
+
+const QColor RING_COLORS[] = {
+    Qt::darkGray, Qt::lightGray, Qt::darkGreen, Qt::yellow, Qt::blue
+};
+
+}
+
+/**
+ * @brief Frame time of panning a board of radius BOARD_RADIUS.
+ * @details Each iteration scrolls the view by PAN_STEP pixels and repaints
+ * it. benchPanPolygonItems draws the terrain like the game did before the
+ * terrain layer, with one antialiased polygon item per hex.
+ * benchZoomedOut draws the whole board below Student::LOW_DETAIL_LEVEL.
+ */
+class TerrainRenderingBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    TerrainRenderingBench();
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void benchPanPolygonItems();
+    void benchPanTerrainLayer();
+    void benchPanTerrainLayerSinking();
+    void benchZoomedOut();
+
+private:
+    std::vector<Common::CubeCoordinate> boardCoordinates() const;
+    QColor terrainColor(Common::CubeCoordinate coord) const;
+    void addPolygonItems();
+    void addTerrainLayer();
+    void showView();
+    void pan();
+
+    QGraphicsScene *scene_;
+    Student::View *view_;
+    Student::TerrainLayer *terrain_;
+    int panDirection_;
+};
+
+TerrainRenderingBench::TerrainRenderingBench() :
+    scene_(nullptr),
+    view_(nullptr),
+    terrain_(nullptr),
+    panDirection_(1)
+{
+}
+
+void TerrainRenderingBench::init()
+{
+    scene_ = new QGraphicsScene;
+    view_ = new Student::View;
+    terrain_ = nullptr;
+    panDirection_ = 1;
+}
+
+void TerrainRenderingBench::cleanup()
+{
+    delete view_;
+    delete scene_;
+}
+
+void TerrainRenderingBench::benchPanPolygonItems()
+{
+    addPolygonItems();
+    showView();
+    QBENCHMARK {
+        pan();
+    }
+}
+
+void TerrainRenderingBench::benchPanTerrainLayer()
+{
+    addTerrainLayer();
+    showView();
+    QBENCHMARK {
+        pan();
+    }
+}
+
+void TerrainRenderingBench::benchPanTerrainLayerSinking()
+{
+    addTerrainLayer();
+    showView();
+    std::vector<Common::CubeCoordinate> coords = boardCoordinates();
+    std::size_t next = 0;
+    // one hex sinks every frame, so one tile is partly redrawn
+    QBENCHMARK {
+        terrain_->setHex(coords.at(next), Qt::blue);
+        next = (next + 1) % coords.size();
+        pan();
+    }
+}
+
+void TerrainRenderingBench::benchZoomedOut()
+{
+    addTerrainLayer();
+    view_->resetTransform();
+    view_->scale(ZOOMED_OUT_SCALE, ZOOMED_OUT_SCALE);
+    showView();
+    // the scale changes a little every frame, so the tile caches are
+    // redrawn like when zooming with the wheel
+    qreal step = 1.01;
+    QBENCHMARK {
+        view_->scale(step, step);
+        step = 1 / step;
+        view_->viewport()->repaint();
+    }
+}
+
+std::vector<Common::CubeCoordinate>
+TerrainRenderingBench::boardCoordinates() const
+{
+    std::vector<Common::CubeCoordinate> coords;
+    for (int x = -BOARD_RADIUS; x <= BOARD_RADIUS; ++x) {
+        for (int z = -BOARD_RADIUS; z <= BOARD_RADIUS; ++z) {
+            int y = -x - z;
+            if (y >= -BOARD_RADIUS && y <= BOARD_RADIUS) {
+                coords.push_back(Common::CubeCoordinate(x, y, z));
+            }
+        }
+    }
+    return coords;
+}
+
+QColor TerrainRenderingBench::terrainColor(Common::CubeCoordinate coord) const
+{
+    int ring = std::max(std::abs(coord.x),
+                        std::max(std::abs(coord.y), std::abs(coord.z)));
+    return RING_COLORS[ring % 5];
+}
+
+void TerrainRenderingBench::addPolygonItems()
+{
+    QPen pen(Qt::black);
+    pen.setWidth(3);
+    for (Common::CubeCoordinate coord : boardCoordinates()) {
+        QGraphicsPolygonItem *hex = new QGraphicsPolygonItem(
+                    Student::hexagonCorners(HEX_SIZE));
+        hex->setPen(pen);
+        hex->setBrush(terrainColor(coord));
+        hex->setPos(Student::cubeToPixel(coord, HEX_SIZE));
+        scene_->addItem(hex);
+    }
+}
+
+void TerrainRenderingBench::addTerrainLayer()
+{
+    QPen pen(Qt::black);
+    pen.setWidth(3);
+    terrain_ = new Student::TerrainLayer(HEX_SIZE);
+    scene_->addItem(terrain_);
+    for (Common::CubeCoordinate coord : boardCoordinates()) {
+        QPointF pixelCoords = Student::cubeToPixel(coord, HEX_SIZE);
+        // the hexItems are there for the clicks, like in the game
+        Student::HexItem *hex = new Student::HexItem(coord, pixelCoords,
+                                                     HEX_SIZE, pen);
+        hex->setPolygon(Student::hexagonCorners(HEX_SIZE));
+        hex->setPos(pixelCoords);
+        scene_->addItem(hex);
+        terrain_->setHex(coord, terrainColor(coord));
+    }
+}
+
+void TerrainRenderingBench::showView()
+{
+    view_->setScene(scene_);
+    view_->resize(1280, 720);
+    view_->show();
+    QVERIFY(QTest::qWaitForWindowExposed(view_));
+    // the first frame fills the caches
+    view_->viewport()->repaint();
+}
+
+void TerrainRenderingBench::pan()
+{
+    QScrollBar *scrollBar = view_->horizontalScrollBar();
+    int value = scrollBar->value() + panDirection_ * PAN_STEP;
+    if (value <= scrollBar->minimum() || value >= scrollBar->maximum()) {
+        panDirection_ = -panDirection_;
+    }
+    scrollBar->setValue(value);
+    view_->viewport()->repaint();
+}
+
+QTEST_MAIN(TerrainRenderingBench)
+
+#include "tst_terrainrenderingbench.moc"
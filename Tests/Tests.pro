@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     UnitTests \
-    IntegrationTests
+    IntegrationTests \
+    Benchmarks
@@ -39,6 +39,7 @@ SOURCES += \
     ../../../GameLogic/Engine/formatexception.cpp \
     ../../../GameLogic/Engine/gameexception.cpp \
     ../../../UI/gameboard.cpp \
+    ../../../UI/entitystore.cpp \
     ../../../GameLogic/Engine/pawn.cpp \
     ../../../GameLogic/Engine/transport.cpp \
     ../../../GameLogic/Engine/dolphin.cpp \
@@ -47,7 +48,26 @@ SOURCES += \
     ../../../GameLogic/Engine/kraken.cpp \
     ../../../GameLogic/Engine/seamunster.cpp \
     ../../../GameLogic/Engine/shark.cpp \
-    ../../../GameLogic/Engine/vortex.cpp
+    ../../../GameLogic/Engine/vortex.cpp \
+    ../../../GameLogic/Engine/arena.cpp \
+    ../../../GameLogic/Engine/transportfactory.cpp \
+    ../../../GameLogic/Engine/gameevent.cpp \
+    ../../../GameLogic/Engine/gamejournal.cpp \
+    ../../../GameLogic/Engine/journalreplayer.cpp \
+    ../../../GameLogic/Engine/replaytimeline.cpp \
+    ../../../GameLogic/Engine/pawnrouter.cpp \
+    ../../../GameLogic/Engine/landcomponents.cpp \
+    ../../../GameLogic/Engine/hexdistance.cpp \
+    ../../../GameLogic/Engine/hexbitboard.cpp \
+    ../../../GameLogic/Engine/savefile.cpp \
+    ../../../GameLogic/Engine/gameengine.cpp \
+    ../../../GameLogic/Engine/initialize.cpp \
+    ../../../GameLogic/Engine/illegalmoveexception.cpp \
+    ../../../GameLogic/Engine/playertable.cpp \
+    ../../../GameLogic/Engine/trace.cpp \
+    ../../../GameLogic/Engine/wheellayoutparser.cpp \
+    ../../../UI/gamestate.cpp \
+    ../../../UI/player.cpp
 
 
 
@@ -61,6 +81,7 @@ HEADERS += \
     ../../../GameLogic/Engine/gameexception.hh \
     ../../../GameLogic/Engine/igameboard.hh \
     ../../../UI/gameboard.hh \
+    ../../../UI/entitystore.hh \
     ../../../GameLogic/Engine/pawn.hh \
     ../../../GameLogic/Engine/transport.hh \
     ../../../GameLogic/Engine/dolphin.hh \
@@ -69,7 +90,27 @@ HEADERS += \
     ../../../GameLogic/Engine/kraken.hh \
     ../../../GameLogic/Engine/seamunster.hh \
     ../../../GameLogic/Engine/shark.hh \
-    ../../../GameLogic/Engine/vortex.hh
+    ../../../GameLogic/Engine/vortex.hh \
+    ../../../GameLogic/Engine/arena.hh \
+    ../../../GameLogic/Engine/transportfactory.hh \
+    ../../../GameLogic/Engine/gameevent.hh \
+    ../../../GameLogic/Engine/gamejournal.hh \
+    ../../../GameLogic/Engine/journalreplayer.hh \
+    ../../../GameLogic/Engine/replaytimeline.hh \
+    ../../../GameLogic/Engine/pawnrouter.hh \
+    ../../../GameLogic/Engine/landcomponents.hh \
+    ../../../GameLogic/Engine/hexdistance.hh \
+    ../../../GameLogic/Engine/hexbitboard.hh \
+    ../../../GameLogic/Engine/savefile.hh \
+    ../../../GameLogic/Engine/gameengine.hh \
+    ../../../GameLogic/Engine/initialize.hh \
+    ../../../GameLogic/Engine/igamerunner.hh \
+    ../../../GameLogic/Engine/illegalmoveexception.hh \
+    ../../../GameLogic/Engine/playertable.hh \
+    ../../../GameLogic/Engine/trace.hh \
+    ../../../GameLogic/Engine/wheellayoutparser.hh \
+    ../../../UI/gamestate.hh \
+    ../../../UI/player.hh
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
@@ -77,3 +118,10 @@ INCLUDEPATH += ../../../UI \
                 ../../../GameLogic/Engine/
 DEPENDPATH  += ../../../UI \
                 ../../../GameLogic/Engine/
+
+# the engine of the release test reads the game pieces and the wheel from
+# Assets
+copyfiles.commands += cp -r $$_PRO_FILE_PWD_/../../../GameLogic/Assets $$OUT_PWD
+
+QMAKE_EXTRA_TARGETS += copyfiles
+POST_TARGETDEPS += copyfiles
@@ -1,8 +1,35 @@
 #include <QString>
 #include <QtTest>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
 #include "gameboard.hh"
+#include "gamestate.hh"
+#include "player.hh"
+#include "entitystore.hh"
+#include "formatexception.hh"
+#include "ioexception.hh"
+#include "gameevent.hh"
+#include "gamejournal.hh"
+#include "hexbitboard.hh"
+#include "hexdistance.hh"
+#include "igamerunner.hh"
+#include "initialize.hh"
+#include "journalreplayer.hh"
+#include "landcomponents.hh"
+#include "pawnrouter.hh"
+#include "replaytimeline.hh"
+#include "savefile.hh"
+#include "actorfactory.hh"
+#include "transportfactory.hh"
 #include "hex.hh"
 #include "pawn.hh"
 #include "transport.hh"
@@ -23,6 +50,15 @@ const std::string TST_HEXTYPE = "None";
 const std::string TST_DEFAULT_ACTOR_TYPE = "Shark";
 const std::string TST_DEFAULT_TRANSPORT_TYPE = "Boat";
 
+// Games created, played and destroyed in the memory release test.
+const int TST_RELEASE_GAMES = 10000;
+// Players of each of those games.
+const int TST_RELEASE_PLAYERS = 2;
+// Games played before the resident set size is sampled for the first time.
+const int TST_RELEASE_WARMUP_GAMES = 1000;
+// Allowed growth of the resident set size after the warm-up games.
+const long TST_RELEASE_MAX_GROWTH = 4 * 1024 * 1024;
+
 class GameBoardTest : public QObject
 {
     Q_OBJECT
@@ -75,11 +111,48 @@ private Q_SLOTS:
     void testRemoveTransport();
     void testRemoveTransportCorrect();
 
+    // Entity store
+    void testGetPawnsOfPlayer();
+    void testGetActorsOnWater();
+    void testEntityHandles();
+    void testMoveTransportMovesPawns();
+    void testPawnTransportTracking();
+    void testTransportCanMove();
+    void testActorActionsUpdateStore();
+    void testVortexClearsStore();
+
+    // Game journal
+    void testJournalReplay();
+    void testJournalRejectsCorruptData();
+    void testReplayTimelineSeek();
+    void testBoardPublishesEvents();
+
+    // Pawn routes
+    void testPawnRouteAroundWater();
+    void testPawnRouteBlockedByFullHex();
+    void testPawnReachFromAllPawns();
+    void testPawnReachSwimming();
+    void testLandComponentsSplit();
+    void testLandComponentsMatchRoutes();
+    void testLandComponentsRandomOrder();
+    void testHexKernelsMatchScalar();
+    void testBitboardMatchesRoutes();
+    void testBitboardMaskOperations();
+
+    // Save files
+    void testSaveFileRoundTrip();
+    void testSaveFileRejectsCorruptData();
+
+    // Memory of finished games
+    void testFinishedGamesReleaseMemory();
+
 private:
     Common::CubeCoordinate center_;
     std::shared_ptr<Common::IGameBoard> board_;
 
     void generateTileCircle(int range);
+    void linkNeighbours();
+    long residentSetSize() const;
     std::vector<Common::CubeCoordinate> addHex(
             Common::CubeCoordinate coord,
             std::string pieceType);
@@ -443,6 +516,1012 @@ void GameBoardTest::testRemoveTransportCorrect()
 
 }
 
+void GameBoardTest::testGetPawnsOfPlayer()
+{
+    generateTileCircle(1);
+    std::vector<Common::CubeCoordinate> neighbours =
+            board_->getHex(center_)->getNeighbourVector();
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+
+    for(int i = 0; i < TST_MAX_SIDES; ++i)
+    {
+        addPawn(i, i % 2, neighbours.at(i));
+    }
+    QCOMPARE(board->getPawnsOfPlayer(0).size(), size_t(3));
+    QCOMPARE(board->getPawnsOfPlayer(1).size(), size_t(3));
+    QVERIFY(board->getPawnsOfPlayer(2).empty());
+
+    board_->removePawn(2);
+    std::vector<int> pawns = board->getPawnsOfPlayer(0);
+    QCOMPARE(pawns.size(), size_t(2));
+    QVERIFY(std::find(pawns.begin(), pawns.end(), 2) == pawns.end());
+}
+
+void GameBoardTest::testGetActorsOnWater()
+{
+    generateTileCircle(1);
+    std::vector<Common::CubeCoordinate> neighbours =
+            board_->getHex(center_)->getNeighbourVector();
+    addHex(neighbours.at(0), "Water");
+    addHex(neighbours.at(1), "Water");
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+
+    addActor(1, center_, TST_DEFAULT_ACTOR_TYPE);
+    addActor(2, neighbours.at(0), TST_DEFAULT_ACTOR_TYPE);
+    QCOMPARE(board->getActorsOnWater(), std::vector<int>({2}));
+
+    board_->moveActor(1, neighbours.at(1));
+    std::vector<int> actors = board->getActorsOnWater();
+    std::sort(actors.begin(), actors.end());
+    QCOMPARE(actors, std::vector<int>({1, 2}));
+}
+
+void GameBoardTest::testEntityHandles()
+{
+    Student::EntityStore store;
+    Student::EntityHandle first =
+            store.add(Student::EntityKind::PAWN, 1, 1, center_);
+    Student::EntityHandle second =
+            store.add(Student::EntityKind::ACTOR, 1,
+                      Student::EntityStore::NO_OWNER, center_);
+    Common::CubeCoordinate coord(1, -1, 0);
+    Student::EntityHandle third =
+            store.add(Student::EntityKind::TRANSPORT, 1,
+                      Student::EntityStore::NO_OWNER, coord);
+
+    // Removing a row moves the last one, handles stay valid
+    store.remove(first);
+    QVERIFY(!store.isValid(first));
+    QVERIFY(store.isValid(second));
+    QVERIFY(store.position(third) == coord);
+    QCOMPARE(store.size(), size_t(2));
+
+    // A reused slot does not revive the old handle
+    Student::EntityHandle fourth =
+            store.add(Student::EntityKind::PAWN, 2, 1, coord);
+    QVERIFY(!store.isValid(first));
+    QVERIFY(store.position(fourth) == coord);
+    QVERIFY_EXCEPTION_THROWN(store.position(first), std::out_of_range);
+}
+
+void GameBoardTest::testMoveTransportMovesPawns()
+{
+    generateTileCircle(1);
+    Common::CubeCoordinate target =
+            board_->getHex(center_)->getNeighbourVector().at(0);
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+
+    std::shared_ptr<Common::Transport> transport =
+            addTransport(1, center_, TST_DEFAULT_TRANSPORT_TYPE);
+    addPawn(1, 1, center_);
+    transport->addPawn(board_->getHex(center_)->givePawn(1));
+
+    board_->moveTransport(1, target);
+    QVERIFY(board->getPawnCoords(1) == target);
+    QCOMPARE(board->getEntities().cargo(
+                 board->getEntities().handle(
+                     Student::EntityKind::TRANSPORT, 1)), 1);
+}
+
+void GameBoardTest::testPawnTransportTracking()
+{
+    addHex(center_, "Water");
+    std::shared_ptr<Common::Transport> boat =
+            addTransport(1, center_, TST_DEFAULT_TRANSPORT_TYPE);
+    std::shared_ptr<Common::Transport> dolphin =
+            addTransport(2, center_, "Dolphin");
+    addPawn(1, 1, center_);
+    addPawn(2, 1, center_);
+    std::shared_ptr<Common::Pawn> rider = board_->getHex(center_)->givePawn(1);
+    std::shared_ptr<Common::Pawn> swimmer =
+            board_->getHex(center_)->givePawn(2);
+
+    boat->addPawn(rider);
+    QVERIFY(boat->isPawnInTransport(rider));
+    QVERIFY(rider->getTransport() == boat);
+    QVERIFY(!swimmer->isInTransport());
+
+    // Boarding another transport leaves the previous one
+    dolphin->addPawn(rider);
+    QVERIFY(!boat->isPawnInTransport(rider));
+    QVERIFY(boat->getPawnsInTransport().empty());
+    QVERIFY(rider->getTransport() == dolphin);
+
+    board_->getHex(center_)->clearPawnsFromTerrain();
+    QVERIFY(board_->getHex(center_)->givePawn(1) != nullptr);
+    QVERIFY(board_->getHex(center_)->givePawn(2) == nullptr);
+
+    // The transports leave the hex with their riders still on board, but a
+    // transport elsewhere does not keep a pawn off this terrain
+    board_->getHex(center_)->clearTransports();
+    QVERIFY(rider->getTransport() == dolphin);
+    QVERIFY(dolphin->isPawnInTransport(rider));
+    QVERIFY(!board_->getHex(center_)->isPawnInTransport(rider));
+    QVERIFY(board_->getHex(center_)->givePawn(1) != nullptr);
+    board_->getHex(center_)->clearPawnsFromTerrain();
+    QVERIFY(board_->getHex(center_)->givePawn(1) == nullptr);
+}
+
+void GameBoardTest::testJournalReplay()
+{
+    Logic::ActorFactory::getInstance().addActor(
+                "shark", [] (int id) -> std::shared_ptr<Common::Actor>
+    {
+        return std::make_shared<Common::Shark>(id);
+    });
+    Logic::TransportFactory::getInstance().addTransport(
+                "boat", [] (int id) -> std::shared_ptr<Common::Transport>
+    {
+        return std::make_shared<Common::Boat>(id);
+    });
+
+    Common::CubeCoordinate west(-1, 1, 0);
+    Common::CubeCoordinate east(1, -1, 0);
+    Common::CubeCoordinate north(0, 1, -1);
+
+    Common::GameJournal journal(42);
+    journal.recordHexAdded(center_, "Peak");
+    journal.recordHexAdded(west, "Water");
+    journal.recordHexAdded(east, "Water");
+    journal.recordHexAdded(north, "Beach");
+    journal.recordTransportAdded(1, "boat", west);
+    journal.recordPawnAdded(11, 1, center_);
+    journal.recordPawnAdded(21, 2, center_);
+    journal.recordPlayerInTurn(1);
+    journal.recordPawnMoved(11, center_, west);
+    journal.recordPawnBoarded(11, 1, west);
+    journal.recordPlayerInTurn(1);
+    journal.recordTransportMoved(1, west, east);
+    journal.recordFlip(north, "shark", 7, false);
+    journal.recordSpin("shark", "2");
+    journal.recordPlayerInTurn(2);
+    journal.recordPawnRemoved(21, center_);
+    QCOMPARE(journal.eventCount(), std::size_t(15));
+
+    Common::JournalReader reader(journal.data());
+    QCOMPARE(reader.seed(), std::uint32_t(42));
+    Common::JournalReplayer replayer(board_);
+    QCOMPARE(replayer.replay(reader), std::size_t(15));
+
+    // The pawn rode the boat to the east
+    std::shared_ptr<Common::Hex> eastHex = board_->getHex(east);
+    QVERIFY(eastHex != nullptr);
+    std::shared_ptr<Common::Transport> boat = eastHex->giveTransport(1);
+    QVERIFY(boat != nullptr);
+    std::shared_ptr<Common::Pawn> rider = eastHex->givePawn(11);
+    QVERIFY(rider != nullptr);
+    QVERIFY(rider->getTransport() == boat);
+    QCOMPARE(board_->getHex(west)->getPawnAmount(), 0);
+
+    // The flipped tile sank and spawned the recorded actor
+    std::shared_ptr<Common::Hex> northHex = board_->getHex(north);
+    QVERIFY(northHex->isWaterTile());
+    QVERIFY(northHex->giveActor(7) != nullptr);
+    QVERIFY(board_->getHex(center_)->givePawn(21) == nullptr);
+}
+
+void GameBoardTest::testJournalRejectsCorruptData()
+{
+    std::vector<std::uint8_t> notJournal = {'X', 'Y', 'Z', 1, 0};
+    QVERIFY_EXCEPTION_THROWN(Common::JournalReader reader(notJournal),
+                             Common::FormatException);
+
+    Common::GameJournal journal(7);
+    journal.recordPawnMoved(1, center_, Common::CubeCoordinate(-40, 0, 40));
+    std::vector<std::uint8_t> truncated = journal.data();
+    truncated.pop_back();
+
+    Common::JournalReader reader(truncated);
+    Common::JournalEvent event;
+    QVERIFY_EXCEPTION_THROWN(reader.next(event), Common::FormatException);
+}
+
+void GameBoardTest::testBoardPublishesEvents()
+{
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+    auto events = std::make_shared<Common::GameEventPublisher>();
+    Common::GameJournal journal(3);
+    std::vector<Common::GameEventType> seen;
+    events->subscribe([&journal] (const Common::GameEvent& event)
+    {
+        journal.record(event);
+    });
+    int watcher = events->subscribe([&seen] (const Common::GameEvent& event)
+    {
+        seen.push_back(event.type);
+    });
+    board->setEventPublisher(events);
+
+    addHex(center_, "Water");
+    addTransport(1, center_, TST_DEFAULT_TRANSPORT_TYPE);
+    addPawn(11, 1, center_);
+    QVERIFY(board->boardPawn(11, 1));
+    // Boarding the same transport again changes nothing
+    QVERIFY(!board->boardPawn(11, 1));
+    board->removeTransport(1);
+    events->unsubscribe(watcher);
+    board->removePawn(11);
+
+    std::vector<Common::GameEventType> expected = {
+        Common::GameEventType::PAWN_ADDED,
+        Common::GameEventType::PAWN_BOARDED,
+        Common::GameEventType::TRANSPORT_REMOVED
+    };
+    QVERIFY(seen == expected);
+
+    std::vector<Common::JournalEventType> recorded;
+    Common::JournalReader reader(journal.data());
+    Common::JournalEvent event;
+    while (reader.next(event)) {
+        recorded.push_back(event.type);
+    }
+    std::vector<Common::JournalEventType> expectedRecord = {
+        Common::JournalEventType::PAWN_ADD,
+        Common::JournalEventType::PAWN_BOARD,
+        Common::JournalEventType::TRANSPORT_REMOVE,
+        Common::JournalEventType::PAWN_REMOVE
+    };
+    QVERIFY(recorded == expectedRecord);
+}
+
+void GameBoardTest::testReplayTimelineSeek()
+{
+    Common::CubeCoordinate west(-1, 1, 0);
+    Common::CubeCoordinate east(1, -1, 0);
+    Common::CubeCoordinate north(0, 1, -1);
+
+    Common::GameJournal journal(42);
+    journal.recordHexAdded(center_, "Peak");
+    journal.recordHexAdded(west, "Water");
+    journal.recordHexAdded(east, "Water");
+    journal.recordHexAdded(north, "Beach");
+    journal.recordTransportAdded(1, "boat", west);
+    journal.recordPawnAdded(11, 1, center_);
+    journal.recordPawnAdded(21, 2, center_);
+    journal.recordPlayerInTurn(1);
+    journal.recordPawnMoved(11, center_, west);
+    journal.recordPawnBoarded(11, 1, west);
+    journal.recordTransportMoved(1, west, east);
+    journal.recordFlip(north, "shark", 7, false);
+    journal.recordSpin("shark", "2");
+    journal.recordPlayerInTurn(2);
+    journal.recordPawnRemoved(21, center_);
+
+    // The hexes, the boat and the pawns are the setup, the rest are plies
+    Common::ReplayTimeline timeline(journal.data(), 3);
+    QCOMPARE(timeline.plyCount(), std::size_t(8));
+    QCOMPARE(timeline.keyframeCount(), std::size_t(3));
+
+    Common::ReplayFrame last = timeline.frameAt(8);
+    QCOMPARE(last.playerInTurn, 2);
+    QCOMPARE(last.pawns.size(), std::size_t(1));
+    QVERIFY(last.pawns.at(11).location == east);
+    QCOMPARE(last.pawns.at(11).transport, 1);
+    QCOMPARE(timeline.name(last.actors.at(7).type), std::string("shark"));
+    QCOMPARE(timeline.name(last.hexTypes.at(3)), std::string("Water"));
+
+    // Seeking backwards starts from a keyframe
+    Common::ReplayFrame first = timeline.frameAt(2);
+    QCOMPARE(first.playerInTurn, 1);
+    QVERIFY(first.pawns.at(11).location == west);
+    QCOMPARE(first.pawns.at(11).transport, 0);
+    QVERIFY(first.actors.empty());
+    QCOMPARE(timeline.name(first.hexTypes.at(3)), std::string("Beach"));
+
+    Common::ReplayDiff diff = Common::ReplayTimeline::diff(first, last);
+    QCOMPARE(diff.hexes, std::vector<std::size_t>({3}));
+    QCOMPARE(diff.pawns.removed, std::vector<int>({21}));
+    QCOMPARE(diff.pawns.moved, std::vector<int>({11}));
+    QCOMPARE(diff.actors.added, std::vector<int>({7}));
+    QCOMPARE(diff.transports.moved, std::vector<int>({1}));
+    QVERIFY(Common::ReplayTimeline::diff(first, timeline.frameAt(1))
+            .hexes.empty());
+}
+
+void GameBoardTest::testPawnRouteAroundWater()
+{
+    generateTileCircle(3);
+    Common::CubeCoordinate gap(1, -1, 0);
+    for (Common::CubeCoordinate coord :
+         board_->getHex(center_)->getNeighbourVector()) {
+        if (!(coord == gap)) {
+            board_->getHex(coord)->setPieceType("Water");
+        }
+    }
+    Common::PawnRouter router(board_);
+
+    // A water hex can be entered but not walked over
+    Common::CubeCoordinate water(-1, 1, 0);
+    QVERIFY(router.steps(center_, water) == 1);
+
+    Common::CubeCoordinate target(-2, 2, 0);
+    std::vector<Common::CubeCoordinate> route = router.route(center_, target);
+    QVERIFY(route.size() > 3);
+    QVERIFY(route.front() == center_);
+    QVERIFY(route.at(1) == gap);
+    QVERIFY(route.back() == target);
+    QVERIFY(router.steps(center_, target) ==
+            static_cast<int>(route.size()) - 1);
+    for (std::size_t i = 1; i < route.size(); ++i) {
+        Common::CubeCoordinate from = route.at(i - 1);
+        Common::CubeCoordinate to = route.at(i);
+        QVERIFY(std::abs(from.x - to.x) + std::abs(from.y - to.y) +
+                std::abs(from.z - to.z) == 2);
+        QVERIFY(!board_->isWaterTile(to));
+    }
+
+    // Hexes reached already are answered without searching further
+    std::size_t visited = router.visited();
+    QVERIFY(router.steps(center_, Common::CubeCoordinate(2, -2, 0)) == 2);
+    QVERIFY(router.visited() == visited);
+    QVERIFY(router.steps(center_, Common::CubeCoordinate(9, -9, 0)) == -1);
+}
+
+void GameBoardTest::testPawnRouteBlockedByFullHex()
+{
+    generateTileCircle(2);
+    Common::CubeCoordinate gap(1, -1, 0);
+    for (Common::CubeCoordinate coord :
+         board_->getHex(center_)->getNeighbourVector()) {
+        if (!(coord == gap)) {
+            board_->getHex(coord)->setPieceType("Water");
+        }
+    }
+    Common::PawnRouter router(board_);
+    Common::CubeCoordinate target(-2, 2, 0);
+    QVERIFY(router.steps(center_, target) > 2);
+
+    // A full hex closes the only way off the center
+    for (int pawnId = 0; pawnId < Common::PawnRouter::MAX_PAWNS_PER_HEX;
+         ++pawnId) {
+        addPawn(pawnId, 1, gap);
+    }
+    router.invalidate();
+    QVERIFY(router.route(center_, target).empty());
+    QVERIFY(router.route(center_, gap).empty());
+
+    // The pawns on the origin don't stop the pawn leaving it
+    board_->removePawn(0);
+    router.invalidate();
+    for (int pawnId = 10; pawnId < 13; ++pawnId) {
+        addPawn(pawnId, 1, center_);
+    }
+    QVERIFY(router.route(center_, target).size() > 3);
+}
+
+void GameBoardTest::testPawnReachFromAllPawns()
+{
+    generateTileCircle(3);
+    board_->getHex(Common::CubeCoordinate(1, 0, -1))->setPieceType("Water");
+    board_->getHex(Common::CubeCoordinate(0, 1, -1))->setPieceType("Water");
+    std::vector<std::pair<Common::CubeCoordinate, int>> pawns = {
+        {center_, 1}, {Common::CubeCoordinate(3, -3, 0), 2},
+        {Common::CubeCoordinate(-2, 0, 2), 3}};
+    for (const auto& pawn : pawns) {
+        addPawn(pawn.second, 1, pawn.first);
+    }
+    Common::CubeCoordinate full(-1, 1, 0);
+    for (int pawnId = 10; pawnId < 13; ++pawnId) {
+        addPawn(pawnId, 2, full);
+    }
+    Common::PawnRouter router(board_);
+
+    // Every hex costs the shortest route of the nearest pawn
+    std::vector<Common::PawnReach> reached = router.reachAll(pawns, 100);
+    auto hexes = std::static_pointer_cast<Student::GameBoard>(board_)
+            ->getBoard();
+    QVERIFY(reached.size() == hexes.size() - 1);
+    for (std::size_t i = 0; i < reached.size(); ++i) {
+        const Common::PawnReach& reach = reached.at(i);
+        QVERIFY(!(reach.hex == full));
+        QVERIFY(i == 0 || reached.at(i - 1).actions <= reach.actions);
+        int nearest = -1;
+        for (const auto& pawn : pawns) {
+            int steps = router.steps(pawn.first, reach.hex);
+            if (steps >= 0 && (nearest < 0 || steps < nearest)) {
+                nearest = steps;
+            }
+        }
+        QVERIFY(reach.actions == nearest);
+        QVERIFY(reach.pawnId >= 1 && reach.pawnId <= 3);
+        QVERIFY(router.steps(pawns.at(reach.pawnId - 1).first, reach.hex) ==
+                nearest);
+    }
+
+    // This turn only
+    for (const Common::PawnReach& reach : router.reachAll(pawns, 1)) {
+        QVERIFY(reach.actions <= 1);
+    }
+}
+
+void GameBoardTest::testPawnReachSwimming()
+{
+    generateTileCircle(2);
+    Common::CubeCoordinate water(1, -1, 0);
+    board_->getHex(water)->setPieceType("Water");
+    addPawn(1, 1, water);
+    Common::PawnRouter router(board_);
+
+    std::vector<Common::PawnReach> reached = router.reachAll({{water, 1}},
+                                                             4);
+    QVERIFY(reached.front().actions == 0);
+    for (const Common::PawnReach& reach : reached) {
+        int distance = (std::abs(reach.hex.x - water.x) +
+                        std::abs(reach.hex.y - water.y) +
+                        std::abs(reach.hex.z - water.z)) / 2;
+        QVERIFY(reach.pawnId == 1);
+        if (distance > 0) {
+            QVERIFY(reach.actions ==
+                    Common::PawnRouter::SWIM_ACTIONS + distance - 1);
+        }
+    }
+    QVERIFY(router.reachAll({{water, 1}}, 2).size() == 1);
+}
+
+void GameBoardTest::testLandComponentsSplit()
+{
+    Common::LandComponents land;
+    for (int x = -2; x <= 2; ++x) {
+        land.addHex(Common::CubeCoordinate(x, -x, 0), true);
+    }
+    Common::CubeCoordinate west(-2, 2, 0);
+    Common::CubeCoordinate middle(0, 0, 0);
+    Common::CubeCoordinate east(2, -2, 0);
+    QVERIFY(land.regions() == 1);
+    QVERIFY(land.connected(west, east));
+
+    land.sink(middle);
+    QVERIFY(land.regions() == 2);
+    QVERIFY(!land.connected(west, east));
+    QVERIFY(!land.connected(west, middle));
+    QVERIFY(land.connected(east, Common::CubeCoordinate(1, -1, 0)));
+    // the sunk hex can still be swum to from both sides
+    QVERIFY(land.reachable(west, middle));
+    QVERIFY(land.reachable(east, middle));
+    QVERIFY(!land.reachable(west, east));
+
+    land.sink(east);
+    QVERIFY(land.regions() == 2);
+    land.sink(Common::CubeCoordinate(1, -1, 0));
+    QVERIFY(land.regions() == 1);
+
+    land.addHex(middle, true);
+    QVERIFY(land.regions() == 1);
+    QVERIFY(land.connected(west, middle));
+
+    // Hexes added out of order are joined through each other, the piece
+    // that breaks off must not stay joined through them
+    Common::LandComponents strip;
+    for (int x : {-2, -3, -1, 0, 1, 2, 3}) {
+        strip.addHex(Common::CubeCoordinate(x, -x, 0), true);
+    }
+    strip.sink(Common::CubeCoordinate(-1, 1, 0));
+    Common::CubeCoordinate a(-3, 3, 0);
+    Common::CubeCoordinate b(-2, 2, 0);
+    Common::CubeCoordinate d(0, 0, 0);
+    Common::CubeCoordinate g(3, -3, 0);
+    QVERIFY(strip.regions() == 2);
+    QVERIFY(strip.connected(a, b));
+    QVERIFY(strip.connected(d, g));
+    QVERIFY(!strip.connected(d, b));
+    QVERIFY(!strip.connected(d, a));
+    QVERIFY(!strip.reachable(g, a));
+    QVERIFY(strip.reachable(g, Common::CubeCoordinate(-1, 1, 0)));
+}
+
+void GameBoardTest::testLandComponentsMatchRoutes()
+{
+    generateTileCircle(4);
+    auto hexes = std::static_pointer_cast<Student::GameBoard>(board_)
+            ->getBoard();
+    std::vector<Common::CubeCoordinate> coords;
+    Common::LandComponents land;
+    for (const auto& hex : hexes) {
+        coords.push_back(hex.first);
+        land.addHex(hex.first, true);
+    }
+    Common::PawnRouter router(board_);
+
+    // Sink all but the origin in a fixed random order, the regions must
+    // agree with a full search after every sink
+    std::mt19937 random(45);
+    std::shuffle(coords.begin(), coords.end(), random);
+    for (std::size_t sunk = 0; sunk + 1 < coords.size(); ++sunk) {
+        board_->getHex(coords.at(sunk))->setPieceType("Water");
+        land.sink(coords.at(sunk));
+        router.invalidate();
+        Common::CubeCoordinate origin = coords.back();
+        for (std::size_t i = sunk + 1; i < coords.size(); ++i) {
+            QVERIFY(land.connected(origin, coords.at(i)) ==
+                    (router.steps(origin, coords.at(i)) >= 0));
+        }
+        for (std::size_t i = 0; i <= sunk; ++i) {
+            QVERIFY(land.reachable(origin, coords.at(i)) ==
+                    (router.steps(origin, coords.at(i)) >= 0));
+        }
+    }
+    QVERIFY(land.regions() == 1);
+    land.sink(coords.back());
+    QVERIFY(land.regions() == 0);
+}
+
+void GameBoardTest::testLandComponentsRandomOrder()
+{
+    // Hexes of a board of radius 5 are added in a random order and then
+    // sunk, and now and then raised again, in another. After every change
+    // the regions must agree with a breadth first search over the land.
+    const int radius = 5;
+    std::vector<Common::CubeCoordinate> coords;
+    for (int x = -radius; x <= radius; ++x) {
+        for (int z = -radius; z <= radius; ++z) {
+            if (std::abs(x + z) <= radius) {
+                coords.push_back(Common::CubeCoordinate(x, -x - z, z));
+            }
+        }
+    }
+    auto key = [radius](Common::CubeCoordinate coord) {
+        return (coord.x + radius) * (2 * radius + 1) + coord.z + radius;
+    };
+    const int sides[6][2] = {{1, 0}, {1, -1}, {0, -1},
+                             {-1, 0}, {-1, 1}, {0, 1}};
+
+    for (unsigned int seed = 0; seed < 20; ++seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::vector<int> region((2 * radius + 1) * (2 * radius + 1), -1);
+        std::vector<bool> land(region.size(), false);
+        Common::LandComponents components;
+
+        auto check = [&]() {
+            std::fill(region.begin(), region.end(), -1);
+            std::size_t regions = 0;
+            for (const auto& start : coords) {
+                if (!land.at(key(start)) || region.at(key(start)) != -1) {
+                    continue;
+                }
+                std::vector<Common::CubeCoordinate> queue = {start};
+                region.at(key(start)) = static_cast<int>(regions);
+                for (std::size_t next = 0; next < queue.size(); ++next) {
+                    for (const auto& side : sides) {
+                        Common::CubeCoordinate neighbour(
+                                    queue.at(next).x + side[0],
+                                    queue.at(next).y - side[0] - side[1],
+                                    queue.at(next).z + side[1]);
+                        if (std::abs(neighbour.x) > radius ||
+                                std::abs(neighbour.y) > radius ||
+                                std::abs(neighbour.z) > radius ||
+                                !land.at(key(neighbour)) ||
+                                region.at(key(neighbour)) != -1) {
+                            continue;
+                        }
+                        region.at(key(neighbour)) =
+                                static_cast<int>(regions);
+                        queue.push_back(neighbour);
+                    }
+                }
+                ++regions;
+            }
+            QVERIFY(components.regions() == regions);
+
+            Common::CubeCoordinate origin = coords.at(percent(random) %
+                                                      coords.size());
+            for (const auto& other : coords) {
+                bool same = land.at(key(origin)) && land.at(key(other)) &&
+                        region.at(key(origin)) == region.at(key(other));
+                QVERIFY(components.connected(origin, other) == same);
+            }
+        };
+
+        std::shuffle(coords.begin(), coords.end(), random);
+        for (const auto& coord : coords) {
+            bool isLand = percent(random) < 80;
+            components.addHex(coord, isLand);
+            land.at(key(coord)) = isLand;
+            check();
+        }
+
+        std::shuffle(coords.begin(), coords.end(), random);
+        for (const auto& coord : coords) {
+            components.sink(coord);
+            land.at(key(coord)) = false;
+            check();
+            if (percent(random) < 10) {
+                const auto& raised = coords.at(percent(random) %
+                                               coords.size());
+                components.addHex(raised, true);
+                land.at(key(raised)) = true;
+                check();
+            }
+        }
+    }
+}
+
+void GameBoardTest::testHexKernelsMatchScalar()
+{
+    // Sizes around the lane counts leave every length of scalar tail
+    std::mt19937 random(49);
+    std::uniform_int_distribution<int> coordinate(-40, 40);
+    std::uniform_int_distribution<int> coin(0, 1);
+    Common::CubeCoordinate origin(7, -3, -4);
+    for (std::size_t size : {0, 1, 3, 4, 5, 7, 8, 9, 16, 17, 101}) {
+        Common::HexBatch batch;
+        std::vector<Common::CubeCoordinate> coords;
+        std::vector<bool> water;
+        for (std::size_t i = 0; i < size; ++i) {
+            int x = coordinate(random);
+            int z = coordinate(random);
+            coords.push_back(Common::CubeCoordinate(x, -x - z, z));
+            water.push_back(coin(random) == 1);
+            batch.add(coords.back(), water.back());
+        }
+
+        std::vector<std::int32_t> distances(size);
+        Common::hexDistances(origin, batch, distances.data());
+        for (std::size_t i = 0; i < size; ++i) {
+            QCOMPARE(static_cast<unsigned int>(distances.at(i)),
+                     Common::hexDistance(origin, coords.at(i)));
+        }
+
+        for (int range : {-1, 0, 5, 40}) {
+            std::vector<std::uint32_t> indices(size);
+            std::size_t found = Common::waterWithin(origin, batch, range,
+                                                    indices.data());
+            indices.resize(found);
+            std::vector<std::uint32_t> expected;
+            for (std::size_t i = 0; i < size; ++i) {
+                if (water.at(i) && static_cast<int>(
+                            Common::hexDistance(origin, coords.at(i))) <=
+                        range) {
+                    expected.push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+            QVERIFY(indices == expected);
+        }
+    }
+}
+
+void GameBoardTest::testBitboardMatchesRoutes()
+{
+    // Hexes are added in the order of the map, so the box grows to all
+    // sides
+    generateTileCircle(5);
+    auto hexes = std::static_pointer_cast<Student::GameBoard>(board_)
+            ->getBoard();
+    std::mt19937 random(50);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Common::HexBitboard bits;
+    int pawnId = 0;
+    for (const auto& hex : hexes) {
+        if (!(hex.first == center_) && percent(random) < 25) {
+            hex.second->setPieceType("Water");
+        }
+        bits.addHex(hex.first, hex.second->getPieceType());
+        if (percent(random) < 20) {
+            for (int player = 1;
+                 player <= Common::PawnRouter::MAX_PAWNS_PER_HEX; ++player) {
+                addPawn(++pawnId, player, hex.first);
+                bits.addPawn(hex.first, player);
+            }
+        }
+    }
+    QCOMPARE(bits.hexes().count(), hexes.size());
+    QCOMPARE(bits.full().count(), bits.pawnsOf(1).count());
+
+    Common::PawnRouter router(board_);
+    for (const auto& origin : hexes) {
+        Common::HexMask moves = bits.pawnMoves(origin.first, 2);
+        for (const auto& target : hexes) {
+            int steps = router.steps(origin.first, target.first);
+            QCOMPARE(bits.steps(origin.first, target.first, 1000), steps);
+            QCOMPARE(bits.contains(moves, target.first),
+                     steps >= 0 && steps <= 2);
+            QCOMPARE(bits.canWalk(origin.first, target.first, 2),
+                     steps >= 0 && steps <= 2);
+        }
+    }
+}
+
+void GameBoardTest::testBitboardMaskOperations()
+{
+    generateTileCircle(2);
+    auto hexes = std::static_pointer_cast<Student::GameBoard>(board_)
+            ->getBoard();
+    Common::HexBitboard bits;
+    for (const auto& hex : hexes) {
+        bits.addHex(hex.first, TST_HEXTYPE);
+    }
+    Common::CubeCoordinate edge(2, -2, 0);
+    bits.addHex(edge, "Coral");
+    bits.sink(center_);
+    QCOMPARE(bits.water().count(), static_cast<std::size_t>(1));
+    QCOMPARE(bits.goals().count(), static_cast<std::size_t>(1));
+    QCOMPARE(bits.terrain(TST_HEXTYPE).count(), static_cast<std::size_t>(17));
+    QCOMPARE(bits.land().count(), static_cast<std::size_t>(18));
+    QVERIFY(!bits.terrain("Forest").any());
+
+    // A vortex in the center clears it and its neighbours
+    for (int pawn = 0; pawn < Common::PawnRouter::MAX_PAWNS_PER_HEX; ++pawn) {
+        bits.addPawn(center_, 1);
+    }
+    bits.addPawn(Common::CubeCoordinate(1, -1, 0), 2);
+    bits.addPawn(edge, 2);
+    QVERIFY(bits.contains(bits.full(), center_));
+    Common::HexMask area = bits.dilate(bits.mask(center_));
+    QCOMPARE(area.count(), static_cast<std::size_t>(7));
+    QCOMPARE(bits.coordinates(area).size(), static_cast<std::size_t>(7));
+    bits.clearPawns(area);
+    QVERIFY(!bits.full().any());
+    QVERIFY(!bits.pawnsOf(1).any());
+    QCOMPARE(bits.pawnCount(center_), 0);
+    QCOMPARE(bits.pawnCount(edge), 1);
+    QVERIFY(bits.pawnsOf(2) == bits.mask(edge));
+}
+
+void GameBoardTest::testSaveFileRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("game.igs").toStdString();
+
+    Common::SaveFileWriter writer;
+    writer.header().currentPlayer = 2;
+    writer.header().draws = 12345;
+    writer.addHex(center_, "Water");
+    writer.addHex(Common::CubeCoordinate(1, -1, 0), "Forest");
+    writer.addPawn(21, 2, center_, 3);
+    writer.addTransport(3, "boat", center_);
+    writer.addPlayer({2, 1, 3, 0});
+    writer.write(path);
+
+    Common::SaveFile save(path);
+    QCOMPARE(save.header().currentPlayer, 2);
+    QCOMPARE(save.header().draws, static_cast<std::uint64_t>(12345));
+    QCOMPARE(save.hexes().size(), static_cast<std::size_t>(2));
+    QCOMPARE(save.string(save.hexes()[1].type), std::string("Forest"));
+    QCOMPARE(save.hexes()[1].x, 1);
+    QCOMPARE(save.pawns().size(), static_cast<std::size_t>(1));
+    QCOMPARE(save.pawns()[0].transport, 3);
+    QCOMPARE(save.string(save.transports()[0].type), std::string("boat"));
+    QCOMPARE(save.players()[0].pawns, static_cast<std::uint32_t>(3));
+    QCOMPARE(save.actors().size(), static_cast<std::size_t>(0));
+}
+
+void GameBoardTest::testSaveFileRejectsCorruptData()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("game.igs").toStdString();
+
+    QVERIFY_EXCEPTION_THROWN(Common::SaveFile save(path),
+                             Common::IoException);
+
+    Common::SaveFileWriter writer;
+    writer.addHex(center_, "Water");
+    writer.write(path);
+    // write() fills in the sections, so corrupt the file afterwards
+    Common::SaveHeader header;
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    header.sections[Common::SAVE_HEXES].count = 1000;
+    {
+        std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    QVERIFY_EXCEPTION_THROWN(Common::SaveFile save(path),
+                             Common::FormatException);
+}
+
+void GameBoardTest::testTransportCanMove()
+{
+    addHex(center_, "Water");
+    std::shared_ptr<Common::Transport> boat =
+            addTransport(1, center_, TST_DEFAULT_TRANSPORT_TYPE);
+    for(int pawnid = 1; pawnid <= 3; ++pawnid)
+    {
+        addPawn(pawnid, pawnid == 3 ? 2 : 1, center_);
+    }
+    auto hex = board_->getHex(center_);
+
+    // Empty transport can be moved by anyone
+    QVERIFY(boat->canMove(1));
+    QVERIFY(boat->canMove(2));
+
+    boat->addPawn(hex->givePawn(1));
+    boat->addPawn(hex->givePawn(3));
+    QVERIFY(boat->canMove(1));
+    QVERIFY(boat->canMove(2));
+    QVERIFY(!boat->canMove(3));
+
+    boat->addPawn(hex->givePawn(2));
+    QVERIFY(boat->canMove(1));
+    QVERIFY(!boat->canMove(2));
+
+    boat->removePawn(hex->givePawn(1));
+    boat->removePawn(hex->givePawn(2));
+    QVERIFY(!boat->canMove(1));
+    QVERIFY(boat->canMove(2));
+
+    boat->removePawns();
+    QVERIFY(boat->canMove(1));
+    QVERIFY(boat->canMove(3));
+}
+
+void GameBoardTest::testActorActionsUpdateStore()
+{
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+    auto events = std::make_shared<Common::GameEventPublisher>();
+    std::vector<Common::GameEventType> seen;
+    events->subscribe([&seen] (const Common::GameEvent& event)
+    {
+        seen.push_back(event.type);
+    });
+    board->setEventPublisher(events);
+
+    // A tile sinks under two pawns, one of them in a boat, and a shark
+    // comes up
+    addHex(center_, "Water");
+    addTransport(1, center_, TST_DEFAULT_TRANSPORT_TYPE);
+    addPawn(1, 1, center_);
+    addPawn(2, 1, center_);
+    QVERIFY(board->boardPawn(1, 1));
+    std::shared_ptr<Common::Actor> shark =
+            addActor(1, center_, TST_DEFAULT_ACTOR_TYPE);
+    QVERIFY(board->getActorsOnWater() == std::vector<int>{1});
+    seen.clear();
+
+    shark->doAction();
+    QVERIFY(board->getPawnsOfPlayer(1) == std::vector<int>{1});
+    QVERIFY(board->getEntities().idsAt(Student::EntityKind::PAWN,
+                                       center_) == std::vector<int>{1});
+    QVERIFY(seen == std::vector<Common::GameEventType>{
+                Common::GameEventType::PAWN_REMOVED});
+
+    // The cargo column follows the transport, not only the board
+    Student::EntityHandle boat =
+            board->getEntities().handle(Student::EntityKind::TRANSPORT, 1);
+    QCOMPARE(board->getEntities().cargo(boat), 1);
+    board_->getHex(center_)->giveTransport(1)->removePawns();
+    QCOMPARE(board->getEntities().cargo(boat), 0);
+
+    // A kraken takes the boat
+    addActor(2, center_, "Kraken")->doAction();
+    QVERIFY(!board->getEntities().isValid(boat));
+    QVERIFY(board_->getHex(center_)->getTransports().empty());
+    QVERIFY(board->getPawnsOfPlayer(1) == std::vector<int>{1});
+
+    // A tile that turns to land leaves its actors out of the water
+    board_->getHex(center_)->setPieceType("Beach");
+    QVERIFY(board->getActorsOnWater().empty());
+}
+
+void GameBoardTest::testVortexClearsStore()
+{
+    auto board = std::static_pointer_cast<Student::GameBoard>(board_);
+    generateTileCircle(2);
+    linkNeighbours();
+    Common::CubeCoordinate neighbour(1, -1, 0);
+    Common::CubeCoordinate outside(2, -2, 0);
+    board_->getHex(center_)->setPieceType("Water");
+    board_->getHex(neighbour)->setPieceType("Water");
+
+    addPawn(1, 1, center_);
+    addPawn(2, 2, neighbour);
+    addPawn(3, 2, outside);
+    addTransport(1, neighbour, TST_DEFAULT_TRANSPORT_TYPE);
+    QVERIFY(board->boardPawn(2, 1));
+    addActor(1, neighbour, TST_DEFAULT_ACTOR_TYPE);
+    std::shared_ptr<Common::Actor> vortex = addActor(2, center_, "Vortex");
+    QCOMPARE(board->getEntities().size(), static_cast<std::size_t>(6));
+
+    vortex->doAction();
+
+    // The vortex takes everything around it and itself, but nothing further
+    const Student::EntityStore& entities = board->getEntities();
+    QCOMPARE(entities.size(), static_cast<std::size_t>(1));
+    QVERIFY(board->getPawnsOfPlayer(1).empty());
+    QVERIFY(board->getPawnsOfPlayer(2) == std::vector<int>{3});
+    QVERIFY(board->getActorsOnWater().empty());
+    QVERIFY(entities.idsAt(Student::EntityKind::ACTOR, center_).empty());
+    QVERIFY(entities.idsAt(Student::EntityKind::TRANSPORT, neighbour).empty());
+}
+
+void GameBoardTest::testFinishedGamesReleaseMemory()
+{
+    long residentAfterWarmup = 0;
+
+    for(int game = 0; game < TST_RELEASE_GAMES; ++game)
+    {
+        // A whole game as the user interface plays it: the engine, its
+        // arena, journal and event subscriptions, the router's board and
+        // the pawn riding a boat all go when the game is dropped.
+        std::weak_ptr<Common::IGameBoard> board;
+        std::weak_ptr<Common::IGameRunner> runner;
+        std::weak_ptr<Common::GameEventPublisher> events;
+        std::weak_ptr<Common::GameJournal> journal;
+        std::weak_ptr<Common::Hex> hex;
+        std::weak_ptr<Common::Transport> transport;
+        std::weak_ptr<Common::Pawn> pawn;
+        {
+            std::shared_ptr<Student::GameBoard> gameBoard =
+                    std::make_shared<Student::GameBoard>();
+            std::shared_ptr<Student::GameState> state =
+                    std::make_shared<Student::GameState>();
+            std::vector<std::shared_ptr<Common::IPlayer>> players;
+            for (int id = 1; id <= TST_RELEASE_PLAYERS; ++id) {
+                players.push_back(std::make_shared<Student::Player>(id, 2));
+            }
+            std::shared_ptr<Common::IGameRunner> gameRunner =
+                    Common::Initialization::getGameRunner(
+                        gameBoard, state, players, game);
+            board = gameBoard;
+            runner = gameRunner;
+            events = gameRunner->getEvents();
+            journal = gameRunner->getJournal();
+            int player = gameRunner->currentPlayer();
+
+            // A pawn boards a boat and the boat sails one hex
+            Common::CubeCoordinate port;
+            std::shared_ptr<Common::Transport> boat;
+            for (const auto& entry : gameBoard->getBoard()) {
+                if (!entry.second->getTransports().empty()) {
+                    port = entry.first;
+                    boat = entry.second->getTransports().front();
+                    break;
+                }
+            }
+            QVERIFY(boat != nullptr);
+            gameBoard->addPawn(player, 1, port);
+            boat->addPawn(gameBoard->getHex(port)->givePawn(1));
+            hex = gameBoard->getHex(port);
+            transport = boat;
+            pawn = gameBoard->getHex(port)->givePawn(1);
+
+            state->changeGamePhase(Common::GamePhase::MOVEMENT);
+            std::vector<Common::CubeCoordinate> sea =
+                    gameRunner->findTransportMoves(port, boat->getId(), "1");
+            sea.erase(std::remove(sea.begin(), sea.end(), port), sea.end());
+            QVERIFY(!sea.empty());
+            gameRunner->moveTransport(port, sea.front(), boat->getId());
+            boat.reset();
+
+            // A pawn walks on land
+            for (const auto& entry : gameBoard->getBoard()) {
+                if (!entry.second->isWaterTile()) {
+                    gameBoard->addPawn(player, 2, entry.first);
+                    std::vector<Common::CubeCoordinate> moves =
+                            gameRunner->findPawnMoves(entry.first, 2);
+                    if (!moves.empty()) {
+                        gameRunner->movePawn(entry.first, moves.front(), 2);
+                    }
+                    break;
+                }
+            }
+
+            state->changeGamePhase(Common::GamePhase::SINKING);
+            gameRunner->flipTile(gameRunner->getFlippableTiles().front());
+            state->changeGamePhase(Common::GamePhase::SPINNING);
+            gameRunner->spinWheel();
+        }
+        QVERIFY(runner.expired());
+        QVERIFY(board.expired());
+        QVERIFY(events.expired());
+        QVERIFY(journal.expired());
+        QVERIFY(hex.expired());
+        QVERIFY(transport.expired());
+        QVERIFY(pawn.expired());
+
+        if (game + 1 == TST_RELEASE_WARMUP_GAMES) {
+            residentAfterWarmup = residentSetSize();
+        }
+    }
+
+    long growth = residentSetSize() - residentAfterWarmup;
+    QVERIFY2(growth < TST_RELEASE_MAX_GROWTH,
+             qPrintable(QString("Resident set grew by %1 bytes").arg(growth)));
+}
+
 void GameBoardTest::generateTileCircle(int range)
 {
     Common::CubeCoordinate coord;
@@ -463,6 +1542,37 @@ void GameBoardTest::generateTileCircle(int range)
     }
 }
 
+void GameBoardTest::linkNeighbours()
+{
+    // Same linking as in GameEngine::addHexToBoard
+    auto hexes = std::static_pointer_cast<Student::GameBoard>(board_)->getBoard();
+    for(auto it = hexes.begin(); it != hexes.end(); ++it)
+    {
+        for(auto coord : it->second->getNeighbourVector())
+        {
+            std::shared_ptr<Common::Hex> neighbour = board_->getHex(coord);
+            if(neighbour != nullptr)
+            {
+                it->second->addNeighbour(neighbour);
+            }
+        }
+    }
+}
+
+long GameBoardTest::residentSetSize() const
+{
+#ifdef Q_OS_LINUX
+    long totalPages = 0;
+    long residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> totalPages >> residentPages;
+    return residentPages * sysconf(_SC_PAGESIZE);
+#else
+    // Not measured on this platform, the expired() checks still apply.
+    return 0;
+#endif
+}
+
 std::vector<Common::CubeCoordinate> GameBoardTest::addHex(
         Common::CubeCoordinate coord,
         std::string pieceType)
@@ -0,0 +1,42 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_gameenginetest
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += --coverage
+QMAKE_LFLAGS += --coverage
+
+SOURCES += \
+    tst_gameenginetest.cpp \
+    ../../../UI/gameboard.cpp \
+    ../../../UI/entitystore.cpp \
+    ../../../UI/gamestate.cpp \
+    ../../../UI/player.cpp
+
+HEADERS += \
+    ../../../UI/gameboard.hh \
+    ../../../UI/entitystore.hh \
+    ../../../UI/gamestate.hh \
+    ../../../UI/player.hh
+
+INCLUDEPATH += ../../../UI \
+                ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../UI \
+                ../../../GameLogic/Engine/
+
+LIBS += -L$$OUT_PWD/../../../GameLogic/Engine -lEngine
+
+# the engine reads the game pieces and the wheel from Assets
+copyfiles.commands += cp -r $$_PRO_FILE_PWD_/../../../GameLogic/Assets $$OUT_PWD
+
+QMAKE_EXTRA_TARGETS += copyfiles
+POST_TARGETDEPS += copyfiles
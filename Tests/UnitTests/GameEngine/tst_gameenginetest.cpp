@@ -0,0 +1,727 @@
+#include <QString>
+#include <QtTest>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gameboard.hh"
+#include "gamestate.hh"
+#include "player.hh"
+#include "initialize.hh"
+#include "igamerunner.hh"
+#include "formatexception.hh"
+#include "illegalmoveexception.hh"
+#include "playertable.hh"
+#include "savefile.hh"
+#include "hex.hh"
+#include "pawn.hh"
+#include "actor.hh"
+#include "transport.hh"
+#include "trace.hh"
+
+namespace {
+
+const std::uint32_t TST_SEED = 34;
+const int TST_PLAYERS = 2;
+
+/**
+ * @brief A game as the user interface builds it.
+ */
+struct TestGame {
+    std::shared_ptr<Student::GameBoard> board;
+    std::shared_ptr<Student::GameState> state;
+    std::vector<std::shared_ptr<Common::IPlayer>> players;
+    std::shared_ptr<Common::IGameRunner> runner;
+};
+
+// A board that does not publish its changes, as the boards of the course.
+class SilentBoard : public Student::GameBoard
+{
+public:
+    bool setEventPublisher(std::shared_ptr<Common::GameEventPublisher> events)
+    {
+        (void)events;
+        return false;
+    }
+};
+
+TestGame newGame(std::uint32_t seed,
+                 std::shared_ptr<Student::GameBoard> board = nullptr)
+{
+    TestGame game;
+    game.board = board != nullptr ? board
+                                  : std::make_shared<Student::GameBoard>();
+    game.state = std::make_shared<Student::GameState>();
+    for (int id = 1; id <= TST_PLAYERS; ++id) {
+        game.players.push_back(std::make_shared<Student::Player>(id, 2));
+    }
+    game.runner = Common::Initialization::getGameRunner(
+                game.board, game.state, game.players, seed);
+    return game;
+}
+
+// A game whose players share one PlayerTable, as in the user interface.
+TestGame newTableGame(std::uint32_t seed,
+                      std::shared_ptr<Common::PlayerTable> table)
+{
+    TestGame game;
+    game.board = std::make_shared<Student::GameBoard>();
+    game.state = std::make_shared<Student::GameState>();
+    for (int id = 1; id <= 3; ++id) {
+        game.players.push_back(std::make_shared<Student::Player>(table, id,
+                                                                 2));
+    }
+    game.runner = Common::Initialization::getGameRunner(
+                game.board, game.state, game.players, seed);
+    return game;
+}
+
+TestGame loadGame(const Common::SaveFile& save)
+{
+    TestGame game;
+    game.board = std::make_shared<Student::GameBoard>();
+    game.state = std::make_shared<Student::GameState>();
+    for (const Common::SavedPlayer& saved : save.players()) {
+        game.players.push_back(std::make_shared<Student::Player>(
+                                   saved.id, saved.pawns));
+    }
+    game.runner = Common::Initialization::loadGameRunner(
+                game.board, game.state, game.players, save);
+    return game;
+}
+
+// Everything on the board, hex by hex, as text that can be compared.
+std::string describe(const Student::GameBoard& board)
+{
+    std::ostringstream text;
+    for (const auto& entry : board.getBoard()) {
+        const Common::CubeCoordinate& coord = entry.first;
+        const std::shared_ptr<Common::Hex>& hex = entry.second;
+        text << coord.x << "," << coord.z << " " << hex->getPieceType();
+        for (const auto& pawn : hex->getPawns()) {
+            text << " p" << pawn->getId() << "/" << pawn->getPlayerId();
+        }
+        for (const auto& actor : hex->getActors()) {
+            text << " a" << actor->getId() << actor->getActorType();
+        }
+        for (const auto& transport : hex->getTransports()) {
+            text << " t" << transport->getId()
+                 << transport->getTransportType();
+        }
+        text << "\n";
+    }
+    return text.str();
+}
+
+}
+
+class GameEngineTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    GameEngineTest();
+
+private Q_SLOTS:
+    void testSaveRoundTrip();
+    void testLoadRejectsCorruptSaves();
+    void testFullHexesBlockMoves();
+    void testCheckPawnMovementsBatch();
+    void testPlayerTableLookup();
+    void testPlayerTableTurns();
+    void testFlippableTilesMatchBoard();
+    void testActorAndTransportMovesMatchChecks();
+    void testTracerRingBuffer();
+};
+
+GameEngineTest::GameEngineTest()
+{
+}
+
+void GameEngineTest::testSaveRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("game.igs").toStdString();
+
+    TestGame original = newGame(TST_SEED);
+    std::vector<Common::CubeCoordinate> flippable =
+            original.runner->getFlippableTiles();
+    QVERIFY(flippable.size() >= 2);
+    original.board->addPawn(1, 1, flippable.at(0));
+    original.board->addPawn(1, 2, flippable.at(0));
+    original.board->addPawn(2, 3, flippable.at(1));
+    for (int turn = 0; turn < 3; ++turn) {
+        original.runner->flipTile(original.runner->getFlippableTiles()
+                                  .front());
+        original.runner->spinWheel();
+    }
+    original.runner->saveGame(path);
+
+    Common::SaveFile save(path);
+    TestGame loaded = loadGame(save);
+    QCOMPARE(describe(*loaded.board), describe(*original.board));
+    QCOMPARE(loaded.runner->currentPlayer(), original.runner->currentPlayer());
+    QVERIFY(loaded.runner->currentGamePhase() ==
+            original.runner->currentGamePhase());
+    std::vector<Common::CubeCoordinate> loadedTiles =
+            loaded.runner->getFlippableTiles();
+    std::vector<Common::CubeCoordinate> originalTiles =
+            original.runner->getFlippableTiles();
+    std::sort(loadedTiles.begin(), loadedTiles.end());
+    std::sort(originalTiles.begin(), originalTiles.end());
+    QVERIFY(loadedTiles == originalTiles);
+
+    // Both games go on side by side: the random numbers continue from the
+    // save, and the new pieces of each game are numbered from its own ids
+    for (int turn = 0; turn < 6; ++turn) {
+        std::vector<Common::CubeCoordinate> tiles =
+                original.runner->getFlippableTiles();
+        if (tiles.empty()) {
+            break;
+        }
+        QCOMPARE(loaded.runner->flipTile(tiles.front()),
+                 original.runner->flipTile(tiles.front()));
+        QVERIFY(loaded.runner->spinWheel() == original.runner->spinWheel());
+    }
+    QCOMPARE(describe(*loaded.board), describe(*original.board));
+}
+
+void GameEngineTest::testLoadRejectsCorruptSaves()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("game.igs").toStdString();
+
+    Common::CubeCoordinate center(0, 0, 0);
+    Common::CubeCoordinate land(1, -1, 0);
+    Common::CubeCoordinate water(0, -1, 1);
+    auto valid = [&]() {
+        std::shared_ptr<Common::SaveFileWriter> writer =
+                std::make_shared<Common::SaveFileWriter>();
+        writer->header().gamePhase = Common::GamePhase::MOVEMENT;
+        writer->header().currentPlayer = 1;
+        writer->addHex(center, "Coral");
+        writer->addHex(land, "Forest");
+        writer->addHex(water, "Water");
+        writer->addPawn(1, 1, land, 0);
+        writer->addTransport(1, "boat", water);
+        writer->addActor(1, "shark", water);
+        writer->addPlayer({1, 3, 1, 0});
+        return writer;
+    };
+
+    valid()->write(path);
+    {
+        Common::SaveFile save(path);
+        TestGame game = loadGame(save);
+        QCOMPARE(game.board->getBoard().size(), static_cast<std::size_t>(3));
+    }
+
+    std::vector<std::shared_ptr<Common::SaveFileWriter>> corrupt;
+    corrupt.push_back(valid());
+    corrupt.back()->header().gamePhase = 7;
+    corrupt.push_back(valid());
+    corrupt.back()->header().currentPlayer = 5;
+    corrupt.push_back(valid());
+    corrupt.back()->header().actorIdCounter = -1;
+    corrupt.push_back(valid());
+    // restoring the random numbers would take forever
+    corrupt.back()->header().draws = std::uint64_t(1) << 62;
+    corrupt.push_back(valid());
+    // a hex far beyond any island
+    corrupt.back()->addHex(Common::CubeCoordinate(2000000000, 0,
+                                                  -2000000000), "Water");
+    corrupt.push_back(valid());
+    corrupt.back()->addHex(Common::CubeCoordinate(1000, -1000, 0), "Water");
+    corrupt.push_back(valid());
+    corrupt.back()->addHex(Common::CubeCoordinate(2, 2, 0), "Water");
+    corrupt.push_back(valid());
+    corrupt.back()->addHex(land, "Forest");
+    corrupt.push_back(valid());
+    corrupt.back()->addActor(2, "leviathan", water);
+    corrupt.push_back(valid());
+    corrupt.back()->addTransport(2, "raft", water);
+    corrupt.push_back(valid());
+    corrupt.back()->addTransport(1, "dolphin", water);
+    corrupt.push_back(valid());
+    corrupt.back()->addPawn(2, 1, Common::CubeCoordinate(3, -3, 0), 0);
+    corrupt.push_back(valid());
+    corrupt.back()->addPawn(2, 9, land, 0);
+    corrupt.push_back(valid());
+    corrupt.back()->addPawn(1, 1, center, 0);
+    corrupt.push_back(valid());
+    corrupt.back()->addPawn(2, 1, land, 7);
+
+    for (const auto& writer : corrupt) {
+        writer->write(path);
+        Common::SaveFile save(path);
+        QVERIFY_EXCEPTION_THROWN(loadGame(save), Common::FormatException);
+    }
+}
+
+void GameEngineTest::testFullHexesBlockMoves()
+{
+    // The game is built like the user interface does, and nobody hands the
+    // publisher to the board: the engine sees the pawns anyway
+    std::vector<std::shared_ptr<Student::GameBoard>> boards = {
+        std::make_shared<Student::GameBoard>(),
+        std::make_shared<SilentBoard>()
+    };
+    for (const auto& board : boards) {
+        TestGame game = newGame(TST_SEED, board);
+        Common::CubeCoordinate origin;
+        Common::CubeCoordinate full;
+        bool found = false;
+        for (const auto& entry : game.board->getBoard()) {
+            if (found || entry.second->isWaterTile()) {
+                continue;
+            }
+            for (const auto& coord : entry.second->getNeighbourVector()) {
+                std::shared_ptr<Common::Hex> neighbour =
+                        game.board->getHex(coord);
+                if (neighbour != nullptr && !neighbour->isWaterTile()) {
+                    origin = entry.first;
+                    full = coord;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        QVERIFY(found);
+
+        game.board->addPawn(1, 1, origin);
+        auto listed = [&game, &origin](Common::CubeCoordinate target) {
+            std::vector<Common::CubeCoordinate> moves =
+                    game.runner->findPawnMoves(origin, 1);
+            return std::find(moves.begin(), moves.end(), target) !=
+                    moves.end();
+        };
+        auto checked = [&game, &origin](Common::CubeCoordinate target) {
+            return game.runner->checkPawnMovement(origin, target, 1) >= 0;
+        };
+        QVERIFY(listed(full) && checked(full));
+
+        game.board->addPawn(2, 2, full);
+        game.board->addPawn(2, 3, full);
+        QVERIFY(listed(full) && checked(full));
+        game.board->addPawn(2, 4, full);
+        QVERIFY(!listed(full) && !checked(full));
+        // every move agrees with the full hex, the walks past it too
+        for (const auto& entry : game.board->getBoard()) {
+            if (!(entry.first == origin)) {
+                QCOMPARE(listed(entry.first), checked(entry.first));
+            }
+        }
+
+        // a shark eats the pawns without the engine
+        game.board->getHex(full)->clearPawnsFromTerrain();
+        QVERIFY(listed(full) && checked(full));
+        QCOMPARE(game.runner->checkPawnMovement(origin, full, 1), 2);
+    }
+}
+
+void GameEngineTest::testCheckPawnMovementsBatch()
+{
+    // A board that does not publish has its pawns counted by the engine
+    std::vector<std::shared_ptr<Student::GameBoard>> boards = {
+        std::make_shared<Student::GameBoard>(),
+        std::make_shared<SilentBoard>()
+    };
+    for (const auto& board : boards) {
+        TestGame game = newGame(TST_SEED, board);
+        auto isWater = [&game](Common::CubeCoordinate coord) {
+            return game.board->getHex(coord)->isWaterTile();
+        };
+        auto distance = [](Common::CubeCoordinate a,
+                           Common::CubeCoordinate b) {
+            return (std::abs(a.x - b.x) + std::abs(a.y - b.y) +
+                    std::abs(a.z - b.z)) / 2;
+        };
+
+        // Pawns of the current player on three coastal hexes and one in the
+        // water next to the first of them, and a full hex beside it
+        std::vector<Common::CubeCoordinate> origins;
+        for (const auto& entry : game.board->getBoard()) {
+            if (origins.size() == 3 || isWater(entry.first)) {
+                continue;
+            }
+            for (const auto& coord : entry.second->getNeighbourVector()) {
+                if (game.board->getHex(coord) != nullptr && isWater(coord)) {
+                    origins.push_back(entry.first);
+                    break;
+                }
+            }
+        }
+        QCOMPARE(origins.size(), static_cast<std::size_t>(3));
+        Common::CubeCoordinate full;
+        bool foundFull = false;
+        for (const auto& coord :
+             game.board->getHex(origins.front())->getNeighbourVector()) {
+            if (game.board->getHex(coord) == nullptr) {
+                continue;
+            }
+            if (isWater(coord) && origins.size() == 3) {
+                origins.push_back(coord);
+            } else if (!isWater(coord) && !foundFull &&
+                       std::find(origins.begin(), origins.end(), coord) ==
+                       origins.end()) {
+                full = coord;
+                foundFull = true;
+            }
+        }
+        QCOMPARE(origins.size(), static_cast<std::size_t>(4));
+        QVERIFY(foundFull);
+        for (std::size_t i = 0; i < origins.size(); ++i) {
+            game.board->addPawn(1, static_cast<int>(i) + 1, origins.at(i));
+        }
+        game.board->addPawn(2, 11, full);
+        game.board->addPawn(2, 12, full);
+        game.board->addPawn(2, 13, full);
+
+        // Every hex near each pawn, a pawn asked about at the wrong hex and a
+        // pawn of the other player
+        std::vector<Common::PawnMoveQuery> queries;
+        for (std::size_t i = 0; i < origins.size(); ++i) {
+            for (const auto& entry : game.board->getBoard()) {
+                if (distance(origins.at(i), entry.first) <= 4) {
+                    queries.push_back({origins.at(i), entry.first,
+                                       static_cast<int>(i) + 1});
+                }
+            }
+        }
+        queries.push_back({origins.at(1), origins.at(2), 1});
+        queries.push_back({full, origins.at(0), 11});
+        std::shuffle(queries.begin(), queries.end(), std::mt19937(47));
+
+        std::vector<int> movesLeft(queries.size(), -2);
+        game.runner->checkPawnMovements(queries.data(), queries.size(),
+                                        movesLeft.data());
+
+        int legal = 0;
+        int waterTargets = 0;
+        int fullTargets = 0;
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const Common::PawnMoveQuery& query = queries.at(i);
+            QCOMPARE(movesLeft.at(i), game.runner->checkPawnMovement(
+                         query.origin, query.target, query.pawnId));
+            legal += movesLeft.at(i) >= 0;
+            waterTargets += isWater(query.target) && movesLeft.at(i) >= 0;
+            if (query.target == full) {
+                QCOMPARE(movesLeft.at(i), -1);
+                ++fullTargets;
+            }
+        }
+        QVERIFY(legal > 0);
+        QVERIFY(legal < static_cast<int>(queries.size()));
+        QVERIFY(waterTargets > 0);
+        QVERIFY(fullTargets >= 2);
+    }
+}
+
+void GameEngineTest::testPlayerTableLookup()
+{
+    std::shared_ptr<Common::PlayerTable> table =
+            std::make_shared<Common::PlayerTable>();
+    Student::Player first(table, 1, 4);
+    Student::Player third(table, 3, 2);
+    QCOMPARE(table->size(), static_cast<std::size_t>(2));
+
+    // ids are rows, the unused ones and those past the end are not found
+    QVERIFY(table->find(1) == &table->at(1));
+    QCOMPARE(table->find(3)->id, 3);
+    QVERIFY(table->find(0) == nullptr);
+    QVERIFY(table->find(2) == nullptr);
+    QVERIFY(table->find(4) == nullptr);
+    QVERIFY(table->find(-1) == nullptr);
+    QVERIFY_EXCEPTION_THROWN(table->at(2), std::out_of_range);
+    QVERIFY_EXCEPTION_THROWN(table->addPlayer(3, 1, 1),
+                             std::invalid_argument);
+    QVERIFY_EXCEPTION_THROWN(table->addPlayer(-2, 1, 1),
+                             std::invalid_argument);
+    QCOMPARE(table->size(), static_cast<std::size_t>(2));
+
+    // The players and the table are views of the same rows
+    QCOMPARE(table->at(1).pawns, 4u);
+    QCOMPARE(table->at(1).actionsLeft, 3u);
+    first.setActionsLeft(1);
+    first.addPoints(5);
+    first.addPoints(2);
+    first.removePawn();
+    QCOMPARE(table->at(1).actionsLeft, 1u);
+    QCOMPARE(table->at(1).points, 7u);
+    QCOMPARE(table->at(1).pawns, 3u);
+    table->at(3).points = 4;
+    table->at(3).actionsLeft = 0;
+    QCOMPARE(third.getPoints(), 4u);
+    QCOMPARE(third.getActionsLeft(), 0u);
+    QCOMPARE(third.getPawns(), 2u);
+    QCOMPARE(first.getPoints(), 7u);
+
+    // Rows added later keep the earlier ones where they were
+    Student::Player sixth(table, 6, 1);
+    QCOMPARE(first.getActionsLeft(), 1u);
+    QCOMPARE(third.getPoints(), 4u);
+    QCOMPARE(sixth.getActionsLeft(), 3u);
+}
+
+void GameEngineTest::testPlayerTableTurns()
+{
+    std::shared_ptr<Common::PlayerTable> table =
+            std::make_shared<Common::PlayerTable>();
+    TestGame game = newTableGame(TST_SEED, table);
+    Common::CubeCoordinate center(0, 0, 0);
+    QVERIFY(!game.board->isWaterTile(center));
+
+    std::vector<std::shared_ptr<Student::Player>> players;
+    for (const auto& player : game.players) {
+        players.push_back(std::static_pointer_cast<Student::Player>(player));
+        Common::CubeCoordinate start = players.back()->getStartingCoord();
+        QVERIFY(!game.board->isWaterTile(start));
+        game.board->addPawn(player->getPlayerId(), player->getPlayerId(),
+                            start);
+    }
+
+    // Two rounds in turn order, as the user interface passes the turn: each
+    // player walks to the center and back, and only its own row changes
+    for (int round = 0; round < 2; ++round) {
+        for (const auto& player : players) {
+            int id = player->getPlayerId();
+            game.state->changePlayerTurn(id);
+            player->setActionsLeft(3);
+            QCOMPARE(game.runner->currentPlayer(), id);
+
+            int other = id % 3 + 1;
+            unsigned int otherActions = table->at(other).actionsLeft;
+            Common::CubeCoordinate start = player->getStartingCoord();
+            Common::CubeCoordinate from = round == 0 ? start : center;
+            Common::CubeCoordinate to = round == 0 ? center : start;
+            Common::CubeCoordinate otherFrom =
+                    round == 0 ? players.at(other - 1)->getStartingCoord()
+                               : center;
+            QVERIFY_EXCEPTION_THROWN(
+                        game.runner->movePawn(otherFrom, to, other),
+                        Common::IllegalMoveException);
+
+            QCOMPARE(game.runner->movePawn(from, to, id), 2);
+            QCOMPARE(table->at(id).actionsLeft, 2u);
+            QCOMPARE(player->getActionsLeft(), 2u);
+            QCOMPARE(game.runner->getCurrentPlayer()->getActionsLeft(), 2u);
+            QCOMPARE(table->at(other).actionsLeft, otherActions);
+        }
+    }
+    QCOMPARE(game.board->getHex(center)->getPawnAmount(), 0);
+}
+
+void GameEngineTest::testFlippableTilesMatchBoard()
+{
+    TestGame game = newGame(TST_SEED);
+    const std::vector<std::string> sinkingOrder = {
+        "Beach", "Forest", "Mountain", "Peak"
+    };
+    // The tiles of the first type in the sinking order that is left
+    auto scan = [&game, &sinkingOrder]() {
+        std::vector<Common::CubeCoordinate> tiles;
+        for (const std::string& type : sinkingOrder) {
+            for (const auto& entry : game.board->getBoard()) {
+                if (entry.second->getPieceType() == type) {
+                    tiles.push_back(entry.first);
+                }
+            }
+            if (!tiles.empty()) {
+                break;
+            }
+        }
+        std::sort(tiles.begin(), tiles.end());
+        return tiles;
+    };
+
+    std::mt19937 random(32);
+    int flips = 0;
+    while (true) {
+        std::vector<Common::CubeCoordinate> tiles =
+                game.runner->getFlippableTiles();
+        std::sort(tiles.begin(), tiles.end());
+        QVERIFY(tiles == scan());
+        if (tiles.empty()) {
+            break;
+        }
+
+        // A tile of a later type is refused and the index stays
+        std::string type = game.board->getHex(tiles.front())->getPieceType();
+        for (const auto& entry : game.board->getBoard()) {
+            std::string other = entry.second->getPieceType();
+            if (other != type && other != "Water" && other != "Coral") {
+                QVERIFY_EXCEPTION_THROWN(game.runner->flipTile(entry.first),
+                                         Common::IllegalMoveException);
+                break;
+            }
+        }
+
+        // Tiles are taken from anywhere in the bucket
+        std::uniform_int_distribution<std::size_t> pick(0, tiles.size() - 1);
+        Common::CubeCoordinate tile = tiles.at(pick(random));
+        game.runner->flipTile(tile);
+        QVERIFY(game.board->isWaterTile(tile));
+        QVERIFY_EXCEPTION_THROWN(game.runner->flipTile(tile),
+                                 Common::IllegalMoveException);
+        ++flips;
+    }
+    QVERIFY(flips > 10);
+    QVERIFY(scan().empty());
+}
+
+void GameEngineTest::testActorAndTransportMovesMatchChecks()
+{
+    TestGame game = newGame(TST_SEED);
+    // sinking tiles spawns actors and transports and turns land to water
+    for (int flip = 0; flip < 20; ++flip) {
+        std::vector<Common::CubeCoordinate> tiles =
+                game.runner->getFlippableTiles();
+        if (tiles.empty()) {
+            break;
+        }
+        game.runner->flipTile(tiles.front());
+    }
+
+    const std::vector<std::string> wheel = {"1", "2", "3", "D", "x"};
+    int actors = 0;
+    int transports = 0;
+    for (const auto& entry : game.board->getBoard()) {
+        Common::CubeCoordinate origin = entry.first;
+        for (const auto& actor : entry.second->getActors()) {
+            ++actors;
+            for (const std::string& moves : wheel) {
+                std::vector<Common::CubeCoordinate> listed =
+                        game.runner->findActorMoves(origin, actor->getId(),
+                                                    moves);
+                std::sort(listed.begin(), listed.end());
+                std::vector<Common::CubeCoordinate> checked;
+                for (const auto& target : game.board->getBoard()) {
+                    if (game.runner->checkActorMovement(
+                                origin, target.first, actor->getId(),
+                                moves)) {
+                        checked.push_back(target.first);
+                    }
+                }
+                QVERIFY(listed == checked);
+            }
+        }
+        for (const auto& transport : entry.second->getTransports()) {
+            ++transports;
+            for (const std::string& moves : wheel) {
+                std::vector<Common::CubeCoordinate> listed =
+                        game.runner->findTransportMoves(
+                            origin, transport->getId(), moves);
+                std::sort(listed.begin(), listed.end());
+                std::vector<Common::CubeCoordinate> checked;
+                for (const auto& target : game.board->getBoard()) {
+                    if (game.runner->checkTransportMovement(
+                                origin, target.first, transport->getId(),
+                                moves) >= 0) {
+                        checked.push_back(target.first);
+                    }
+                }
+                QVERIFY(listed == checked);
+            }
+        }
+    }
+    QVERIFY(actors > 0);
+    QVERIFY(transports > 0);
+    QVERIFY(game.runner->findActorMoves(Common::CubeCoordinate(), -1,
+                                        "D").empty());
+}
+
+void GameEngineTest::testTracerRingBuffer()
+{
+    Common::Tracer& tracer = Common::Tracer::instance();
+    tracer.clear();
+    const std::size_t overflow = 100;
+
+    // A thread that overflows its buffer and ends before the export
+    std::thread worker([&tracer, overflow]() {
+        for (std::size_t i = 0;
+             i < Common::Tracer::BUFFER_EVENTS + overflow; ++i) {
+            tracer.counter("tst counter", static_cast<std::int64_t>(i));
+        }
+    });
+    worker.join();
+    tracer.span("tst \"quoted\" span", Common::Tracer::now(), 1500);
+    QCOMPARE(tracer.eventCount(), Common::Tracer::BUFFER_EVENTS + 1);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("trace.json").toStdString();
+    tracer.writeChromeTrace(path);
+    tracer.clear();
+    QCOMPARE(tracer.eventCount(), static_cast<std::size_t>(0));
+
+    // One event per line between the header and the footer
+    auto field = [](const std::string& event, const std::string& key) {
+        std::string::size_type start = event.find("\"" + key + "\":");
+        if (start == std::string::npos) {
+            return std::string();
+        }
+        start += key.size() + 3;
+        return event.substr(start, event.find_first_of(",}", start) - start);
+    };
+    std::ifstream in(path);
+    std::string line;
+    QVERIFY(static_cast<bool>(std::getline(in, line)));
+    QCOMPARE(line, std::string("{\"traceEvents\":["));
+    std::vector<std::int64_t> values;
+    std::string counterThread;
+    std::string spanThread;
+    double lastStart = 0;
+    bool footer = false;
+    while (std::getline(in, line)) {
+        if (line == "],\"displayTimeUnit\":\"ns\"}") {
+            footer = true;
+            break;
+        }
+        if (!line.empty() && line.back() == ',') {
+            line.pop_back();
+        }
+        QVERIFY(line.front() == '{' && line.back() == '}');
+        std::string phase = field(line, "ph");
+        if (phase == "\"C\"") {
+            QCOMPARE(field(line, "name"), std::string("\"tst counter\""));
+            if (counterThread.empty()) {
+                counterThread = field(line, "tid");
+            }
+            QCOMPARE(field(line, "tid"), counterThread);
+            values.push_back(std::stoll(field(line, "value")));
+            // oldest first
+            QVERIFY(std::stod(field(line, "ts")) >= lastStart);
+            lastStart = std::stod(field(line, "ts"));
+        } else if (phase == "\"X\"") {
+            QVERIFY(line.find("\"name\":\"tst \\\"quoted\\\" span\"") !=
+                    std::string::npos);
+            QCOMPARE(field(line, "dur"), std::string("1.500"));
+            spanThread = field(line, "tid");
+        } else {
+            QCOMPARE(phase, std::string("\"M\""));
+        }
+    }
+    QVERIFY(footer);
+    QVERIFY(!std::getline(in, line));
+
+    // The oldest events were overwritten, the rest are kept in order
+    QCOMPARE(values.size(), Common::Tracer::BUFFER_EVENTS);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        QCOMPARE(values.at(i), static_cast<std::int64_t>(i + overflow));
+    }
+    QVERIFY(!spanThread.empty());
+    QVERIFY(spanThread != counterThread);
+}
+
+QTEST_APPLESS_MAIN(GameEngineTest)
+
+#include "tst_gameenginetest.moc"
@@ -39,6 +39,7 @@ SOURCES += \
     ../../../GameLogic/Engine/formatexception.cpp \
     ../../../GameLogic/Engine/gameexception.cpp \
     ../../../UI/gamestate.cpp \
+    ../../../GameLogic/Engine/gameevent.cpp \
     ../../../GameLogic/Engine/pawn.cpp \
     ../../../GameLogic/Engine/transport.cpp \
     ../../../GameLogic/Engine/dolphin.cpp \
@@ -58,6 +59,7 @@ HEADERS += \
     ../../../GameLogic/Engine/gameexception.hh \
     ../../../GameLogic/Engine/igameboard.hh \
     ../../../UI/gamestate.hh \
+    ../../../GameLogic/Engine/gameevent.hh \
     ../../../GameLogic/Engine/pawn.hh \
     ../../../GameLogic/Engine/transport.hh \
     ../../../GameLogic/Engine/dolphin.hh \
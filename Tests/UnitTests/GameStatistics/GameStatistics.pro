@@ -0,0 +1,30 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_gamestatisticstest
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += --coverage
+QMAKE_LFLAGS += --coverage
+
+SOURCES += \
+    tst_gamestatisticstest.cpp \
+    ../../../GameLogic/Engine/gameevent.cpp \
+    ../../../GameLogic/Engine/gamestatistics.cpp
+
+HEADERS += \
+    ../../../GameLogic/Engine/cubecoordinate.hh \
+    ../../../GameLogic/Engine/gameevent.hh \
+    ../../../GameLogic/Engine/gamestatistics.hh \
+    ../../../GameLogic/Engine/igamestate.hh
+
+INCLUDEPATH += ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../GameLogic/Engine/
@@ -0,0 +1,207 @@
+#include <QString>
+#include <QtTest>
+
+#include "gameevent.hh"
+#include "gamestatistics.hh"
+
+#include <memory>
+
+using Common::GameEventType;
+
+class GameStatisticsTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    GameStatisticsTest();
+
+private Q_SLOTS:
+    void init();
+
+    // Mean and variance of a stream and of merged streams
+    void testRunningStat();
+    void testRunningStatMerge();
+
+    // A won game is counted when the winner is published
+    void testWonGame();
+
+    // Pawns are credited to the actor that moved to their hex last
+    void testPawnsLost();
+
+    // Transports and spins are counted by type
+    void testTransportsAndSpins();
+
+    // An abandoned game is counted when its recorder is destroyed
+    void testAbandonedGame();
+
+    // Statistics of two threads merge like one
+    void testMerge();
+
+private:
+    void playTwoPlayerGame(Common::GameStatistics& statistics, int winner);
+
+    std::shared_ptr<Common::GameEventPublisher> events_;
+};
+
+GameStatisticsTest::GameStatisticsTest()
+{
+}
+
+void GameStatisticsTest::init()
+{
+    events_ = std::make_shared<Common::GameEventPublisher>();
+}
+
+void GameStatisticsTest::testRunningStat()
+{
+    Common::RunningStat stat;
+    QVERIFY(stat.count() == 0);
+    for (double value : {2., 4., 4., 4., 5., 5., 7., 9.}) {
+        stat.add(value);
+    }
+    QVERIFY(stat.count() == 8);
+    QCOMPARE(stat.mean(), 5.);
+    QCOMPARE(stat.variance(), 32. / 7);
+    QCOMPARE(stat.min(), 2.);
+    QCOMPARE(stat.max(), 9.);
+}
+
+void GameStatisticsTest::testRunningStatMerge()
+{
+    Common::RunningStat all;
+    Common::RunningStat first;
+    Common::RunningStat second;
+    for (int i = 0; i < 100; ++i) {
+        double value = (i * 37) % 11;
+        all.add(value);
+        (i < 30 ? first : second).add(value);
+    }
+    first.merge(second);
+    QVERIFY(first.count() == all.count());
+    QVERIFY(qAbs(first.mean() - all.mean()) < 1e-9);
+    QVERIFY(qAbs(first.variance() - all.variance()) < 1e-9);
+    QCOMPARE(first.min(), all.min());
+    QCOMPARE(first.max(), all.max());
+}
+
+void GameStatisticsTest::testWonGame()
+{
+    Common::GameStatistics statistics;
+    playTwoPlayerGame(statistics, 2);
+    QVERIFY(statistics.games() == 1);
+    QVERIFY(statistics.wonGames() == 1);
+    QCOMPARE(statistics.gameLength().mean(), 3.);
+    QVERIFY(statistics.lengthHistogram()[0] == 1);
+    QVERIFY(statistics.seats().size() == 2);
+    QVERIFY(statistics.seats()[0].games == 1);
+    QVERIFY(statistics.seats()[0].wins == 0);
+    QVERIFY(statistics.seats()[1].wins == 1);
+    QVERIFY(statistics.phaseTime(Common::GamePhase::SINKING).count() == 1);
+    QVERIFY(statistics.phaseTime(Common::GamePhase::MOVEMENT).count() == 2);
+}
+
+void GameStatisticsTest::testPawnsLost()
+{
+    Common::GameStatistics statistics;
+    {
+        Common::GameStatistics::Recorder recorder(statistics, events_);
+        events_->publish(GameEventType::ACTOR_SPAWNED, 1, 0, {0, 0, 0},
+                         {1, -1, 0}, "shark");
+        events_->publish(GameEventType::ACTOR_SPAWNED, 2, 0, {0, 0, 0},
+                         {2, -2, 0}, "seamunster");
+        events_->publish(GameEventType::ACTOR_MOVED, 2, 0, {2, -2, 0},
+                         {1, -1, 0});
+        events_->publish(GameEventType::PAWN_REMOVED, 11, 0, {1, -1, 0},
+                         {1, -1, 0});
+        events_->publish(GameEventType::ACTOR_SPAWNED, 3, 0, {0, 0, 0},
+                         {5, -5, 0}, "vortex");
+        events_->publish(GameEventType::PAWN_REMOVED, 12, 0, {5, -4, -1},
+                         {5, -4, -1});
+        events_->publish(GameEventType::PAWN_REMOVED, 13, 0, {-5, 5, 0},
+                         {-5, 5, 0});
+    }
+    QVERIFY(statistics.pawnsLost().at("seamunster") == 1);
+    QVERIFY(statistics.pawnsLost().at("vortex") == 1);
+    QVERIFY(statistics.pawnsLost().at("none") == 1);
+    QVERIFY(statistics.pawnsLost().count("shark") == 0);
+}
+
+void GameStatisticsTest::testTransportsAndSpins()
+{
+    Common::GameStatistics statistics;
+    {
+        Common::GameStatistics::Recorder recorder(statistics, events_);
+        events_->publish(GameEventType::TRANSPORT_ADDED, 1, 0, {0, 0, 0},
+                         {1, 0, -1}, "boat");
+        events_->publish(GameEventType::TRANSPORT_SPAWNED, 2, 0, {0, 0, 0},
+                         {2, 0, -2}, "dolphin");
+        events_->publish(GameEventType::PAWN_BOARDED, 11, 1, {1, 0, -1},
+                         {1, 0, -1});
+        events_->publish(GameEventType::TRANSPORT_MOVED, 1, 0, {1, 0, -1},
+                         {2, 0, -2});
+        events_->publish(GameEventType::TRANSPORT_REMOVED, 2, 0, {2, 0, -2},
+                         {2, 0, -2});
+        events_->publish(GameEventType::WHEEL_SPUN, 0, 0, {0, 0, 0},
+                         {0, 0, 0}, "shark", "2");
+        events_->publish(GameEventType::WHEEL_SPUN, 0, 0, {0, 0, 0},
+                         {0, 0, 0}, "shark", "2");
+    }
+    const auto& usage = statistics.transportUsage();
+    QVERIFY(usage.at("boat").appeared == 1);
+    QVERIFY(usage.at("boat").boarded == 1);
+    QVERIFY(usage.at("boat").moves == 1);
+    QVERIFY(usage.at("dolphin").removed == 1);
+    QVERIFY(statistics.spins().at({"shark", "2"}) == 2);
+}
+
+void GameStatisticsTest::testAbandonedGame()
+{
+    Common::GameStatistics statistics;
+    {
+        Common::GameStatistics::Recorder recorder(statistics, events_);
+        events_->publish(GameEventType::PAWN_ADDED, 11, 1, {0, 0, 0},
+                         {0, 0, 0});
+        QVERIFY(statistics.games() == 0);
+    }
+    QVERIFY(statistics.games() == 1);
+    QVERIFY(statistics.wonGames() == 0);
+    QVERIFY(statistics.seats()[0].games == 1);
+
+    // the recorder is gone, so later events change nothing
+    events_->publish(GameEventType::GAME_WON, 1);
+    QVERIFY(statistics.wonGames() == 0);
+}
+
+void GameStatisticsTest::testMerge()
+{
+    Common::GameStatistics first;
+    Common::GameStatistics second;
+    playTwoPlayerGame(first, 1);
+    playTwoPlayerGame(second, 2);
+    playTwoPlayerGame(second, 2);
+    first.merge(second);
+    QVERIFY(first.games() == 3);
+    QVERIFY(first.seats()[0].wins == 1);
+    QVERIFY(first.seats()[1].wins == 2);
+    QVERIFY(first.seats()[1].games == 3);
+    QVERIFY(first.gameLength().count() == 3);
+}
+
+void GameStatisticsTest::playTwoPlayerGame(Common::GameStatistics& statistics,
+                                           int winner)
+{
+    Common::GameStatistics::Recorder recorder(statistics, events_);
+    events_->publish(GameEventType::PAWN_ADDED, 11, 1, {0, 0, 0}, {0, 0, 0});
+    events_->publish(GameEventType::PAWN_ADDED, 21, 2, {0, 0, 0}, {0, 0, 0});
+    events_->publish(GameEventType::PHASE_CHANGED, 0,
+                     Common::GamePhase::SINKING);
+    events_->publish(GameEventType::PHASE_CHANGED, 0,
+                     Common::GamePhase::MOVEMENT);
+    events_->publish(GameEventType::PLAYER_CHANGED, 2);
+    events_->publish(GameEventType::PLAYER_CHANGED, 1);
+    events_->publish(GameEventType::GAME_WON, winner);
+}
+
+QTEST_APPLESS_MAIN(GameStatisticsTest)
+
+#include "tst_gamestatisticstest.moc"
@@ -0,0 +1,33 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_protocoltest
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DESTDIR = bin
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += --coverage
+QMAKE_LFLAGS += --coverage
+
+SOURCES += \
+    tst_protocoltest.cpp \
+    ../../../Server/Protocol/protocol.cpp \
+    ../../../GameLogic/Engine/formatexception.cpp \
+    ../../../GameLogic/Engine/gameexception.cpp
+
+HEADERS += \
+    ../../../Server/Protocol/protocol.hh \
+    ../../../GameLogic/Engine/cubecoordinate.hh \
+    ../../../GameLogic/Engine/formatexception.hh \
+    ../../../GameLogic/Engine/gameexception.hh
+
+INCLUDEPATH += ../../../Server/Protocol \
+                ../../../GameLogic/Engine/
+DEPENDPATH  += ../../../Server/Protocol \
+                ../../../GameLogic/Engine/
@@ -0,0 +1,208 @@
+#include <QString>
+#include <QtTest>
+
+#include "protocol.hh"
+#include "formatexception.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using Server::FrameReader;
+using Server::FrameWriter;
+using Server::MessageType;
+
+class ProtocolTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProtocolTest();
+
+private Q_SLOTS:
+    // Every field reads back as it was written
+    void testRoundTrip();
+
+    // The length prefix is little-endian and counts the type and payload
+    void testFrameLayout();
+
+    // Frames cut at any byte come out whole, the rest waits for more
+    void testSplitStream();
+
+    // Empty, oversized and truncated frames are refused
+    void testRejectsBadFrames();
+
+private:
+    // Three frames back to back, as a client sends them in one write
+    std::vector<std::uint8_t> sampleStream() const;
+
+    // Cuts complete frames off the front of buffer like the server does
+    std::vector<std::vector<std::uint8_t>> takeFrames(
+            std::vector<std::uint8_t>& buffer) const;
+};
+
+ProtocolTest::ProtocolTest()
+{
+}
+
+void ProtocolTest::testRoundTrip()
+{
+    std::vector<std::uint8_t> out;
+    std::string longText(300, 'a');
+    std::uint8_t raw[] = {9, 8, 7};
+    FrameWriter(out, MessageType::RESULT)
+            .u8(200)
+            .u16(65000)
+            .u32(4000000000u)
+            .i32(-123456)
+            .coordinate(Common::CubeCoordinate(-7, 3, 4))
+            .text("sea serpent")
+            .text(longText)
+            .bytes(raw, sizeof(raw))
+            .finish();
+
+    QCOMPARE(Server::frameSize(out.data(), out.size()), out.size());
+    FrameReader reader(out.data(), out.size());
+    QVERIFY(reader.type() == MessageType::RESULT);
+    QCOMPARE(reader.u8(), static_cast<std::uint8_t>(200));
+    QCOMPARE(reader.u16(), static_cast<std::uint16_t>(65000));
+    QCOMPARE(reader.u32(), 4000000000u);
+    QCOMPARE(reader.i32(), -123456);
+    Common::CubeCoordinate coord = reader.coordinate();
+    QVERIFY(coord == Common::CubeCoordinate(-7, 3, 4));
+    QCOMPARE(reader.text(), std::string("sea serpent"));
+    // strings are cut to 255 bytes
+    QCOMPARE(reader.text(), std::string(255, 'a'));
+    QVERIFY(reader.rest() == std::vector<std::uint8_t>({9, 8, 7}));
+    QVERIFY(reader.rest().empty());
+}
+
+void ProtocolTest::testFrameLayout()
+{
+    std::vector<std::uint8_t> out = {0xee};
+    FrameWriter(out, MessageType::MOVE_PAWN).i32(0x01020304).finish();
+
+    std::vector<std::uint8_t> expected = {
+        0xee,
+        5, 0, 0, 0,
+        static_cast<std::uint8_t>(MessageType::MOVE_PAWN),
+        4, 3, 2, 1
+    };
+    QVERIFY(out == expected);
+    // a frame starts where the writer was, not at the start of the buffer
+    QCOMPARE(Server::frameSize(out.data() + 1, out.size() - 1),
+             static_cast<std::size_t>(9));
+}
+
+void ProtocolTest::testSplitStream()
+{
+    std::vector<std::uint8_t> stream = sampleStream();
+    std::vector<std::uint8_t> whole = stream;
+    std::vector<std::vector<std::uint8_t>> expected = takeFrames(whole);
+    QCOMPARE(expected.size(), static_cast<std::size_t>(3));
+    QVERIFY(whole.empty());
+
+    for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+        std::vector<std::uint8_t> buffer;
+        std::vector<std::vector<std::uint8_t>> frames;
+        for (std::size_t start = 0; start < stream.size(); start += chunk) {
+            std::size_t end = std::min(start + chunk, stream.size());
+            buffer.insert(buffer.end(), stream.begin() + start,
+                          stream.begin() + end);
+            for (auto& frame : takeFrames(buffer)) {
+                frames.push_back(frame);
+            }
+            // whatever is left is less than the next frame
+            QVERIFY(buffer.size() < Server::FRAME_LENGTH_SIZE ||
+                    Server::frameSize(buffer.data(), buffer.size()) == 0);
+        }
+        QVERIFY(buffer.empty());
+        QVERIFY(frames == expected);
+    }
+
+    FrameReader flip(expected.at(1).data(), expected.at(1).size());
+    QVERIFY(flip.type() == MessageType::FLIP);
+    QVERIFY(flip.coordinate() == Common::CubeCoordinate(2, -1, -1));
+    FrameReader spin(expected.at(2).data(), expected.at(2).size());
+    QVERIFY(spin.type() == MessageType::SPIN);
+    QVERIFY(spin.rest().empty());
+}
+
+void ProtocolTest::testRejectsBadFrames()
+{
+    // fewer bytes than the length are not an error yet
+    std::vector<std::uint8_t> partial = {0, 0};
+    QCOMPARE(Server::frameSize(partial.data(), partial.size()),
+             static_cast<std::size_t>(0));
+
+    std::vector<std::uint8_t> empty = {0, 0, 0, 0};
+    QVERIFY_EXCEPTION_THROWN(Server::frameSize(empty.data(), empty.size()),
+                             Common::FormatException);
+
+    std::uint32_t tooLarge =
+            static_cast<std::uint32_t>(Server::MAX_FRAME_SIZE) + 1;
+    std::vector<std::uint8_t> large = {
+        static_cast<std::uint8_t>(tooLarge),
+        static_cast<std::uint8_t>(tooLarge >> 8),
+        static_cast<std::uint8_t>(tooLarge >> 16),
+        static_cast<std::uint8_t>(tooLarge >> 24)
+    };
+    QVERIFY_EXCEPTION_THROWN(Server::frameSize(large.data(), large.size()),
+                             Common::FormatException);
+
+    // the largest frame is waited for, not refused
+    std::uint32_t largest = static_cast<std::uint32_t>(Server::MAX_FRAME_SIZE);
+    std::vector<std::uint8_t> waiting = {
+        static_cast<std::uint8_t>(largest),
+        static_cast<std::uint8_t>(largest >> 8),
+        static_cast<std::uint8_t>(largest >> 16),
+        static_cast<std::uint8_t>(largest >> 24),
+        static_cast<std::uint8_t>(MessageType::SKIP)
+    };
+    QCOMPARE(Server::frameSize(waiting.data(), waiting.size()),
+             static_cast<std::size_t>(0));
+
+    // a payload shorter than its fields
+    std::vector<std::uint8_t> out;
+    FrameWriter(out, MessageType::MOVE_PAWN).i32(3).u8(1).finish();
+    FrameReader reader(out.data(), out.size());
+    QCOMPARE(reader.i32(), 3);
+    QVERIFY_EXCEPTION_THROWN(reader.coordinate(), Common::FormatException);
+
+    std::vector<std::uint8_t> text;
+    FrameWriter(text, MessageType::RESULT).u8(10).u8('a').finish();
+    FrameReader textReader(text.data(), text.size());
+    QVERIFY_EXCEPTION_THROWN(textReader.text(), Common::FormatException);
+}
+
+std::vector<std::uint8_t> ProtocolTest::sampleStream() const
+{
+    std::vector<std::uint8_t> stream;
+    FrameWriter(stream, MessageType::NEW_GAME).u8(2).u8(3).u32(34).finish();
+    FrameWriter(stream, MessageType::FLIP)
+            .coordinate(Common::CubeCoordinate(2, -1, -1))
+            .finish();
+    FrameWriter(stream, MessageType::SPIN).finish();
+    return stream;
+}
+
+std::vector<std::vector<std::uint8_t>> ProtocolTest::takeFrames(
+        std::vector<std::uint8_t>& buffer) const
+{
+    std::vector<std::vector<std::uint8_t>> frames;
+    std::size_t complete = 0;
+    std::size_t size;
+    while ((size = Server::frameSize(buffer.data() + complete,
+                                     buffer.size() - complete)) != 0) {
+        frames.emplace_back(buffer.begin() + complete,
+                            buffer.begin() + complete + size);
+        complete += size;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + complete);
+    return frames;
+}
+
+QTEST_APPLESS_MAIN(ProtocolTest)
+
+#include "tst_protocoltest.moc"
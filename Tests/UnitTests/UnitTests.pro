@@ -2,5 +2,8 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     GameBoard \
-    GameState
+    GameEngine \
+    GameState \
+    GameStatistics \
+    Protocol
 
@@ -17,10 +17,14 @@ SOURCES += \
     mainwindow.cpp \
     main.cpp \
     gameboard.cpp \
+    entitystore.cpp \
     gamestate.cpp \
     player.cpp \
     helpers.cpp \
     hexitem.cpp \
+    terrainlayer.cpp \
+    spriteatlas.cpp \
+    renderstats.cpp \
     pawnitem.cpp \
     view.cpp \
     gamepixmapitem.cpp \
@@ -33,7 +37,11 @@ HEADERS  += \
     gamestate.hh \
     mainwindow.hh \
     gameboard.hh \
+    entitystore.hh \
     hexitem.hh \
+    terrainlayer.hh \
+    spriteatlas.hh \
+    renderstats.hh \
     pawnitem.hh \
     helpers.hh \
     view.hh \
@@ -43,6 +51,11 @@ HEADERS  += \
     startdialog.hh
 
 INCLUDEPATH += $$PWD/../GameLogic/Engine
+
+# qmake CONFIG+=tracing records the TRACE_SCOPE timers, see trace.hh
+tracing {
+    DEFINES += ISLANDGAME_TRACING
+}
 DEPENDPATH += $$PWD/../GameLogic/Engine
 
 CONFIG(release, debug|release) {
@@ -3,6 +3,7 @@
  */
 
 #include "actoritem.hh"
+#include "spriteatlas.hh"
 
 namespace Student {
 
@@ -18,25 +19,25 @@ ActorItem::ActorItem(QSize size, int actorId, std::string actorType,
 
 void ActorItem::setActorPixmap(bool selected)
 {
+    SpriteAtlas& atlas = SpriteAtlas::instance();
     // vortex doesnt have selected option
     if (actorType_ == "vortex") {
-        setItemPixmap(QPixmap(":/actor-images/vortex.png").
-                  scaled(3*size_, Qt::KeepAspectRatio));
+        setItemPixmap(atlas.sprite(":/actor-images/vortex.png", 3*size_));
         changeType("vortex");
     } else {
         // set pixmap to be highlighted (white)
         if (selected) {
             if (actorType_ == "shark") {
-                setPixmap(QPixmap(":/actor-images/shark-selected.png").
-                        scaled(size_, Qt::KeepAspectRatio));
+                setPixmap(atlas.sprite(":/actor-images/shark-selected.png",
+                                       size_));
             }
             else if (actorType_ == "kraken") {
-                setPixmap(QPixmap(":/actor-images/kraken-selected.png").
-                        scaled(size_, Qt::KeepAspectRatio));
+                setPixmap(atlas.sprite(":/actor-images/kraken-selected.png",
+                                       size_));
             }
             else if (actorType_ == "seamunster") {
-                setPixmap(QPixmap(":/actor-images/seamunster-selected.png").
-                        scaled(size_, Qt::KeepAspectRatio));
+                setPixmap(atlas.sprite(":/actor-images/seamunster-selected.png",
+                                       size_));
             } else {
                 // Game doesn't know the actor
                 throw std::invalid_argument("invalid actor type");
@@ -44,16 +45,13 @@ void ActorItem::setActorPixmap(bool selected)
         } else {
             QPixmap pixmap;
             if (actorType_ == "shark") {
-                pixmap = QPixmap(":/actor-images/shark.png").
-                        scaled(size_, Qt::KeepAspectRatio);
+                pixmap = atlas.sprite(":/actor-images/shark.png", size_);
             }
             else if (actorType_ == "kraken") {
-                pixmap = QPixmap(":/actor-images/kraken.png").
-                        scaled(size_, Qt::KeepAspectRatio);
+                pixmap = atlas.sprite(":/actor-images/kraken.png", size_);
             }
             else if (actorType_ == "seamunster") {
-                pixmap = QPixmap(":/actor-images/seamunster.png").
-                        scaled(size_, Qt::KeepAspectRatio);
+                pixmap = atlas.sprite(":/actor-images/seamunster.png", size_);
             } else {
                 // Game doesn't know the actor
                 throw std::invalid_argument("invalid actor type");
@@ -63,4 +61,9 @@ void ActorItem::setActorPixmap(bool selected)
     }
 }
 
+RenderStats::ItemClass ActorItem::statsClass() const
+{
+    return RenderStats::ACTOR;
+}
+
 }
@@ -34,6 +34,9 @@ public:
      */
     void setActorPixmap(bool selected);
 
+protected:
+    RenderStats::ItemClass statsClass() const override;
+
 private:
     QSize size_;
     std::string actorType_;
@@ -0,0 +1,238 @@
+/* file: entitystore.cpp
+ * description: Implementation for the class EntityStore.
+ */
+
+#include "entitystore.hh"
+#include <stdexcept>
+
+namespace Student {
+
+EntityStore::EntityStore() :
+    ids_({}),
+    kinds_({}),
+    positions_({}),
+    hexes_({}),
+    owners_({}),
+    cargo_({}),
+    slotOfRow_({}),
+    slots_({}),
+    freeSlots_({}),
+    slotOfKey_({})
+{
+}
+
+EntityHandle EntityStore::add(EntityKind kind, int id, int owner,
+                              Common::CubeCoordinate position,
+                              const Common::Hex* hex)
+{
+    if (contains(kind, id)) {
+        remove(handle(kind, id));
+    }
+
+    // Grow every column first, so the rows cannot get out of step
+    std::size_t rows = ids_.size() + 1;
+    ids_.reserve(rows);
+    kinds_.reserve(rows);
+    positions_.reserve(rows);
+    hexes_.reserve(rows);
+    owners_.reserve(rows);
+    cargo_.reserve(rows);
+    slotOfRow_.reserve(rows);
+
+    std::uint32_t slot;
+    if (freeSlots_.empty()) {
+        slot = static_cast<std::uint32_t>(slots_.size());
+        slots_.push_back({0, 0, false});
+    }
+    else {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    std::uint32_t row = static_cast<std::uint32_t>(ids_.size());
+    ids_.push_back(id);
+    kinds_.push_back(kind);
+    positions_.push_back(position);
+    hexes_.push_back(hex);
+    owners_.push_back(owner);
+    cargo_.push_back(0);
+    slotOfRow_.push_back(slot);
+
+    slots_.at(slot).row = row;
+    slots_.at(slot).used = true;
+    slotOfKey_[key(kind, id)] = slot;
+
+    return {slot, slots_.at(slot).generation};
+}
+
+void EntityStore::remove(EntityHandle handle)
+{
+    std::size_t row = rowOf(handle);
+    std::size_t last = ids_.size() - 1;
+
+    slotOfKey_.erase(key(kinds_.at(row), ids_.at(row)));
+
+    // Move the last row into the freed one
+    if (row != last) {
+        ids_.at(row) = ids_.at(last);
+        kinds_.at(row) = kinds_.at(last);
+        positions_.at(row) = positions_.at(last);
+        hexes_.at(row) = hexes_.at(last);
+        owners_.at(row) = owners_.at(last);
+        cargo_.at(row) = cargo_.at(last);
+        slotOfRow_.at(row) = slotOfRow_.at(last);
+        slots_.at(slotOfRow_.at(row)).row = static_cast<std::uint32_t>(row);
+    }
+    ids_.pop_back();
+    kinds_.pop_back();
+    positions_.pop_back();
+    hexes_.pop_back();
+    owners_.pop_back();
+    cargo_.pop_back();
+    slotOfRow_.pop_back();
+
+    Slot& slot = slots_.at(handle.slot);
+    slot.used = false;
+    ++slot.generation;
+    freeSlots_.push_back(handle.slot);
+}
+
+bool EntityStore::contains(EntityKind kind, int id) const
+{
+    return slotOfKey_.find(key(kind, id)) != slotOfKey_.end();
+}
+
+bool EntityStore::isValid(EntityHandle handle) const
+{
+    return handle.slot < slots_.size() &&
+            slots_[handle.slot].used &&
+            slots_[handle.slot].generation == handle.generation;
+}
+
+EntityHandle EntityStore::handle(EntityKind kind, int id) const
+{
+    std::uint32_t slot = slotOfKey_.at(key(kind, id));
+    return {slot, slots_.at(slot).generation};
+}
+
+Common::CubeCoordinate EntityStore::position(EntityHandle handle) const
+{
+    return positions_.at(rowOf(handle));
+}
+
+void EntityStore::setPosition(EntityHandle handle,
+                              Common::CubeCoordinate position,
+                              const Common::Hex* hex)
+{
+    std::size_t row = rowOf(handle);
+    positions_[row] = position;
+    hexes_[row] = hex;
+}
+
+int EntityStore::owner(EntityHandle handle) const
+{
+    return owners_.at(rowOf(handle));
+}
+
+int EntityStore::cargo(EntityHandle handle) const
+{
+    return cargo_.at(rowOf(handle));
+}
+
+void EntityStore::setCargo(EntityHandle handle, int pawns)
+{
+    cargo_.at(rowOf(handle)) = pawns;
+}
+
+std::size_t EntityStore::size() const
+{
+    return ids_.size();
+}
+
+std::vector<int> EntityStore::idsOfOwner(EntityKind kind, int owner) const
+{
+    std::vector<int> result;
+    for (std::size_t row = 0; row < ids_.size(); ++row) {
+        if (owners_[row] == owner && kinds_[row] == kind) {
+            result.push_back(ids_[row]);
+        }
+    }
+    return result;
+}
+
+std::vector<int> EntityStore::idsAt(EntityKind kind,
+                                    Common::CubeCoordinate position) const
+{
+    std::vector<int> result;
+    for (std::size_t row = 0; row < ids_.size(); ++row) {
+        if (positions_[row] == position && kinds_[row] == kind) {
+            result.push_back(ids_[row]);
+        }
+    }
+    return result;
+}
+
+const std::vector<int>& EntityStore::ids() const
+{
+    return ids_;
+}
+
+const std::vector<EntityKind>& EntityStore::kinds() const
+{
+    return kinds_;
+}
+
+const std::vector<Common::CubeCoordinate>& EntityStore::positions() const
+{
+    return positions_;
+}
+
+const std::vector<const Common::Hex*>& EntityStore::hexes() const
+{
+    return hexes_;
+}
+
+const std::vector<int>& EntityStore::owners() const
+{
+    return owners_;
+}
+
+const std::vector<int>& EntityStore::cargo() const
+{
+    return cargo_;
+}
+
+void EntityStore::clear()
+{
+    // Retire every used slot so that old handles stay invalid
+    for (std::uint32_t row = 0; row < slotOfRow_.size(); ++row) {
+        Slot& slot = slots_.at(slotOfRow_.at(row));
+        slot.used = false;
+        ++slot.generation;
+        freeSlots_.push_back(slotOfRow_.at(row));
+    }
+    ids_.clear();
+    kinds_.clear();
+    positions_.clear();
+    hexes_.clear();
+    owners_.clear();
+    cargo_.clear();
+    slotOfRow_.clear();
+    slotOfKey_.clear();
+}
+
+std::size_t EntityStore::rowOf(EntityHandle handle) const
+{
+    if (!isValid(handle)) {
+        throw std::out_of_range("EntityStore: invalid entity handle");
+    }
+    return slots_[handle.slot].row;
+}
+
+std::uint64_t EntityStore::key(EntityKind kind, int id)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) << 2) |
+            static_cast<std::uint64_t>(kind);
+}
+
+}
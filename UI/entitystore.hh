@@ -0,0 +1,202 @@
+/* file: entitystore.hh
+ * description: Header for class EntityStore, the struct-of-arrays storage of
+ * the pawns, actors and transports on the game board.
+ */
+
+#ifndef ENTITYSTORE_HH
+#define ENTITYSTORE_HH
+
+#include "cubecoordinate.hh"
+#include "hex.hh"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Student {
+
+/**
+ * @brief EntityKind tells which kind of game object an entity is.
+ */
+enum class EntityKind : unsigned char {
+    PAWN,
+    ACTOR,
+    TRANSPORT
+};
+
+/**
+ * @brief EntityHandle is a stable reference to an entity in an EntityStore.
+ * @details A handle stays valid while the entity exists, even though the
+ * entity's row moves inside the dense arrays when other entities are
+ * removed. A handle of a removed entity never refers to a newer entity.
+ */
+struct EntityHandle {
+    std::uint32_t slot;
+    std::uint32_t generation;
+};
+
+/**
+ * @brief EntityStore keeps the pawns, actors and transports of the board in
+ * dense, parallel arrays.
+ * @details Row i of every column describes the same entity. Rows are packed:
+ * a removed entity is replaced by the last row, so bulk queries such as
+ * "all pawns of player N" are linear sweeps over contiguous memory. Entities
+ * are looked up by kind and id, or by EntityHandle.
+ */
+class EntityStore
+{
+public:
+    //! Owner of entities that belong to no player (actors and transports).
+    static const int NO_OWNER = -1;
+
+    EntityStore();
+    ~EntityStore() = default;
+
+    /**
+     * @brief add adds a new entity to the store.
+     * @param kind Kind of the entity.
+     * @param id Identifier of the entity, unique within its kind.
+     * @param owner Id of the owning player or NO_OWNER.
+     * @param position Location of the entity.
+     * @param hex The hex at position, nullptr if not known.
+     * @return Handle of the new entity.
+     * @post If an entity of the same kind and id existed, it is replaced.
+     * Exception quarantee: basic
+     */
+    EntityHandle add(EntityKind kind, int id, int owner,
+                     Common::CubeCoordinate position,
+                     const Common::Hex* hex = nullptr);
+
+    /**
+     * @brief remove removes an entity.
+     * @param handle Handle of the entity.
+     * @exception std::out_of_range The handle is not valid.
+     * @post The last row has been moved into the freed row.
+     * Exception quarantee: strong
+     */
+    void remove(EntityHandle handle);
+
+    /**
+     * @brief contains tells if an entity of the given kind and id exists.
+     * @post Exception quarantee: nothrow
+     */
+    bool contains(EntityKind kind, int id) const;
+
+    /**
+     * @brief isValid tells if the handle refers to an existing entity.
+     * @post Exception quarantee: nothrow
+     */
+    bool isValid(EntityHandle handle) const;
+
+    /**
+     * @brief handle finds the handle of an entity.
+     * @param kind Kind of the entity.
+     * @param id Identifier of the entity.
+     * @return Handle of the entity.
+     * @exception std::out_of_range No such entity.
+     * @post Exception quarantee: strong
+     */
+    EntityHandle handle(EntityKind kind, int id) const;
+
+    /**
+     * @brief position returns the location of an entity.
+     * @exception std::out_of_range The handle is not valid.
+     */
+    Common::CubeCoordinate position(EntityHandle handle) const;
+
+    /**
+     * @brief setPosition changes the location of an entity.
+     * @param hex The hex at position, nullptr if not known.
+     * @exception std::out_of_range The handle is not valid.
+     * @post Exception quarantee: strong
+     */
+    void setPosition(EntityHandle handle, Common::CubeCoordinate position,
+                     const Common::Hex* hex = nullptr);
+
+    /**
+     * @brief owner returns the owning player of an entity.
+     * @exception std::out_of_range The handle is not valid.
+     */
+    int owner(EntityHandle handle) const;
+
+    /**
+     * @brief cargo returns the number of pawns a transport carries.
+     * @return Pawn count of a transport, 0 for pawns and actors.
+     * @exception std::out_of_range The handle is not valid.
+     */
+    int cargo(EntityHandle handle) const;
+
+    /**
+     * @brief setCargo records how many pawns a transport carries.
+     * @exception std::out_of_range The handle is not valid.
+     * @post Exception quarantee: strong
+     */
+    void setCargo(EntityHandle handle, int pawns);
+
+    /**
+     * @brief size returns the number of entities in the store.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief idsOfOwner returns the entities of one kind owned by a player.
+     * @param kind Kind of the entities.
+     * @param owner Id of the player.
+     * @return Ids of the matching entities in row order.
+     */
+    std::vector<int> idsOfOwner(EntityKind kind, int owner) const;
+
+    /**
+     * @brief idsAt returns the entities of one kind at a location.
+     * @param kind Kind of the entities.
+     * @param position Location to look at.
+     * @return Ids of the matching entities in row order.
+     */
+    std::vector<int> idsAt(EntityKind kind,
+                           Common::CubeCoordinate position) const;
+
+    /**
+     * @brief Columns of the store, for sweeps that are not covered above.
+     * Row i of each column belongs to the same entity.
+     */
+    const std::vector<int>& ids() const;
+    const std::vector<EntityKind>& kinds() const;
+    const std::vector<Common::CubeCoordinate>& positions() const;
+    //! Hex at each position, so that a sweep can read the terrain without
+    //! looking the hex up. Not owned, nullptr where not known.
+    const std::vector<const Common::Hex*>& hexes() const;
+    const std::vector<int>& owners() const;
+    const std::vector<int>& cargo() const;
+
+    /**
+     * @brief clear removes all entities. Existing handles become invalid.
+     */
+    void clear();
+
+private:
+    struct Slot {
+        std::uint32_t row;
+        std::uint32_t generation;
+        bool used;
+    };
+
+    std::size_t rowOf(EntityHandle handle) const;
+    static std::uint64_t key(EntityKind kind, int id);
+
+    // Dense columns, one row per entity
+    std::vector<int> ids_;
+    std::vector<EntityKind> kinds_;
+    std::vector<Common::CubeCoordinate> positions_;
+    std::vector<const Common::Hex*> hexes_;
+    std::vector<int> owners_;
+    std::vector<int> cargo_;
+    std::vector<std::uint32_t> slotOfRow_;
+
+    // Indirection from handles to rows
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::unordered_map<std::uint64_t, std::uint32_t> slotOfKey_;
+};
+
+}
+
+#endif // ENTITYSTORE_HH
@@ -3,17 +3,27 @@
  */
 
 #include "gameboard.hh"
+#include "trace.hh"
 
 namespace Student {
 
 GameBoard::GameBoard() :
     hexes_({}),
-    pawns_({}),
-    actors_({}),
-    transports_({})
+    entities_(),
+    detachedPawns_({}),
+    arena_(std::make_shared<Common::Arena>()),
+    events_(nullptr)
 {
 }
 
+GameBoard::~GameBoard()
+{
+    // the hexes may outlive the board, e.g. in the neighbours of an actor
+    for (auto& hex : hexes_) {
+        hex.second->setChangeListener(nullptr);
+    }
+}
+
 int GameBoard::checkTileOccupation(Common::CubeCoordinate tileCoord) const
 {
     auto it = hexes_.find(tileCoord);
@@ -49,104 +59,222 @@ std::shared_ptr<Common::Hex> GameBoard::getHex(Common::CubeCoordinate
 
 void GameBoard::addPawn(int playerId, int pawnId)
 {
+    TRACE_SCOPE("GameBoard::addPawn");
     std::shared_ptr<Common::Pawn> pawn =
-            std::make_shared<Common::Pawn>();
+            Common::makePooled<Common::Pawn>(arena_);
     pawn->setId(playerId, pawnId);
-    pawns_[pawnId] = pawn;
+    detachedPawns_[pawnId] = pawn;
 }
 
 void GameBoard::addPawn(int playerId, int pawnId, Common::CubeCoordinate coord)
 {
+    TRACE_SCOPE("GameBoard::addPawn");
     std::shared_ptr<Common::Pawn> pawn =
-            std::make_shared<Common::Pawn>(pawnId, playerId, coord);
-    hexes_.at(coord)->addPawn(pawn);
-    pawns_[pawnId] = pawn;
+            Common::makePooled<Common::Pawn>(arena_, pawnId, playerId, coord);
+    std::shared_ptr<Common::Hex> hex = hexes_.at(coord);
+    hex->addPawn(pawn);
+    entities_.add(EntityKind::PAWN, pawnId, playerId, coord, hex.get());
+    detachedPawns_.erase(pawnId);
+    publish(Common::GameEventType::PAWN_ADDED, pawnId, playerId, coord);
 }
 
 void GameBoard::movePawn(int pawnId, Common::CubeCoordinate pawnCoord)
 {
+    TRACE_SCOPE("GameBoard::movePawn");
     auto it = hexes_.find(pawnCoord);
-    if (it != hexes_.end()) {
-        auto pawn = pawns_.at(pawnId);
-        hexes_.at(pawn->getCoordinates())->removePawn(pawn);
-        hexes_.at(pawnCoord)->addPawn(pawn);
-        pawns_.at(pawnId)->setCoordinates(pawnCoord);
+    if (it == hexes_.end()) {
+        return;
+    }
+
+    auto detached = detachedPawns_.find(pawnId);
+    if (detached != detachedPawns_.end()) {
+        // First placement of a pawn that was added without a location
+        auto pawn = detached->second;
+        it->second->addPawn(pawn);
+        pawn->setCoordinates(pawnCoord);
+        entities_.add(EntityKind::PAWN, pawnId, pawn->getPlayerId(),
+                      pawnCoord, it->second.get());
+        detachedPawns_.erase(detached);
+        return;
+    }
+
+    EntityHandle handle = entities_.handle(EntityKind::PAWN, pawnId);
+    auto from = hexes_.at(entities_.position(handle));
+    auto pawn = from->givePawn(pawnId);
+    if (pawn == nullptr) {
+        // the pawn left its hex without the board knowing
+        syncHex(from->getCoordinates());
+        return;
     }
+    from->removePawn(pawn);
+    it->second->addPawn(pawn);
+    pawn->setCoordinates(pawnCoord);
+    entities_.setPosition(handle, pawnCoord, it->second.get());
 }
 
 void GameBoard::removePawn(int pawnId)
 {
-    auto pawn = pawns_.at(pawnId);
-    hexes_.at(pawn->getCoordinates())->removePawn(pawn);
-    pawns_.erase(pawnId);
+    TRACE_SCOPE("GameBoard::removePawn");
+    if (detachedPawns_.erase(pawnId) > 0) {
+        return;
+    }
+
+    EntityHandle handle = entities_.handle(EntityKind::PAWN, pawnId);
+    Common::CubeCoordinate coord = entities_.position(handle);
+    auto hex = hexes_.at(coord);
+    auto pawn = hex->givePawn(pawnId);
+    if (pawn != nullptr && pawn->isInTransport()) {
+        pawn->getTransport()->removePawn(pawn);
+    }
+    hex->removePawn(pawn);
+    entities_.remove(handle);
+    publish(Common::GameEventType::PAWN_REMOVED, pawnId, 0, coord);
+}
+
+bool GameBoard::boardPawn(int pawnId, int transportId)
+{
+    TRACE_SCOPE("GameBoard::boardPawn");
+    EntityHandle handle = entities_.handle(EntityKind::TRANSPORT, transportId);
+    Common::CubeCoordinate coord = entities_.position(handle);
+    auto hex = hexes_.at(coord);
+    auto transport = hex->giveTransport(transportId);
+    auto pawn = hex->givePawn(pawnId);
+    if (pawn == nullptr || transport->getCapacity() <= 0 ||
+            transport->isPawnInTransport(pawn)) {
+        return false;
+    }
+    auto previous = pawn->getTransport();
+    transport->addPawn(pawn);
+    if (pawn->getTransport() != transport) {
+        return false;
+    }
+    if (previous != nullptr) {
+        updateCargo(entities_.handle(EntityKind::TRANSPORT, previous->getId()),
+                    previous);
+    }
+    updateCargo(handle, transport);
+    publish(Common::GameEventType::PAWN_BOARDED, pawnId, transportId, coord);
+    return true;
 }
 
 void GameBoard::addActor(std::shared_ptr<Common::Actor> actor,
                          Common::CubeCoordinate actorCoord)
 {
-    actors_[actor->getId()] = actorCoord;
-    actor->addHex(hexes_.at(actorCoord));
+    TRACE_SCOPE("GameBoard::addActor");
+    std::shared_ptr<Common::Hex> hex = hexes_.at(actorCoord);
+    actor->addHex(hex);
+    entities_.add(EntityKind::ACTOR, actor->getId(), EntityStore::NO_OWNER,
+                  actorCoord, hex.get());
 }
 
 void GameBoard::moveActor(int actorId, Common::CubeCoordinate actorCoord)
 {
+    TRACE_SCOPE("GameBoard::moveActor");
     auto it = hexes_.find(actorCoord);
     if (it != hexes_.end()) {
-        auto actor = hexes_.at(actors_.at(actorId))->giveActor(actorId);
-        actors_.at(actorId) = actorCoord;
-        actor->move(hexes_.at(actorCoord));
+        EntityHandle handle = entities_.handle(EntityKind::ACTOR, actorId);
+        auto actor = hexes_.at(entities_.position(handle))->giveActor(actorId);
+        if (actor == nullptr) {
+            syncHex(entities_.position(handle));
+            return;
+        }
+        entities_.setPosition(handle, actorCoord, it->second.get());
+        actor->move(it->second);
     }
 }
 
 void GameBoard::removeActor(int actorId)
 {
-    auto actor = hexes_.at(actors_.at(actorId))->giveActor(actorId);
-    hexes_.at(actors_.at(actorId))->removeActor(actor);
-    actors_.erase(actorId);
+    TRACE_SCOPE("GameBoard::removeActor");
+    EntityHandle handle = entities_.handle(EntityKind::ACTOR, actorId);
+    Common::CubeCoordinate coord = entities_.position(handle);
+    auto hex = hexes_.at(coord);
+    hex->removeActor(hex->giveActor(actorId));
+    entities_.remove(handle);
+    publish(Common::GameEventType::ACTOR_REMOVED, actorId, 0, coord);
 }
 
 void GameBoard::addHex(std::shared_ptr<Common::Hex> newHex)
 {
-    hexes_[newHex->getCoordinates()] = newHex;
+    TRACE_SCOPE("GameBoard::addHex");
+    std::shared_ptr<Common::Hex>& hex = hexes_[newHex->getCoordinates()];
+    if (hex != nullptr && hex != newHex) {
+        hex->setChangeListener(nullptr);
+    }
+    hex = newHex;
+    hex->setChangeListener([this] (Common::CubeCoordinate coord) {
+        syncHex(coord);
+    });
 }
 
 void GameBoard::addTransport(std::shared_ptr<Common::Transport> transport,
                              Common::CubeCoordinate coord)
 {
-    transports_[transport->getId()] = coord;
-    transport->addHex(hexes_.at(coord));
+    TRACE_SCOPE("GameBoard::addTransport");
+    std::shared_ptr<Common::Hex> hex = hexes_.at(coord);
+    transport->addHex(hex);
+    EntityHandle handle = entities_.add(EntityKind::TRANSPORT,
+                                        transport->getId(),
+                                        EntityStore::NO_OWNER, coord,
+                                        hex.get());
+    updateCargo(handle, transport);
 }
 
 void GameBoard::moveTransport(int id, Common::CubeCoordinate coord)
 {
+    TRACE_SCOPE("GameBoard::moveTransport");
     auto it = hexes_.find(coord);
     if (it != hexes_.end()) {
-        auto transport = hexes_.at(transports_.at(id))->giveTransport(id);
-        transports_.at(id) = coord;
-        transport->move(hexes_.at(coord));
+        EntityHandle handle = entities_.handle(EntityKind::TRANSPORT, id);
+        auto transport =
+                hexes_.at(entities_.position(handle))->giveTransport(id);
+        if (transport == nullptr) {
+            syncHex(entities_.position(handle));
+            return;
+        }
+        entities_.setPosition(handle, coord, it->second.get());
+        transport->move(it->second);
+
+        // The pawns on board moved along with the transport
+        for (auto pawn : transport->getPawnsInTransport()) {
+            if (entities_.contains(EntityKind::PAWN, pawn->getId())) {
+                entities_.setPosition(
+                            entities_.handle(EntityKind::PAWN, pawn->getId()),
+                            coord, it->second.get());
+            }
+        }
+        updateCargo(handle, transport);
     }
 }
 
 void GameBoard::removeTransport(int id)
 {
-    auto transport = hexes_.at(transports_.at(id))->giveTransport(id);
-    hexes_.at(transports_.at(id))->removeTransport(transport);
-    transports_.erase(id);
+    TRACE_SCOPE("GameBoard::removeTransport");
+    EntityHandle handle = entities_.handle(EntityKind::TRANSPORT, id);
+    Common::CubeCoordinate coord = entities_.position(handle);
+    auto hex = hexes_.at(coord);
+    hex->removeTransport(hex->giveTransport(id));
+    entities_.remove(handle);
+    publish(Common::GameEventType::TRANSPORT_REMOVED, id, 0, coord);
 }
 
 Common::CubeCoordinate GameBoard::getPawnCoords(int id) const
 {
-    return pawns_.at(id)->getCoordinates();
+    auto detached = detachedPawns_.find(id);
+    if (detached != detachedPawns_.end()) {
+        return detached->second->getCoordinates();
+    }
+    return entities_.position(entities_.handle(EntityKind::PAWN, id));
 }
 
 Common::CubeCoordinate GameBoard::getActorCoords(int id) const
 {
-    return actors_.at(id);
+    return entities_.position(entities_.handle(EntityKind::ACTOR, id));
 }
 
 Common::CubeCoordinate GameBoard::getTransportCoords(int id) const
 {
-    return transports_.at(id);
+    return entities_.position(entities_.handle(EntityKind::TRANSPORT, id));
 }
 
 std::map<Common::CubeCoordinate, std::shared_ptr<Common::Hex>>
@@ -155,4 +283,87 @@ GameBoard::getBoard() const
     return hexes_;
 }
 
+std::vector<int> GameBoard::getPawnsOfPlayer(int playerId) const
+{
+    return entities_.idsOfOwner(EntityKind::PAWN, playerId);
+}
+
+std::vector<int> GameBoard::getActorsOnWater() const
+{
+    const std::vector<int>& ids = entities_.ids();
+    const std::vector<EntityKind>& kinds = entities_.kinds();
+    const std::vector<const Common::Hex*>& hexes = entities_.hexes();
+
+    // the hexes are read through the store, flips show without a lookup
+    std::vector<int> result;
+    for (std::size_t row = 0; row < ids.size(); ++row) {
+        if (kinds[row] == EntityKind::ACTOR && hexes[row] != nullptr &&
+                hexes[row]->isWaterTile()) {
+            result.push_back(ids[row]);
+        }
+    }
+    return result;
+}
+
+const EntityStore& GameBoard::getEntities() const
+{
+    return entities_;
+}
+
+bool GameBoard::setEventPublisher(
+        std::shared_ptr<Common::GameEventPublisher> events)
+{
+    events_ = events;
+    return true;
+}
+
+void GameBoard::updateCargo(EntityHandle transport,
+                            const std::shared_ptr<Common::Transport>& object)
+{
+    entities_.setCargo(transport,
+                       static_cast<int>(object->getPawnsInTransport().size()));
+}
+
+void GameBoard::syncHex(Common::CubeCoordinate coord)
+{
+    TRACE_SCOPE("GameBoard::syncHex");
+    auto it = hexes_.find(coord);
+    if (it == hexes_.end()) {
+        return;
+    }
+    const std::shared_ptr<Common::Hex>& hex = it->second;
+
+    // Pieces the hex no longer has were removed by the rules of an actor
+    for (int id : entities_.idsAt(EntityKind::PAWN, coord)) {
+        if (hex->givePawn(id) == nullptr) {
+            entities_.remove(entities_.handle(EntityKind::PAWN, id));
+            publish(Common::GameEventType::PAWN_REMOVED, id, 0, coord);
+        }
+    }
+    for (int id : entities_.idsAt(EntityKind::ACTOR, coord)) {
+        if (hex->giveActor(id) == nullptr) {
+            entities_.remove(entities_.handle(EntityKind::ACTOR, id));
+            publish(Common::GameEventType::ACTOR_REMOVED, id, 0, coord);
+        }
+    }
+    for (int id : entities_.idsAt(EntityKind::TRANSPORT, coord)) {
+        EntityHandle handle = entities_.handle(EntityKind::TRANSPORT, id);
+        std::shared_ptr<Common::Transport> transport = hex->giveTransport(id);
+        if (transport == nullptr) {
+            entities_.remove(handle);
+            publish(Common::GameEventType::TRANSPORT_REMOVED, id, 0, coord);
+        } else {
+            updateCargo(handle, transport);
+        }
+    }
+}
+
+void GameBoard::publish(Common::GameEventType type, int id, int other,
+                        Common::CubeCoordinate coord)
+{
+    if (events_ != nullptr) {
+        events_->publish(type, id, other, coord, coord);
+    }
+}
+
 }
@@ -6,12 +6,16 @@
 #define GAMEBOARD_HH
 
 #include "igameboard.hh"
+#include "arena.hh"
+#include "entitystore.hh"
 #include "pawn.hh"
 #include "actor.hh"
 #include "transport.hh"
 #include "illegalmoveexception.hh"
+#include "gameevent.hh"
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace Student {
 
@@ -19,7 +23,7 @@ class GameBoard : public Common::IGameBoard
 {
 public:
     GameBoard();
-    ~GameBoard() = default;
+    ~GameBoard();
 
     /**
      * @brief checkTileOccupation Checks the current amount of pawns on the tile
@@ -79,6 +83,17 @@ public:
      */
     void removePawn(int pawnId);
 
+    /**
+     * @brief boardPawn puts a pawn into a transport on the same hex.
+     * @param pawnId The identifier of the pawn.
+     * @param transportId The identifier of the transport.
+     * @pre The pawn and the transport exist.
+     * @return True if the pawn boarded, false if the transport is full or
+     * the pawn is already in it or not on its hex.
+     * @post Exception quarantee: basic
+     */
+    bool boardPawn(int pawnId, int transportId);
+
     /**
      * @brief addActor adds a new actor to the game board
      * @param actor
@@ -171,11 +186,64 @@ public:
      */
     std::map<Common::CubeCoordinate, std::shared_ptr<Common::Hex>> getBoard() const;
 
+    /**
+     * @brief getPawnsOfPlayer returns the pawns of a player on the board.
+     * @param playerId The identifier of the player.
+     * @return Ids of the pawns.
+     * @post Exception quarantee: strong
+     */
+    std::vector<int> getPawnsOfPlayer(int playerId) const;
+
+    /**
+     * @brief getActorsOnWater returns the actors that are on water tiles.
+     * @return Ids of the actors.
+     * @post Exception quarantee: strong
+     */
+    std::vector<int> getActorsOnWater() const;
+
+    /**
+     * @brief getEntities gives read access to the pawns, actors and
+     * transports of the board, for bulk queries.
+     * @return The entity store of the board.
+     */
+    const EntityStore& getEntities() const;
+
+    /**
+     * @brief setEventPublisher makes the board publish the changes made to
+     * it by the rules of the game: pawns added, pawns boarding and pieces
+     * removed. The moves and spawns are published by the game engine, which
+     * makes them.
+     * @param events Publisher of the game, nullptr to stop publishing.
+     * @return True, the board publishes its changes.
+     * @post Exception quarantee: nothrow
+     */
+    bool setEventPublisher(std::shared_ptr<Common::GameEventPublisher> events);
+
 private:
+    void updateCargo(EntityHandle transport,
+                     const std::shared_ptr<Common::Transport>& object);
+    // Drops the pieces a hex lost without the board and counts the cargo
+    // of its transports again. Hexes of the board call it when the rules of
+    // an actor change them.
+    void syncHex(Common::CubeCoordinate coord);
+    void publish(Common::GameEventType type, int id, int other,
+                 Common::CubeCoordinate coord);
+
     std::map<Common::CubeCoordinate, std::shared_ptr<Common::Hex>> hexes_;
-    std::unordered_map<int, std::shared_ptr<Common::Pawn>> pawns_;
-    std::unordered_map<int, Common::CubeCoordinate> actors_;
-    std::unordered_map<int, Common::CubeCoordinate> transports_;
+
+    // Positions, owners and cargo of everything on the board. The objects
+    // themselves are reached through the hexes. The hexes tell syncHex
+    // when an actor removes pieces or a transport loads or unloads pawns.
+    EntityStore entities_;
+
+    // Pawns added without a location, they have no hex yet.
+    std::unordered_map<int, std::shared_ptr<Common::Pawn>> detachedPawns_;
+
+    // Storage for the pawns of this game, released with the board.
+    std::shared_ptr<Common::Arena> arena_;
+
+    // Where the changes are published, nullptr if nobody listens.
+    std::shared_ptr<Common::GameEventPublisher> events_;
 
 };
 
@@ -3,13 +3,39 @@
  */
 
 #include "gamepixmapitem.hh"
+#include "helpers.hh"
+#include <map>
 
 namespace Student {
 
+namespace {
+
+// average color of a pixmap, items sharing a sprite of the atlas share the
+// cache key too, so the color is computed once per sprite
+QColor averageColor(const QPixmap& pixmap)
+{
+    static std::map<qint64, QColor> colors;
+    auto found = colors.find(pixmap.cacheKey());
+    if (found != colors.end()) {
+        return found->second;
+    }
+    // scaling to one pixel averages the opaque part of the image
+    QImage average = pixmap.toImage().scaled(
+                1, 1, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    QColor color = QColor::fromRgba(average.pixel(0, 0));
+    color.setAlpha(255);
+    colors[pixmap.cacheKey()] = color;
+    return color;
+}
+
+}
+
 GamePixmapItem::GamePixmapItem(std::string type, int id, HexItem *parentHex) :
     type_(type),
     id_(id),
     parentHex_(parentHex),
+    pixmap_(),
+    dotColor_(Qt::black),
     currentSlot_(0)
 {
 }
@@ -31,51 +57,63 @@ void GamePixmapItem::setLocationOnBoard(HexItem *source, HexItem *target,
         return;
     }
 
-    // remove the item from the previous location
-    if (parentHex_ != nullptr) {
-        scene->removeItem(this);
-    }
-
-    // no slot-index given
-    if (i < 0) {
-        // check if there's available item slots on the target hex
-        // and set new position and parent hex for the item (if all
-        // slots are occupied, nothing is changed)
+    // no slot-index given, take the first unoccupied slot on the target hex
+    int slot = i;
+    if (slot < 0) {
         for (int j = 0; j < 3; ++j) {
             if (!target->slotFull(type_, j)) {
-                setPos(target->getSlot(type_, j));
-                target->changeSlotOccupation(type_, j);
-                if (source != nullptr) {
-                    source->changeSlotOccupation(type_, currentSlot_);
-                }
-                parentHex_ = target;
-                currentSlot_ = j;
+                slot = j;
                 break;
             }
         }
     }
-    // set location on the given slot-index if possible
-    else {
-        if (!target->slotFull(type_, i)) {
-            setPos(target->getSlot(type_, i));
-            target->changeSlotOccupation(type_, i);
-            if (source != nullptr) {
-                source->changeSlotOccupation(type_, currentSlot_);
-            }
-            parentHex_ = target;
-            currentSlot_ = i;
+
+    // set new position and parent hex for the item (if the slot is
+    // occupied, nothing is changed)
+    if (slot >= 0 && !target->slotFull(type_, slot)) {
+        if (source != nullptr) {
+            source->setSlotOccupied(type_, currentSlot_, false);
         }
+        target->setSlotOccupied(type_, slot, true);
+        setPos(target->getSlot(type_, slot));
+        parentHex_ = target;
+        currentSlot_ = slot;
     }
 
-    // restore items pixmap to normal and re-add item to the scene
-    setPixmap(pixmap_);
-    scene->addItem(this);
+    // restore the pixmap of a selected item to normal, setting the same
+    // pixmap again would make the scene redraw the item
+    if (pixmap().cacheKey() != pixmap_.cacheKey()) {
+        setPixmap(pixmap_);
+    }
+    // the item is added to the scene when it is placed the first time,
+    // after that moving it only changes its position
+    if (this->scene() != scene) {
+        scene->addItem(this);
+    }
 }
 
 void GamePixmapItem::setItemPixmap(QPixmap pixmap)
 {
     pixmap_ = pixmap;
     setPixmap(pixmap);
+    if (!pixmap.isNull()) {
+        dotColor_ = averageColor(pixmap);
+    }
+}
+
+void GamePixmapItem::paint(QPainter *painter,
+                           const QStyleOptionGraphicsItem *option,
+                           QWidget *widget)
+{
+    RenderStats::PaintTimer timer(statsClass());
+    if (!isLowDetail(painter)) {
+        QGraphicsPixmapItem::paint(painter, option, widget);
+        return;
+    }
+    bool selected = pixmap().cacheKey() != pixmap_.cacheKey();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(selected ? QColor(Qt::white) : dotColor_);
+    painter->drawEllipse(boundingRect());
 }
 
 void GamePixmapItem::changeType(std::string type)
@@ -88,4 +126,9 @@ int GamePixmapItem::currentSlot()
     return currentSlot_;
 }
 
+RenderStats::ItemClass GamePixmapItem::statsClass() const
+{
+    return RenderStats::OTHER;
+}
+
 }
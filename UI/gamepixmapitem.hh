@@ -6,9 +6,11 @@
 #define GAMEPIXMAPITEM_HH
 
 #include "hexitem.hh"
+#include "renderstats.hh"
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 
 namespace Student {
 
@@ -39,10 +41,12 @@ public:
     virtual void mousePressEvent(QGraphicsSceneMouseEvent * event);
 
     /**
-     * @brief setLocationOnBoard moves the item from source hex to target hex
+     * @brief setLocationOnBoard moves the item from source hex to target hex.
+     * The item is added to the scene the first time it is placed, after that
+     * only its position changes.
      * @param source current location of the item
      * @param target location to be moved into
-     * @param scene QGraphicsScene where items are added/removed from
+     * @param scene QGraphicsScene the item is shown in
      * @param i index of the slot where location is set (if not given,
      *        location will be set on the first unoccupied slot)
      */
@@ -55,6 +59,14 @@ public:
      */
     virtual void setItemPixmap(QPixmap pixmap);
 
+    /**
+     * @brief paint draws the pixmap, or a dot of the main color of the pixmap
+     * when the item is drawn below LOW_DETAIL_LEVEL. Selected items are
+     * white dots.
+     */
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
     /**
      * @brief changeType changes the type of the item
      * @param type to be changed to
@@ -70,11 +82,20 @@ public:
 signals:
     void selected(int id);
 
+protected:
+    /**
+     * @brief statsClass returns the class the painting of the item is
+     * counted in by RenderStats
+     */
+    virtual RenderStats::ItemClass statsClass() const;
+
 private:
     std::string type_;
     int id_;
     Student::HexItem *parentHex_;
     QPixmap pixmap_;
+    // average color of pixmap_, the color of the item when zoomed far out
+    QColor dotColor_;
     int currentSlot_;
 };
 
@@ -10,7 +10,8 @@ GameState::GameState() :
     currentGamePhase_(Common::GamePhase::MOVEMENT),
     currentPlayerId_(1),
     winCondition_(false),
-    winnerId_(0)
+    winnerId_(0),
+    events_(nullptr)
 {
 }
 
@@ -26,12 +27,25 @@ int GameState::currentPlayer() const
 
 void GameState::changeGamePhase(Common::GamePhase nextPhase)
 {
+    if (nextPhase == currentGamePhase_) {
+        return;
+    }
     currentGamePhase_ = nextPhase;
+    if (events_ != nullptr) {
+        events_->publish(Common::GameEventType::PHASE_CHANGED, 0,
+                         static_cast<int>(nextPhase));
+    }
 }
 
 void GameState::changePlayerTurn(int nextPlayer)
 {
+    if (nextPlayer == currentPlayerId_) {
+        return;
+    }
     currentPlayerId_ = nextPlayer;
+    if (events_ != nullptr) {
+        events_->publish(Common::GameEventType::PLAYER_CHANGED, nextPlayer);
+    }
 }
 
 bool GameState::checkWinCondition()
@@ -43,6 +57,9 @@ void GameState::endGame(int winnerId)
 {
     winCondition_ = true;
     winnerId_ = winnerId;
+    if (events_ != nullptr) {
+        events_->publish(Common::GameEventType::GAME_WON, winnerId);
+    }
 }
 
 int GameState::getWinnerId()
@@ -50,4 +67,10 @@ int GameState::getWinnerId()
     return winnerId_;
 }
 
+void GameState::setEventPublisher(
+        std::shared_ptr<Common::GameEventPublisher> events)
+{
+    events_ = events;
+}
+
 }
@@ -6,6 +6,9 @@
 #define GAMESTATE_HH
 
 #include "igamestate.hh"
+#include "gameevent.hh"
+
+#include <memory>
 
 namespace Student {
 
@@ -61,11 +64,20 @@ public:
      */
     int getWinnerId();
 
+    /**
+     * @brief setEventPublisher makes the state publish the changes of the
+     * phase and the player in turn and the end of the game.
+     * @param events Publisher of the game, nullptr to stop publishing.
+     * @post Exception quarantee: nothrow
+     */
+    void setEventPublisher(std::shared_ptr<Common::GameEventPublisher> events);
+
 private:
     Common::GamePhase currentGamePhase_;
     int currentPlayerId_;
     bool winCondition_;
     int winnerId_;
+    std::shared_ptr<Common::GameEventPublisher> events_;
 
 };
 
@@ -3,9 +3,16 @@
  */
 
 #include "helpers.hh"
+#include <QStyleOptionGraphicsItem>
 
 namespace Student {
 
+namespace {
+
+const qreal SQRT_3 = std::sqrt(3.);
+
+}
+
 QPointF hexCorner(int size, int i)
 {
     double angleDeg = (60 * i) - 30;
@@ -18,20 +25,34 @@ QPointF hexCorner(int size, int i)
 
 QPolygonF hexagonCorners(int size)
 {
-    QPolygonF points;
-    for (int i = 0; i < 6; ++i){
-        points << hexCorner(size, i);
+    // all hexes of a board have the same size, so the corners are computed
+    // once and the copies share them
+    static int cachedSize = 0;
+    static QPolygonF cachedPoints;
+    if (size != cachedSize || cachedPoints.isEmpty()) {
+        QPolygonF points;
+        for (int i = 0; i < 6; ++i){
+            points << hexCorner(size, i);
+        }
+        cachedPoints = points;
+        cachedSize = size;
     }
-    return points;
+    return cachedPoints;
 }
 
 QPointF cubeToPixel(Common::CubeCoordinate cube, int size)
 {
     qreal x = cube.x;
     qreal y = cube.z;
-    x = size * ((sqrt(3) * x)  +  ((sqrt(3)/2) * y));
+    x = size * ((SQRT_3 * x)  +  ((SQRT_3/2) * y));
     y = size * ((3./2) * y);
     return QPointF(x, y);
 }
 
+bool isLowDetail(const QPainter *painter)
+{
+    return QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+                painter->worldTransform()) < LOW_DETAIL_LEVEL;
+}
+
 }
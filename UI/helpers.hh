@@ -6,12 +6,17 @@
 #define HELPERS_HH
 
 #include "cubecoordinate.hh"
+#include <QPainter>
 #include <QPointF>
 #include <QPolygonF>
 #include <QtMath>
 
 namespace Student {
 
+// Below this level of detail (scale of the view) the board is drawn without
+// outlines, pixmaps and smoothing.
+const qreal LOW_DETAIL_LEVEL = 0.1;
+
 /**
  * @brief hexCorner Calculates a hexagons corner assuming center is at (0, 0)
  * @param size Hexagons radius from center to a corner in pixels
@@ -35,6 +40,14 @@ QPolygonF hexagonCorners(int size);
  */
 QPointF cubeToPixel(Common::CubeCoordinate cube, int size);
 
+/**
+ * @brief isLowDetail Tells if an item is painted so small that it is drawn
+ *        without details
+ * @param painter Painter the item is painted with
+ * @return True if the level of detail is below LOW_DETAIL_LEVEL
+ */
+bool isLowDetail(const QPainter *painter);
+
 }
 
 #endif // HELPERS_HH
@@ -18,6 +18,8 @@ HexItem::HexItem(Common::CubeCoordinate cubeCoords, QPointF pixelCoords,
     setPen(pen);
     initializeSlots();
     setAcceptHoverEvents(true);
+    // the terrain is drawn by the TerrainLayer
+    setFlag(QGraphicsItem::ItemHasNoContents);
 }
 
 Common::CubeCoordinate HexItem::getCubeCoords()
@@ -35,6 +37,7 @@ void HexItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
     if (event->buttons() == Qt::LeftButton) {
         setPen(pen_);
         setZValue(0);
+        setFlag(QGraphicsItem::ItemHasNoContents);
         emit clicked(cubeCoords_);
         QGraphicsPolygonItem::mousePressEvent(event);
     }
@@ -50,6 +53,7 @@ void HexItem::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
         pen.setWidth(10);
         setPen(pen);
         setZValue(5);
+        setFlag(QGraphicsItem::ItemHasNoContents, false);
     }
     emit hover(cubeCoords_);
     QGraphicsPolygonItem::hoverEnterEvent(event);
@@ -61,10 +65,18 @@ void HexItem::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
     if (!isUnderMouse()) {
         setPen(pen_);
         setZValue(0);
+        setFlag(QGraphicsItem::ItemHasNoContents);
     }
     QGraphicsPolygonItem::hoverLeaveEvent(event);
 }
 
+void HexItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+                    QWidget *widget)
+{
+    RenderStats::PaintTimer timer(RenderStats::HEX);
+    QGraphicsPolygonItem::paint(painter, option, widget);
+}
+
 bool HexItem::slotFull(std::string type, int i)
 {
     if (type == "pawn") {
@@ -82,37 +94,26 @@ bool HexItem::slotFull(std::string type, int i)
 }
 
 void HexItem::changeSlotOccupation(std::string type, int i)
+{
+    setSlotOccupied(type, i, !slotFull(type, i));
+}
+
+void HexItem::setSlotOccupied(std::string type, int i, bool occupied)
 {
     if (type == "pawn") {
-        if (slotFull(type, i)) {
-            pawnSlots_.at(i).second = false;
-            return;
-        }
-        pawnSlots_.at(i).second = true;
+        pawnSlots_.at(i).second = occupied;
     }
 
     else if (type == "actor") {
-        if (slotFull(type, i)) {
-            actorSlots_.at(i).second = false;
-            return;
-        }
-        actorSlots_.at(i).second = true;
+        actorSlots_.at(i).second = occupied;
     }
 
     else if (type == "dolphin") {
-        if (slotFull(type, i)) {
-            dolphinSlots_.at(i).second = false;
-            return;
-        }
-        dolphinSlots_.at(i).second = true;
+        dolphinSlots_.at(i).second = occupied;
     }
 
     else if (type == "boat") {
-        if (boatSlot_.second) {
-            boatSlot_.second = false;
-            return;
-        }
-        boatSlot_.second = true;
+        boatSlot_.second = occupied;
     }
     else {
         // type is vortex, do nothing.
@@ -1,12 +1,15 @@
 /* file: hexitem.hh
- * description: Header for class HexItem. Class is used for drawing the hexes
- * for the gameboard.
+ * description: Header for class HexItem. Class is used for the hexes of the
+ * gameboard: clicks, hovering, highlights and the slots of the items on the
+ * hex. The terrain itself is drawn by TerrainLayer, so a hexItem is only
+ * drawn while it is highlighted under the mouse.
  */
 
 #ifndef HEXITEM_HH
 #define HEXITEM_HH
 
 #include "cubecoordinate.hh"
+#include "renderstats.hh"
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QPainter>
@@ -59,6 +62,13 @@ public:
      */
     void hoverLeaveEvent(QGraphicsSceneHoverEvent * event);
 
+    /**
+     * @brief paint draws the outline of a highlighted hex, the terrain is
+     * drawn by TerrainLayer
+     */
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
     /**
      * @brief slotFull checks if slot is occupied
      * @param type of the slot
@@ -75,6 +85,14 @@ public:
      */
     void changeSlotOccupation(std::string type, int i);
 
+    /**
+     * @brief setSlotOccupied sets the bool value of the slot
+     * @param type of the slot
+     * @param i map-index of the slot
+     * @param occupied true, if an item takes the slot
+     */
+    void setSlotOccupied(std::string type, int i, bool occupied);
+
     /**
      * @brief getSlot returns the slot's pixel-coordinates
      * @param type of the slot
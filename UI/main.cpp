@@ -1,18 +1,67 @@
 /* file: main.cpp
  * description: Starts and closes the program. Checks for errors in opening and
- * reading the initialization files.
+ * reading the initialization files or a saved game or replay given as an
+ * argument.
  */
 
 #include "mainwindow.hh"
 #include "ioexception.hh"
 #include "formatexception.hh"
+#include "trace.hh"
 
+#include <iostream>
 #include <memory>
 #include <QApplication>
 
+namespace {
+
+// runs the game, and writes the trace of it when tracing is compiled in
+int run(QApplication& app)
+{
+    int result = app.exec();
+#ifdef ISLANDGAME_TRACING
+    try {
+        Common::Tracer::instance().writeChromeTraceFromEnvironment();
+    } catch (Common::IoException &e) {
+        std::cerr << e.msg() << std::endl;
+    }
+#endif
+    return result;
+}
+
+}
+
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    if (argc > 1) {
+        // watch the replay or continue the saved game given on the command
+        // line
+        std::string filePath = argv[1];
+        QMessageBox error;
+        error.setIcon(QMessageBox::Critical);
+        Student::MainWindow *w;
+        try {
+            if (QString::fromStdString(filePath).endsWith(".igj")) {
+                w = new Student::MainWindow(
+                            std::make_shared<Common::ReplayTimeline>(
+                                Common::JournalReader::readFile(filePath)));
+            } else {
+                Common::SaveFile save(filePath);
+                w = new Student::MainWindow(save);
+            }
+        } catch (Common::IoException &e) {
+            error.setText(QString::fromStdString(e.msg()));
+            error.exec();
+            return 1;
+        } catch (Common::FormatException &e) {
+            error.setText(QString::fromStdString(e.msg()));
+            error.exec();
+            return 1;
+        }
+        w->show();
+        return run(a);
+    }
     Student::StartDialog d;
     int accepted = d.exec();
     Student::MainWindow *w;
@@ -36,5 +85,5 @@ int main(int argc, char *argv[])
         return 0;
     }
     w->show();
-    return a.exec();
+    return run(a);
 }
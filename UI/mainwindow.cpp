@@ -4,6 +4,7 @@
 
 #include "mainwindow.hh"
 #include "ui_mainwindow.h"
+#include "trace.hh"
 
 namespace Student {
 
@@ -12,53 +13,175 @@ MainWindow::MainWindow(unsigned players, unsigned pawns, QWidget *parent) :
     ui_(new Ui::MainWindow),
     boardScene_(new QGraphicsScene),
     boardView_(new View),
+    terrain_(new TerrainLayer(HEX_SIZE)),
     pawnItems_({}),
     actorItems_({}),
     transportItems_({}),
     gameBoard_(std::make_shared<GameBoard>()),
     gameState_(std::make_shared<GameState>()),
+    playerTable_(std::make_shared<Common::PlayerTable>()),
     players_({}),
     gameEngine_(nullptr),
     pawnToBeMoved_(0),
     actorToBeMoved_(0),
-    transportToBeMoved_(0)
+    transportToBeMoved_(0),
+    wheelInfo_(),
+    replay_(nullptr),
+    shownFrame_(),
+    replaySlider_(nullptr),
+    eventSubscription_(0)
 {
-    ui_->setupUi(this);
-    setCentralWidget(ui_->horizontalWidget);
-    ui_->viewLayout->addWidget(boardView_);
+    initializeWindow();
     setPlayers(players, pawns);
     initializeGameEngine();
-    initializePawns();
+    connectEvents();
+    // the items of the pawns are created from the events of adding them
     drawBoard();
+    initializePawns();
     updateInfo();
     // // ui_->hexInfo->hide();
-    connect(ui_->spinWheelButton, &QPushButton::clicked,
-            this, &MainWindow::spinWheel);
-    connect(ui_->skipButton, &QPushButton::clicked,
-            this, &MainWindow::skipMovement);
     ui_->skipButton->setEnabled(true);
     ui_->spinWheelButton->setEnabled(false);
 }
 
+MainWindow::MainWindow(const Common::SaveFile& save, QWidget *parent) :
+    QMainWindow(parent),
+    ui_(new Ui::MainWindow),
+    boardScene_(new QGraphicsScene),
+    boardView_(new View),
+    terrain_(new TerrainLayer(HEX_SIZE)),
+    pawnItems_({}),
+    actorItems_({}),
+    transportItems_({}),
+    gameBoard_(std::make_shared<GameBoard>()),
+    gameState_(std::make_shared<GameState>()),
+    playerTable_(std::make_shared<Common::PlayerTable>()),
+    players_({}),
+    gameEngine_(nullptr),
+    pawnToBeMoved_(0),
+    actorToBeMoved_(0),
+    transportToBeMoved_(0),
+    wheelInfo_(),
+    replay_(nullptr),
+    shownFrame_(),
+    replaySlider_(nullptr),
+    eventSubscription_(0)
+{
+    initializeWindow();
+    for (const Common::SavedPlayer& saved : save.players()) {
+        players_[saved.id] = std::make_shared<Player>(playerTable_, saved.id,
+                                                      saved.pawns);
+    }
+    gameEngine_ = Common::Initialization::loadGameRunner(gameBoard_,
+                                                         gameState_,
+                                                         enginePlayers(),
+                                                         save);
+    connectEvents();
+    drawBoard();
+    updateInfo();
+
+    // the wheel is not part of the save, so a spinning turn starts with a spin
+    Common::GamePhase phase = gameState_->currentGamePhase();
+    ui_->skipButton->setEnabled(phase != Common::GamePhase::SINKING);
+    ui_->spinWheelButton->setEnabled(phase == Common::GamePhase::SPINNING);
+    if (phase == Common::GamePhase::SINKING) {
+        highlightFlippableHexes();
+    }
+}
+
+MainWindow::MainWindow(std::shared_ptr<Common::ReplayTimeline> replay,
+                       QWidget *parent) :
+    QMainWindow(parent),
+    ui_(new Ui::MainWindow),
+    boardScene_(new QGraphicsScene),
+    boardView_(new View),
+    terrain_(new TerrainLayer(HEX_SIZE)),
+    pawnItems_({}),
+    actorItems_({}),
+    transportItems_({}),
+    gameBoard_(std::make_shared<GameBoard>()),
+    gameState_(std::make_shared<GameState>()),
+    playerTable_(std::make_shared<Common::PlayerTable>()),
+    players_({}),
+    gameEngine_(nullptr),
+    pawnToBeMoved_(0),
+    actorToBeMoved_(0),
+    transportToBeMoved_(0),
+    wheelInfo_(),
+    replay_(replay),
+    shownFrame_(),
+    replaySlider_(new QSlider(Qt::Horizontal)),
+    eventSubscription_(0)
+{
+    initializeWindow();
+    ui_->skipButton->setEnabled(false);
+    ui_->spinWheelButton->setEnabled(false);
+    ui_->currentGamePhase->setText("REPLAY");
+
+    // the slider handles the arrow, page and home/end keys by itself
+    replaySlider_->setRange(0, static_cast<int>(replay_->plyCount()));
+    replaySlider_->setPageStep(10);
+    ui_->infoLayout->addWidget(replaySlider_);
+    connect(replaySlider_, &QSlider::valueChanged,
+            this, &MainWindow::seekReplay);
+
+    seekReplay(0);
+    boardView_->setScene(boardScene_);
+    replaySlider_->setFocus();
+}
+
 MainWindow::~MainWindow()
 {
+    if (gameEngine_ != nullptr) {
+        gameEngine_->getEvents()->unsubscribe(eventSubscription_);
+    }
     delete boardScene_;
     delete boardView_;
     delete ui_;
 }
 
+void MainWindow::initializeWindow()
+{
+    ui_->setupUi(this);
+    setCentralWidget(ui_->horizontalWidget);
+    ui_->viewLayout->addWidget(boardView_);
+    boardScene_->addItem(terrain_);
+    // the item images are scaled once for all items
+    SpriteAtlas& atlas = SpriteAtlas::instance();
+    atlas.preload(":/pawn-images", {PAWN_PIXMAP_SIZE});
+    atlas.preload(":/actor-images", {ACTOR_PIXMAP_SIZE, 3*ACTOR_PIXMAP_SIZE});
+    atlas.preload(":/transport-images", {ACTOR_PIXMAP_SIZE, BOAT_PIXMAP_SIZE});
+    connect(ui_->spinWheelButton, &QPushButton::clicked,
+            this, &MainWindow::spinWheel);
+    connect(ui_->skipButton, &QPushButton::clicked,
+            this, &MainWindow::skipMovement);
+    QShortcut *saveShortcut = new QShortcut(QKeySequence::Save, this);
+    connect(saveShortcut, &QShortcut::activated,
+            this, &MainWindow::saveGame);
+    QShortcut *replayShortcut = new QShortcut(QKeySequence::SaveAs, this);
+    connect(replayShortcut, &QShortcut::activated,
+            this, &MainWindow::saveReplay);
+    QShortcut *statsShortcut = new QShortcut(Qt::Key_F3, this);
+    connect(statsShortcut, &QShortcut::activated,
+            this, &MainWindow::toggleRenderStats);
+    QShortcut *statsCsvShortcut = new QShortcut(Qt::Key_F4, this);
+    connect(statsCsvShortcut, &QShortcut::activated,
+            this, &MainWindow::toggleRenderStatsCsv);
+}
+
 void MainWindow::setPlayers(unsigned int players, unsigned int pawns)
 {
     for (unsigned i = 0; i < players; ++i) {
         int playerId = static_cast<int>(i+1);
         std::shared_ptr<Player> newPlayer =
-                std::make_shared<Player>(playerId, pawns);
+                std::make_shared<Player>(playerTable_, playerId, pawns);
         players_[playerId] = newPlayer;
     }
 }
 
 void MainWindow::pawnSelected(int pawnId)
 {
+    TRACE_SCOPE("MainWindow::pawnSelected");
     if (gameState_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
         if (pawnToBeMoved_ != 0) {
             pawnItems_.at(pawnToBeMoved_)->setPawnPixmap(false);
@@ -74,6 +197,7 @@ void MainWindow::pawnSelected(int pawnId)
 
 void MainWindow::actorSelected(int actorId)
 {
+    TRACE_SCOPE("MainWindow::actorSelected");
     if (gameState_->currentGamePhase() == Common::GamePhase::SPINNING) {
         if ((ui_->spinWheelButton->isEnabled() != true) &&
             (transportToBeMoved_ == 0)) {
@@ -92,6 +216,7 @@ void MainWindow::actorSelected(int actorId)
 
 void MainWindow::transportSelected(int transportId)
 {
+    TRACE_SCOPE("MainWindow::transportSelected");
     if (gameState_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
         Common::CubeCoordinate coords =
                 gameBoard_->getTransportCoords(transportId);
@@ -127,10 +252,14 @@ void MainWindow::transportSelected(int transportId)
 
 void MainWindow::hexClicked(Common::CubeCoordinate coords)
 {
+    TRACE_SCOPE("MainWindow::hexClicked");
     if (gameState_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
         movePawn(coords);
         moveTransport(coords);
         toggleHexHighlighting(false);
+        if (gameState_->currentGamePhase() == Common::GamePhase::SINKING) {
+            highlightFlippableHexes();
+        }
 
     } else if (gameState_->currentGamePhase() == Common::GamePhase::SINKING) {
         initializeActor(coords);
@@ -153,17 +282,13 @@ void MainWindow::movePawn(Common::CubeCoordinate target)
     std::shared_ptr<Common::Pawn> pawn =
             gameBoard_->getHex(source)->givePawn(pawnToBeMoved_);
     PawnItem *pawnItem = pawnItems_.at(pawnToBeMoved_);
-    HexItem *sourceHexItem = hexItems_.at(source);
-    HexItem *targetHexItem = hexItems_.at(target);
 
     try {
         int movesLeft = gameEngine_->movePawn(source, target, pawnToBeMoved_);
-        for (auto transport : gameBoard_->getHex(source)->getTransports()) {
-                    if (transport->isPawnInTransport(pawn)) {
-                        transport->removePawn(pawn);
-                    }
-                }
-        pawnItem->setLocationOnBoard(sourceHexItem, targetHexItem, boardScene_);
+        std::shared_ptr<Common::Transport> carrier = pawn->getTransport();
+        if (carrier != nullptr) {
+            carrier->removePawn(pawn);
+        }
 
         for (auto transport : gameBoard_->getHex(target)->getTransports()) {
             movePawnToTransport(pawnToBeMoved_, transport->getId());
@@ -197,8 +322,6 @@ void MainWindow::moveActor(Common::CubeCoordinate target)
 
     Common::CubeCoordinate source = gameBoard_->getActorCoords(actorToBeMoved_);
     ActorItem *actorItem = actorItems_.at(actorToBeMoved_).second;
-    HexItem *sourceHexItem = hexItems_.at(source);
-    HexItem *targetHexItem = hexItems_.at(target);
 
     if (gameBoard_->getHex(source)->giveActor(actorToBeMoved_)->getActorType()
             != wheelInfo_.first) {
@@ -226,7 +349,6 @@ void MainWindow::moveActor(Common::CubeCoordinate target)
 
     try {
         gameEngine_->moveActor(source, target, actorToBeMoved_, wheelInfo_.second);
-        actorItem->setLocationOnBoard(sourceHexItem, targetHexItem, boardScene_);
         actorDoAction(actorToBeMoved_);
         gameState_->changeGamePhase(Common::GamePhase::MOVEMENT);
         changePlayer();
@@ -275,7 +397,6 @@ void MainWindow::moveTransportInMovement(Common::CubeCoordinate source,
                                          Common::CubeCoordinate target,
                                          TransportItem *transportItem)
 {
-    HexItem *sourceHexItem = hexItems_.at(source);
     HexItem *targetHexItem = hexItems_.at(target);
 
     if ((transportItem->getType() == "boat") &&
@@ -299,21 +420,6 @@ void MainWindow::moveTransportInMovement(Common::CubeCoordinate source,
         showPopup(QString::fromStdString(e.msg()));
         return;
     }
-    if (transportItem->getType() == "dolphin") {
-        for (auto pawn : gameBoard_->getHex(target)->giveTransport(
-                 transportToBeMoved_)->getPawnsInTransport()) {
-            movePawnWithDolphin(sourceHexItem, targetHexItem, transportItem,
-                                pawnItems_.at(pawn->getId()));
-        }
-    } else {
-        transportItem->setLocationOnBoard(
-                    sourceHexItem, targetHexItem, boardScene_);
-        for (auto pawn : gameBoard_->getHex(target)->giveTransport(
-                 transportToBeMoved_)->getPawnsInTransport()) {
-            pawnItems_.at(pawn->getId())->setLocationOnBoard(
-                        sourceHexItem, targetHexItem, boardScene_);
-        }
-    }
     for (auto pawn : gameBoard_->getHex(target)->getPawns()) {
         movePawnToTransport(pawn->getId(), transportToBeMoved_);
     }
@@ -328,7 +434,6 @@ void MainWindow::moveTransportInSpinning(Common::CubeCoordinate source,
                                          Common::CubeCoordinate target,
                                          TransportItem *transportItem)
 {
-    HexItem *sourceHexItem = hexItems_.at(source);
     HexItem *targetHexItem = hexItems_.at(target);
     if (gameBoard_->getHex(source)->giveTransport(
                 transportToBeMoved_)->getTransportType() != wheelInfo_.first) {
@@ -355,19 +460,6 @@ void MainWindow::moveTransportInSpinning(Common::CubeCoordinate source,
         showPopup(QString::fromStdString(e.msg()));
         return;
     }
-    std::vector<std::shared_ptr<Common::Pawn>> pawnsInTransport =
-            gameBoard_->getHex(target)->giveTransport(
-                transportToBeMoved_)->getPawnsInTransport();
-
-    if ((pawnsInTransport.size() > 0) && (wheelInfo_.second != "D")) {
-        for (auto pawn : pawnsInTransport) {
-            movePawnWithDolphin(sourceHexItem, targetHexItem, transportItem,
-                                pawnItems_.at(pawn->getId()));
-        }
-    } else {
-        transportItem->setLocationOnBoard(
-                    sourceHexItem, targetHexItem, boardScene_);
-    }
     for (auto pawn : gameBoard_->getHex(target)->getPawns()) {
         movePawnToTransport(pawn->getId(), transportToBeMoved_);
     }
@@ -381,24 +473,12 @@ void MainWindow::moveTransportInSpinning(Common::CubeCoordinate source,
 bool MainWindow::removePawns(Common::CubeCoordinate location)
 {
     bool removed = false;
-    std::vector<std::shared_ptr<Common::Pawn>> pawns =
-            gameBoard_->getHex(location)->getPawns();
-    std::vector<std::shared_ptr<Common::Transport>> transports =
-            gameBoard_->getHex(location)->getTransports();
+    std::shared_ptr<Common::Hex> hex = gameBoard_->getHex(location);
+    std::vector<std::shared_ptr<Common::Pawn>> pawns = hex->getPawns();
     for (std::shared_ptr<Common::Pawn> pawn : pawns) {
-        bool isInTransport = false;
-        for (std::shared_ptr<Common::Transport> transport : transports) {
-            if (transport->isPawnInTransport(pawn)) {
-                isInTransport = true;
-            }
-        }
-        if (!isInTransport) {
+        if (!hex->isPawnInTransport(pawn)) {
             int pawnId = pawn->getId();
             players_.at(pawn->getPlayerId())->removePawn();
-            int slot = pawnItems_.at(pawnId)->currentSlot();
-            hexItems_.at(location)->changeSlotOccupation("pawn", slot);
-            delete pawnItems_.at(pawnId);
-            pawnItems_.erase(pawnId);
             gameBoard_->removePawn(pawnId);
             removed = true;
         }
@@ -414,10 +494,6 @@ bool MainWindow::removeActors(Common::CubeCoordinate location)
     for (std::shared_ptr<Common::Actor> actor : actors) {
         int actorId = actor->getId();
         if (actor->getActorType() != "vortex") {
-            int slot = actorItems_.at(actorId).second->currentSlot();
-            hexItems_.at(location)->changeSlotOccupation("actor", slot);
-            delete actorItems_.at(actorId).second;
-            actorItems_.erase(actorId);
             gameBoard_->removeActor(actorId);
             removed = true;
         }
@@ -431,14 +507,8 @@ bool MainWindow::removeTransports(Common::CubeCoordinate location)
     std::vector<std::shared_ptr<Common::Transport>> transports =
             gameBoard_->getHex(location)->getTransports();
     for (std::shared_ptr<Common::Transport> transport : transports) {
-        int transportId = transport->getId();
         transport->removePawns();
-        int slot = transportItems_.at(transportId).second->currentSlot();
-        hexItems_.at(location)->changeSlotOccupation(
-                    transport->getTransportType(), slot);
-        delete transportItems_.at(transportId).second;
-        transportItems_.erase(transportId);
-        gameBoard_->removeTransport(transportId);
+        gameBoard_->removeTransport(transport->getId());
         removed = true;
     }
     return removed;
@@ -498,32 +568,20 @@ void MainWindow::actorDoAction(int actorId)
 
 void MainWindow::movePawnToTransport(int pawnId, int transportId)
 {
-    Common::CubeCoordinate coords = gameBoard_->getTransportCoords(transportId);
-
-    std::shared_ptr<Common::Transport> transport = gameBoard_->getHex(
-                coords)->giveTransport(transportId);
-
-    std::shared_ptr<Common::Pawn> pawn =
-            gameBoard_->getHex(coords)->givePawn(pawnId);
-
-    if ((transport->getCapacity() > 0) &&
-            (!transport->isPawnInTransport(pawn))) {
+    const std::pair<std::string, TransportItem *>& transport =
+            transportItems_.at(transportId);
 
-        if (transport->getTransportType() == "boat") {
-            gameBoard_->getHex(coords)->giveTransport(transportId)->addPawn(
-                        gameBoard_->getHex(coords)->givePawn(pawnId));
-
-        } else if (transport->getTransportType() == "dolphin") {
-            if (pawnItems_.at(pawnId)->currentSlot() ==
-                    transportItems_.at(transportId).second->currentSlot()) {
-                gameBoard_->getHex(coords)->giveTransport(transportId)->addPawn(
-                            gameBoard_->getHex(coords)->givePawn(pawnId));
-            }
-        } else {
-            // Game doesn't know the transport
-            throw std::invalid_argument("invalid transport type");
+    if (transport.first == "dolphin") {
+        // a pawn rides the dolphin it shares a slot with
+        if (pawnItems_.at(pawnId)->currentSlot() !=
+                transport.second->currentSlot()) {
+            return;
         }
+    } else if (transport.first != "boat") {
+        // Game doesn't know the transport
+        throw std::invalid_argument("invalid transport type");
     }
+    gameBoard_->boardPawn(pawnId, transportId);
 }
 
 void MainWindow::movePawnWithDolphin(HexItem *sourceHex,
@@ -616,8 +674,17 @@ void MainWindow::toggleHexHighlighting(bool value)
     }
 }
 
+void MainWindow::highlightFlippableHexes()
+{
+    toggleHexHighlighting(false);
+    for (Common::CubeCoordinate coords : gameEngine_->getFlippableTiles()) {
+        hexItems_.at(coords)->setHiglighted(true);
+    }
+}
+
 void MainWindow::spinWheel()
 {
+    TRACE_SCOPE("MainWindow::spinWheel");
     wheelInfo_ = gameEngine_->spinWheel();
     ui_->spinInfo->setText(QString::fromStdString(wheelInfo_.first +
                                                   " moves " +
@@ -649,9 +716,11 @@ void MainWindow::spinWheel()
 
 void MainWindow::skipMovement()
 {
+    TRACE_SCOPE("MainWindow::skipMovement");
     if (gameState_->currentGamePhase() == Common::GamePhase::MOVEMENT) {
         gameState_->changeGamePhase(Common::GamePhase::SINKING);
         ui_->skipButton->setEnabled(false);
+        highlightFlippableHexes();
         updateInfo();
     } else if (gameState_->currentGamePhase() == Common::GamePhase::SPINNING) {
         changePlayer();
@@ -662,39 +731,26 @@ void MainWindow::skipMovement()
 
 void MainWindow::drawBoard()
 {
-    QBrush brush(Qt::darkGray, Qt::SolidPattern);
-
+    TRACE_SCOPE("MainWindow::drawBoard");
     // copy the hexes from gameboard
     auto board = gameBoard_->getBoard();
 
     for (auto it = board.begin(); it != board.end(); ++it) {
         Common::CubeCoordinate cubeCoords = it->first;
-        QPointF pixelCoords = cubeToPixel(cubeCoords, HEX_SIZE);
-        QPen pen(Qt::black);
-        pen.setWidth(3);
-        HexItem *hex = new HexItem(cubeCoords,
-                                                     pixelCoords,
-                                                     HEX_SIZE, pen);
+        HexItem *hex = addHexItem(cubeCoords, it->second->getPieceType());
         connect(hex, &HexItem::clicked, this, &MainWindow::hexClicked);
         connect(hex, &HexItem::hover, this, &MainWindow::updateHexInfo);
-        setBrushColor(it->second->getPieceType(), brush);
-        addHexToScene(hex, brush);
         initializePawnItems(hex);
 
         // checking if there's transports in the tile
         for (auto transport : gameBoard_->getHex(cubeCoords)->getTransports()) {
-            QSize size = ACTOR_PIXMAP_SIZE;
-            if (transport->getTransportType() == "boat") {
-                size = BOAT_PIXMAP_SIZE;
-            }
-            TransportItem *transportItem = new TransportItem(
-                        size, transport->getId(), transport->getTransportType());
-            connect(transportItem, &TransportItem::selected,
-                   this, &MainWindow::transportSelected);
+            addTransportItem(transport->getId(), transport->getTransportType(),
+                             cubeCoords);
+        }
 
-            transportItems_[transport->getId()] =
-                    std::make_pair(transport->getTransportType(), transportItem);
-            transportItem->setLocationOnBoard(nullptr, hex, boardScene_);
+        // actors are only on the board when continuing a saved game
+        for (auto actor : gameBoard_->getHex(cubeCoords)->getActors()) {
+            addActorItem(actor->getId(), actor->getActorType(), cubeCoords);
         }
     }
     boardView_->setScene(boardScene_);
@@ -715,9 +771,22 @@ void MainWindow::initializePawns()
     }
 }
 
+HexItem *MainWindow::addHexItem(Common::CubeCoordinate cubeCoords,
+                                std::string pieceType)
+{
+    QBrush brush(Qt::darkGray, Qt::SolidPattern);
+    QPointF pixelCoords = cubeToPixel(cubeCoords, HEX_SIZE);
+    QPen pen(Qt::black);
+    pen.setWidth(3);
+    HexItem *hex = new HexItem(cubeCoords, pixelCoords, HEX_SIZE, pen);
+    setBrushColor(pieceType, brush);
+    addHexToScene(hex, brush);
+    return hex;
+}
+
 void MainWindow::addHexToScene(HexItem *hex, QBrush &brush)
 {
-    hex->setBrush(brush);
+    terrain_->setHex(hex->getCubeCoords(), brush.color());
     hex->setPolygon(hexagonCorners(HEX_SIZE));
     boardScene_->addItem(hex);
     hex->setPos(hex->getPixelCoords().rx(), hex->getPixelCoords().ry());
@@ -765,10 +834,7 @@ void MainWindow::initializePawnItems(HexItem *hexItem)
     for (int i = 0; i < pawnsInTile; ++i) {
         int ownerId = pawnVector.at(static_cast<unsigned>(i))->getPlayerId();
         int pawnId = pawnVector.at(static_cast<unsigned>(i))->getId();
-        PawnItem *pawnItem = new PawnItem(PAWN_PIXMAP_SIZE, ownerId, pawnId);
-        connect(pawnItem, &PawnItem::selected, this, &MainWindow::pawnSelected);
-        pawnItems_[pawnId] = pawnItem;
-        pawnItem->setLocationOnBoard(nullptr, hexItem, boardScene_);
+        addPawnItem(pawnId, ownerId, cubeCoords);
     }
 }
 
@@ -781,40 +847,18 @@ void MainWindow::initializeActor(Common::CubeCoordinate coords)
         showPopup(QString::fromStdString(e.msg()));
         return;
     }
-    HexItem *hex = hexItems_.at(coords);
-    hex->setBrush(QBrush(Qt::blue));
+    toggleHexHighlighting(false);
     updateHexInfo(coords);
-    hex->update();
 
     if (isActor(creatableType)) {
         for (auto actor : gameBoard_->getHex(coords)->getActors()) {
-            ActorItem *actorItem = new ActorItem(
-                        ACTOR_PIXMAP_SIZE, actor->getId(), creatableType);
-            connect(actorItem, &ActorItem::selected, this,
-                    &MainWindow::actorSelected);
-            actorItems_[actor->getId()] =
-                    std::make_pair(creatableType, actorItem);
-            actorItem->setLocationOnBoard(nullptr, hex, boardScene_);
             actorDoAction(actor->getId());
             if (creatableType == "vortex") {
-                delete actorItems_.at(actor->getId()).second;
-                actorItems_.erase(actor->getId());
                 gameBoard_->removeActor(actor->getId());
             }
         }
     } else {
         for (auto transport : gameBoard_->getHex(coords)->getTransports()) {
-            QSize size = ACTOR_PIXMAP_SIZE;
-            if (creatableType == "boat") {
-                size = BOAT_PIXMAP_SIZE;
-            }
-            TransportItem *transportItem = new TransportItem(
-                        size, transport->getId(), creatableType);
-            connect(transportItem, &TransportItem::selected,
-                   this, &MainWindow::transportSelected);
-            transportItems_[transport->getId()] =
-                    std::make_pair(creatableType, transportItem);
-            transportItem->setLocationOnBoard(nullptr, hex, boardScene_);
             for (auto pawn : gameBoard_->getHex(coords)->getPawns()) {
                 movePawnToTransport(pawn->getId(), transport->getId());
             }
@@ -830,6 +874,7 @@ void MainWindow::initializeActor(Common::CubeCoordinate coords)
 
 void MainWindow::updateInfo()
 {
+    TRACE_SCOPE("MainWindow::updateInfo");
     int currentPlayerId = gameState_->currentPlayer();
     std::string currentPlayerColor =
             players_.at(currentPlayerId)->getPlayerColor();
@@ -959,6 +1004,13 @@ bool MainWindow::isActor(std::string type)
 }
 
 void MainWindow::initializeGameEngine()
+{
+    gameEngine_ = Common::Initialization::getGameRunner(gameBoard_,
+                                                            gameState_,
+                                                            enginePlayers());
+}
+
+std::vector<std::shared_ptr<Common::IPlayer>> MainWindow::enginePlayers() const
 {
     std::vector<std::shared_ptr<Common::IPlayer>> players;
 
@@ -966,10 +1018,306 @@ void MainWindow::initializeGameEngine()
         players.push_back(
                     std::static_pointer_cast<Common::IPlayer>(player.second));
     }
+    return players;
+}
 
-    gameEngine_ = Common::Initialization::getGameRunner(gameBoard_,
-                                                            gameState_,
-                                                            players);
+void MainWindow::saveGame()
+{
+    if (gameEngine_ == nullptr) {
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(
+                this, "Save game", "", "Saved games (*.igs)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    try {
+        gameEngine_->saveGame(fileName.toStdString());
+    } catch (Common::IoException &e) {
+        showPopup(QString::fromStdString(e.msg()));
+    }
+}
+
+void MainWindow::saveReplay()
+{
+    if (gameEngine_ == nullptr) {
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(
+                this, "Save replay", "", "Replays (*.igj)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    try {
+        gameEngine_->getJournal()->writeFile(fileName.toStdString());
+    } catch (Common::IoException &e) {
+        showPopup(QString::fromStdString(e.msg()));
+    }
+}
+
+void MainWindow::toggleRenderStats()
+{
+    boardView_->setStatsOverlayVisible(!boardView_->statsOverlayVisible());
+}
+
+void MainWindow::toggleRenderStatsCsv()
+{
+    RenderStats& stats = RenderStats::instance();
+    if (stats.csvOpen()) {
+        stats.stopCsv();
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(
+                this, "Save frame statistics", "", "CSV files (*.csv)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    try {
+        stats.startCsv(fileName.toStdString());
+    } catch (Common::IoException &e) {
+        showPopup(QString::fromStdString(e.msg()));
+    }
+}
+
+void MainWindow::seekReplay(int ply)
+{
+    TRACE_SCOPE("MainWindow::seekReplay");
+    const Common::ReplayFrame& frame =
+            replay_->frameAt(static_cast<std::size_t>(ply));
+    Common::ReplayDiff diff = Common::ReplayTimeline::diff(shownFrame_, frame);
+
+    // removed items go first, so the slots they free can be taken
+    for (int id : diff.pawns.removed) {
+        removeItem(pawnItems_.at(id), shownFrame_.pawns.at(id).location,
+                   "pawn");
+        pawnItems_.erase(id);
+    }
+    for (int id : diff.actors.removed) {
+        removeItem(actorItems_.at(id).second,
+                   shownFrame_.actors.at(id).location, "actor");
+        actorItems_.erase(id);
+    }
+    for (int id : diff.transports.removed) {
+        removeItem(transportItems_.at(id).second,
+                   shownFrame_.transports.at(id).location,
+                   transportItems_.at(id).first);
+        transportItems_.erase(id);
+    }
+
+    for (std::size_t index : diff.hexes) {
+        Common::CubeCoordinate coords = replay_->hexCoordinates().at(index);
+        std::uint16_t type = frame.hexTypes.at(index);
+        auto hexItem = hexItems_.find(coords);
+        if (hexItem == hexItems_.end()) {
+            if (type != 0) {
+                addHexItem(coords, replay_->name(type));
+            }
+        } else if (type == 0) {
+            hexItem->second->setVisible(false);
+            terrain_->removeHex(coords);
+        } else {
+            QBrush brush(Qt::darkGray, Qt::SolidPattern);
+            setBrushColor(replay_->name(type), brush);
+            terrain_->setHex(coords, brush.color());
+            hexItem->second->setVisible(true);
+        }
+    }
+
+    for (int id : diff.pawns.moved) {
+        pawnItems_.at(id)->setLocationOnBoard(
+                    hexItems_.at(shownFrame_.pawns.at(id).location),
+                    hexItems_.at(frame.pawns.at(id).location), boardScene_);
+    }
+    for (int id : diff.actors.moved) {
+        actorItems_.at(id).second->setLocationOnBoard(
+                    hexItems_.at(shownFrame_.actors.at(id).location),
+                    hexItems_.at(frame.actors.at(id).location), boardScene_);
+    }
+    for (int id : diff.transports.moved) {
+        transportItems_.at(id).second->setLocationOnBoard(
+                    hexItems_.at(shownFrame_.transports.at(id).location),
+                    hexItems_.at(frame.transports.at(id).location),
+                    boardScene_);
+    }
+
+    for (int id : diff.pawns.added) {
+        const Common::ReplayPiece& pawn = frame.pawns.at(id);
+        PawnItem *pawnItem = new PawnItem(PAWN_PIXMAP_SIZE, pawn.player, id);
+        pawnItems_[id] = pawnItem;
+        pawnItem->setLocationOnBoard(nullptr, hexItems_.at(pawn.location),
+                                     boardScene_);
+    }
+    for (int id : diff.actors.added) {
+        const Common::ReplayPiece& actor = frame.actors.at(id);
+        std::string type = replay_->name(actor.type);
+        ActorItem *actorItem = new ActorItem(ACTOR_PIXMAP_SIZE, id, type);
+        actorItems_[id] = std::make_pair(type, actorItem);
+        actorItem->setLocationOnBoard(nullptr, hexItems_.at(actor.location),
+                                      boardScene_);
+    }
+    for (int id : diff.transports.added) {
+        const Common::ReplayPiece& transport = frame.transports.at(id);
+        std::string type = replay_->name(transport.type);
+        QSize size = ACTOR_PIXMAP_SIZE;
+        if (type == "boat") {
+            size = BOAT_PIXMAP_SIZE;
+        }
+        TransportItem *transportItem = new TransportItem(size, id, type);
+        transportItems_[id] = std::make_pair(type, transportItem);
+        transportItem->setLocationOnBoard(
+                    nullptr, hexItems_.at(transport.location), boardScene_);
+    }
+
+    shownFrame_ = frame;
+    ui_->currentPlayer->setText(QString::fromStdString(
+                                    "IN TURN: \nPlayer " +
+                                    std::to_string(frame.playerInTurn)));
+    ui_->movesLeft->setText(QString::fromStdString(
+                                "Ply " + std::to_string(ply) + " / " +
+                                std::to_string(replay_->plyCount())));
+}
+
+void MainWindow::removeItem(GamePixmapItem *item,
+                            Common::CubeCoordinate location,
+                            std::string slotType)
+{
+    hexItems_.at(location)->changeSlotOccupation(slotType,
+                                                 item->currentSlot());
+    delete item;
+}
+
+void MainWindow::connectEvents()
+{
+    std::shared_ptr<Common::GameEventPublisher> events =
+            gameEngine_->getEvents();
+    // the engine gave the board its publisher already
+    gameState_->setEventPublisher(events);
+    eventSubscription_ = events->subscribe(
+                [this](const Common::GameEvent& event) { applyEvent(event); });
+}
+
+void MainWindow::applyEvent(const Common::GameEvent& event)
+{
+    TRACE_SCOPE("MainWindow::applyEvent");
+    switch (event.type) {
+    case Common::GameEventType::PAWN_ADDED:
+        addPawnItem(event.id, event.other, event.target);
+        break;
+
+    case Common::GameEventType::PAWN_MOVED:
+        pawnItems_.at(event.id)->setLocationOnBoard(
+                    hexItems_.at(event.origin), hexItems_.at(event.target),
+                    boardScene_);
+        break;
+
+    case Common::GameEventType::PAWN_REMOVED:
+        removeItem(pawnItems_.at(event.id), event.target, "pawn");
+        pawnItems_.erase(event.id);
+        break;
+
+    case Common::GameEventType::ACTOR_SPAWNED:
+        addActorItem(event.id, event.name, event.target);
+        break;
+
+    case Common::GameEventType::ACTOR_MOVED:
+        actorItems_.at(event.id).second->setLocationOnBoard(
+                    hexItems_.at(event.origin), hexItems_.at(event.target),
+                    boardScene_);
+        break;
+
+    case Common::GameEventType::ACTOR_REMOVED:
+        removeItem(actorItems_.at(event.id).second, event.target, "actor");
+        actorItems_.erase(event.id);
+        break;
+
+    case Common::GameEventType::TRANSPORT_SPAWNED:
+        addTransportItem(event.id, event.name, event.target);
+        break;
+
+    case Common::GameEventType::TRANSPORT_MOVED:
+        moveTransportItem(event.id, event.origin, event.target);
+        break;
+
+    case Common::GameEventType::TRANSPORT_REMOVED:
+        removeItem(transportItems_.at(event.id).second, event.target,
+                   transportItems_.at(event.id).first);
+        transportItems_.erase(event.id);
+        break;
+
+    case Common::GameEventType::HEX_SUNK:
+        terrain_->setHex(event.target, QColor(Qt::blue));
+        break;
+
+    case Common::GameEventType::PHASE_CHANGED:
+    case Common::GameEventType::PLAYER_CHANGED:
+        updateInfo();
+        break;
+
+    default:
+        // the rest do not change what is shown
+        break;
+    }
+}
+
+void MainWindow::addPawnItem(int pawnId, int playerId,
+                             Common::CubeCoordinate location)
+{
+    PawnItem *pawnItem = new PawnItem(PAWN_PIXMAP_SIZE, playerId, pawnId);
+    connect(pawnItem, &PawnItem::selected, this, &MainWindow::pawnSelected);
+    pawnItems_[pawnId] = pawnItem;
+    pawnItem->setLocationOnBoard(nullptr, hexItems_.at(location), boardScene_);
+}
+
+void MainWindow::addActorItem(int actorId, std::string type,
+                              Common::CubeCoordinate location)
+{
+    ActorItem *actorItem = new ActorItem(ACTOR_PIXMAP_SIZE, actorId, type);
+    connect(actorItem, &ActorItem::selected, this, &MainWindow::actorSelected);
+    actorItems_[actorId] = std::make_pair(type, actorItem);
+    actorItem->setLocationOnBoard(nullptr, hexItems_.at(location), boardScene_);
+}
+
+void MainWindow::addTransportItem(int transportId, std::string type,
+                                  Common::CubeCoordinate location)
+{
+    QSize size = ACTOR_PIXMAP_SIZE;
+    if (type == "boat") {
+        size = BOAT_PIXMAP_SIZE;
+    }
+    TransportItem *transportItem = new TransportItem(size, transportId, type);
+    connect(transportItem, &TransportItem::selected,
+            this, &MainWindow::transportSelected);
+    transportItems_[transportId] = std::make_pair(type, transportItem);
+    transportItem->setLocationOnBoard(nullptr, hexItems_.at(location),
+                                      boardScene_);
+}
+
+void MainWindow::moveTransportItem(int transportId,
+                                   Common::CubeCoordinate source,
+                                   Common::CubeCoordinate target)
+{
+    HexItem *sourceHexItem = hexItems_.at(source);
+    HexItem *targetHexItem = hexItems_.at(target);
+    TransportItem *transportItem = transportItems_.at(transportId).second;
+    // the board has moved the pawns in the transport along with it
+    std::vector<std::shared_ptr<Common::Pawn>> pawnsInTransport =
+            gameBoard_->getHex(target)->giveTransport(
+                transportId)->getPawnsInTransport();
+
+    if ((transportItem->getType() == "dolphin") &&
+            (pawnsInTransport.size() > 0)) {
+        for (auto pawn : pawnsInTransport) {
+            movePawnWithDolphin(sourceHexItem, targetHexItem, transportItem,
+                                pawnItems_.at(pawn->getId()));
+        }
+    } else {
+        transportItem->setLocationOnBoard(
+                    sourceHexItem, targetHexItem, boardScene_);
+        for (auto pawn : pawnsInTransport) {
+            pawnItems_.at(pawn->getId())->setLocationOnBoard(
+                        sourceHexItem, targetHexItem, boardScene_);
+        }
+    }
 }
 
 void MainWindow::showPopup(QString msg)
@@ -17,13 +17,22 @@
 #include "initialize.hh"
 #include "gameexception.hh"
 #include "illegalmoveexception.hh"
+#include "ioexception.hh"
+#include "savefile.hh"
+#include "replaytimeline.hh"
+#include "gameevent.hh"
 #include "helpers.hh"
 #include "view.hh"
+#include "terrainlayer.hh"
+#include "spriteatlas.hh"
 #include <QMainWindow>
 #include <QGraphicsScene>
 #include <QPolygonF>
 #include <QString>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QShortcut>
+#include <QSlider>
 
 // a single hexes radius
 const int HEX_SIZE = 120;
@@ -46,6 +55,22 @@ class MainWindow : public QMainWindow
 public:
     explicit MainWindow(unsigned players, unsigned pawns,
                         QWidget *parent = nullptr);
+
+    /**
+     * @brief MainWindow Continues a saved game.
+     * @param save The saved game.
+     * @exception FormatException The save does not describe a valid game.
+     */
+    explicit MainWindow(const Common::SaveFile& save,
+                        QWidget *parent = nullptr);
+
+    /**
+     * @brief MainWindow Shows a recorded game. A slider selects the ply to
+     *        show, the game can't be played.
+     * @param replay The recorded game.
+     */
+    explicit MainWindow(std::shared_ptr<Common::ReplayTimeline> replay,
+                        QWidget *parent = nullptr);
     ~MainWindow();
 
 public slots:
@@ -87,6 +112,12 @@ public slots:
      */
     void toggleHexHighlighting(bool value);
 
+    /**
+     * @brief highlightFlippableHexes Highlights only the hexes that can be
+     *        sunk in the SINKING phase.
+     */
+    void highlightFlippableHexes();
+
     /**
      * @brief spinWheel Receives a signal from spin button and spins the wheel.
      */
@@ -97,8 +128,44 @@ public slots:
      */
     void skipMovement();
 
+    /**
+     * @brief saveGame Asks for a file name and saves the game to it.
+     */
+    void saveGame();
+
+    /**
+     * @brief saveReplay Asks for a file name and saves the journal of the
+     *        game to it, so the game can be watched later.
+     */
+    void saveReplay();
+
+    /**
+     * @brief seekReplay Shows the state of a recorded game after a ply.
+     *        Only the items that differ from the state shown are changed.
+     * @param ply The ply to show.
+     */
+    void seekReplay(int ply);
+
+    /**
+     * @brief toggleRenderStats Shows or hides the frame statistics of the
+     *        board view.
+     */
+    void toggleRenderStats();
+
+    /**
+     * @brief toggleRenderStatsCsv Asks for a file name and starts writing the
+     *        statistics of every frame to it, or stops the writing.
+     */
+    void toggleRenderStatsCsv();
+
 private:
 
+    /**
+     * @brief initializeWindow Sets up the widgets and connects the buttons
+     *        and shortcuts.
+     */
+    void initializeWindow();
+
     /**
      * @brief setPlayers Initializes players after receiving info from dialog.
      * @param players Number of players
@@ -107,7 +174,8 @@ private:
     void setPlayers(unsigned int players, unsigned int pawns);
 
     /**
-     * @brief drawBoard Copies the hexes from the gameboard and creates the hexItems.
+     * @brief drawBoard Copies the hexes from the gameboard and creates the
+     *        hexItems and the items of the pawns, actors and transports on them.
      */
     void drawBoard();
 
@@ -117,7 +185,76 @@ private:
     void initializePawns();
 
     /**
-     * @brief addHexToScene Adds a single hexItem to the scene.
+     * @brief addHexItem Creates a hexItem and adds it to the scene.
+     * @param cubeCoords Coordinates of the hex.
+     * @param pieceType Type of the hex.
+     * @return The new hexItem.
+     */
+    HexItem *addHexItem(Common::CubeCoordinate cubeCoords,
+                        std::string pieceType);
+
+    /**
+     * @brief removeItem Frees the slot of an item and deletes it.
+     * @param item The item.
+     * @param location Coordinates of the hex the item is on.
+     * @param slotType Type of the slot the item takes.
+     */
+    void removeItem(GamePixmapItem *item, Common::CubeCoordinate location,
+                    std::string slotType);
+
+    /**
+     * @brief connectEvents Makes the gameboard and the game state publish
+     *        their changes and updates the items from the events of the game.
+     */
+    void connectEvents();
+
+    /**
+     * @brief applyEvent Updates the items and the info affected by a change
+     *        in the game. Items are created, moved and deleted only here and
+     *        when drawing the board.
+     * @param event The change.
+     */
+    void applyEvent(const Common::GameEvent& event);
+
+    /**
+     * @brief addPawnItem Creates a pawnItem on a hex.
+     * @param pawnId Identifier of the pawn.
+     * @param playerId Identifier of the owner of the pawn.
+     * @param location Coordinates of the hex.
+     */
+    void addPawnItem(int pawnId, int playerId, Common::CubeCoordinate location);
+
+    /**
+     * @brief addActorItem Creates an actorItem on a hex.
+     * @param actorId Identifier of the actor.
+     * @param type Type of the actor.
+     * @param location Coordinates of the hex.
+     */
+    void addActorItem(int actorId, std::string type,
+                      Common::CubeCoordinate location);
+
+    /**
+     * @brief addTransportItem Creates a transportItem on a hex.
+     * @param transportId Identifier of the transport.
+     * @param type Type of the transport.
+     * @param location Coordinates of the hex.
+     */
+    void addTransportItem(int transportId, std::string type,
+                          Common::CubeCoordinate location);
+
+    /**
+     * @brief moveTransportItem Moves a transportItem and the pawnItems in the
+     *        transport. Pawns riding a dolphin share a slot with it.
+     * @param transportId Identifier of the transport.
+     * @param source Coordinates of the source hex.
+     * @param target Coordinates of the target hex.
+     */
+    void moveTransportItem(int transportId, Common::CubeCoordinate source,
+                           Common::CubeCoordinate target);
+
+    /**
+     * @brief addHexToScene Adds a single hexItem to the scene and its terrain
+     *        to the terrain layer.
      * @param hex Pointer to the hexItem to be added.
      * @param brush Initialized based on the tile type to be added.
      */
@@ -279,6 +416,11 @@ private:
      */
     void initializeGameEngine();
 
+    /**
+     * @brief enginePlayers Returns the players as given to the gameRunner.
+     */
+    std::vector<std::shared_ptr<Common::IPlayer>> enginePlayers() const;
+
     /**
      * @brief showPopup Show a popup.
      * @param msg Message shown in the popup.
@@ -288,6 +430,8 @@ private:
     Ui::MainWindow *ui_;
     QGraphicsScene *boardScene_;
     View *boardView_;
+    // Terrain of the board, owned by boardScene_.
+    TerrainLayer *terrain_;
 
     // Containers for graphical items in the game.
     std::map<int, PawnItem *> pawnItems_;
@@ -297,6 +441,8 @@ private:
 
     std::shared_ptr<GameBoard> gameBoard_;
     std::shared_ptr<GameState> gameState_;
+    // State of all players, shared with the game engine.
+    std::shared_ptr<Common::PlayerTable> playerTable_;
     std::map<int, std::shared_ptr<Player>> players_;
     std::shared_ptr<Common::IGameRunner> gameEngine_;
 
@@ -308,6 +454,15 @@ private:
     int transportToBeMoved_;
     // When the wheel is spun the results are stored here.
     std::pair<std::string, std::string> wheelInfo_;
+
+    // The recorded game and the state of it that is shown, when watching
+    // a replay.
+    std::shared_ptr<Common::ReplayTimeline> replay_;
+    Common::ReplayFrame shownFrame_;
+    QSlider *replaySlider_;
+
+    // Subscription of the window to the events of the game.
+    int eventSubscription_;
 };
 
 }
@@ -4,6 +4,7 @@
 
 #include "pawnitem.hh"
 #include "player.hh"
+#include "spriteatlas.hh"
 
 namespace Student {
 
@@ -20,38 +21,19 @@ PawnItem::PawnItem(QSize size, int ownerId, int pawnId, HexItem* parentHex) :
 void PawnItem::setPawnPixmap(bool selected)
 {
     if (selected) {
-        setPixmap(QPixmap(":/pawn-images/pawn-image-selected.png").
-                        scaled(size_, Qt::KeepAspectRatio));
+        setPixmap(SpriteAtlas::instance().sprite(
+                      ":/pawn-images/pawn-image-selected.png", size_));
     } else {
-        QPixmap pixmap;
-        switch(ownerId_) {
-        case 1:
-            pixmap = QPixmap(":/pawn-images/pawn-image1.png").
-                    scaled(size_, Qt::KeepAspectRatio);
-            break;
-        case 2:
-            pixmap = QPixmap(":/pawn-images/pawn-image2.png").
-                    scaled(size_, Qt::KeepAspectRatio);
-            break;
-        case 3:
-            pixmap = QPixmap(":/pawn-images/pawn-image3.png").
-                    scaled(size_, Qt::KeepAspectRatio);
-            break;
-        case 4:
-            pixmap = QPixmap(":/pawn-images/pawn-image4.png").
-                    scaled(size_, Qt::KeepAspectRatio);
-            break;
-        case 5:
-            pixmap = QPixmap(":/pawn-images/pawn-image5.png").
-                    scaled(size_, Qt::KeepAspectRatio);
-            break;
-        case 6:
-            pixmap = QPixmap(":/pawn-images/pawn-image6.png")
-                    .scaled(size_, Qt::KeepAspectRatio);
-            break;
-        }
-        setItemPixmap(pixmap);
+        // players 1 to 6 have images, other players get an empty pixmap
+        setItemPixmap(SpriteAtlas::instance().sprite(
+                          QString(":/pawn-images/pawn-image%1.png")
+                          .arg(ownerId_), size_));
     }
 }
 
+RenderStats::ItemClass PawnItem::statsClass() const
+{
+    return RenderStats::PAWN;
+}
+
 }
@@ -33,6 +33,9 @@ public:
      */
     void setPawnPixmap(bool selected);
 
+protected:
+    RenderStats::ItemClass statsClass() const override;
+
 private:  
     QSize size_;
     int ownerId_;
@@ -6,54 +6,42 @@
 
 namespace Student {
 
-Player::Player(int id, unsigned pawns) :
-    playerId_(id),
-    startingCoord_({0,0,0}),
-    pawns_(pawns),
-    actionsLeft_(3),
-    points_(0)
+Player::Player(std::shared_ptr<Common::PlayerTable> table, int id,
+               unsigned pawns) :
+    Common::TablePlayer(table, id, pawns, 3),
+    startingCoord_({0,0,0})
 {
     setStartingCoordAndColor();
 }
 
-int Player::getPlayerId() const
-{
-    return playerId_;
-}
-
-void Player::setActionsLeft(unsigned int actionsLeft)
-{
-    actionsLeft_ = actionsLeft;
-}
-
-unsigned int Player::getActionsLeft() const
+Player::Player(int id, unsigned pawns) :
+    Player(std::make_shared<Common::PlayerTable>(), id, pawns)
 {
-    return actionsLeft_;
 }
 
 unsigned int Player::getPoints() const
 {
-    return points_;
+    return record().points;
 }
 
 void Player::addPoints(unsigned int points)
 {
-    points_ += points;
+    record().points += points;
 }
 
 unsigned int Player::getPawns() const
 {
-    return pawns_;
+    return record().pawns;
 }
 
 void Player::removePawn()
 {
-    pawns_ -= 1;
+    record().pawns -= 1;
 }
 
 void Player::setStartingCoordAndColor()
 {
-    switch (playerId_) {
+    switch (getPlayerId()) {
     case 1:
         startingCoord_ = {-1,1,0};
         playerColor_ = "red";
@@ -5,39 +5,36 @@
 #ifndef PLAYER_HH
 #define PLAYER_HH
 
-#include "iplayer.hh"
+#include "playertable.hh"
 #include "pawn.hh"
 #include <map>
 #include <memory>
+#include <string>
 
 namespace Student {
 
-class Player : public Common::IPlayer
+/**
+ * @brief Player of the game. The actions, pawns and points of the player are
+ * stored in the PlayerTable shared by all players of the game.
+ */
+class Player : public Common::TablePlayer
 {
 public:
-    Player(int id, unsigned pawns);
-    ~Player() = default;
-
     /**
-     * @brief getPlayer gets the player id.
-     * @return The identifier of the player.
-     * @post Exception quarantee: nothrow
+     * @brief Player creates a player in the player table of the game
+     * @param table The player table of the game
+     * @param id The identifier of the player
+     * @param pawns Number of pawns the player starts with
      */
-    int getPlayerId() const;
+    Player(std::shared_ptr<Common::PlayerTable> table, int id, unsigned pawns);
 
     /**
-     * @brief setActionsLeft sets the player's remaining number of actions.
-     * @param actionsLeft The number of actions left.
-     * @post Actions left set to parameter value. Exception quarantee: nothrow
+     * @brief Player creates a player with a player table of its own
+     * @param id The identifier of the player
+     * @param pawns Number of pawns the player starts with
      */
-    void setActionsLeft(unsigned int actionsLeft);
-
-    /**
-     * @brief getActionsLeft returns the amount of actions left for the player
-     * @return amount of actions
-     * @post Exception quarantee: nothrow
-     */
-    unsigned int getActionsLeft() const;
+    Player(int id, unsigned pawns);
+    ~Player() = default;
 
     /**
      * @brief getPoints returns the amount of points player has gained in game
@@ -84,12 +81,8 @@ public:
     std::string getPlayerColor();
 
 private:
-    int playerId_;
     Common::CubeCoordinate startingCoord_;
     std::string playerColor_;
-    unsigned pawns_;
-    unsigned actionsLeft_;
-    unsigned points_;
 };
 
 }
@@ -0,0 +1,141 @@
+/* file: renderstats.cpp
+ * description: Implementation for the class RenderStats.
+ */
+
+#include "renderstats.hh"
+#include "ioexception.hh"
+
+namespace Student {
+
+RenderStats::PaintTimer::PaintTimer(ItemClass itemClass) :
+    itemClass_(itemClass),
+    running_(RenderStats::instance().inFrame_),
+    timer_()
+{
+    if (running_) {
+        timer_.start();
+    }
+}
+
+RenderStats::PaintTimer::~PaintTimer()
+{
+    if (running_) {
+        Frame& frame = RenderStats::instance().frame_;
+        frame.paintTime[itemClass_] += timer_.nsecsElapsed();
+        ++frame.painted[itemClass_];
+    }
+}
+
+RenderStats& RenderStats::instance()
+{
+    static RenderStats stats;
+    return stats;
+}
+
+QString RenderStats::name(ItemClass itemClass)
+{
+    switch (itemClass) {
+    case HEX:
+        return "HexItem";
+    case TERRAIN:
+        return "TerrainTile";
+    case PAWN:
+        return "PawnItem";
+    case ACTOR:
+        return "ActorItem";
+    case TRANSPORT:
+        return "TransportItem";
+    default:
+        return "other";
+    }
+}
+
+bool RenderStats::enabled() const
+{
+    return collecting_ || csvFile_.isOpen();
+}
+
+void RenderStats::setCollecting(bool collecting)
+{
+    collecting_ = collecting;
+}
+
+void RenderStats::beginFrame()
+{
+    frame_ = Frame();
+    frame_.number = ++frames_;
+    inFrame_ = enabled();
+}
+
+const RenderStats::Frame& RenderStats::endFrame(qint64 frameTime,
+                                                qint64 indexTime)
+{
+    inFrame_ = false;
+    frame_.frameTime = frameTime;
+    frame_.indexTime = indexTime;
+    if (csvFile_.isOpen()) {
+        writeCsvLine(frame_);
+    }
+    return frame_;
+}
+
+void RenderStats::startCsv(const std::string& filePath)
+{
+    QFile file(QString::fromStdString(filePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate
+                   | QIODevice::Text)) {
+        throw Common::IoException("Could not write statistics " + filePath);
+    }
+    file.close();
+    stopCsv();
+    csvFile_.setFileName(QString::fromStdString(filePath));
+    csvFile_.open(QIODevice::WriteOnly | QIODevice::Truncate
+                  | QIODevice::Text);
+    csv_.setDevice(&csvFile_);
+    csv_ << "frame,frame_us,index_us,items";
+    for (int i = 0; i < ITEM_CLASSES; ++i) {
+        QString itemClass = name(static_cast<ItemClass>(i));
+        csv_ << "," << itemClass << "_us," << itemClass << "_count";
+    }
+    csv_ << "\n";
+}
+
+void RenderStats::stopCsv()
+{
+    if (csvFile_.isOpen()) {
+        csv_.flush();
+        csv_.setDevice(nullptr);
+        csvFile_.close();
+    }
+}
+
+bool RenderStats::csvOpen() const
+{
+    return csvFile_.isOpen();
+}
+
+RenderStats::RenderStats() :
+    collecting_(false),
+    inFrame_(false),
+    frame_(),
+    frames_(0),
+    csvFile_(),
+    csv_()
+{
+}
+
+void RenderStats::writeCsvLine(const Frame& frame)
+{
+    int items = 0;
+    for (int count : frame.painted) {
+        items += count;
+    }
+    csv_ << frame.number << "," << frame.frameTime / 1000 << ","
+         << frame.indexTime / 1000 << "," << items;
+    for (int i = 0; i < ITEM_CLASSES; ++i) {
+        csv_ << "," << frame.paintTime[i] / 1000 << "," << frame.painted[i];
+    }
+    csv_ << "\n";
+}
+
+}
@@ -0,0 +1,134 @@
+/* file: renderstats.hh
+ * description: Header for class RenderStats. Measures how long drawing the
+ * board takes, for the statistics overlay of View and the CSV dump.
+ */
+
+#ifndef RENDERSTATS_HH
+#define RENDERSTATS_HH
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+#include <array>
+#include <string>
+
+namespace Student {
+
+/**
+ * @brief RenderStats collects the time spent drawing each frame of the
+ * board view.
+ * @details There is one collector for the whole program. Nothing is measured
+ * unless collection is turned on or a CSV file is being written, so the
+ * timers in the paint functions only check a flag. A frame is everything
+ * painted between beginFrame and endFrame.
+ */
+class RenderStats
+{
+public:
+    //! Classes of items whose painting is timed separately.
+    enum ItemClass {
+        HEX,
+        TERRAIN,
+        PAWN,
+        ACTOR,
+        TRANSPORT,
+        OTHER,
+        ITEM_CLASSES
+    };
+
+    //! Statistics of one frame, times in nanoseconds.
+    struct Frame {
+        unsigned long long number = 0;
+        qint64 frameTime = 0;
+        qint64 indexTime = 0;
+        std::array<qint64, ITEM_CLASSES> paintTime = {};
+        std::array<int, ITEM_CLASSES> painted = {};
+    };
+
+    /**
+     * @brief PaintTimer adds the time until it is destroyed to the paint
+     * time of an item class.
+     */
+    class PaintTimer
+    {
+    public:
+        explicit PaintTimer(ItemClass itemClass);
+        ~PaintTimer();
+
+    private:
+        ItemClass itemClass_;
+        bool running_;
+        QElapsedTimer timer_;
+    };
+
+    /**
+     * @brief instance returns the collector of the program.
+     */
+    static RenderStats& instance();
+
+    /**
+     * @brief name returns the name of an item class.
+     */
+    static QString name(ItemClass itemClass);
+
+    /**
+     * @brief enabled tells whether frames are measured.
+     * @return True if collection is on or a CSV file is being written.
+     */
+    bool enabled() const;
+
+    /**
+     * @brief setCollecting turns collection on or off.
+     */
+    void setCollecting(bool collecting);
+
+    /**
+     * @brief beginFrame starts a frame, the paint times are counted into it.
+     */
+    void beginFrame();
+
+    /**
+     * @brief endFrame finishes the frame and writes it to the CSV file.
+     * @param frameTime Time taken by the whole frame.
+     * @param indexTime Time taken by finding the items to draw.
+     * @return The statistics of the frame.
+     */
+    const Frame& endFrame(qint64 frameTime, qint64 indexTime);
+
+    /**
+     * @brief startCsv starts writing a line per frame to a file.
+     * @param filePath Path of the file, an old file is replaced.
+     * @exception IoException if the file can't be opened.
+     * @post Exception quarantee: strong
+     */
+    void startCsv(const std::string& filePath);
+
+    /**
+     * @brief stopCsv stops writing and closes the file, if one is open.
+     */
+    void stopCsv();
+
+    /**
+     * @brief csvOpen tells whether the frames are written to a file.
+     */
+    bool csvOpen() const;
+
+private:
+    RenderStats();
+    RenderStats(const RenderStats&) = delete;
+    RenderStats& operator=(const RenderStats&) = delete;
+
+    void writeCsvLine(const Frame& frame);
+
+    bool collecting_;
+    bool inFrame_;
+    Frame frame_;
+    unsigned long long frames_;
+    QFile csvFile_;
+    QTextStream csv_;
+};
+
+}
+
+#endif // RENDERSTATS_HH
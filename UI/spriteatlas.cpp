@@ -0,0 +1,51 @@
+/* file: spriteatlas.cpp
+ * description: Implementation for the class SpriteAtlas.
+ */
+
+#include "spriteatlas.hh"
+#include <QDirIterator>
+
+namespace Student {
+
+SpriteAtlas& SpriteAtlas::instance()
+{
+    static SpriteAtlas atlas;
+    return atlas;
+}
+
+void SpriteAtlas::preload(const QString& directory,
+                          const std::vector<QSize>& sizes)
+{
+    QDirIterator images(directory, {"*.png"}, QDir::Files);
+    while (images.hasNext()) {
+        QString path = images.next();
+        for (QSize size : sizes) {
+            sprite(path, size);
+        }
+    }
+}
+
+QPixmap SpriteAtlas::sprite(const QString& path, QSize size)
+{
+    auto key = std::make_pair(path, std::make_pair(size.width(),
+                                                   size.height()));
+    auto found = sprites_.find(key);
+    if (found != sprites_.end()) {
+        return found->second;
+    }
+    QPixmap image(path);
+    if (!image.isNull()) {
+        // scaled only once, so the smooth scaling is affordable
+        image = image.scaled(size, Qt::KeepAspectRatio,
+                             Qt::SmoothTransformation);
+    }
+    sprites_[key] = image;
+    return image;
+}
+
+std::size_t SpriteAtlas::size() const
+{
+    return sprites_.size();
+}
+
+}
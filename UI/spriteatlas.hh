@@ -0,0 +1,70 @@
+/* file: spriteatlas.hh
+ * description: Header for class SpriteAtlas. The images of pawns, actors and
+ * transports are decoded and scaled once and shared by all items.
+ */
+
+#ifndef SPRITEATLAS_HH
+#define SPRITEATLAS_HH
+
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Student {
+
+/**
+ * @brief SpriteAtlas holds the item images scaled to the sizes they are
+ * drawn in.
+ * @details There is one atlas for the whole program. The images are loaded
+ * at startup with preload, and an image asked in a size that was not
+ * preloaded is scaled once when it is first needed. The returned pixmaps
+ * share their data with the atlas, so giving the same sprite to many items
+ * costs no memory or decoding.
+ */
+class SpriteAtlas
+{
+public:
+    /**
+     * @brief instance returns the atlas of the program.
+     */
+    static SpriteAtlas& instance();
+
+    /**
+     * @brief preload scales every image of a resource directory to the
+     * given sizes.
+     * @param directory Resource directory of the images, e.g.
+     * ":/pawn-images".
+     * @param sizes Sizes the images are drawn in.
+     */
+    void preload(const QString& directory, const std::vector<QSize>& sizes);
+
+    /**
+     * @brief sprite returns an image scaled to fit in size, keeping its
+     * aspect ratio.
+     * @param path Resource path of the image, e.g.
+     * ":/pawn-images/pawn-image1.png".
+     * @param size Size the image is drawn in.
+     * @return The image, a null pixmap if there is no image in path.
+     */
+    QPixmap sprite(const QString& path, QSize size);
+
+    /**
+     * @brief size returns the number of images in the atlas.
+     */
+    std::size_t size() const;
+
+private:
+    SpriteAtlas() = default;
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // images by path and size, the size as width and height
+    std::map<std::pair<QString, std::pair<int, int>>, QPixmap> sprites_;
+};
+
+}
+
+#endif // SPRITEATLAS_HH
@@ -0,0 +1,171 @@
+/* file: terrainlayer.cpp
+ * description: Implementation for the classes TerrainLayer and TerrainTile.
+ */
+
+#include "terrainlayer.hh"
+#include "helpers.hh"
+#include "renderstats.hh"
+
+namespace Student {
+
+namespace {
+
+// outline width of the hexes
+const int TERRAIN_PEN_WIDTH = 3;
+
+// rounds towards negative infinity, so tiles of negative coordinates have
+// the same size as the others
+int floorDiv(int value, int divisor)
+{
+    int quotient = value / divisor;
+    if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) {
+        --quotient;
+    }
+    return quotient;
+}
+
+}
+
+TerrainTile::TerrainTile(const QPolygonF& hexagon, QGraphicsItem *parent) :
+    QGraphicsItem(parent),
+    hexagon_(hexagon),
+    hexagonRect_(hexagon.boundingRect()),
+    cellRect_(),
+    pen_(Qt::black),
+    hexes_(),
+    bounds_()
+{
+    pen_.setWidth(TERRAIN_PEN_WIDTH);
+    // rows of pointy-top hexes are three quarters of a hex height apart
+    cellRect_ = QRectF(hexagonRect_.left(), -hexagonRect_.height() * 3 / 8,
+                       hexagonRect_.width(), hexagonRect_.height() * 3 / 4);
+    qreal margin = TERRAIN_PEN_WIDTH / 2. + 1;
+    hexagonRect_.adjust(-margin, -margin, margin, margin);
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void TerrainTile::setHex(Common::CubeCoordinate coord, QPointF center,
+                         QColor color)
+{
+    QRectF rect = hexRect(center);
+    auto found = hexes_.find(coord);
+    if (found == hexes_.end()) {
+        hexes_[coord] = {center, color};
+        if (!bounds_.contains(rect)) {
+            prepareGeometryChange();
+            bounds_ = bounds_.united(rect);
+        }
+    } else if (found->second.color == color) {
+        return;
+    } else {
+        found->second.color = color;
+    }
+    update(rect);
+}
+
+bool TerrainTile::removeHex(Common::CubeCoordinate coord)
+{
+    auto found = hexes_.find(coord);
+    if (found != hexes_.end()) {
+        update(hexRect(found->second.center));
+        hexes_.erase(found);
+    }
+    return hexes_.empty();
+}
+
+QRectF TerrainTile::boundingRect() const
+{
+    return bounds_;
+}
+
+void TerrainTile::paint(QPainter *painter,
+                        const QStyleOptionGraphicsItem *option,
+                        QWidget *)
+{
+    RenderStats::PaintTimer timer(RenderStats::TERRAIN);
+    if (isLowDetail(painter)) {
+        paintCells(painter, option->exposedRect);
+        return;
+    }
+    painter->setPen(pen_);
+    for (const auto& hex : hexes_) {
+        if (!option->exposedRect.intersects(hexRect(hex.second.center))) {
+            continue;
+        }
+        painter->setBrush(hex.second.color);
+        painter->translate(hex.second.center);
+        painter->drawPolygon(hexagon_);
+        painter->translate(-hex.second.center);
+    }
+}
+
+QRectF TerrainTile::hexRect(QPointF center) const
+{
+    return hexagonRect_.translated(center);
+}
+
+void TerrainTile::paintCells(QPainter *painter, const QRectF& exposed) const
+{
+    std::map<QRgb, std::vector<QRectF>> cells;
+    for (const auto& hex : hexes_) {
+        QRectF cell = cellRect_.translated(hex.second.center);
+        if (exposed.intersects(cell)) {
+            cells[hex.second.color.rgba()].push_back(cell);
+        }
+    }
+    painter->setPen(Qt::NoPen);
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    for (const auto& color : cells) {
+        painter->setBrush(QColor::fromRgba(color.first));
+        painter->drawRects(color.second.data(),
+                           static_cast<int>(color.second.size()));
+    }
+}
+
+TerrainLayer::TerrainLayer(int hexSize) :
+    hexSize_(hexSize),
+    hexagon_(hexagonCorners(hexSize)),
+    tiles_()
+{
+    setFlag(QGraphicsItem::ItemHasNoContents);
+    setAcceptedMouseButtons(Qt::NoButton);
+    setZValue(-1);
+}
+
+void TerrainLayer::setHex(Common::CubeCoordinate coord, QColor color)
+{
+    std::pair<int, int> key = tileKey(coord);
+    auto found = tiles_.find(key);
+    if (found == tiles_.end()) {
+        found = tiles_.insert({key, new TerrainTile(hexagon_, this)}).first;
+    }
+    found->second->setHex(coord, cubeToPixel(coord, hexSize_), color);
+}
+
+void TerrainLayer::removeHex(Common::CubeCoordinate coord)
+{
+    auto found = tiles_.find(tileKey(coord));
+    if (found != tiles_.end() && found->second->removeHex(coord)) {
+        delete found->second;
+        tiles_.erase(found);
+    }
+}
+
+QRectF TerrainLayer::boundingRect() const
+{
+    return QRectF();
+}
+
+void TerrainLayer::paint(QPainter *, const QStyleOptionGraphicsItem *,
+                         QWidget *)
+{
+}
+
+std::pair<int, int> TerrainLayer::tileKey(Common::CubeCoordinate coord) const
+{
+    return {floorDiv(coord.x, TILE_HEXES), floorDiv(coord.z, TILE_HEXES)};
+}
+
+}
@@ -0,0 +1,126 @@
+/* file: terrainlayer.hh
+ * description: Header for classes TerrainLayer and TerrainTile. The terrain
+ * of the board is drawn by a few cached tiles instead of an item per hex.
+ */
+
+#ifndef TERRAINLAYER_HH
+#define TERRAINLAYER_HH
+
+#include "cubecoordinate.hh"
+#include <QColor>
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <QStyleOptionGraphicsItem>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Student {
+
+/**
+ * @brief TerrainTile draws the hexes of one square block of the board.
+ * @details The tile is cached in device coordinates, so panning the view
+ * only copies the cached pixmap. The cache is redrawn when the view is
+ * zoomed or when a hex of the tile changes, and then only the hexes that
+ * intersect the exposed area are drawn. Below LOW_DETAIL_LEVEL the hexes
+ * are drawn as flat cells without outlines, with one call per color.
+ */
+class TerrainTile : public QGraphicsItem
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param hexagon Corners of a hex centered at (0, 0).
+     * @param parent The terrain layer.
+     */
+    TerrainTile(const QPolygonF& hexagon, QGraphicsItem *parent);
+    ~TerrainTile() = default;
+
+    /**
+     * @brief setHex adds a hex to the tile or changes its color.
+     * @param coord Cube coordinates of the hex.
+     * @param center Pixel coordinates of the center of the hex.
+     * @param color Color of the terrain.
+     */
+    void setHex(Common::CubeCoordinate coord, QPointF center, QColor color);
+
+    /**
+     * @brief removeHex stops drawing a hex.
+     * @param coord Cube coordinates of the hex.
+     * @return True if the tile has no hexes left.
+     */
+    bool removeHex(Common::CubeCoordinate coord);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+private:
+    struct TerrainHex {
+        QPointF center;
+        QColor color;
+    };
+
+    // area of the hex at center, outline included
+    QRectF hexRect(QPointF center) const;
+    void paintCells(QPainter *painter, const QRectF& exposed) const;
+
+    QPolygonF hexagon_;
+    QRectF hexagonRect_;
+    // rectangle of a hex centered at (0, 0) that tiles the board with the
+    // rectangles of the other hexes
+    QRectF cellRect_;
+    QPen pen_;
+    std::map<Common::CubeCoordinate, TerrainHex> hexes_;
+    QRectF bounds_;
+};
+
+/**
+ * @brief TerrainLayer is the terrain under the items of the board.
+ * @details The hexes are grouped in tiles of TILE_HEXES x TILE_HEXES cube
+ * coordinates. Changing a hex redraws only the part of its tile the hex
+ * covers. The layer itself draws nothing and lies under all other items.
+ */
+class TerrainLayer : public QGraphicsItem
+{
+public:
+    //! Hexes along each side of a tile.
+    static const int TILE_HEXES = 8;
+
+    /**
+     * @brief Constructor.
+     * @param hexSize Radius of a hex from center to a corner in pixels.
+     */
+    explicit TerrainLayer(int hexSize);
+    ~TerrainLayer() = default;
+
+    /**
+     * @brief setHex adds a hex to the terrain or changes its color.
+     * @param coord Cube coordinates of the hex.
+     * @param color Color of the terrain.
+     */
+    void setHex(Common::CubeCoordinate coord, QColor color);
+
+    /**
+     * @brief removeHex removes a hex from the terrain, if it is there.
+     * @param coord Cube coordinates of the hex.
+     */
+    void removeHex(Common::CubeCoordinate coord);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+private:
+    std::pair<int, int> tileKey(Common::CubeCoordinate coord) const;
+
+    int hexSize_;
+    QPolygonF hexagon_;
+    std::map<std::pair<int, int>, TerrainTile *> tiles_;
+};
+
+}
+
+#endif // TERRAINLAYER_HH
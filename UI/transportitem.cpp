@@ -3,6 +3,7 @@
  */
 
 #include "transportitem.hh"
+#include "spriteatlas.hh"
 
 namespace Student {
 
@@ -19,14 +20,15 @@ TransportItem::TransportItem(QSize size, int transportId,
 
 void TransportItem::setTransportPixmap(bool selected)
 {
+    SpriteAtlas& atlas = SpriteAtlas::instance();
     if (selected) {
         if (transportType_ == "dolphin") {
-            setPixmap(QPixmap(":/transport-images/dolphin-selected.png").
-                      scaled(size_, Qt::KeepAspectRatio));
+            setPixmap(atlas.sprite(":/transport-images/dolphin-selected.png",
+                                   size_));
         }
         else if (transportType_ == "boat") {
-            setPixmap(QPixmap(":/transport-images/boat-selected.png").
-                      scaled(size_, Qt::KeepAspectRatio));
+            setPixmap(atlas.sprite(":/transport-images/boat-selected.png",
+                                   size_));
         } else {
             // Game doesn't know the transport
             throw std::invalid_argument("invalid transport type");
@@ -34,12 +36,10 @@ void TransportItem::setTransportPixmap(bool selected)
     } else {
         QPixmap pixmap;
         if (transportType_ == "dolphin") {
-            pixmap = QPixmap(":/transport-images/dolphin.png").
-                    scaled(size_, Qt::KeepAspectRatio);
+            pixmap = atlas.sprite(":/transport-images/dolphin.png", size_);
         }
         else if (transportType_ == "boat") {
-            pixmap = QPixmap(":/transport-images/boat.png").
-                    scaled(size_, Qt::KeepAspectRatio);
+            pixmap = atlas.sprite(":/transport-images/boat.png", size_);
         } else {
             // Game doesn't know the transport
             throw std::invalid_argument("invalid transport type");
@@ -53,4 +53,9 @@ std::string TransportItem::getType()
     return transportType_;
 }
 
+RenderStats::ItemClass TransportItem::statsClass() const
+{
+    return RenderStats::TRANSPORT;
+}
+
 }
@@ -41,6 +41,9 @@ public:
      */
     std::string getType();
 
+protected:
+    RenderStats::ItemClass statsClass() const override;
+
 private:
     QSize size_;
     std::string transportType_;
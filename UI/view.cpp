@@ -3,13 +3,17 @@
  */
 
 #include "view.hh"
+#include <QFontDatabase>
 
 namespace Student {
 
 View::View() :
+    zoom_(1.0),
     pan_(false),
     panStartX_(0),
-    panStartY_(0)
+    panStartY_(0),
+    statsOverlay_(new QLabel(viewport())),
+    statsShown_()
 {
     setTransformationAnchor(QGraphicsView::NoAnchor);
     setResizeAnchor(QGraphicsView::NoAnchor);
@@ -20,6 +24,28 @@ View::View() :
 
     // Things look better when drawn big and scaled down.
     scale(0.25, 0.25);
+    updateRenderHints();
+
+    // an opaque overlay doesn't make the board under it repaint when its
+    // text changes
+    statsOverlay_->setAutoFillBackground(true);
+    statsOverlay_->setFont(QFontDatabase::systemFont(
+                               QFontDatabase::FixedFont));
+    statsOverlay_->setMargin(4);
+    statsOverlay_->move(0, 0);
+    statsOverlay_->hide();
+}
+
+void View::setStatsOverlayVisible(bool visible)
+{
+    RenderStats::instance().setCollecting(visible);
+    statsOverlay_->setVisible(visible);
+    statsShown_.invalidate();
+}
+
+bool View::statsOverlayVisible() const
+{
+    return statsOverlay_->isVisible();
 }
 
 void View::wheelEvent(QWheelEvent *event)
@@ -31,26 +57,87 @@ void View::wheelEvent(QWheelEvent *event)
     static const double zoomMin = 0.1;
     static const double zoomMax = 100;
 
-    // Current zoom for checking boundaries
-    static double currentZoom = 1.0;
-
     QPointF oldPos = mapToScene(event->pos());
 
-    if ((event->delta() > 0) && (currentZoom < zoomMax)) {
+    if ((event->delta() > 0) && (zoom_ < zoomMax)) {
         scale(zoomFactor, zoomFactor);
-        currentZoom *= zoomFactor;
-    } else if (currentZoom > zoomMin) {
+        zoom_ *= zoomFactor;
+    } else if (zoom_ > zoomMin) {
         scale(1 / zoomFactor, 1 / zoomFactor);
-        currentZoom /= zoomFactor;
+        zoom_ /= zoomFactor;
     } else {
         // If the boundaries are not met, do nothing.
     }
+    updateRenderHints();
     QPointF newPos = mapToScene(event->pos());
     QPointF delta = newPos - oldPos;
     translate(delta.x(), delta.y());
 
 }
 
+void View::showStats(const RenderStats::Frame& frame)
+{
+    // the text is changed a few times a second so it can be read
+    static const qint64 refreshInterval = 250;
+    if (statsShown_.isValid() && !statsShown_.hasExpired(refreshInterval)) {
+        return;
+    }
+    statsShown_.start();
+
+    int items = 0;
+    QString text = QString("frame %1 ms\nindex %2 ms")
+            .arg(frame.frameTime / 1e6, 0, 'f', 2)
+            .arg(frame.indexTime / 1e6, 0, 'f', 2);
+    for (int i = 0; i < RenderStats::ITEM_CLASSES; ++i) {
+        items += frame.painted[i];
+        text += QString("\n%1 %2 ms %3")
+                .arg(RenderStats::name(static_cast<RenderStats::ItemClass>(i)),
+                     -13)
+                .arg(frame.paintTime[i] / 1e6, 6, 'f', 2)
+                .arg(frame.painted[i]);
+    }
+    text += QString("\nitems %1").arg(items);
+    if (RenderStats::instance().csvOpen()) {
+        text += "\nwriting CSV";
+    }
+    statsOverlay_->setText(text);
+    statsOverlay_->adjustSize();
+}
+
+void View::updateRenderHints()
+{
+    // smoothing can't be seen when the hexes are a few pixels wide
+    bool detailed = transform().m11() >= LOW_DETAIL_LEVEL;
+    setRenderHint(QPainter::Antialiasing, detailed);
+    setRenderHint(QPainter::SmoothPixmapTransform, detailed);
+}
+
+void View::paintEvent(QPaintEvent *event)
+{
+    RenderStats& stats = RenderStats::instance();
+    if (!stats.enabled() || scene() == nullptr) {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+    // the view doesn't tell how long finding the exposed items takes, so
+    // the same query is timed separately
+    QElapsedTimer indexTimer;
+    indexTimer.start();
+    scene()->items(mapToScene(event->rect()), Qt::IntersectsItemBoundingRect,
+                   Qt::DescendingOrder, viewportTransform());
+    qint64 indexTime = indexTimer.nsecsElapsed();
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    stats.beginFrame();
+    QGraphicsView::paintEvent(event);
+    const RenderStats::Frame& frame =
+            stats.endFrame(frameTimer.nsecsElapsed(), indexTime);
+    if (statsOverlay_->isVisible()) {
+        showStats(frame);
+    }
+}
+
 void View::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::RightButton)
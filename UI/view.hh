@@ -1,6 +1,8 @@
 /* file: view.hh
  * description: Header for class View. Class is used for implementing zoom
- * and panning to the view.
+ * and panning to the view. Zoomed far out, the board is drawn without
+ * smoothing and the items draw themselves with less detail. The view can
+ * show the statistics of RenderStats on top of the board.
  */
 
 #ifndef VIEW_HH
@@ -9,6 +11,10 @@
 #include <QGraphicsView>
 #include <QWheelEvent>
 #include <QScrollBar>
+#include "helpers.hh"
+#include "renderstats.hh"
+#include <QLabel>
+#include <QPaintEvent>
 
 namespace Student {
 
@@ -21,6 +27,17 @@ public:
     View();
     ~View() = default;
 
+    /**
+     * @brief setStatsOverlayVisible Shows or hides the frame statistics in
+     *        the top left corner. Frames are measured while they are shown.
+     */
+    void setStatsOverlayVisible(bool visible);
+
+    /**
+     * @brief statsOverlayVisible Tells whether the statistics are shown.
+     */
+    bool statsOverlayVisible() const;
+
 protected:
     /**
      * @brief wheelEvent Zooms the view when scrolling with mouse wheel.
@@ -42,11 +59,33 @@ protected:
      */
     void mouseMoveEvent(QMouseEvent *event);
 
+    /**
+     * @brief paintEvent Draws the scene, measuring the frame when RenderStats
+     *        is enabled.
+     */
+    void paintEvent(QPaintEvent *event);
+
 private:
+    /**
+     * @brief updateRenderHints Turns smoothing off when the board is drawn
+     *        below LOW_DETAIL_LEVEL and back on above it.
+     */
+    void updateRenderHints();
+
+    /**
+     * @brief showStats Writes the statistics of a frame to the overlay.
+     */
+    void showStats(const RenderStats::Frame& frame);
+
+    //! Zoom relative to the starting scale.
+    double zoom_;
     //! Data needed for moving the view is stored here.
     bool pan_;
     int panStartX_;
     int panStartY_;
+    //! Frame statistics drawn over the board, hidden by default.
+    QLabel *statsOverlay_;
+    QElapsedTimer statsShown_;
 };
 
 }